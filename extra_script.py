@@ -1,2 +1,113 @@
 Import("env") # type: ignore
 env.Append(LINKFLAGS=["-flto-partition=none"]) # type: ignore
+
+import os
+import subprocess
+
+# ============================================
+# 配置レポート
+# ============================================
+# ビルド後に ELF のシンボルアドレスから ITCM / DTCM / OCRAM / FLASH への
+# 配置を集計し、utils/placement.hpp のポリシーどおりか確認する。
+# 結果は標準出力と $BUILD_DIR/placement_report.txt に出力される。
+
+REGIONS = [
+    # (名前, 開始, 終了)
+    ("ITCM",   0x00000000, 0x00080000),
+    ("DTCM",   0x20000000, 0x20080000),
+    ("OCRAM",  0x20200000, 0x20280000),
+    ("FLASH",  0x60000000, 0x61000000),
+    ("EXTMEM", 0x70000000, 0x71000000),
+]
+
+# 監視対象: (シンボル名に含まれる文字列, 期待する領域)
+EXPECTED = [
+    ("Wavetable::sine",             "DTCM"),
+    ("Wavetable::triangle",         "DTCM"),
+    ("Wavetable::saw",              "DTCM"),
+    ("Wavetable::square",           "DTCM"),
+    ("mip_memory",                  "DTCM"),
+    ("Envelope::exp2_table",        "DTCM"),
+    ("Algorithms::algorithms_",     "DTCM"),
+    ("Synth::generate",             "ITCM"),
+    ("DefaultPresets::presets_",    "FLASH"),
+    ("AudioMath::NOTE_FREQ_TABLE",  "FLASH"),
+    ("AudioMath::VELOCITY_TABLE",   "FLASH"),
+    ("AudioMath::PAN_SIN_TABLE",    "FLASH"),
+    ("AudioMath::PAN_COS_TABLE",    "FLASH"),
+    ("arena_memory",                "OCRAM"),
+]
+
+TOP_N = 8
+
+
+def region_of(addr):
+    for name, lo, hi in REGIONS:
+        if lo <= addr < hi:
+            return name
+    return "?"
+
+
+def placement_report(source, target, env):
+    elf = str(target[0])
+    nm = env.subst("$CC").replace("gcc", "nm")
+    try:
+        out = subprocess.check_output([nm, "-C", "-S", "--size-sort", elf], universal_newlines=True)
+    except (OSError, subprocess.CalledProcessError) as e:
+        print("placement report: nm failed: %s" % e)
+        return
+
+    symbols = []
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) < 4:
+            continue
+        addr, size, kind, name = parts
+        symbols.append((int(addr, 16), int(size, 16), kind, name))
+
+    totals = {}
+    by_region = {}
+    for addr, size, kind, name in symbols:
+        r = region_of(addr)
+        totals[r] = totals.get(r, 0) + size
+        by_region.setdefault(r, []).append((size, name))
+
+    lines = ["", "=== Placement report ==="]
+    for name, _, _ in REGIONS:
+        if name in totals:
+            lines.append("  %-6s %8d bytes" % (name, totals[name]))
+
+    lines.append("")
+    lines.append("  Watched symbols:")
+    mismatches = 0
+    for key, expected in EXPECTED:
+        hits = [(a, s, n) for a, s, k, n in symbols
+                if key in n and not n.startswith("guard variable")]
+        if not hits:
+            lines.append("    %-28s %-6s (not found / optimized out)" % (key, "-"))
+            continue
+        for addr, size, name in hits:
+            actual = region_of(addr)
+            mark = "" if actual == expected else "  <-- expected %s" % expected
+            if mark:
+                mismatches += 1
+            lines.append("    %-28s %-6s %7d bytes @0x%08x%s" % (name[:28], actual, size, addr, mark))
+
+    for name, _, _ in REGIONS:
+        if name not in by_region:
+            continue
+        lines.append("")
+        lines.append("  Largest in %s:" % name)
+        for size, sym in sorted(by_region[name], reverse=True)[:TOP_N]:
+            lines.append("    %7d  %s" % (size, sym[:60]))
+
+    lines.append("")
+    lines.append("  %d placement mismatch(es)" % mismatches)
+
+    text = "\n".join(lines) + "\n"
+    print(text)
+    with open(os.path.join(env.subst("$BUILD_DIR"), "placement_report.txt"), "w") as f:
+        f.write(text)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", placement_report) # type: ignore
@@ -5,6 +5,7 @@
 #include <SPI.h>
 
 #include "utils/color.hpp"
+#include "tools/profiler.hpp"
 
 // WaveShare 1.5inch RGB OLED Module 128x128 16bit
 constexpr uint16_t SCREEN_WIDTH = 128;
@@ -24,72 +25,149 @@ constexpr int16_t DEFAULT_FONT_HEIGHT = 8;
 using AudioCallback = void(*)();
 extern AudioCallback gfxAudioCallback;
 
+// 前回のコールバックから rows 行送ったところでコールバックを呼ぶか
+// 未設定なら GFX_CHUNK_H 行ごと。どちらでも GFX_CHUNK_H_MAX 行より間は空けない
+using AudioDueCheck = bool(*)(int16_t rows);
+extern AudioDueCheck gfxAudioDue;
+
+constexpr int16_t GFX_CHUNK_H = 4;
+constexpr int16_t GFX_CHUNK_H_MAX = 16;
+
 struct TextBounds{
     int16_t x, y;
     uint16_t w, h;
 };
 
-class GFX_SSD1351 {
+// 画面ごとの転送量 (GET DISPLAY)
+struct TransferStat {
+    const char* screen;
+    uint32_t frames;     // 転送があったフレーム数
+    uint64_t requested;  // 以前の方式での転送量（全画面 / 画面が指定した矩形を1行ずつ）
+    uint64_t sent;       // 実際に送ったバイト数（画素 + 窓の設定）
+    uint32_t windows;    // 設定した窓の数
+};
+
+/**
+ * @brief 描画した範囲を行ごとに記録するキャンバス
+ *
+ * GFXcanvas16 の基本の描画（点・水平線・垂直線・矩形・全面）を横取りし、
+ * 行ごとに書き換えた列の範囲を覚える。文字・線・図形・ビットマップはすべてこれらを経由する。
+ * getBuffer() へ直接書いた分は記録されないので markDirty() で知らせる。回転は 0 のみ。
+ */
+class TrackedCanvas : public GFXcanvas16 {
 private:
-    static inline Adafruit_SSD1351 display = {SCREEN_WIDTH, SCREEN_HEIGHT, &SPI1, CS_PIN, DC_PIN, RST_PIN};
+    int16_t x0_[SCREEN_HEIGHT];  // 行ごとの書き換えた範囲（x0 > x1 なら書き換えなし）
+    int16_t x1_[SCREEN_HEIGHT];
 
 public:
-    static inline void begin() {
-        display.begin(OLED_SPI_SPEED);
-        display.setRotation(0);
-        display.fillScreen(Color::BLACK);
+    TrackedCanvas() : GFXcanvas16(SCREEN_WIDTH, SCREEN_HEIGHT) { clearDirty(); }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        GFXcanvas16::drawPixel(x, y, color);
+        markDirty(x, y, 1, 1);
+    }
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+        GFXcanvas16::drawFastHLine(x, y, w, color);
+        markDirty(x, y, w, 1);
+    }
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+        GFXcanvas16::drawFastVLine(x, y, h, color);
+        markDirty(x, y, 1, h);
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+        GFXcanvas16::fillRect(x, y, w, h, color);
+        markDirty(x, y, w, h);
+    }
+    void fillScreen(uint16_t color) override {
+        GFXcanvas16::fillScreen(color);
+        markDirty(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
     }
 
-    /**
-     * @brief キャンバスの内容をディスプレイに転送（分割転送）
-     */
-    static void flash(GFXcanvas16& canvas, int16_t x = 0, int16_t y = 0) {
-        const int16_t w = canvas.width();
-        const int16_t h = canvas.height();
-        constexpr int16_t CHUNK_H = 4;  // 4行ごとにオーディオ処理
+    /** @brief 矩形を書き換えたことにする（画面外ははみ出た分を切る） */
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+        if (w < 0) { x += w + 1; w = -w; }
+        if (h < 0) { y += h + 1; h = -h; }
+        int16_t xe = x + w - 1;
+        int16_t ye = y + h - 1;
+        if (x < 0) x = 0;
+        if (y < 0) y = 0;
+        if (xe >= SCREEN_WIDTH) xe = SCREEN_WIDTH - 1;
+        if (ye >= SCREEN_HEIGHT) ye = SCREEN_HEIGHT - 1;
+        for (int16_t row = y; row <= ye && x <= xe; ++row) {
+            if (x < x0_[row]) x0_[row] = x;
+            if (xe > x1_[row]) x1_[row] = xe;
+        }
+    }
 
-        display.startWrite();
-        for (int16_t row = 0; row < h; ++row) {
-            uint16_t* ptr = canvas.getBuffer() + (row * w);
-            display.drawRGBBitmap(x, y + row, ptr, w, 1);
-
-            // 定期的にオーディオ処理を呼び出す
-            if ((row & (CHUNK_H - 1)) == (CHUNK_H - 1)) {
-                display.endWrite();
-                if (gfxAudioCallback) gfxAudioCallback();
-                display.startWrite();
-            }
+    /** @brief 行 y の書き換えた範囲 [x0, x1]。書き換えがなければ false */
+    bool dirtyRow(int16_t y, int16_t& x0, int16_t& x1) const {
+        x0 = x0_[y];
+        x1 = x1_[y];
+        return x0 <= x1;
+    }
+
+    void clearDirty() {
+        for (int16_t row = 0; row < SCREEN_HEIGHT; ++row) {
+            x0_[row] = SCREEN_WIDTH;
+            x1_[row] = -1;
         }
+    }
+};
+
+class GFX_SSD1351 {
+private:
+    static inline Adafruit_SSD1351 display = {SCREEN_WIDTH, SCREEN_HEIGHT, &SPI1, CS_PIN, DC_PIN, RST_PIN};
+
+    /**
+     * @brief 1行送るたびに呼び、必要ならオーディオ処理を挟む
+     *
+     * @param rows 前回のコールバックから送った行数（呼んだら 0 に戻す）
+     * @param row 送り終えた行（トレース用）
+     * @return コールバックを挟んだか（挟んだら転送先の窓を設定し直す）
+     */
+    static inline bool audioBreak(int16_t& rows, int16_t row) {
+        ++rows;
+        const bool due = rows >= GFX_CHUNK_H_MAX || (gfxAudioDue ? gfxAudioDue(rows) : rows >= GFX_CHUNK_H);
+        if (!due) return false;
         display.endWrite();
+        Trace::event(Trace::FLASH_CHUNK, 0, row + 1);
+        if (gfxAudioCallback) gfxAudioCallback();
+        display.startWrite();
+        rows = 0;
+        return true;
     }
 
+    // ディスプレイに送った内容の写し (PLACE_BULK)
+    static uint16_t shadow_[SCREEN_WIDTH * SCREEN_HEIGHT];
+    static constexpr uint8_t STAT_SCREENS = 8;
+    static TransferStat stats_[STAT_SCREENS];
+
+    static void sendRect(TrackedCanvas& canvas, int16_t x, int16_t y, int16_t w, int16_t h,
+        int16_t& rows, uint32_t& windows);
+
+public:
+    static void begin();
+
+    // SSD1351 の窓の設定 (0x15 + 2, 0x75 + 2, 0x5C)
+    static constexpr uint32_t WINDOW_BYTES = 7;
+    static constexpr uint32_t FULL_FRAME_BYTES = SCREEN_WIDTH * SCREEN_HEIGHT * 2 + SCREEN_HEIGHT * WINDOW_BYTES;
+
     /**
-     * @brief キャンバスの指定した矩形範囲だけをディスプレイに転送（部分更新）
+     * @brief キャンバスで書き換えた範囲のうち、実際に変わった部分だけをディスプレイに転送
+     *
+     * 行ごとの書き換え範囲を前回送った内容と比べて両端の変わっていない画素を削り、
+     * 続く行は窓の設定より安くなる限り1つの矩形にまとめて送る。転送中のオーディオ処理の呼び出しは
+     * audioBreak() で行単位のまま。
+     *
+     * @param screen 集計に使う画面名
+     * @param requested 以前の方式で送っていたバイト数（集計用）
      */
-    static void flashWindow(GFXcanvas16& canvas, int16_t x, int16_t y, int16_t w, int16_t h) {
-        // 範囲チェック
-        if (x < 0) x = 0;
-        if (y < 0) y = 0;
-        if (x + w > canvas.width()) w = canvas.width() - x;
-        if (y + h > canvas.height()) h = canvas.height() - y;
-        if (w <= 0 || h <= 0) return;
+    static void flashDirty(TrackedCanvas& canvas, const char* screen, uint32_t requested);
 
-        constexpr int16_t CHUNK_H = 4;  // 4行ごとにオーディオ処理
+    /** @brief 画面ごとの転送量を表で出力する (Serial) */
+    static void printStats();
 
-        display.startWrite();
-        for (int16_t row = 0; row < h; ++row) {
-            uint16_t* ptr = canvas.getBuffer() + ((y + row) * canvas.width()) + x;
-            display.drawRGBBitmap(x, y + row, ptr, w, 1);
-
-            // 大きい転送の場合のみオーディオ処理
-            if (h > CHUNK_H && (row & (CHUNK_H - 1)) == (CHUNK_H - 1)) {
-                display.endWrite();
-                if (gfxAudioCallback) gfxAudioCallback();
-                display.startWrite();
-            }
-        }
-        display.endWrite();
-    }
+    static void clearStats();
 
     /**
      * @brief 文字列を描画
@@ -27,6 +27,67 @@ constexpr size_t   BUFFER_SIZE  = 128;   // AudioBufferのサイズ
 constexpr uint8_t  QUEUE_BLOCKS = 2;     // AudioPlayQueueのバッファ数
 constexpr uint32_t AUDIO_MEMORY = QUEUE_BLOCKS * 6 + 4 + 2; // AudioMemoryの必要量
 
+// --------------
+// Underrun
+// --------------
+// アンダーラン発生時の回復ポリシー
+enum class UnderrunPolicy : uint8_t {
+    NONE = 0,  // 何もしない（枯渇中は I2S が無音を出す）
+    REPEAT,    // 直前のブロックをフェードアウトしながら繰り返す
+    SILENCE,   // 無音ブロックを挿入してキューを埋め直す
+    SHED,      // 無音を挿入し、最も古いボイスを解放して負荷を下げる
+    COUNT
+};
+
+// アンダーランイベントの種類
+constexpr uint8_t UNDERRUN_STARVED = 0x00; // 再生キューが空になり、出力が途切れた
+constexpr uint8_t UNDERRUN_LATE    = 0x01; // キューが空の状態でブロックが届いた（ぎりぎり間に合った）
+
+// UnderrunEvent::fx のビット
+constexpr uint8_t FX_BIT_LPF    = 0x01;
+constexpr uint8_t FX_BIT_HPF    = 0x02;
+constexpr uint8_t FX_BIT_DELAY  = 0x04;
+constexpr uint8_t FX_BIT_CHORUS = 0x08;
+constexpr uint8_t FX_BIT_REVERB = 0x10;
+
+constexpr uint8_t UNDERRUN_LOG_SIZE = 16; // イベントログの件数
+
+struct UnderrunEvent {
+    uint32_t time_ms; // 発生時刻 (millis)
+    uint8_t  kind;    // UNDERRUN_STARVED / UNDERRUN_LATE
+    uint8_t  voices;  // 発生時の発音数
+    uint8_t  fx;      // 発生時に有効だったエフェクト (FX_BIT_*)
+};
+
+/**
+ * @brief 再生キューの枯渇を検出するタップ
+ *
+ * queue_L の出力を読み取り専用で受け取り、オーディオ割り込みのたびに
+ * ブロックが届いたか（= キューが空でなかったか）を数える。
+ * arm() されている間だけ空を枯渇として数え、連続した空は1回のイベントにまとめる。
+ */
+class AudioQueueProbe : public AudioStream {
+private:
+    audio_block_t* inputQueueArray[1];
+    volatile uint32_t consumed_ = 0;       // 受け取ったブロック数
+    volatile uint32_t starved_ = 0;        // 空だった回数（arm中のみ）
+    volatile uint32_t events_ = 0;         // 枯渇の始まりの回数
+    volatile uint32_t event_time_ms_ = 0;  // 直近の枯渇の開始時刻
+    volatile bool armed_ = false;
+    bool was_starved_ = false;
+
+public:
+    AudioQueueProbe() : AudioStream(1, inputQueueArray) {}
+
+    void update() override;
+
+    void arm(bool on) { armed_ = on; }
+    uint32_t consumed() const { return consumed_; }
+    uint32_t starved() const { return starved_; }
+    uint32_t events() const { return events_; }
+    uint32_t eventTimeMs() const { return event_time_ms_; }
+};
+
 class AudioHandler {
 private:
 // --------------
@@ -57,8 +118,54 @@ private:
     AudioConnection  patchCord5 = {queue_R,  0, i2s_quad, 2};
     AudioConnection  patchCord6 = {queue_RM, 0, i2s_quad, 3};
 
+    // PlayQueue(L+) -> 枯渇検出タップ
+    // update() は宣言順に呼ばれるので、queue_L より後に置いて同じ割り込み内で受け取る
+    AudioQueueProbe  probe = {};
+    AudioConnection  patchCord7 = {queue_L, 0, probe, 0};
+
     State& state_;
 
+// --------------
+// Underrun
+// --------------
+    UnderrunPolicy policy_ = UnderrunPolicy::REPEAT;
+
+    // 音源の状態 (setSource() で毎ループ更新)
+    bool source_active_ = false;
+    uint8_t source_voices_ = 0;
+    uint8_t source_fx_ = 0;
+
+    bool armed_ = false;          // 連続再生中（枯渇を数える状態）か
+    bool recovering_ = false;     // 枯渇を検出してから次の実ブロックまで
+    uint32_t pushed_ = 0;         // キューへ送ったブロック数（補填を含む）
+    uint32_t seen_events_ = 0;    // ログ済みの枯渇イベント数
+    uint32_t late_ = 0;           // UNDERRUN_LATE の回数
+    uint32_t filled_ = 0;         // 補填したブロック数
+    uint32_t shed_ = 0;           // 解放を要求したボイス数
+    uint32_t starved_base_ = 0;   // clearUnderrunStats() 時点のプローブ累計
+    uint32_t events_base_ = 0;
+    uint8_t shed_request_ = 0;    // 未処理のボイス解放要求
+
+    // REPEAT 用: 直前の実ブロックと現在のフェードゲイン
+    Sample16_t last_L_[BUFFER_SIZE] = {};
+    Sample16_t last_R_[BUFFER_SIZE] = {};
+    Gain_t fade_gain_ = 0;
+
+    UnderrunEvent log_[UNDERRUN_LOG_SIZE] = {};
+    uint8_t log_head_ = 0;        // 次に書き込む位置
+    uint32_t log_total_ = 0;      // 記録した総数
+
+    /** @brief 再生キューに残っているブロック数（推定） */
+    uint32_t queueDepth() const;
+
+    /** @brief 4ch のキューへ1ブロック送る */
+    void playBlock(const Sample16_t* l, const Sample16_t* r, const Sample16_t* lm, const Sample16_t* rm);
+
+    /** @brief 音源が間に合わないときの補填ブロックを送る */
+    void fillBlock();
+
+    void logEvent(uint8_t kind, uint32_t time_ms);
+
 public:
     AudioHandler(State& state) : state_(state) {}
 
@@ -67,6 +174,54 @@ public:
     /** @brief バッファに格納されたオーディオデータを再生 */
     void process();
 
+    /**
+     * @brief 音源の状態を伝える（アンダーラン判定とイベント記録用）
+     *
+     * @param active 発音中またはエフェクトテール処理中か。false の間は空のキューを枯渇とみなさない
+     * @param voices 発音数
+     * @param fx 有効なエフェクト (FX_BIT_*)
+     */
+    void setSource(bool active, uint8_t voices, uint8_t fx);
+
+    /**
+     * @brief 再生キューが空になるまでの見込み (μs)
+     *
+     * キューに残っているブロックと、生成済みでまだ送っていないブロックの分。
+     * 音源が止まっている（枯渇を数えていない）間は UINT32_MAX。
+     */
+    uint32_t headroomUs() const;
+
+    /** @brief キューに次のブロックを送る空きがあるか */
+    bool hasQueueRoom() const { return queueDepth() < QUEUE_BLOCKS; }
+
+    /** @brief 未処理のボイス解放要求数を取り出す (SHED ポリシー) */
+    uint8_t takeShedRequest() {
+        uint8_t n = shed_request_;
+        shed_request_ = 0;
+        return n;
+    }
+
+    // --- アンダーラン統計 ---
+    void setUnderrunPolicy(UnderrunPolicy policy) { policy_ = policy; }
+    UnderrunPolicy getUnderrunPolicy() const { return policy_; }
+    uint32_t getStarvedEvents() const { return probe.events() - events_base_; }
+    uint32_t getStarvedBlocks() const { return probe.starved() - starved_base_; }
+    uint32_t getLateBlocks() const { return late_; }
+    uint32_t getFilledBlocks() const { return filled_; }
+    uint32_t getShedVoices() const { return shed_; }
+
+    /**
+     * @brief イベントログを新しい順に取得
+     *
+     * @param index 0 が最新
+     * @return 範囲外なら nullptr
+     */
+    const UnderrunEvent* getEvent(uint8_t index) const;
+    uint32_t getEventTotal() const { return log_total_; }
+
+    /** @brief カウンターとログをクリア（割り込み側の累計は差分で扱う） */
+    void clearUnderrunStats();
+
     /** @brief 録音開始 */
     void beginRecord();
 
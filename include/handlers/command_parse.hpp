@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// =============================================
+// シリアルコマンドのパーサーユーティリティ
+// =============================================
+
+// s が prefix で始まれば残り文字列を返す、マッチしなければ nullptr
+inline const char* match(const char* s, uint8_t len, const char* prefix) {
+    uint8_t plen = strlen(prefix);
+    if (len < plen || strncmp(s, prefix, plen) != 0) return nullptr;
+    return s + plen;
+}
+
+inline bool parseU8(const char* s, uint8_t& out, uint8_t lo, uint8_t hi) {
+    if (!s || !*s) return false;
+    int v = atoi(s);
+    if (v < lo || v > hi) return false;
+    out = static_cast<uint8_t>(v);
+    return true;
+}
+
+inline bool parseI8(const char* s, int8_t& out, int8_t lo, int8_t hi) {
+    if (!s || !*s) return false;
+    int v = atoi(s);
+    if (v < lo || v > hi) return false;
+    out = static_cast<int8_t>(v);
+    return true;
+}
+
+inline bool parseBool(const char* s, bool& out) {
+    if (!s || !*s) return false;
+    int v = atoi(s);
+    if (v != 0 && v != 1) return false;
+    out = (v == 1);
+    return true;
+}
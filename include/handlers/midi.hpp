@@ -4,6 +4,7 @@
 #include <MIDI.h>
 
 #include "modules/synth.hpp"
+#include "tools/capture.hpp"
 #include "utils/state.hpp"
 
 constexpr uint8_t MIDI_MAX_NOTE = 127;
@@ -29,6 +30,9 @@ private:
     State& state_;
     bool last_midi_state = false;
 
+    // 読み出し中の入力（USB / Serial7 でコールバックを共有しているため）
+    Capture::Source source_ = Capture::SRC_USB;
+
     static inline bool isValidNoteOn(uint8_t note, uint8_t velocity) {
         return note <= MIDI_MAX_NOTE && velocity <= MIDI_MAX_VELOCITY && velocity > 0;
     }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief SET コマンド（シンセのパラメータ変更）の解釈と適用
+ *
+ * シリアルの SET と、キャプチャの再生（ホストの replay）で同じコードを通すため
+ * SerialHandler から分けてある。結果は "OK: ..." / "ERR: ..." を Serial に出す。
+ */
+class ParamCommand {
+public:
+    /**
+     * @brief "SET " を除いたコマンドを適用
+     *
+     * @param s "MASTER LEVEL 100" など（null 終端）
+     * @param len s の長さ
+     * @return 対象 (MASTER|OP|LFO|DELAY|LPF|HPF|CHORUS|REVERB) が不明なら false。値の誤りは ERR を出して true
+     */
+    static bool set(const char* s, uint8_t len);
+};
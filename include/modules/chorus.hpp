@@ -29,9 +29,9 @@ constexpr uint8_t CHORUS_DEPTH_MAX = 99;
 
 class Chorus {
 private:
-    // ディレイバッファ (L/R)
-    Sample16_t buffer_L[CHORUS_BUFFER_SIZE] = {};
-    Sample16_t buffer_R[CHORUS_BUFFER_SIZE] = {};
+    // ディレイバッファ (L/R、EffectArena から CHORUS_BUFFER_SIZE ずつ貸し出される)
+    Sample16_t* buffer_L = nullptr;
+    Sample16_t* buffer_R = nullptr;
     uint32_t write_pos = 0;
 
     // 内部LFO (位相アキュムレーター方式)
@@ -94,6 +94,14 @@ private:
     void updatePhaseInc();
 
 public:
+    /**
+     * @brief バッファ領域を割り当てる（内容はクリアされる）
+     *
+     * @param mem L/R 連続領域 (CHORUS_BUFFER_SIZE × 2)、nullptr で切り離し
+     */
+    void attach(Sample16_t* mem);
+    bool hasMemory() const { return buffer_L != nullptr; }
+
     void reset();
     void setRate(uint8_t rate);
     void setDepth(uint8_t depth);
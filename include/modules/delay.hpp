@@ -5,10 +5,10 @@
 #include "utils/buffer.hpp"
 
 constexpr uint32_t DELAY_BUFFER_MS = 300;
-constexpr uint32_t DELAY_BUFFER_SIZE = (DELAY_BUFFER_MS * SAMPLE_RATE) / 1000;
+constexpr uint32_t DELAY_BUFFER_SIZE = (DELAY_BUFFER_MS * SAMPLE_RATE) / 1000 + 1; // 300ms の間隔を取るため +1
 
 constexpr int32_t MIN_TIME = 1;
-constexpr int32_t MAX_TIME = 300;
+constexpr int32_t MAX_TIME = 300; // 常に保証される最大値（アリーナに余裕があればそれ以上も可）
 constexpr Gain_t MIN_LEVEL = 0;
 constexpr Gain_t MAX_LEVEL = Q15_MAX;
 constexpr Gain_t MIN_FEEDBACK = 0;
@@ -16,10 +16,10 @@ constexpr Gain_t MAX_FEEDBACK = Q15_MAX;
 
 class Delay {
 private:
-    // 13230samples = 44100hz * 300ms
-    IntervalRingBuffer<Sample16_t, DELAY_BUFFER_SIZE> buffer_L = {}, buffer_R = {};
+    // バッファは EffectArena から貸し出される（標準 13231samples = 44100hz * 300ms + 1）
+    ExternalIntervalRingBuffer<Sample16_t> buffer_L = {}, buffer_R = {};
 
-    int32_t time = 80;          // ms (1-300)
+    int32_t time = 80;          // ms (1-getMaxTime())
     Gain_t level = 9830;        // Q15 (default: 30% = 9830)
     Gain_t feedback = 16384;    // Q15 (default: 50% = 16384)
     uint32_t delay_length = 0;
@@ -35,6 +35,18 @@ private:
     }
 
 public:
+    /**
+     * @brief バッファ領域を割り当てる（内容はクリアされ、タイムは容量内に再クランプ）
+     *
+     * @param mem L/R 連続領域 (samples_per_ch × 2)、nullptr で切り離し
+     * @param samples_per_ch 1chあたりのサンプル数
+     */
+    void attach(Sample16_t* mem, uint32_t samples_per_ch);
+    bool hasMemory() const { return buffer_L.isAttached(); }
+
+    /** @brief 現在の割り当てで設定可能な最大ディレイタイム (ms) */
+    int32_t getMaxTime() const;
+
     void reset();
     void setDelay(int32_t time, Gain_t level, Gain_t feedback);
     void setTime(int32_t time);
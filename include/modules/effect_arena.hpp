@@ -0,0 +1,96 @@
+#pragma once
+
+#include "types.hpp"
+#include "modules/delay.hpp"
+#include "modules/chorus.hpp"
+#include "modules/reverb.hpp"
+
+// アリーナ総容量（サンプル数）
+// 全エフェクト有効時に従来の静的確保と同じ配分ができる大きさ
+constexpr uint32_t EFFECT_ARENA_SAMPLES =
+    REVERB_TOTAL_SAMPLES + CHORUS_BUFFER_SIZE * 2 + DELAY_BUFFER_SIZE * 2;
+
+// ディレイOFF時に使用するリバーブ拡張倍率 (Q8: 384 = 1.5倍)
+constexpr uint16_t REVERB_LARGE_SCALE = 384;
+
+static_assert(reverbTotalSamples(REVERB_LARGE_SCALE) + CHORUS_BUFFER_SIZE * 2 <= EFFECT_ARENA_SAMPLES,
+              "large reverb does not fit in the effect arena");
+
+/**
+ * @brief エフェクト用共有メモリアリーナ
+ *
+ * Delay / Chorus / Reverb のバッファを1つの領域から貸し出す。
+ * Synth と Passthrough は同じエフェクトインスタンスを共有しているため、
+ * アリーナもそれぞれのモードから同じものを使う。
+ *
+ * 配置ポリシー（plan() 呼び出し時）:
+ * - 無効なエフェクトには領域を貸さない
+ * - Reverb: 標準サイズ。Delay が無効なら REVERB_LARGE_SCALE 倍に拡張
+ * - Chorus: 固定 CHORUS_BUFFER_SIZE × 2
+ * - Delay : 残り全部を L/R で等分（最低でも MAX_TIME 分は保証される）
+ *
+ * 配置が変わったエフェクトだけ付け替え、付け替えたバッファはクリアされる。
+ * 配置は [Reverb][Chorus][Delay L][Delay R] の順。
+ */
+class EffectArena {
+public:
+    struct Region {
+        uint32_t offset = 0;  // 先頭からのオフセット（サンプル）
+        uint32_t length = 0;  // 長さ（サンプル、L/R合計）
+    };
+
+    struct Layout {
+        Region reverb = {};
+        Region chorus = {};
+        Region delay = {};
+        uint16_t reverb_scale = REVERB_SCALE_ONE; // Q8
+    };
+
+private:
+    Delay& delay_;
+    Chorus& chorus_;
+    Reverb& reverb_;
+
+    Layout layout_ = {};
+
+    static bool sameRegion(const Region& a, const Region& b) {
+        return a.offset == b.offset && a.length == b.length;
+    }
+
+public:
+    EffectArena(Delay& delay, Chorus& chorus, Reverb& reverb)
+        : delay_(delay), chorus_(chorus), reverb_(reverb) {}
+
+    /**
+     * @brief 有効なエフェクトに合わせて領域を配分し直す
+     *
+     * @param delay_on ディレイ有効
+     * @param chorus_on コーラス有効
+     * @param reverb_on リバーブ有効
+     */
+    void plan(bool delay_on, bool chorus_on, bool reverb_on);
+
+    /**
+     * @brief 指定エフェクトが領域を持っていなければ配分し直す
+     *
+     * 実行中のエフェクト有効化用。既に領域を持っている場合は何もしないので、
+     * 他のエフェクトのバッファ（残響テールなど）を壊さない。
+     */
+    void ensure(bool delay_on, bool chorus_on, bool reverb_on);
+
+    /** @brief 指定の配置にする（スナップショットの復元用） */
+    void restore(const Layout& layout);
+
+    /** @brief アリーナ本体の先頭 */
+    static Sample16_t* memory();
+
+    /** @brief 貸し出している領域を無音にする（配置と各エフェクトの読み書き位置はそのまま） */
+    void clearBuffers();
+
+    const Layout& getLayout() const { return layout_; }
+    static constexpr uint32_t capacity() { return EFFECT_ARENA_SAMPLES; }
+
+    uint32_t used() const {
+        return layout_.reverb.length + layout_.chorus.length + layout_.delay.length;
+    }
+};
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+
 #include "handlers/audio.hpp"
 #include "utils/math.hpp"
 #include "types.hpp"
+#include "utils/placement.hpp"
 
 /**
  * @brief Keyboard Level Scaling のカーブタイプ
@@ -70,8 +73,18 @@ public:
         EnvLevel_t target_level2 = ENV_LEVEL_MIN;
         EnvLevel_t target_level3 = ENV_LEVEL_MIN;
         EnvLevel_t target_level4 = ENV_LEVEL_MIN;
+        // 現在ステージの増分キャッシュ（64サンプル基準）
+        // inc_state / inc_version が一致している間は再計算しない
+        int32_t stage_inc = 0;
+        EnvelopeState inc_state = EnvelopeState::Idle;
+        uint8_t inc_version = 0;  // 0 = 無効
     };
 
+    // 制御レート: 1回の update() で進むサンプル数 = ENV_BLOCK_MAX >> rate_shift
+    static constexpr uint8_t ENV_LG_BLOCK_MAX = 6;
+    static constexpr size_t ENV_BLOCK_MAX = 1 << ENV_LG_BLOCK_MAX;  // 64 (基準)
+    static constexpr uint8_t ENV_RATE_SHIFT_MAX = 2;                // 16サンプルまで
+
 private:
     // Rate/Level形式のパラメータ (0-99)
     // Rate: 変化速度 (0=遅い, 99=即座)
@@ -100,6 +113,52 @@ private:
     // ベロシティ感度 (0-7, 0=感度なし)
     uint8_t velocity_sens_ = 7;
 
+    // ノート別テーブル（プリセットロード時に構築、関連パラメータ変更で dirty）
+    // kls_outlevel_table_: (Output Level + KLS) を 0-127 にクランプして << 5 した値
+    // rs_delta_table_    : Rate Scaling による rate 増分
+    int16_t kls_outlevel_table_[128] = {};
+    int8_t rs_delta_table_[128] = {};
+    uint8_t table_op_level_ = 0xFF;  // kls_outlevel_table_ 構築時の Output Level
+    bool kls_table_dirty_ = true;
+    bool rs_table_dirty_ = true;
+
+    void buildKlsTable(uint8_t op_level);
+    void buildRateScalingTable();
+
+    // Rateパラメータの版数（変更時に増やし、Memory側の増分キャッシュを無効化する）
+    uint8_t param_version_ = 1;
+
+    inline void bumpParamVersion() {
+        if (++param_version_ == 0) param_version_ = 1;
+    }
+
+    /**
+     * @brief 現在ステージの増分を返す（キャッシュが古ければ再計算）
+     *
+     * qrate = (rate * 41) >> 6 + rate_scaling_delta
+     * inc = (4 + (qrate & 3)) << (2 + LG_N + (qrate >> 2))
+     */
+    inline int32_t stageInc(Memory& mem) const {
+        if (mem.inc_state == mem.state && mem.inc_version == param_version_) {
+            return mem.stage_inc;
+        }
+        uint8_t rate_param;
+        switch (mem.state) {
+            case EnvelopeState::Phase1: rate_param = rate1_param; break;
+            case EnvelopeState::Phase2: rate_param = rate2_param; break;
+            case EnvelopeState::Phase3: rate_param = rate3_param; break;
+            default:                    rate_param = rate4_param; break;
+        }
+        int qrate = (static_cast<int>(rate_param) * 41) >> 6;
+        qrate += mem.rate_scaling_delta;
+        if (qrate < 0) qrate = 0;
+        if (qrate > 63) qrate = 63;
+        mem.stage_inc = (4 + (qrate & 3)) << (2 + ENV_LG_BLOCK_MAX + (qrate >> 2));
+        mem.inc_state = mem.state;
+        mem.inc_version = param_version_;
+        return mem.stage_inc;
+    }
+
     // === 指数スケーリング用データテーブル ===
     // 33要素: group 0-32 に対応する指数カーブ値
     static constexpr uint8_t EXP_SCALE_DATA[33] = {
@@ -164,14 +223,20 @@ private:
     inline static const std::array<uint32_t, RATE_TABLE_SIZE> rate_table = generate_rate_table();
 
     // Exp2テーブル (対数レベル -> 線形レベルへ)
-    inline static const std::array<int32_t, EXP2_N_SAMPLES * 2> exp2_table = generate_exp2_table();
+    inline static const std::array<int32_t, EXP2_N_SAMPLES * 2> exp2_table PLACE_HOT = generate_exp2_table();
 
 public:
     void reset(Memory& mem);
     void release(Memory& mem);
     void clear(Memory& mem);  // 完全にIdle状態にリセット
 
-    FASTRUN void update(Memory& mem);
+    /**
+     * @brief エンベロープを1制御ブロック分進める
+     *
+     * @param mem エンベロープメモリ
+     * @param rate_shift 制御レート (0: 64サンプル, 1: 32サンプル, 2: 16サンプル)
+     */
+    FASTRUN void update(Memory& mem, uint8_t rate_shift = 0);
 
     // 対数レベルから線形レベルへ変換
     static void updateCurrentLevel(Memory& mem);
@@ -250,6 +315,19 @@ public:
      */
     static int8_t calcRateScalingDelta(uint8_t midinote, uint8_t sensitivity);
 
+    /**
+     * @brief ノート別テーブルを必要なら再構築
+     *
+     * ノートオン時の setOutlevel() / applyRateScaling() をテーブル参照だけにする。
+     * プリセットロード時と Synth::update() から呼ばれる。
+     *
+     * @param op_level オペレーター出力レベル (0-99)
+     */
+    void prepareNoteTables(uint8_t op_level) {
+        if (kls_table_dirty_ || op_level != table_op_level_) buildKlsTable(op_level);
+        if (rs_table_dirty_) buildRateScalingTable();
+    }
+
     /**
      * @brief ノートごとのRate Scaling増分を設定
      *
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "types.hpp"
+#include "handlers/audio.hpp"
+
+/**
+ * @brief マスターダイナミクス（ゲインステージ + 簡易リミッター）
+ *
+ * 旧方式の「master_volume × (Q15_MAX / MAX_NOTES)」固定スケールでは
+ * 単音が常にフルスケールの 1/16 しか使えず、約4bitを無駄にしていた。
+ *
+ * ここでは 1ボイスあたり VOICE_HEADROOM 分の余裕だけを確保した
+ * メイクアップゲインを基準とし、実際のミックスのピークを
+ * CONTROL_BLOCK サンプルごとに追従してゲインを下げる。
+ * - アタック: ピークを検出したブロックの先頭から目標ゲインを適用する
+ *   （ゲイン計算前にブロック全体のピークを見るため、実質 CONTROL_BLOCK 分の先読み）
+ * - リリース: 1次IIR で基準ゲインへゆっくり戻す
+ *
+ * ゲインはQ23のまま Q23_to_Sample16 の前で適用される。
+ * 1サンプルあたりのコストは 絶対値比較 + 64bit乗算1回 程度で、
+ * Biquad 1段（64bit MAC 5回）より軽い。
+ */
+class Limiter {
+public:
+    static constexpr size_t CONTROL_BLOCK = 16;      // ゲイン計算間隔（サンプル）
+    static constexpr uint8_t CONTROL_SHIFT = 4;      // log2(CONTROL_BLOCK)
+    static constexpr uint8_t VOICE_HEADROOM = 4;     // 単音に対するヘッドルーム (1/4 = -12dB)
+    static constexpr uint8_t RELEASE_SHIFT = 8;      // リリース係数 1/256 per block (約93ms)
+
+    // スレッショルド: -1dBFS (Q23)
+    static constexpr Audio24_t THRESHOLD = static_cast<Audio24_t>(Q23_MAX * 0.891f);
+
+    static_assert((BUFFER_SIZE % CONTROL_BLOCK) == 0, "BUFFER_SIZE must be a multiple of CONTROL_BLOCK");
+    static_assert((1u << CONTROL_SHIFT) == CONTROL_BLOCK, "CONTROL_SHIFT mismatch");
+
+private:
+    EnvGain_t makeup_gain_ = ENVGAIN_MAX / VOICE_HEADROOM; // 基準ゲイン Q24
+    EnvGain_t gain_ = ENVGAIN_MAX / VOICE_HEADROOM;        // 現在ゲイン Q24
+    EnvGain_t min_gain_ = ENVGAIN_MAX / VOICE_HEADROOM;    // 直近の最小ゲイン（表示用）
+
+public:
+    /**
+     * @brief マスターレベルからメイクアップゲインを設定
+     *
+     * @param level マスターレベル (Q15)
+     */
+    void setMasterLevel(Gain_t level) {
+        makeup_gain_ = static_cast<EnvGain_t>(
+            (static_cast<int64_t>(level) << (ENVGAIN_SHIFT - Q15_SHIFT)) / VOICE_HEADROOM
+        );
+    }
+
+    /** @brief ゲイン状態を基準値に戻す */
+    void reset() {
+        gain_ = makeup_gain_;
+        min_gain_ = makeup_gain_;
+    }
+
+    /**
+     * @brief ミックスバッファにゲインを適用（インプレース）
+     *
+     * @param bufL Lチャンネル (Q23、未クリップ)
+     * @param bufR Rチャンネル (Q23、未クリップ)
+     * @param size サンプル数 (CONTROL_BLOCK の倍数)
+     */
+    FASTRUN void process(Audio24_t* bufL, Audio24_t* bufR, size_t size);
+
+    // 状態取得
+    EnvGain_t getMakeupGain() const { return makeup_gain_; }
+    EnvGain_t getGain() const { return gain_; }
+
+    /**
+     * @brief 前回取得以降の最大ゲインリダクション (dB, 0以下)
+     *
+     * 表示用。呼び出すと最小ゲインの記録をリセットする。
+     */
+    float takeGainReductionDb() {
+        const EnvGain_t min_gain = min_gain_;
+        min_gain_ = gain_;
+        if (makeup_gain_ <= 0 || min_gain >= makeup_gain_) return 0.0f;
+        if (min_gain <= 0) return -96.0f;
+        return 20.0f * log10f(static_cast<float>(min_gain) / static_cast<float>(makeup_gain_));
+    }
+};
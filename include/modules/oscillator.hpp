@@ -13,8 +13,18 @@ public:
         Phase_t delta = 0;
         Gain_t vel_vol = 0;
         uint8_t note = 60;  // エイリアシング防止用のキースケーリングに使用
+        uint8_t mip = 0;    // 帯域制限ミップレベル (0 = 元テーブル, setFrequency で決定)
     };
 
+    // 帯域制限ミップマップ
+    // レベル L (1-8) は 2^(8-L) 次までの倍音のみを含む（オクターブ間隔）
+    // レベル 0 は元のテーブル（512サンプル = 255次まで）
+    static constexpr uint8_t MIP_LEVELS = 9;
+    static constexpr size_t MIP_TABLE_SIZE = 512;
+    static constexpr uint8_t MIP_TOP_HARMONIC_LG = 8;  // レベル0相当の倍音上限 log2(256)
+    static constexpr uint8_t MIP_WAVEFORMS = 3;          // 三角波・ノコギリ波・矩形波
+    static constexpr size_t MIP_MEMORY_BYTES = MIP_WAVEFORMS * (MIP_LEVELS - 1) * MIP_TABLE_SIZE * sizeof(Audio24_t);
+
     Oscillator() {
         bit_padding = AudioMath::bitPadding32(wavetable_size);
     }
@@ -43,9 +53,37 @@ public:
         for (size_t i = 0; i < 100; ++i) {
             level_table[i] = AudioMath::levelToLinear(i);
         }
+        buildMipTables();
         table_initialized = true;
     }
 
+    /**
+     * @brief 帯域制限ミップテーブルを生成（起動時に1回）
+     *
+     * 三角波・ノコギリ波・矩形波の元テーブルを DFT で倍音分解し、
+     * レベルごとに上限次数までを再合成する。サイン波はミップを持たない。
+     */
+    static void buildMipTables();
+
+    /**
+     * @brief ノートの位相増分に対するミップレベルを選択
+     *
+     * ナイキスト (位相増分 2^31) を超えない最大倍音数 H = 2^31 / delta から
+     * 2^(8-L) <= H となる最小の L を選ぶ。
+     *
+     * @param delta 1サンプルあたりの位相増分
+     * @return uint8_t ミップレベル (0-8)
+     */
+    static inline uint8_t selectMipLevel(Phase_t delta) {
+        if (delta == 0) return 0;
+        const uint32_t harmonics = 0x80000000u / delta;
+        if (harmonics >= (1u << MIP_TOP_HARMONIC_LG)) return 0;
+        if (harmonics == 0) return MIP_LEVELS - 1;
+        // floor(log2(harmonics))
+        const uint8_t lg = static_cast<uint8_t>(31 - __builtin_clz(harmonics));
+        return static_cast<uint8_t>(MIP_TOP_HARMONIC_LG - lg);
+    }
+
     /** @brief オシレーターの状態 */
     inline bool isActive() const {
         return enabled;
@@ -100,6 +138,17 @@ public:
     /** @brief FIXEDモードを設定 */
     void setFixed(bool fixed) {
         this->is_fixed = fixed;
+        delta_table_dirty = true;
+    }
+
+    /**
+     * @brief ノート別位相増分テーブルを必要なら再構築
+     *
+     * プリセットロード時と Synth::update() から呼ばれ、
+     * ノートオン時の setFrequency() をテーブル参照だけにする。
+     */
+    void prepareNoteTable() {
+        if (delta_table_dirty) buildDeltaTable();
     }
 
     /**
@@ -112,6 +161,48 @@ public:
         if(enabled) mem.phase += mem.delta;
     }
 
+    /**
+     * @brief 指定した増分で位相を進める
+     *
+     * ピッチ変調込みの増分を modulatedDelta() でブロック単位に求めておき、
+     * サンプル毎はこちらで加算のみ行う。
+     *
+     * @param mem オシレーターメモリ
+     * @param step 1サンプルあたりの位相増分
+     */
+    FASTRUN inline void update(Memory& mem, Phase_t step) {
+        if(enabled) mem.phase += step;
+    }
+
+    /**
+     * @brief ピッチ変調を反映した位相増分を計算
+     *
+     * delta + delta * pitch_mod / 2^15
+     * 毎サンプル delta と変調分を別々に加算する場合と同じ値になる。
+     *
+     * @param mem オシレーターメモリ
+     * @param pitch_mod ピッチ変調量 (符号付き Q15)
+     * @return Phase_t 1サンプルあたりの位相増分
+     */
+    FASTRUN inline Phase_t modulatedDelta(const Memory& mem, int32_t pitch_mod) const {
+        if (pitch_mod == 0) return mem.delta;
+        return mem.delta + static_cast<Phase_t>(
+            (static_cast<int64_t>(mem.delta) * pitch_mod) >> Q15_SHIFT
+        );
+    }
+
+    /**
+     * @brief ノートに対応する波形テーブルを取得
+     *
+     * ブロック先頭で1回取得し、getSample() に渡して使う。
+     *
+     * @param mem オシレーターメモリ
+     * @return const Audio24_t* ミップレベルに応じた波形テーブル
+     */
+    FASTRUN inline const Audio24_t* getTable(const Memory& mem) const {
+        return mip_set[mem.mip];
+    }
+
     /**
      * @brief oscillatorのサンプルを取得
      *
@@ -122,6 +213,18 @@ public:
      * @return Audio24_t オシレーター出力サンプル (Q23)
      */
     FASTRUN inline Audio24_t getSample(Memory& mem, Audio24_t mod_input = 0) {
+        return getSample(mem, mod_input, getTable(mem));
+    }
+
+    /**
+     * @brief oscillatorのサンプルを取得（テーブル指定）
+     *
+     * @param mem オシレーターメモリ
+     * @param mod_input 変調入力 (Q23)
+     * @param table getTable() で取得した波形テーブル
+     * @return Audio24_t オシレーター出力サンプル (Q23)
+     */
+    FASTRUN inline Audio24_t getSample(Memory& mem, Audio24_t mod_input, const Audio24_t* table) {
         if(!enabled) return 0;
 
         // ローカル変数にキャッシュ
@@ -152,9 +255,12 @@ public:
         const uint32_t frac = (effective_phase & frac_mask) >> (bit_padding - 16);
 
         // 線形補間: y0 + (y1 - y0) * frac / 65536
-        const Audio24_t y0 = wavetable[index];
-        const Audio24_t y1 = wavetable[next_index];
-        const Audio24_t sample = y0 + (((y1 - y0) * static_cast<int32_t>(frac)) >> 16);
+        // 差分 (最大 2^24) × frac (16bit) は 32bit を超えるので 64bit で掛ける
+        const Audio24_t y0 = table[index];
+        const Audio24_t y1 = table[next_index];
+        const Audio24_t sample = y0 + static_cast<Audio24_t>(
+            (static_cast<int64_t>(y1 - y0) * static_cast<int32_t>(frac)) >> 16
+        );
 
         // 波形出力のみを返す
         // レベル(Output Level)とベロシティはエンベロープ(outlevel)で適用される
@@ -184,6 +290,15 @@ private:
         {Wavetable::square,   sizeof(Wavetable::square) / sizeof(Wavetable::square[0])},
     };
 
+    static_assert(sizeof(Wavetable::triangle) / sizeof(Wavetable::triangle[0]) == MIP_TABLE_SIZE &&
+                  sizeof(Wavetable::saw) / sizeof(Wavetable::saw[0]) == MIP_TABLE_SIZE &&
+                  sizeof(Wavetable::square) / sizeof(Wavetable::square[0]) == MIP_TABLE_SIZE,
+                  "mipmapped wavetables must be MIP_TABLE_SIZE long");
+
+    // テーブルIDごとのミップレベル → 波形テーブル
+    // サイン波は全レベルが元テーブルを指す
+    static const Audio24_t* MIP_SETS[4][MIP_LEVELS];
+
     // パラメータ検証
     static inline Gain_t clamp_level(Gain_t value) {
         return std::clamp<Gain_t>(value, 0, Q15_MAX);
@@ -204,6 +319,7 @@ private:
     // OSC設定
     uint8_t bit_padding; // コンストラクタで初期化
     const Audio24_t* wavetable = Wavetable::sine;
+    const Audio24_t* const* mip_set = MIP_SETS[0];
     size_t wavetable_size = sizeof(Wavetable::sine) / sizeof(Wavetable::sine[0]);
     bool enabled = false;
     Gain_t level = 0;       // Q15スケール (0-32767)
@@ -216,4 +332,10 @@ private:
 
     // ratioかfixedか
     bool is_fixed = false;
+
+    // ノート別位相増分テーブル（ピッチ系パラメータ変更時に dirty）
+    Phase_t delta_table[128] = {};
+    bool delta_table_dirty = true;
+
+    void buildDeltaTable();
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "modules/delay.hpp"
 #include "modules/chorus.hpp"
 #include "modules/reverb.hpp"
+#include "modules/effect_arena.hpp"
 
 /**
  * @brief PCM1802 パススルーモジュール
@@ -15,8 +16,9 @@
  */
 class Passthrough {
 public:
-    Passthrough(AudioHandler& audio, Filter& filter, Delay& delay, Chorus& chorus, Reverb& reverb)
-        : audio_(audio), filter_(filter), delay_(delay), chorus_(chorus), reverb_(reverb) {}
+    Passthrough(AudioHandler& audio, Filter& filter, Delay& delay, Chorus& chorus, Reverb& reverb,
+                EffectArena& arena)
+        : audio_(audio), filter_(filter), delay_(delay), chorus_(chorus), reverb_(reverb), arena_(arena) {}
 
     /** @brief パススルーモード開始 (RecordQueue を有効化) */
     void begin();
@@ -39,15 +41,25 @@ public:
         hpf_enabled_ = enabled;
     }
     void setDelayEnabled(bool enabled) {
-        if (!delay_enabled_ && enabled) delay_.reset();
+        if (!delay_enabled_ && enabled) {
+            arena_.ensure(true, chorus_enabled_, reverb_enabled_);
+            delay_.reset();
+            delay_.setTime(delay_.getTime());
+        }
         delay_enabled_ = enabled;
     }
     void setChorusEnabled(bool enabled) {
-        if (!chorus_enabled_ && enabled) chorus_.reset();
+        if (!chorus_enabled_ && enabled) {
+            arena_.ensure(delay_enabled_, true, reverb_enabled_);
+            chorus_.reset();
+        }
         chorus_enabled_ = enabled;
     }
     void setReverbEnabled(bool enabled) {
-        if (!reverb_enabled_ && enabled) reverb_.reset();
+        if (!reverb_enabled_ && enabled) {
+            arena_.ensure(delay_enabled_, chorus_enabled_, true);
+            reverb_.reset();
+        }
         reverb_enabled_ = enabled;
     }
     bool isLpfEnabled() const { return lpf_enabled_; }
@@ -78,6 +90,7 @@ private:
     Delay&  delay_;
     Chorus& chorus_;
     Reverb& reverb_;
+    EffectArena& arena_;
     Gain_t volume_       = Q15_MAX;  // 音量 (Q15: 0=無音, 32767=100%)
     bool lpf_enabled_   = false;
     bool hpf_enabled_   = false;
@@ -54,19 +54,51 @@ constexpr uint16_t ALLPASS_TUNING_R2 = ALLPASS_TUNING_L2 + STEREO_SPREAD;
 constexpr uint16_t ALLPASS_TUNING_R3 = ALLPASS_TUNING_L3 + STEREO_SPREAD;
 constexpr uint16_t ALLPASS_TUNING_R4 = ALLPASS_TUNING_L4 + STEREO_SPREAD;
 
-// 総バッファサイズ (概算: ~25500サンプル = ~50KB)
-constexpr uint32_t REVERB_TOTAL_SAMPLES =
-    COMB_TUNING_L1 + COMB_TUNING_L2 + COMB_TUNING_L3 + COMB_TUNING_L4 +
-    COMB_TUNING_L5 + COMB_TUNING_L6 + COMB_TUNING_L7 + COMB_TUNING_L8 +
-    COMB_TUNING_R1 + COMB_TUNING_R2 + COMB_TUNING_R3 + COMB_TUNING_R4 +
-    COMB_TUNING_R5 + COMB_TUNING_R6 + COMB_TUNING_R7 + COMB_TUNING_R8 +
-    ALLPASS_TUNING_L1 + ALLPASS_TUNING_L2 + ALLPASS_TUNING_L3 + ALLPASS_TUNING_L4 +
-    ALLPASS_TUNING_R1 + ALLPASS_TUNING_R2 + ALLPASS_TUNING_R3 + ALLPASS_TUNING_R4;
+// L/R 各チャンネルのチューニング表 (標準サイズ)
+constexpr uint16_t COMB_TUNINGS_L[8] = {
+    COMB_TUNING_L1, COMB_TUNING_L2, COMB_TUNING_L3, COMB_TUNING_L4,
+    COMB_TUNING_L5, COMB_TUNING_L6, COMB_TUNING_L7, COMB_TUNING_L8
+};
+constexpr uint16_t COMB_TUNINGS_R[8] = {
+    COMB_TUNING_R1, COMB_TUNING_R2, COMB_TUNING_R3, COMB_TUNING_R4,
+    COMB_TUNING_R5, COMB_TUNING_R6, COMB_TUNING_R7, COMB_TUNING_R8
+};
+constexpr uint16_t ALLPASS_TUNINGS_L[4] = {
+    ALLPASS_TUNING_L1, ALLPASS_TUNING_L2, ALLPASS_TUNING_L3, ALLPASS_TUNING_L4
+};
+constexpr uint16_t ALLPASS_TUNINGS_R[4] = {
+    ALLPASS_TUNING_R1, ALLPASS_TUNING_R2, ALLPASS_TUNING_R3, ALLPASS_TUNING_R4
+};
+
+// サイズ倍率 (Q8: 256 = 標準)
+constexpr uint16_t REVERB_SCALE_ONE = 256;
+
+/**
+ * @brief 指定倍率でのバッファ総サンプル数
+ *
+ * @param scale_q8 サイズ倍率 (Q8: 256 = 標準)
+ */
+constexpr uint32_t reverbTotalSamples(uint16_t scale_q8) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < 8; ++i) {
+        total += (static_cast<uint32_t>(COMB_TUNINGS_L[i]) * scale_q8) >> 8;
+        total += (static_cast<uint32_t>(COMB_TUNINGS_R[i]) * scale_q8) >> 8;
+    }
+    for (uint8_t i = 0; i < 4; ++i) {
+        total += (static_cast<uint32_t>(ALLPASS_TUNINGS_L[i]) * scale_q8) >> 8;
+        total += (static_cast<uint32_t>(ALLPASS_TUNINGS_R[i]) * scale_q8) >> 8;
+    }
+    return total;
+}
+
+// 総バッファサイズ (標準倍率: ~25500サンプル = ~50KB)
+constexpr uint32_t REVERB_TOTAL_SAMPLES = reverbTotalSamples(REVERB_SCALE_ONE);
 
 // --- コムフィルタ (ローパスフィードバック付き) ---
-template <uint16_t SIZE>
+// バッファは Reverb::attach() で外部領域から割り当てられる
 struct CombFilter {
-    Sample16_t buffer[SIZE] = {};
+    Sample16_t* buffer = nullptr;
+    uint16_t size = 0;
     uint16_t index = 0;
     int16_t filterstore = 0;  // ローパスフィルタの状態
 
@@ -86,21 +118,21 @@ struct CombFilter {
         if (sum < -32767) sum = -32767;
         buffer[index] = static_cast<Sample16_t>(sum);
 
-        if (++index >= SIZE) index = 0;
+        if (++index >= size) index = 0;
         return output;
     }
 
     void clear() {
-        for (uint16_t i = 0; i < SIZE; ++i) buffer[i] = 0;
+        for (uint16_t i = 0; i < size; ++i) buffer[i] = 0;
         index = 0;
         filterstore = 0;
     }
 };
 
 // --- オールパスフィルタ ---
-template <uint16_t SIZE>
 struct AllpassFilter {
-    Sample16_t buffer[SIZE] = {};
+    Sample16_t* buffer = nullptr;
+    uint16_t size = 0;
     uint16_t index = 0;
 
     // 固定フィードバック係数 0.5 (Q15 = 16384)
@@ -121,12 +153,12 @@ struct AllpassFilter {
         if (sum < -32767) sum = -32767;
         buffer[index] = static_cast<Sample16_t>(sum);
 
-        if (++index >= SIZE) index = 0;
+        if (++index >= size) index = 0;
         return static_cast<Sample16_t>(output);
     }
 
     void clear() {
-        for (uint16_t i = 0; i < SIZE; ++i) buffer[i] = 0;
+        for (uint16_t i = 0; i < size; ++i) buffer[i] = 0;
         index = 0;
     }
 };
@@ -134,34 +166,15 @@ struct AllpassFilter {
 class Reverb {
 private:
     // コムフィルタ (8本 × L/R)
-    CombFilter<COMB_TUNING_L1> comb_L1;
-    CombFilter<COMB_TUNING_L2> comb_L2;
-    CombFilter<COMB_TUNING_L3> comb_L3;
-    CombFilter<COMB_TUNING_L4> comb_L4;
-    CombFilter<COMB_TUNING_L5> comb_L5;
-    CombFilter<COMB_TUNING_L6> comb_L6;
-    CombFilter<COMB_TUNING_L7> comb_L7;
-    CombFilter<COMB_TUNING_L8> comb_L8;
-
-    CombFilter<COMB_TUNING_R1> comb_R1;
-    CombFilter<COMB_TUNING_R2> comb_R2;
-    CombFilter<COMB_TUNING_R3> comb_R3;
-    CombFilter<COMB_TUNING_R4> comb_R4;
-    CombFilter<COMB_TUNING_R5> comb_R5;
-    CombFilter<COMB_TUNING_R6> comb_R6;
-    CombFilter<COMB_TUNING_R7> comb_R7;
-    CombFilter<COMB_TUNING_R8> comb_R8;
+    CombFilter comb_L[8];
+    CombFilter comb_R[8];
 
     // オールパスフィルタ (4本 × L/R)
-    AllpassFilter<ALLPASS_TUNING_L1> allpass_L1;
-    AllpassFilter<ALLPASS_TUNING_L2> allpass_L2;
-    AllpassFilter<ALLPASS_TUNING_L3> allpass_L3;
-    AllpassFilter<ALLPASS_TUNING_L4> allpass_L4;
+    AllpassFilter allpass_L[4];
+    AllpassFilter allpass_R[4];
 
-    AllpassFilter<ALLPASS_TUNING_R1> allpass_R1;
-    AllpassFilter<ALLPASS_TUNING_R2> allpass_R2;
-    AllpassFilter<ALLPASS_TUNING_R3> allpass_R3;
-    AllpassFilter<ALLPASS_TUNING_R4> allpass_R4;
+    Sample16_t* memory_ = nullptr;           // 割り当て領域 (nullptr = 未割り当て)
+    uint16_t scale_q8_ = REVERB_SCALE_ONE;   // バッファ長倍率
 
     // パラメータ
     uint8_t room_size = 50;    // ルームサイズ (0-99)
@@ -177,6 +190,19 @@ private:
     void updateCoefficients();
 
 public:
+    /**
+     * @brief バッファ領域を割り当てる（内容はクリアされる）
+     *
+     * 各コム/オールパスの長さはチューニング値 × scale_q8 になる。
+     * 倍率を上げると同じ RoomSize でも残響が長く、密度が低くなる。
+     *
+     * @param mem reverbTotalSamples(scale_q8) 分の領域、nullptr で切り離し
+     * @param scale_q8 サイズ倍率 (Q8: 256 = 標準)
+     */
+    void attach(Sample16_t* mem, uint16_t scale_q8 = REVERB_SCALE_ONE);
+    bool hasMemory() const { return memory_ != nullptr; }
+    uint16_t getScale() const { return scale_q8_; }
+
     void reset();
 
     void setRoomSize(uint8_t size);
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "types.hpp"
+
+/**
+ * @brief 出力段で波形を取り込むスコープ用のタップ
+ *
+ * Synth::generate() の最終出力（エフェクト後、反転前）を受け取り、
+ * - decimation サンプルごとに絶対値が最大のサンプルを1点として間引き（ピーク保持）
+ * - 間引いた点をリングに書き、トリガーを出力段で判定
+ * - トリガー前 PRE_POINTS 点 + 後ろの点で POINTS 点のフレームを作って公開する
+ *
+ * フレームは3面バッファで受け渡す。書き手（出力段）と読み手（UI）はそれぞれ自分の面だけを触り、
+ * 真ん中の面を atomic に交換するだけなので、ロックも読み手でのコピーもなく、
+ * 読み手の面は次の acquire() まで書き換わらない。
+ *
+ * 書き込みは setEnabled(true) の間だけ（スコープ画面を開いている間）。
+ * 読み取り専用のタップなので出力には影響しない。
+ */
+class ScopeTap {
+public:
+    static constexpr uint16_t POINTS = 128;       // 1フレームの点数（画面幅）
+    static constexpr uint16_t PRE_POINTS = 16;    // トリガーより前に残す点数
+    static constexpr uint16_t AUTO_POINTS = POINTS * 2;  // EDGE / LEVEL でこれだけトリガーがなければ空振りで出す
+    static constexpr uint8_t  MAX_DECIMATION = 128;      // 128点 × 128 ≒ 370ms
+
+    enum Trigger : uint8_t {
+        FREE = 0,  // トリガーなし（連続）
+        EDGE,      // 立ち上がりで level を横切った点
+        LEVEL,     // 絶対値が level 以上になった点
+        NOTE,      // ノートオンの直後の点（次のノートオンまで前のフレームを保持）
+        TRIGGER_COUNT
+    };
+
+    enum Source : uint8_t { LEFT = 0, RIGHT };
+
+    struct Frame {
+        Sample16_t l[POINTS];
+        Sample16_t r[POINTS];
+        uint32_t seq;         // 公開した順の通し番号（0: まだない）
+        uint8_t decimation;
+        Trigger trigger;
+        bool triggered;       // false: AUTO（トリガーが来ずに出したフレーム）
+    };
+
+    /** @brief 取り込みの開始 / 停止（開始時にリングとフレームを空にする） */
+    static void setEnabled(bool enabled);
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief トリガーと間引きを設定（次のブロックから反映。変わったら取り込み直す）
+     *
+     * @param decimation 1〜MAX_DECIMATION
+     */
+    static void configure(Trigger trigger, Source source, Sample16_t level, uint8_t decimation);
+
+    /** @brief 出力段から1ブロック分を書き込む */
+    static void write(const Sample16_t* l, const Sample16_t* r, size_t n);
+
+    /** @brief ノートオンを知らせる (NOTE トリガー) */
+    static void noteOn() { note_pending_.store(true, std::memory_order_relaxed); }
+
+    /** @brief 新しいフレームがあれば読み手の面に取り込む */
+    static bool acquire();
+
+    /** @brief 読み手の面（次の acquire() まで書き換わらない） */
+    static const Frame& frame() { return frames_[front_]; }
+
+    static const char* name(Trigger trigger);
+
+private:
+    static constexpr uint16_t RING = 256;  // POINTS 以上の2のべき乗
+    static constexpr uint8_t  FRESH = 0x80;
+
+    // 設定（読み手が書き、出力段がブロックの先頭で読む）
+    static std::atomic<bool> enabled_;
+    static std::atomic<uint32_t> config_;  // trigger | source << 8 | decimation << 16
+    static std::atomic<Sample16_t> level_;
+    static std::atomic<bool> note_pending_;
+    static std::atomic<bool> restart_;     // setEnabled(true) で立て、出力段が取り込み直す
+
+    // 3面バッファ
+    static Frame frames_[3];
+    static std::atomic<uint8_t> middle_;   // 真ん中の面 (| FRESH: 未読)
+    static uint8_t back_;                  // 書き手の面
+    static uint8_t front_;                 // 読み手の面
+
+    // 出力段の状態
+    static uint32_t applied_;              // 反映済みの config_
+    static Sample16_t ring_l_[RING];
+    static Sample16_t ring_r_[RING];
+    static uint32_t points_;               // 書いた点の総数
+    static uint8_t acc_count_;             // 間引き中のサンプル数
+    static Sample16_t peak_l_;
+    static Sample16_t peak_r_;
+    static Sample16_t prev_;               // 直前の点（EDGE 用）
+    static bool armed_;                    // トリガー待ち
+    static bool capturing_;                // トリガー後の点を集めている
+    static bool hit_;                      // トリガーで始まったフレームか
+    static uint32_t trigger_point_;
+    static uint32_t last_publish_;
+    static uint32_t seq_;
+
+    static void reset();
+    static void push(Sample16_t l, Sample16_t r);
+    static void publish();
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "types.hpp"
+
+/**
+ * @brief スペクトラム用の間引きタップ
+ *
+ * 出力段（Synth::generate() / Passthrough::process()）の最終出力を L+R の平均にして、
+ * decimation サンプルごとに2次 CIC で間引き、size 点たまるごとにフレームとして公開する。
+ * フレームの受け渡しは ScopeTap と同じ3面バッファ（書き手と読み手は自分の面だけを触る）。
+ *
+ * 書き込みは setEnabled(true) の間だけ（スペクトラム画面を開いている間）。
+ */
+class SpectrumTap {
+public:
+    static constexpr uint16_t MAX_SIZE = 512;
+    static constexpr uint8_t  MAX_DECIMATION = 8;
+
+    struct Frame {
+        Sample16_t x[MAX_SIZE];
+        uint32_t seq;        // 公開した順の通し番号（0: まだない）
+        uint16_t size;       // 256 / 512
+        uint8_t decimation;
+    };
+
+    static void setEnabled(bool enabled);
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief フレームの点数と間引きを設定（次のブロックから反映）
+     *
+     * @param size 256 / 512
+     * @param decimation 1〜MAX_DECIMATION
+     */
+    static void configure(uint16_t size, uint8_t decimation);
+
+    /** @brief 出力段から1ブロック分を書き込む */
+    static void write(const Sample16_t* l, const Sample16_t* r, size_t n);
+
+    /** @brief 新しいフレームがあれば読み手の面に取り込む */
+    static bool acquire();
+
+    /** @brief 読み手の面（次の acquire() まで書き換わらない） */
+    static const Frame& frame() { return frames_[front_]; }
+
+private:
+    static constexpr uint8_t FRESH = 0x80;
+
+    static std::atomic<bool> enabled_;
+    static std::atomic<uint32_t> config_;  // size | decimation << 16
+    static std::atomic<bool> restart_;
+
+    static Frame frames_[3];               // PLACE_BULK
+    static std::atomic<uint8_t> middle_;
+    static uint8_t back_;
+    static uint8_t front_;
+
+    // 出力段の状態
+    static uint32_t applied_;
+    static uint16_t fill_;
+    static uint8_t acc_count_;
+    static uint32_t integ1_;               // CIC の積分器（桁あふれは差分で打ち消し合う）
+    static uint32_t integ2_;
+    static uint32_t comb1_;
+    static uint32_t comb2_;
+    static uint32_t seq_;
+
+    static void reset();
+};
+
+/**
+ * @brief 固定小数点 FFT によるスペクトラム解析
+ *
+ * SpectrumTap のフレームに Hann 窓をかけ、256 / 512 点の FFT を
+ * 基数4の周波数間引き（512 点は先頭に基数2を1段）で計算し、
+ * 128 列の対数周波数軸にまとめた dB 値を levels() に出す。
+ *
+ * - 窓と回転因子は Q15、データは int32（入力を 8bit 持ち上げ、各段で 1/4 (基数2は 1/2) に縮める）
+ * - 出力は桁反転順のまま、列にまとめるときに並べ替えて読む
+ * - step() はメインループのタスクから毎回呼ばれ、STEP_US を使い切ったら途中の段で抜けて
+ *   次のループで続きから再開する（1回のループで音を止めるほど長く占有しない）
+ *
+ * すべてメインループから呼ばれるので排他はしない。
+ */
+class Spectrum {
+public:
+    static constexpr uint16_t COLUMNS = 128;       // 画面幅
+    static constexpr uint8_t  DB_RANGE = 90;       // levels() の 0 が -90dBFS、90 が 0dBFS
+    static constexpr uint32_t STEP_US = 150;       // step() 1回の持ち時間
+
+    /** @brief 解析の開始 / 停止（タップもあわせて切り替える） */
+    static void setEnabled(bool enabled);
+
+    /** @brief FFT の点数と間引きを設定 */
+    static void configure(uint16_t size, uint8_t decimation) { SpectrumTap::configure(size, decimation); }
+
+    /** @brief 持ち時間の分だけ解析を進める（メインループのタスク） */
+    static void step();
+
+    /** @brief 列ごとのレベル (0〜DB_RANGE) */
+    static const uint8_t* levels() { return levels_; }
+
+    /** @brief levels() を更新した回数（0: まだない） */
+    static uint32_t seq() { return seq_; }
+
+    /** @brief levels() を計算したフレームの点数 / 間引き */
+    static uint16_t size() { return map_size_; }
+    static uint8_t decimation() { return map_decimation_; }
+
+    /** @brief 周波数に対応する列（表示範囲外なら -1） */
+    static int16_t columnOf(float hz);
+
+    /** @brief 直近1秒に step() が使った CPU 時間の割合 (%) */
+    static float load() { return load_; }
+
+    /** @brief 直前の1フレーム分（窓かけから列まとめまで）の所要時間 (μs) */
+    static uint32_t frameUs() { return frame_us_; }
+
+private:
+    enum Phase : uint8_t { IDLE = 0, LOAD, BUTTERFLY, BIN };
+
+    static constexpr uint16_t N_MAX = SpectrumTap::MAX_SIZE;
+    static constexpr uint8_t  INPUT_SHIFT = 8;
+
+    static bool ready_;
+    static int16_t window_[N_MAX];         // Hann (Q15, N_MAX 点。256 点は1つおきに使う)
+    static int16_t cos_[N_MAX];            // e^{-2πik/N_MAX} (Q15)
+    static int16_t sin_[N_MAX];
+    static int32_t re_[N_MAX];
+    static int32_t im_[N_MAX];
+
+    // 進行状況
+    static Phase phase_;
+    static uint16_t size_;                 // 計算中のフレームの点数
+    static uint8_t decimation_;
+    static uint8_t pass_;                  // BUTTERFLY の段 (0: 512 点の基数2、以降は基数4)
+    static uint16_t span_;                 // 段のブロック長
+    static uint16_t index_;                // 段 / 窓かけ / 列の中の位置
+    static uint32_t frame_ticks_;
+
+    // 対数周波数軸（列 → ビンの範囲）
+    static uint16_t map_size_;
+    static uint8_t map_decimation_;
+    static uint16_t col_lo_[COLUMNS];
+    static uint16_t col_hi_[COLUMNS];
+    static float f_lo_;
+    static float f_hi_;
+
+    static uint8_t pending_[COLUMNS];
+    static uint8_t levels_[COLUMNS];
+    static uint32_t seq_;
+
+    // CPU 時間
+    static uint32_t busy_ticks_;
+    static uint32_t window_start_ms_;
+    static float load_;
+    static uint32_t frame_us_;
+
+    static void buildTables();
+    static void buildMap(uint16_t size, uint8_t decimation);
+    static uint16_t binPosition(uint16_t k);
+    static void butterfly(uint16_t b);
+    static void beginPass(uint8_t pass);
+    static uint16_t passButterflies();
+};
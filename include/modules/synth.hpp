@@ -1,8 +1,7 @@
 #pragma once
 
-#include <Adafruit_GFX.h>
+#include <atomic>
 
-#include "display/gfx.hpp"
 #include "handlers/audio.hpp"
 #include "modules/envelope.hpp"
 #include "modules/oscillator.hpp"
@@ -10,12 +9,15 @@
 #include "modules/filter.hpp"
 #include "modules/chorus.hpp"
 #include "modules/reverb.hpp"
+#include "modules/effect_arena.hpp"
 #include "modules/lfo.hpp"
+#include "modules/limiter.hpp"
 #include "utils/algorithm.hpp"
 #include "utils/state.hpp"
 #include "utils/math.hpp"
 #include "utils/color.hpp"
 #include "utils/preset.hpp"
+#include "utils/snapshot.hpp"
 
 //TODO チャンネル別で音色を選択できるようにする エフェクトの個別適用は処理速度を確認
 constexpr uint8_t MAX_NOTES = 16;    // 最大同時発音数
@@ -46,8 +48,26 @@ private:
     struct Operator {
         Oscillator osc = Oscillator{};
         Envelope env = Envelope{};
+        Gain_t ams_gain = 0;  // オペレーター単位 AMS Q15スケール
     };
-    Operator operators[MAX_OPERATORS] = {};
+
+    // オペレーターパラメータの2面バッファ
+    // generate() / noteOn() は params_seq_ の下位ビットが指す面（ライブ）だけを読み、
+    // UI・シリアル・プリセットロードはもう一方の面（ステージング）に書く。
+    // ブロックの境目 (update() の先頭) で publishParams() が面を入れ替えるので、
+    // 生成中のブロックが書きかけのパラメータを見ることはない。
+    //
+    // これは generate() が書き込み側に割り込まれない（同じメインループで順に動く）ことが前提。
+    // publishParams() は入れ替え直後に古いライブの面（新しいステージング）へ書き写すので、
+    // ブロックの途中で割り込んで入れ替えると、そのブロックが読んでいる面を書き換えてしまう。
+    // 割り込みから編集するようにするなら、ブロックが読んでいる面を知らせる仕組みを先に足すこと。
+    Operator params_[2][MAX_OPERATORS] = {};
+    std::atomic<uint32_t> params_seq_{0};  // 公開した回数（下位ビット = ライブの面）
+    bool params_pending_ = false;          // ステージングに未公開の変更がある
+
+    Operator* liveParams() { return params_[params_seq_.load(std::memory_order_acquire) & 1]; }
+    Operator* stagingParams() { return params_[(params_seq_.load(std::memory_order_relaxed) & 1) ^ 1]; }
+    const Operator* stagingParams() const { return params_[(params_seq_.load(std::memory_order_relaxed) & 1) ^ 1]; }
 
     Delay* delay_ptr_ = nullptr;    // 共有インスタンス (main.cpp で生成)
     bool delay_enabled = false;
@@ -62,20 +82,20 @@ private:
     Reverb* reverb_ptr_ = nullptr;  // 共有インスタンス (main.cpp で生成)
     bool reverb_enabled = false;
 
+    EffectArena* arena_ptr_ = nullptr; // エフェクトバッファ貸し出し元 (main.cpp で生成)
+
     Lfo lfo_;
     bool osc_key_sync_ = true;
-    Gain_t op_ams_gain_[MAX_OPERATORS] = {};  // オペレーター単位 AMS Q15スケール
 
     uint8_t order_max = 0;
     uint8_t last_index = 0;
 
     Gain_t master_volume = static_cast<Gain_t>(Q15_MAX * 0.707); // 71% = 23170 (-3dB)
-    Gain_t polyphony_divisor = Q15_MAX / MAX_NOTES; // 32767 / 16 = 2047
     uint8_t active_carriers = 1; // アクティブなキャリア数（表示用）
 
-    // 最終スケール = master_volume × polyphony_divisor
-    // キャリア数による除算は行わない
-    Gain_t output_scale = static_cast<Gain_t>((static_cast<int32_t>(master_volume) * polyphony_divisor) >> Q15_SHIFT);
+    // 最終ゲイン = master_volume / VOICE_HEADROOM をリミッターが実ピークに応じて絞る
+    // 同時発音数 (MAX_NOTES) による固定除算は行わない
+    Limiter limiter_;
 
     // チャンネル別のバッファ
     Audio24_t left[MAX_CHANNELS] = {};
@@ -85,17 +105,43 @@ private:
     const Algorithm* current_algo = nullptr;
     uint8_t feedback_amount = 0; // 0=disable, 1~7
     uint8_t current_preset_id = 0; // 現在ロードされているプリセットID
+    uint32_t random_seed_ = 0;     // ランダムプリセットの種（プリセットを読み込むと 0）
+    bool voice_edited_ = false;    // 読み込み後にオペレーター/アルゴリズム/フィードバックを変えた
     int8_t transpose = 0; // トランスポーズ (-24 ～ +24)
     VelocityCurve velocity_curve_ = VelocityCurve::Linear; // ベロシティカーブ
+    // ベロシティカーブ変換テーブル [カーブ][入力ベロシティ] (init() で構築)
+    uint8_t velocity_lut_[static_cast<size_t>(VelocityCurve::COUNT)][128] = {};
 
     // ピッチベンド
     volatile int16_t pitch_bend_raw_ = 0;     // 生値 (-8192 ～ +8191)　コールバックから書き込み
     volatile int32_t pitch_bend_mod_ = 0;     // Q15 位相変調量（generate()で使用）LTO対策でvolatile
     uint8_t pitch_bend_range_ = 2;            // ベンドレンジ（半音単位、デフォルト±2）
 
+    // ピッチ変調ランプ（ブロック内で前ブロックの変調量から補間）
+    bool pitch_mod_ramp_ = false;
+    int32_t prev_pitch_mod_ = 0;              // 前ブロックのピッチ変調量 (Q15)
+
+    // エンベロープ制御レート (0: 64サンプル, 1: 32サンプル, 2: 16サンプル)
+    uint8_t env_rate_shift_ = 0;
+
+    // generate() で生成したブロック数（キャプチャと再生の時間軸）と直近の生成開始時刻・所要時間
+    uint32_t block_count_ = 0;
+    uint32_t block_start_ = 0;
+    uint32_t block_ticks_ = 0;
+
+    // ランダムプリセット用の乱数状態
+    uint32_t rng_state_ = 1;
+    long randomRange(long lo, long hi);
+
+    template <typename IO> void snapshotFields(IO& io, const EffectArena::Layout* fx_buffers);
+
+    void resetState();
+
     FASTRUN void generate();
     void updateOrder(uint8_t removed);
     void noteReset(uint8_t index);
+    void buildVelocityTable();
+    void publishParams();
 
     Synth() {}
 
@@ -108,7 +154,8 @@ public:
         return instance;
     };
 
-    void init(Delay& shared_delay, Filter& shared_filter, Chorus& shared_chorus, Reverb& shared_reverb);
+    void init(Delay& shared_delay, Filter& shared_filter, Chorus& shared_chorus, Reverb& shared_reverb,
+              EffectArena& shared_arena);
     FASTRUN void update();
     void noteOn(uint8_t note, uint8_t velocity, uint8_t channel);
     void noteOff(uint8_t note, uint8_t channel);
@@ -119,17 +166,59 @@ public:
     void setFeedback(uint8_t amount);
     void loadPreset(uint8_t preset_id);
     void randomizePreset();
+    void randomizePreset(uint32_t seed);
 
     // --- 状態取得関数 ---
     uint8_t getActiveNoteCount() const {
         return order_max;
     }
 
+    // 発音中のノート番号を古い順に out へ（最大 MAX_NOTES）。戻り値は個数
+    uint8_t getActiveNotes(uint8_t* out) const {
+        uint8_t n = 0;
+        for (uint8_t order = 1; order <= order_max; ++order) {
+            for (uint8_t i = 0; i < MAX_NOTES; ++i) {
+                if (notes[i].order == order) { out[n++] = notes[i].note; break; }
+            }
+        }
+        return n;
+    }
+
+    // 発音中またはエフェクトテール処理中（ブロックを生成し続ける状態）か
+    bool isActive() const {
+        return order_max > 0 || tail_active_;
+    }
+
+    bool shedOldestNote();
+
+    // --- 状態スナップショット (utils/snapshot.hpp) ---
+    // 発音中のノート・エンベロープ・LFO・フィードバック履歴・全パラメータとエフェクトの内部状態を
+    // まとめて保存する。復元はメモリコピーだけなので、ブロックの合間（メインループ）で行える。
+    static uint32_t snapshotBuildId();
+    size_t snapshotSize(bool with_fx_buffers) const;
+    SnapshotStatus saveSnapshot(uint8_t* dst, size_t capacity, bool with_fx_buffers, size_t& written) const;
+    SnapshotStatus restoreSnapshot(const uint8_t* src, size_t len);
+
+    // 生成したブロック数 / 直近ブロックの生成開始時刻 (Profiler::now()) と所要時間
+    uint32_t getBlockCount() const { return block_count_; }
+    uint32_t getBlockStartTicks() const { return block_start_; }
+    uint32_t getBlockTicks() const { return block_ticks_; }
+
     // プリセット情報
     uint8_t getCurrentPresetId() const {
         return current_preset_id;
     }
 
+    // 現在の音色を作ったランダムプリセットの種（プリセットを読み込んだ後は 0）
+    uint32_t getRandomSeed() const {
+        return random_seed_;
+    }
+
+    // 最後の読み込み / ランダム生成の後に音色を編集したか（キャプチャの起点が再現できるかの判定用）
+    bool isVoiceEdited() const {
+        return voice_edited_;
+    }
+
     const char* getCurrentPresetName() const;
 
     // アルゴリズム・フィードバック情報
@@ -138,13 +227,26 @@ public:
         return feedback_amount;
     }
 
-    // オペレーター情報（読み取り専用アクセス）
+    // オペレーター情報（ステージングの面。未公開の変更も含めて見える）
     const Oscillator& getOperatorOsc(uint8_t op_index) const {
-        return operators[op_index].osc;
+        return stagingParams()[op_index].osc;
     }
 
     const Envelope& getOperatorEnv(uint8_t op_index) const {
-        return operators[op_index].env;
+        return stagingParams()[op_index].env;
+    }
+
+    // オペレーター編集（ステージングの面に書き、次のブロックの境目で公開される）
+    Oscillator& editOperatorOsc(uint8_t op_index) {
+        params_pending_ = true;
+        voice_edited_ = true;
+        return stagingParams()[op_index].osc;
+    }
+
+    Envelope& editOperatorEnv(uint8_t op_index) {
+        params_pending_ = true;
+        voice_edited_ = true;
+        return stagingParams()[op_index].env;
     }
 
     // エフェクト状態
@@ -168,6 +270,7 @@ public:
     // エフェクト設定
     void setDelayEnabled(bool enabled) {
         if (!delay_enabled && enabled) {
+            arena_ptr_->ensure(true, chorus_enabled, reverb_enabled);
             delay_ptr_->reset();
             // reset()後にインターバルを再適用（reset()でwrite_idxが初期化されるため）
             delay_ptr_->setTime(delay_ptr_->getTime());
@@ -183,11 +286,17 @@ public:
         hpf_enabled = enabled;
     }
     void setChorusEnabled(bool enabled) {
-        if (!chorus_enabled && enabled) chorus_ptr_->reset();
+        if (!chorus_enabled && enabled) {
+            arena_ptr_->ensure(delay_enabled, true, reverb_enabled);
+            chorus_ptr_->reset();
+        }
         chorus_enabled = enabled;
     }
     void setReverbEnabled(bool enabled) {
-        if (!reverb_enabled && enabled) reverb_ptr_->reset();
+        if (!reverb_enabled && enabled) {
+            arena_ptr_->ensure(delay_enabled, chorus_enabled, true);
+            reverb_ptr_->reset();
+        }
         reverb_enabled = enabled;
     }
 
@@ -197,6 +306,17 @@ public:
     Chorus& getChorus() { return *chorus_ptr_; }
     Reverb& getReverb() { return *reverb_ptr_; }
 
+    // エフェクトメモリアリーナ
+    const EffectArena& getEffectArena() const { return *arena_ptr_; }
+
+    /** @brief 現在のエフェクト有効状態でアリーナを配分し直す（モード復帰時など） */
+    void planEffectMemory() {
+        arena_ptr_->plan(delay_enabled, chorus_enabled, reverb_enabled);
+    }
+
+    /** @brief エフェクトバッファ（残響テール）を無音にする */
+    void clearEffectBuffers() { arena_ptr_->clearBuffers(); }
+
     // コーラスパラメータ取得
     uint8_t getChorusRate() const { return chorus_ptr_->getRate(); }
     uint8_t getChorusDepth() const { return chorus_ptr_->getDepth(); }
@@ -217,22 +337,28 @@ public:
     uint8_t getOperatorAms(uint8_t op) const {
         if (op >= MAX_OPERATORS) return 0;
         for (uint8_t i = 0; i < 4; ++i) {
-            if (op_ams_gain_[op] == Lfo::AMS_TAB[i]) return i;
+            if (stagingParams()[op].ams_gain == Lfo::AMS_TAB[i]) return i;
         }
         return 0;
     }
     void setOperatorAms(uint8_t op, uint8_t ams) {
-        if (op < MAX_OPERATORS)
-            op_ams_gain_[op] = Lfo::AMS_TAB[ams & 3];
+        if (op < MAX_OPERATORS) {
+            stagingParams()[op].ams_gain = Lfo::AMS_TAB[ams & 3];
+            params_pending_ = true;
+            voice_edited_ = true;
+        }
     }
 
     // マスター設定
     Gain_t getMasterLevel() const { return master_volume; }
     void setMasterLevel(Gain_t level) {
         master_volume = std::clamp<Gain_t>(level, 0, Q15_MAX);
-        output_scale = static_cast<Gain_t>((static_cast<int32_t>(master_volume) * polyphony_divisor) >> Q15_SHIFT);
+        limiter_.setMasterLevel(master_volume);
     }
 
+    // マスターリミッター
+    Limiter& getLimiter() { return limiter_; }
+
     // トランスポーズ
     int8_t getTranspose() const { return transpose; }
     void setTranspose(int8_t t) { transpose = std::clamp<int8_t>(t, -24, 24); }
@@ -247,6 +373,22 @@ public:
         setPitchBend(pitch_bend_raw_);
     }
 
+    // ピッチ変調ランプ
+    // 有効時は LFO / ピッチベンドの変化をブロック内で線形補間し、段差を抑える
+    bool isPitchModRamp() const { return pitch_mod_ramp_; }
+    void setPitchModRamp(bool enable) { pitch_mod_ramp_ = enable; }
+
+    // エンベロープ制御レート（1回の更新あたりのサンプル数: 16 / 32 / 64）
+    // 小さいほどアタックが鋭くなるが、エンベロープ更新コストは 64 / N 倍になる
+    uint8_t getEnvControlRate() const {
+        return static_cast<uint8_t>(Envelope::ENV_BLOCK_MAX >> env_rate_shift_);
+    }
+    void setEnvControlRate(uint8_t samples) {
+        if (samples <= 16)      env_rate_shift_ = 2;
+        else if (samples <= 32) env_rate_shift_ = 1;
+        else                    env_rate_shift_ = 0;
+    }
+
     // ベロシティカーブ
     VelocityCurve getVelocityCurve() const { return velocity_curve_; }
     void setVelocityCurve(VelocityCurve curve) { velocity_curve_ = curve; }
@@ -290,4 +432,8 @@ public:
 
     // int16_t getMasterPan() const { return master_pan; }
     // void setMasterPan(int16_t pan) { master_pan = std::clamp<int16_t>(pan, 0, 200); }
-};
\ No newline at end of file
+};
+
+// エフェクトバッファを含まないスナップショットの最大バイト数（保存先の確保用）
+constexpr size_t SYNTH_SNAPSHOT_MAX_BYTES =
+    sizeof(SnapshotHeader) + sizeof(Synth) + sizeof(Delay) + sizeof(Filter) + sizeof(Chorus) + sizeof(Reverb);
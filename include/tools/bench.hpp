@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+class Synth;
+
+/**
+ * @brief モジュール単位のマイクロベンチマーク
+ *
+ * 実機（シリアル BENCH コマンド）とホスト（bench サブコマンド）で同じケースを走らせ、
+ * 同じ形式の表を Serial に出力する。PR 前後の比較用。
+ *
+ * - 実機: ARM_DWT_CYCCNT によるサイクル数
+ * - ホスト: std::chrono::steady_clock によるナノ秒
+ *
+ * 1回の計測単位は 1ブロック (BUFFER_SIZE サンプル) 分の処理。
+ * 表にはブロックあたりとサンプルあたりの min / median / max を出す。
+ *
+ * SYNTH / FX 系は Synth とその共有エフェクトをそのまま使うため実行中は発音が止まる。
+ * 終了時は開始時のスナップショットに戻す（エフェクトバッファは無音になる）。
+ * WARM は開始時に鳴っている状態（なければ和音で暖めた状態）から generate() を計測する。
+ */
+class Bench {
+public:
+    static constexpr uint16_t RUNS = 64;            // 1ケースあたりの計測ブロック数
+    static constexpr uint16_t SYNTH_RUNS_PER_ALGO = 8;
+    static constexpr uint16_t WARMUP = 2;           // 計測前に捨てるブロック数
+    static constexpr uint16_t MAX_SAMPLES = 32 * SYNTH_RUNS_PER_ALGO;
+
+    /** @brief 計測単位 ("cyc" / "ns") */
+    static const char* unit();
+
+    /** @brief 直前の run() で出力がなく計測を捨てたケースの数（0 以外はベンチ側の不具合） */
+    static uint8_t invalidCases();
+
+    /**
+     * @brief ベンチマークを実行して表を出力
+     *
+     * @param synth 計測対象のシンセ（init 済み）
+     * @param group OSC|ENV|SYNTH|FILTER|DELAY|CHORUS|REVERB|LFO|WARM、nullptr または空なら全部
+     * @param full true なら SYNTH をアルゴリズム別にも出力
+     * @return false 不明なグループ
+     */
+    static bool run(Synth& synth, const char* group, bool full);
+};
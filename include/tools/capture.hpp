@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+/**
+ * @brief シンセへの入力のキャプチャ（グリッチ再現用）
+ *
+ * USB / Serial7 / MIDI Player から受けた MIDI、シリアルの SET コマンド、
+ * プリセットの読み込みとランダム生成、Synth::reset() を、そのとき生成済みのブロック数
+ * (Synth::getBlockCount()) 付きで RAM のリングに記録し続ける。CAPTURE SAVE で SD に保存し、
+ * ホストの `replay` で同じ Synth のコードに同じブロック境界で流し込むと出力が再現する。
+ *
+ * - 時間軸は generate() の回数。LFO / エンベロープ / エフェクトは generate() でしか
+ *   進まないので、無音で止まっている間の経過時間は再現に関係しない
+ * - 起点の音色はプリセット ID かランダムプリセットの種で持つ。記録開始前に音色を
+ *   編集していた（Synth::isVoiceEdited()）場合はヘッダの BASE_EDITED で知らせる
+ * - リングが一周して古いエントリを捨てた後は、捨てた分のパラメータ変更が失われる
+ *   （プリセットだけは起点時点のものをヘッダに残す）。replay はどちらも警告して --expect を失敗させる
+ * - UI からのパラメータ編集と SNAP LOAD は記録しない
+ *
+ * 記録はメインループ（と SPI 転送中のオーディオコールバック）からだけ行う。
+ */
+class Capture {
+public:
+    enum Kind : uint8_t {
+        MIDI = 0,       // payload: type(0x80/0x90/0xB0/0xE0), ch(1-16), d1, d2   ピッチベンドは 14bit (中心 8192)
+        COMMAND,        // payload: "SET ..." の文字列（終端なし）
+        PRESET,         // payload: プリセットID
+        RANDOM_PRESET,  // payload: 乱数の種 (uint32 LE)
+        RESET,          // payload なし: Synth::reset()
+        KIND_COUNT
+    };
+
+    enum Source : uint8_t {
+        SRC_USB = 0,
+        SRC_SERIAL7,
+        SRC_PLAYER,
+        SRC_SERIAL_CMD,
+        SRC_SYNTH,      // Synth 内部（プリセット読み込み・リセット）
+        SOURCE_COUNT
+    };
+
+    // エントリ = ヘッダ + payload (len バイト)
+    struct EntryHeader {
+        uint32_t block;   // 適用時点で生成済みのブロック数
+        uint8_t  offset;  // 直近ブロックの生成開始からの経過（サンプル換算、参考値）
+        uint8_t  kind;    // Kind
+        uint8_t  source;  // Source
+        uint8_t  len;     // payload のバイト数
+    };
+    static_assert(sizeof(EntryHeader) == 8, "Capture::EntryHeader must be 8 bytes");
+
+    // 保存ファイルの先頭
+    struct FileHeader {
+        char     magic[4];     // "CRBC"
+        uint16_t version;
+        uint16_t block_size;   // BUFFER_SIZE
+        uint32_t sample_rate;
+        uint32_t entries;
+        uint32_t dropped;      // リングから捨てたエントリ数
+        uint32_t first_block;  // 再生の起点になるブロック数
+        uint8_t  base_preset;  // 起点で読み込まれていたプリセット
+        uint8_t  base_flags;   // BASE_*
+        uint8_t  reserved[2];
+        uint32_t base_seed;    // 0 以外なら起点はこの種のランダムプリセット
+    };
+    static_assert(sizeof(FileHeader) == 32, "Capture::FileHeader must be 32 bytes");
+
+    // FileHeader::base_flags
+    static constexpr uint8_t BASE_EDITED = 1 << 0;  // 起点の音色はプリセット/種から編集されていた
+
+    static constexpr uint16_t FORMAT_VERSION = 2;   // 2: RESET と base_flags を追加
+    static constexpr uint32_t CAPACITY = 32768;   // リングのバイト数 (RAM2)
+    static constexpr uint8_t  MAX_PAYLOAD = 64;
+
+    /** @brief 記録開始（リングをクリアし、現在のブロック数とプリセットを起点にする） */
+    static void start();
+
+    static void stop() { enabled_ = false; }
+    static bool enabled() { return enabled_; }
+
+    // --- 記録 ---
+    static void midi(Source source, uint8_t type, uint8_t ch, uint8_t d1, uint8_t d2);
+    static void pitchBend(Source source, uint8_t ch, int16_t bend);
+    static void command(const char* s, uint8_t len);
+    static void preset(uint8_t preset_id);
+    static void randomPreset(uint32_t seed);
+    static void synthReset();
+
+    static uint32_t count() { return entries_; }
+    static uint32_t dropped() { return dropped_; }
+    static uint32_t bytes() { return used_; }
+
+    /**
+     * @brief リングの内容を SD に保存（保存中は記録を止める）
+     *
+     * @return false SD に書けなかった
+     */
+    static bool save(const char* path);
+
+private:
+    static uint8_t ring_[CAPACITY];
+    static uint32_t head_;     // 次に書き込む位置
+    static uint32_t tail_;     // 最古のエントリの位置
+    static uint32_t used_;
+    static uint32_t entries_;
+    static uint32_t dropped_;
+    static uint32_t first_block_;
+    static uint8_t base_preset_;
+    static uint32_t base_seed_;
+    static uint8_t base_flags_;
+    static bool enabled_;
+
+    static void push(Kind kind, Source source, const uint8_t* payload, uint8_t len);
+    static void dropOldest();
+    static void copyIn(const void* src, uint32_t len);
+    static void copyOut(uint32_t pos, void* dst, uint32_t len);
+};
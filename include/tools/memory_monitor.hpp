@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief RAM1 / RAM2 / フラッシュの使用状況モニター
+ *
+ * リンカシンボルから静的領域（ITCM コード / DTCM .data+.bss / DMAMEM）を求め、
+ * ヒープは sbrk 位置と mallinfo() から、スタックは起動時に塗っておいた
+ * パターンがどこまで残っているか（スタックペインティング）から最大使用量を求める。
+ *
+ * Teensy 4.1 のメモリ構成:
+ * - RAM1 (FlexRAM 512KB) = ITCM (32KB単位) + DTCM。DTCM の .bss 末尾から上端までがスタック
+ * - RAM2 (OCRAM 512KB)   = DMAMEM + ヒープ
+ */
+class MemoryMonitor {
+public:
+    struct Snapshot {
+        // RAM1
+        uint32_t itcm_size = 0;     // ITCM 割り当て
+        uint32_t itcm_used = 0;     // FASTRUN コード
+        uint32_t dtcm_size = 0;     // DTCM 割り当て
+        uint32_t dtcm_static = 0;   // .data + .bss
+        uint32_t stack_size = 0;    // .bss 末尾からスタック上端まで
+        uint32_t stack_peak = 0;    // スタック最大使用量（ペイント消失位置から）
+        // RAM2
+        uint32_t ram2_size = 0;
+        uint32_t ram2_static = 0;   // DMAMEM
+        uint32_t heap_size = 0;     // DMAMEM の後ろから RAM2 末尾まで
+        uint32_t heap_used = 0;     // malloc 済み
+        uint32_t heap_free = 0;     // 未使用（sbrk 未到達分 + フリーリスト）
+        // FLASH
+        uint32_t flash_size = 0;
+        uint32_t flash_used = 0;
+    };
+
+    // 主要モジュールのバッファサイズ
+    struct ModuleUsage {
+        const char* name;
+        uint32_t bytes;
+        const char* region;
+    };
+
+    static constexpr uint32_t STACK_PAINT = 0xA5A5A5A5;
+    static constexpr uint32_t STACK_PAINT_MARGIN = 1024; // 塗らずに残す現在SP直下の領域
+
+    /**
+     * @brief 未使用スタック領域をパターンで塗る
+     *
+     * setup() の先頭で1回呼ぶ。以降 stackPeak() でどこまで使われたかが分かる。
+     */
+    static void paintStack();
+
+    /** @brief スタック最大使用量 (bytes) */
+    static uint32_t stackPeak();
+
+    /** @brief 現在のメモリ使用状況を取得 */
+    static void capture(Snapshot& snap);
+
+    /**
+     * @brief 主要モジュールのバッファサイズ一覧
+     *
+     * @param count 要素数の出力先
+     * @return const ModuleUsage* 一覧の先頭
+     */
+    static const ModuleUsage* modules(size_t& count);
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+#include "modules/synth.hpp"
+#include "tools/profiler.hpp"
+#include "tools/trace.hpp"
+
+/**
+ * @brief デッドライン監視とクラッシュレポート（ポストモーテム）
+ *
+ * PIT の割り込みで 10ms ごとに
+ * - 発音中なのにオーディオブロックが BLOCK_DEADLINE_MS 生成されていない
+ * - メインループが LOOP_DEADLINE_MS 回っていない
+ * を調べ、HardFault / MemManage / BusFault / UsageFault もフックする。
+ *
+ * どれかが起きたらフォールトレジスタ・発音中のノート・表示中の画面・
+ * プロファイラの統計・直近のトレースイベントを RAM2 の初期化されない領域に書いてリセットする。
+ * 次の起動でそれを取り出し、USB シリアルがつながったときに1回出力する（GET CRASH で再表示）。
+ *
+ * - トレースは TRACE ON / ARM で記録しているときだけ残る
+ * - 監視はオーディオ割り込み (優先度 0) より下、オーディオライブラリの更新より上で動くので、
+ *   オーディオ割り込みの中で止まった場合は検出できない
+ * - BENCH や SD への書き出しのように意図的にループを止める処理は Suspend で囲む
+ */
+class PostMortem {
+public:
+    enum Reason : uint8_t {
+        NONE = 0,
+        BLOCK_DEADLINE,  // オーディオブロックが生成されない
+        LOOP_STALL,      // メインループが止まった
+        FAULT,           // HardFault / MemManage / BusFault / UsageFault
+        REASON_COUNT
+    };
+
+    static constexpr uint32_t BLOCK_DEADLINE_MS = 500;
+    static constexpr uint32_t LOOP_DEADLINE_MS = 2000;
+    static constexpr uint32_t CHECK_INTERVAL_US = 10000;
+    static constexpr uint8_t  TRACE_EVENTS = 32;
+
+    struct StageStat {
+        uint32_t count;
+        uint32_t avg;
+        uint32_t max;
+    };
+
+    struct Record {
+        uint32_t magic;          // RECORD_MAGIC
+        uint8_t  version;
+        uint8_t  reason;         // Reason
+        uint8_t  preset_id;
+        uint8_t  voices;         // notes[] の有効数
+        uint32_t uptime_ms;
+        uint32_t block_count;    // Synth::getBlockCount()
+        uint32_t block_age_ms;   // 最後にブロックを生成してから
+        uint32_t loop_age_ms;    // 最後にメインループを回ってから
+        uint32_t cfsr, hfsr, mmfar, bfar;  // FAULT のときだけ
+        uint32_t frame[8];       // 例外スタックフレーム r0 r1 r2 r3 r12 lr pc xpsr (FAULT のときだけ)
+        uint8_t  notes[MAX_NOTES];
+        char     screen[20];
+        StageStat stages[Profiler::STAGE_COUNT];
+        uint16_t trace_count;
+        uint16_t reserved;
+        Trace::Record trace[TRACE_EVENTS];  // 古い順
+        uint32_t checksum;       // checksum 自身を除く全体の FNV-1a
+    };
+
+    /** @brief 意図的にループを止める区間。監視を止め、抜けるときに時刻を取り直す */
+    class Suspend {
+    public:
+        Suspend() { ++suspended_; }
+        ~Suspend() { kick(); --suspended_; }
+        Suspend(const Suspend&) = delete;
+        Suspend& operator=(const Suspend&) = delete;
+    };
+
+    /**
+     * @brief 前回のレポートを取り出し、フォールトハンドラを差し替える
+     *
+     * setup() の先頭で呼ぶ。
+     */
+    static void begin();
+
+    /** @brief デッドライン監視を始める（setup() の最後で呼ぶ） */
+    static void arm();
+
+    static void setEnabled(bool enabled) { kick(); enabled_ = enabled; }
+    static bool enabled() { return enabled_; }
+
+    /** @brief メインループの先頭で毎回呼ぶ。未出力のレポートがあれば USB 接続時に出す */
+    static void process() {
+        loop_ms_ = millis();
+        if (report_pending_ && Serial) print();
+    }
+
+    /** @brief 表示中の画面名（UIManager が画面を切り替えるたびに設定） */
+    static void setScreen(const char* name) { screen_ = name; }
+
+    /** @brief 前回のレポートがあるか */
+    static bool hasReport() { return last_.reason != NONE; }
+
+    /** @brief 前回のレポートを出力 (Serial) */
+    static void print();
+
+    /** @brief 前回のレポートを消す */
+    static void clear();
+
+    /** @brief CRASH TEST: 監視の確認用に意図的にフォールト / ループ停止を起こす（戻らない） */
+    [[noreturn]] static void testFault();
+    [[noreturn]] static void testStall();
+
+    /** @brief フォールトハンドラから呼ばれる */
+    static void onFault(const uint32_t* frame);
+
+private:
+    static constexpr uint32_t RECORD_MAGIC = 0x4D505243;  // "CRPM"
+    static constexpr uint8_t  RECORD_VERSION = 2;  // 2: Profiler に FFT 段を追加
+
+    static Record retained_;  // リセットをまたいで残る領域 (PLACE_RETAINED)
+    static Record last_;      // 起動時に retained_ から取り出したもの
+    static uint32_t reset_status_;  // 起動時の SRC_SRSR
+
+    static volatile uint32_t loop_ms_;
+    static volatile uint32_t block_ms_;
+    static volatile uint32_t last_blocks_;
+    static volatile uint8_t suspended_;
+    static volatile bool enabled_;
+    static bool report_pending_;
+    static const char* volatile screen_;
+
+    static void kick() {
+        loop_ms_ = millis();
+        block_ms_ = loop_ms_;
+    }
+    static void check();
+    [[noreturn]] static void trip(Reason reason, const uint32_t* frame);
+    static uint32_t checksum(const Record& r);
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+#include "tools/trace.hpp"
+
+#if !defined(__IMXRT1062__)
+#include <chrono>
+#endif
+
+/**
+ * @brief 処理段ごとの所要時間プロファイラ
+ *
+ * 各段をスコープ (Profiler::Scope) で囲み、1回ごとの所要時間を
+ * min / 平均 / max と log2 ヒストグラムに積算する。GET PERF で表示してリセットする。
+ *
+ * - 実機: ARM_DWT_CYCCNT によるサイクル数
+ * - ホスト: std::chrono::steady_clock によるナノ秒
+ *
+ * 記録はトレースが有効ならその区間としても残る (Trace::span)。
+ *
+ * すべてメインループ（と SPI 転送中のオーディオコールバック）から呼ばれるので排他はしない。
+ * 入れ子の段は内側も外側も計上する（FLASH には転送中に呼ばれる SYNTH などが含まれる）。
+ */
+class Profiler {
+public:
+    enum Stage : uint8_t {
+        SYNTH = 0,  // 1ブロック生成 (Synth::generate()) 全体
+        VOICES,     // ボイス生成（全ノート × 全オペレーター）
+        OUTPUT,     // リミッター + 16bit 変換 + 出力バッファ
+        LPF,
+        HPF,
+        DELAY,
+        CHORUS,
+        REVERB,
+        AUDIO,      // audio_hdl.process()
+        MIDI,       // midi_hdl.process()
+        UI,         // ui.render()
+        FLASH,      // GFX_SSD1351 の矩形1つの転送
+        PLAYER,     // midi_player.process()
+        SERIAL_IO,  // serial_hdl.process()
+        SD,         // SD カードからの読み込み (MIDI Player)
+        FFT,        // Spectrum::step() 1回（スペクトラム画面）
+        STAGE_COUNT
+    };
+
+    // ヒストグラム: ビン k は [2^(k-1), 2^k) 、ビン 0 は 0
+    static constexpr uint8_t HIST_BINS = 33;
+
+    struct Stat {
+        uint32_t count = 0;
+        uint32_t min = UINT32_MAX;
+        uint32_t max = 0;
+        uint64_t total = 0;
+        uint32_t hist[HIST_BINS] = {};
+    };
+
+    /** @brief 現在時刻 (実機: サイクル / ホスト: ns) */
+    static inline uint32_t now() {
+#if defined(__IMXRT1062__)
+        return ARM_DWT_CYCCNT;
+#else
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /** @brief 1回分の所要時間を積算 */
+    static inline void record(Stage stage, uint32_t ticks) {
+        Stat& s = stats_[stage];
+        ++s.count;
+        s.total += ticks;
+        if (ticks < s.min) s.min = ticks;
+        if (ticks > s.max) s.max = ticks;
+        ++s.hist[ticks ? 32 - __builtin_clz(ticks) : 0];
+        Trace::span(stage, ticks);
+    }
+
+    /** @brief スコープの開始から終了までを stage に積算する */
+    class Scope {
+    private:
+        Stage stage_;
+        uint32_t start_;
+    public:
+        explicit Scope(Stage stage) : stage_(stage), start_(now()) {}
+        ~Scope() { record(stage_, now() - start_); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /** @brief 開始からの経過 */
+        uint32_t elapsed() const { return now() - start_; }
+    };
+
+    /** @brief 計測単位 ("cyc" / "ns") */
+    static const char* unit();
+
+    /** @brief 1秒あたりの計測単位数 */
+    static uint32_t ticksPerSecond();
+
+    /** @brief 段の表示名 */
+    static const char* name(Stage stage);
+
+    static const Stat& stat(Stage stage) { return stats_[stage]; }
+
+    /** @brief 全段の統計を表で出力する (Serial) */
+    static void print();
+
+    /** @brief 全段の統計をクリア */
+    static void reset();
+
+private:
+    static Stat stats_[STAGE_COUNT];
+};
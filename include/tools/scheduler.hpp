@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+#include "tools/profiler.hpp"
+
+/**
+ * @brief メインループの協調スケジューラ
+ *
+ * タスクは優先度と1回あたりの所要時間の見込み (budget) を宣言する。
+ * CRITICAL（音源・オーディオ・MIDI 入力）は毎回実行し、それ以外は優先度順に、
+ * 再生キューが空になるまでの時間 (headroom) に収まるときだけ実行して、収まらなければ次のループへ延ばす。
+ * タスクの前には毎回 CRITICAL を回してキューを満たしておく。
+ *
+ * - 所要時間は budget と、直近 1〜2 秒に実測した「途中で yield() を挟まない最長区間」の大きい方。
+ *   SPI 転送のように途中でオーディオコールバックを呼ぶ処理は、その区切りごとに数える
+ * - yield()（SPI 転送中のオーディオコールバック）では CRITICAL と in_yield のタスクを実行する
+ * - max_defer_ms を超えて延ばしたタスクは headroom に関係なく実行する（入力や USB の取りこぼし防止）
+ *
+ * すべてメインループ（と SPI 転送中のオーディオコールバック）から呼ばれるので排他はしない。
+ */
+class Scheduler {
+public:
+    using TaskFn = void(*)();
+    using HeadroomFn = uint32_t(*)();  // 再生キューが空になるまでの見込み (μs)。UINT32_MAX: 制約なし
+
+    enum Priority : uint8_t {
+        CRITICAL = 0,  // 毎回必ず実行
+        HIGH,
+        NORMAL,
+        LOW,
+        PRIORITY_COUNT
+    };
+
+    struct Task {
+        const char* name;
+        TaskFn fn;
+        Priority priority;
+        uint32_t budget_us;      // 1回の所要時間の見込み
+        uint32_t max_defer_ms;   // これ以上は延ばさない (0: 制限なし)
+        Profiler::Stage stage;   // 計測先 (Profiler::STAGE_COUNT: 計測しない)
+        bool in_yield;           // SPI 転送中のコールバックでも実行するか (CRITICAL は常に実行)
+    };
+
+    struct Stat {
+        uint32_t runs;
+        uint32_t deferred;   // headroom が足りずに延ばしたループ数
+        uint32_t forced;     // max_defer_ms を超えたので足りないまま実行した回数
+        uint32_t overruns;   // 実測が budget_us を超えた回数
+        uint32_t peak_us;    // 実測の最大（GET SCHED でクリア）
+        uint32_t window_us[2];  // 直前と現在のウィンドウでの実測の最大
+        uint32_t last_ms;    // 最後に実行した時刻
+    };
+
+    static constexpr uint8_t  MAX_TASKS = 12;
+    static constexpr uint32_t GUARD_US = 300;     // 見込みの誤差に対する余裕
+    static constexpr uint32_t WINDOW_MS = 1000;   // 実測の最大を覚えておく単位
+
+    /** @brief タスクを登録（優先度順、同じ優先度は登録順に並ぶ） */
+    static bool add(const Task& task);
+
+    static void setHeadroom(HeadroomFn fn) { headroom_fn_ = fn; }
+
+    /** @brief メインループ 1回分 */
+    static void run();
+
+    /**
+     * @brief 協調ポイント（SPI 転送中のオーディオコールバック）
+     *
+     * 実行中のタスクの区間を区切り、CRITICAL と headroom に収まる in_yield のタスクを実行する。
+     */
+    static void yield();
+
+    /** @brief 現在の headroom (μs) */
+    static uint32_t headroomUs() { return headroom_fn_ ? headroom_fn_() : UINT32_MAX; }
+
+    /** @brief タスクごとの統計を表で出力する (Serial) */
+    static void print();
+
+    /** @brief 統計をクリア（所要時間の見込みは残す） */
+    static void clearStats();
+
+private:
+    static Task tasks_[MAX_TASKS];
+    static Stat stats_[MAX_TASKS];
+    static uint8_t count_;
+    static HeadroomFn headroom_fn_;
+
+    // 実行中のタスクの区間計測
+    static bool in_task_;
+    static uint8_t yield_depth_;
+    static uint16_t running_;     // 実行中のタスク（yield() で同じタスクを入れ子に呼ばない）
+    static uint32_t slice_start_;
+    static uint32_t slice_max_;
+    static uint32_t window_start_ms_;
+
+    static uint32_t cost(uint8_t i);
+    static uint32_t criticalCost();
+    static bool fits(uint8_t i);
+    static void runCritical();
+    static void execute(uint8_t i);
+    static void closeSlice();
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+class Synth;
+
+/**
+ * @brief 最悪ケースの入力を内部で作ってブロック処理時間を測るストレステスト
+ *
+ * 外部機材なしで最悪ケースを再現するため、シナリオごとの入力を毎ブロック
+ * Synth に直接流し込み、1ブロックあたりの時間（入力処理 + generate()）の
+ * 平均 / 99.9パーセンタイル / 最大と、ブロック生成の最大間隔 (GAP) を表にする。
+ *
+ * - 実機 (STRESS コマンド): 通常のメインループのまま走らせる。UI 描画・SPI 転送・
+ *   オーディオ出力も本物なので、GAP が持ち時間を大きく超えると出力キューが枯れる (GET XRUN)
+ * - ホスト (stress サブコマンド): run() で generate() を連続で回す
+ *
+ * 開始時の状態をスナップショットに取り、終了時に戻す（エフェクトバッファは無音になる）。
+ * 入力の記録 (Capture) は実行中止め、終了時に記録し直す。
+ */
+class Stress {
+public:
+    enum Scenario : uint8_t {
+        CHORD = 0,  // 16音の和音を毎ブロック弾き直す（毎回全ボイスを奪う）
+        BEND,       // 16音を保持してピッチベンドを最大幅で往復
+        CC,         // 16音を保持して毎ブロック 32 個のパラメータを書き換える
+        FX,         // 16音を保持して5つのエフェクトをすべて最大設定で有効にする
+        PRESET,     // 毎ブロック loadPreset() で音色を切り替えて和音を弾き直す
+        UI,         // 16音を保持してオシロスコープ画面を毎フレーム描画（実機のみ）
+        MIX,        // CHORD + BEND + CC + FX を同時に、8ブロックごとに PRESET も
+        SCENARIO_COUNT
+    };
+
+    static constexpr uint16_t DEFAULT_BLOCKS = 2048;  // 1シナリオのブロック数（約6秒）
+    static constexpr uint16_t MAX_BLOCKS = 4096;
+
+    /** @brief UI シナリオで画面を開く / 閉じるフック (on: 開始時 true、終了時 false) */
+    using UiHook = void (*)(bool on);
+    static void setUiHook(UiHook hook) { ui_hook_ = hook; }
+
+    /** @brief シナリオ名 → Scenario。不明なら false */
+    static bool parse(const char* name, Scenario& out);
+    static const char* name(Scenario scenario);
+
+    /** @brief この環境で走らせられるか（UI はフックが登録されているときだけ） */
+    static bool supported(Scenario scenario) { return scenario != UI || ui_hook_ != nullptr; }
+
+    /**
+     * @brief 開始（結果はシナリオが終わるたびに1行ずつ出力）
+     *
+     * @param all true なら scenario から最後まで順に走らせる（走らせられないものは飛ばす）
+     * @param blocks 1シナリオのブロック数 (1 - MAX_BLOCKS)
+     * @return false 実行中、またはスナップショットを取れなかった
+     */
+    static bool start(Synth& synth, Scenario scenario, bool all, uint16_t blocks);
+
+    /** @brief 中断して開始時の状態に戻す */
+    static void stop(Synth& synth);
+
+    static bool active() { return active_; }
+
+    /**
+     * @brief 毎ブロックの入力と計測
+     *
+     * synth.update() の直前に毎回呼ぶ（メインループと SPI 転送中のコールバックの両方）。
+     * 次の update() でブロックが生成されるときだけ、そのブロックの入力を流し込む。
+     */
+    static void process(Synth& synth);
+
+    /**
+     * @brief 終わるまで process() と update() を回す（ホスト用）
+     */
+    static bool run(Synth& synth, Scenario scenario, bool all, uint16_t blocks);
+
+private:
+    static UiHook ui_hook_;
+    static bool active_;
+    static bool all_;
+    static Scenario scenario_;
+    static uint16_t blocks_;
+    static uint16_t count_;        // 計測済みブロック数
+    static bool pending_;          // 入力済みでまだ生成されていないブロックがある
+    static uint32_t pending_block_;
+    static uint32_t input_ticks_;  // 直近の入力処理時間
+    static uint32_t last_start_;   // 直前ブロックの生成開始時刻
+    static uint32_t max_gap_;
+    static uint64_t total_;
+    static uint32_t rng_;
+    static bool capture_was_on_;
+
+    static void begin(Synth& synth);
+    static void end(Synth& synth);
+    static void finish(Synth& synth);
+    static void inject(Synth& synth);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+/**
+ * @brief バイナリ形式のイベントトレース（リングバッファ）
+ *
+ * 処理段の区間 (Profiler の段と同じ) とノートオン/オフ・ボイススティール・
+ * プリセット読み込み・画面転送の分割点・アンダーランを、Profiler::now() の時刻付きで
+ * 12バイトのレコードとしてリングに書き込む。満杯になると古いものから上書きする。
+ *
+ * TRACE DUMP でシリアルへそのまま流し、ホストの `trace` コマンドで
+ * Chrome / Perfetto のトレース JSON に変換する。
+ *
+ * Profiler と同じくメインループ（と SPI 転送中のオーディオコールバック）からだけ
+ * 書き込むので排他はしない。停止中は分岐1つで抜ける。
+ */
+class Trace {
+public:
+    enum Event : uint8_t {
+        SPAN = 0,     // 処理段の区間         a = Profiler::Stage, dur = 所要時間
+        NOTE_ON,      // ノートオン           a = ノート番号, b = ベロシティ
+        NOTE_OFF,     // ノートオフ           a = ノート番号
+        VOICE_STEAL,  // ボイススティール     a = 奪われたノート番号, b = 1: リリース中だった
+        PRESET_LOAD,  // プリセット読み込み   a = プリセットID
+        FLASH_CHUNK,  // 画面転送の分割点     b = 転送済みの行数（この直後にオーディオ処理が入る）
+        UNDERRUN,     // アンダーラン         a = UNDERRUN_STARVED / UNDERRUN_LATE
+        EVENT_COUNT
+    };
+
+    // TRACE DUMP のレコード（リトルエンディアンのまま送る）
+    struct Record {
+        uint32_t time;  // 開始時刻 (Profiler::now())
+        uint32_t dur;   // SPAN の所要時間。それ以外は 0
+        uint8_t  type;  // Event
+        uint8_t  a;
+        uint16_t b;
+    };
+    static_assert(sizeof(Record) == 12, "Trace::Record must be packed to 12 bytes");
+
+    static constexpr uint16_t CAPACITY = 2048;  // 24KB (RAM2)
+    static constexpr uint8_t  FORMAT_VERSION = 1;
+
+    /**
+     * @brief 記録開始（リングはクリアする）
+     *
+     * @param min_ticks これより短い区間は記録しない（空振りの多い段でリングが埋まるのを防ぐ）
+     * @param stop_on_underrun アンダーランの後、リングの 1/4 を書いたところで自動停止する
+     */
+    static void start(uint32_t min_ticks, bool stop_on_underrun);
+
+    /** @brief 記録停止（内容は残る） */
+    static void stop() { enabled_ = false; }
+
+    static bool enabled() { return enabled_; }
+
+    /** @brief 処理段の区間を記録（Profiler::record() から呼ばれる） */
+    static inline void span(uint8_t stage, uint32_t ticks) {
+        if (enabled_ && ticks >= min_ticks_) pushSpan(stage, ticks);
+    }
+
+    /** @brief 単発イベントを記録 */
+    static inline void event(Event type, uint8_t a = 0, uint16_t b = 0) {
+        if (enabled_) pushEvent(type, a, b);
+    }
+
+    /** @brief 保持しているレコード数 */
+    static uint16_t count() { return count_; }
+
+    /** @brief 上書きで失ったレコード数 */
+    static uint32_t dropped() { return dropped_; }
+
+    /** @brief 古い順に index 番目のレコード */
+    static const Record& at(uint16_t index);
+
+    /**
+     * @brief ヘッダ行とレコード列をシリアルへ送る（送信中は記録を止める）
+     *
+     * "TRACE <version> <count> <ticks/s> <dropped>\n" の後に count × 12 バイト。
+     */
+    static void dump();
+
+private:
+    static Record ring_[CAPACITY];
+    static uint16_t head_;            // 次に書き込む位置
+    static uint16_t count_;
+    static uint32_t dropped_;
+    static uint32_t min_ticks_;
+    static bool enabled_;
+    static bool stop_on_underrun_;
+    static uint16_t stop_countdown_;  // 0: 停止予定なし
+
+    static void pushSpan(uint8_t stage, uint32_t ticks);
+    static void pushEvent(Event type, uint8_t a, uint16_t b);
+    static void push(uint32_t time, uint32_t dur, Event type, uint8_t a, uint16_t b);
+};
@@ -30,6 +30,7 @@ private:
     const Gain_t MIX_STEP = Q15_MAX / 100;  // 1%刻み (約328)
 
 public:
+    const char* name() const override { return "CHORUS"; }
     ChorusScreen() = default;
 
     void onEnter(UIManager* manager) override {
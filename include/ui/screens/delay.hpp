@@ -30,6 +30,7 @@ private:
     const Gain_t FEEDBACK_STEP = Q15_MAX / 100;       // 1%刻み (約328)
 
 public:
+    const char* name() const override { return "DELAY"; }
     DelayScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -91,7 +92,8 @@ public:
             }
             else if (cursor == C_TIME) {
                 int32_t time = synth.getDelayTime() + TIME_STEP;
-                if (time > MAX_TIME) time = MAX_TIME;
+                const int32_t max_time = synth.getDelay().getMaxTime(); // アリーナの配分で変わる
+                if (time > max_time) time = max_time;
                 synth.getDelay().setTime(time);
                 changed = true;
             }
@@ -37,6 +37,7 @@ private:
     };
 
 public:
+    const char* name() const override { return "ENVELOPE MONITOR"; }
     EnvelopeMonitorScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -30,6 +30,7 @@ private:
     int8_t cursor = C_DELAY;
 
 public:
+    const char* name() const override { return "FX"; }
     FXScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -47,6 +47,7 @@ private:
     }
 
 public:
+    const char* name() const override { return "LFO"; }
     LFOScreen() = default;
 
     void onEnter(UIManager* manager) override {
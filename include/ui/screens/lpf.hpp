@@ -30,6 +30,7 @@ private:
     const Gain_t MIX_STEP = 1024; // Q15_MAXの約3%
 
 public:
+    const char* name() const override { return "LPF"; }
     LPFScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -24,6 +24,7 @@ private:
     int8_t cursor = C_LEVEL;
 
 public:
+    const char* name() const override { return "MASTER"; }
     MasterScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "ui/ui.hpp"
+#include "tools/memory_monitor.hpp"
+
+/**
+ * @brief メモリモニター画面
+ *
+ * MemoryMonitor のスナップショットを表示する。
+ * 上下ボタンで「領域ごとの使用率」と「主要モジュールのサイズ」を切り替える。
+ * 値の変化は遅いので REFRESH_MS ごとにだけ描き直す。
+ */
+class MemoryScreen : public Screen {
+private:
+    static constexpr int16_t HEADER_H = 12;
+    static constexpr int16_t ROW_H = 17;
+    static constexpr int16_t BAR_X = 2;
+    static constexpr int16_t BAR_W = SCREEN_WIDTH - 4;
+    static constexpr int16_t BAR_H = 4;
+    static constexpr int16_t MODULE_ROW_H = 12;
+    static constexpr uint32_t REFRESH_MS = 500;
+
+    enum Page : uint8_t {
+        PAGE_REGIONS = 0,
+        PAGE_MODULES,
+        PAGE_MAX
+    };
+    uint8_t page = PAGE_REGIONS;
+
+    bool needsRedraw = true;
+    uint32_t lastRefresh = 0;
+
+public:
+    const char* name() const override { return "MEMORY"; }
+    MemoryScreen() = default;
+
+    void onEnter(UIManager* manager) override {
+        this->manager = manager;
+        needsRedraw = true;
+        manager->invalidate();
+        manager->triggerFullTransfer();
+    }
+
+    bool isAnimated() const override { return true; }
+
+    void handleInput(uint8_t button) override {
+        if (button == BTN_CXL || button == BTN_ET) {
+            manager->popScreen();
+            return;
+        }
+        if (button == BTN_UP || button == BTN_DN) {
+            page = (page + 1) % PAGE_MAX;
+            needsRedraw = true;
+        }
+    }
+
+    void draw(GFXcanvas16& canvas) override {
+        uint32_t now = millis();
+        if (!needsRedraw && now - lastRefresh < REFRESH_MS) return;
+        lastRefresh = now;
+        needsRedraw = false;
+
+        canvas.fillScreen(Color::BLACK);
+        drawHeader(canvas);
+
+        if (page == PAGE_REGIONS) {
+            MemoryMonitor::Snapshot snap;
+            MemoryMonitor::capture(snap);
+            drawRegions(canvas, snap);
+        } else {
+            drawModules(canvas);
+        }
+
+        manager->triggerFullTransfer();
+    }
+
+private:
+    void drawHeader(GFXcanvas16& canvas) {
+        canvas.setTextSize(1);
+        canvas.setTextColor(Color::WHITE);
+        canvas.setCursor(2, 2);
+        canvas.print("MEMORY");
+
+        canvas.setTextColor(Color::MD_GRAY);
+        canvas.setCursor(SCREEN_WIDTH - 6 * 3 - 2, 2);
+        canvas.print(page == PAGE_REGIONS ? "1/2" : "2/2");
+
+        canvas.drawFastHLine(0, HEADER_H - 1, SCREEN_WIDTH, Color::DARK_SLATE);
+    }
+
+    void drawRegions(GFXcanvas16& canvas, const MemoryMonitor::Snapshot& s) {
+        drawUsageRow(canvas, 0, "ITCM",  s.itcm_used,   s.itcm_size);
+        drawUsageRow(canvas, 1, "DTCM",  s.dtcm_static, s.dtcm_size);
+        drawUsageRow(canvas, 2, "STACK", s.stack_peak,  s.stack_size);
+        drawUsageRow(canvas, 3, "RAM2",  s.ram2_static, s.ram2_size);
+        drawUsageRow(canvas, 4, "HEAP",  s.heap_size - s.heap_free, s.heap_size);
+        drawUsageRow(canvas, 5, "FLASH", s.flash_used,  s.flash_size);
+    }
+
+    // 1行: ラベル + 使用量/容量(KB) + 使用率バー
+    void drawUsageRow(GFXcanvas16& canvas, int index, const char* label,
+                      uint32_t used, uint32_t size) {
+        int16_t y = HEADER_H + 2 + index * ROW_H;
+
+        canvas.setTextSize(1);
+        canvas.setTextColor(Color::MD_GRAY);
+        canvas.setCursor(2, y);
+        canvas.print(label);
+
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%lu/%luK",
+                static_cast<unsigned long>((used + 1023) / 1024),
+                static_cast<unsigned long>(size / 1024));
+        int16_t tw = strlen(buf) * 6;
+        canvas.setTextColor(Color::WHITE);
+        canvas.setCursor(SCREEN_WIDTH - tw - 2, y);
+        canvas.print(buf);
+
+        // 使用率バー（90%超で警告色）
+        int16_t by = y + 9;
+        canvas.drawRect(BAR_X, by, BAR_W, BAR_H, Color::DARK_SLATE);
+        if (size > 0) {
+            uint32_t clipped = used < size ? used : size;
+            int16_t w = static_cast<int16_t>(static_cast<uint64_t>(clipped) * (BAR_W - 2) / size);
+            uint16_t color = (clipped * 10 > size * 9) ? Color::MD_RED : Color::MD_TEAL;
+            if (w > 0) canvas.fillRect(BAR_X + 1, by + 1, w, BAR_H - 2, color);
+        }
+    }
+
+    void drawModules(GFXcanvas16& canvas) {
+        size_t count = 0;
+        const MemoryMonitor::ModuleUsage* mods = MemoryMonitor::modules(count);
+
+        canvas.setTextSize(1);
+        for (size_t i = 0; i < count; ++i) {
+            int16_t y = HEADER_H + 4 + static_cast<int16_t>(i) * MODULE_ROW_H;
+            if (y + 8 > SCREEN_HEIGHT) break;
+
+            canvas.setTextColor(Color::MD_GRAY);
+            canvas.setCursor(2, y);
+            canvas.print(mods[i].name);
+
+            char buf[24];
+            snprintf(buf, sizeof(buf), "%luK %s",
+                    static_cast<unsigned long>((mods[i].bytes + 1023) / 1024),
+                    mods[i].region);
+            int16_t tw = strlen(buf) * 6;
+            canvas.setTextColor(Color::WHITE);
+            canvas.setCursor(SCREEN_WIDTH - tw - 2, y);
+            canvas.print(buf);
+        }
+    }
+};
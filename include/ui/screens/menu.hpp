@@ -4,7 +4,9 @@
 #include "ui/screens/passthrough.hpp"
 #include "ui/screens/midi_player_screen.hpp"
 #include "ui/screens/oscilloscope.hpp"
+#include "ui/screens/spectrum.hpp"
 #include "ui/screens/envelope_monitor.hpp"
+#include "ui/screens/memory.hpp"
 
 class MenuScreen : public Screen {
 private:
@@ -18,7 +20,9 @@ private:
         C_PASSTHROUGH = 0,
         C_MIDI_PLAYER,
         C_OSCILLOSCOPE,
+        C_SPECTRUM,
         C_ENV_MONITOR,
+        C_MEMORY,
         C_BACK,
         C_RESTART,
         C_MAX
@@ -26,6 +30,7 @@ private:
     int8_t cursor = C_PASSTHROUGH;
 
 public:
+    const char* name() const override { return "MENU"; }
     MenuScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -66,10 +71,18 @@ public:
                 manager->pushScreen(new OscilloscopeScreen());
                 return;
             }
+            else if (cursor == C_SPECTRUM) {
+                manager->pushScreen(new SpectrumScreen());
+                return;
+            }
             else if (cursor == C_ENV_MONITOR) {
                 manager->pushScreen(new EnvelopeMonitorScreen());
                 return;
             }
+            else if (cursor == C_MEMORY) {
+                manager->pushScreen(new MemoryScreen());
+                return;
+            }
             else if (cursor == C_BACK) {
                 manager->popScreen();
                 return;
@@ -135,7 +148,9 @@ private:
         drawNavItem(canvas, "PASSTHROUGH", 0, cursor == C_PASSTHROUGH);
         drawNavItem(canvas, "MIDI PLAYER", 1, cursor == C_MIDI_PLAYER);
         drawNavItem(canvas, "OSCILLOSCOPE", 2, cursor == C_OSCILLOSCOPE);
-        drawNavItem(canvas, "ENV MONITOR", 3, cursor == C_ENV_MONITOR);
+        drawNavItem(canvas, "SPECTRUM", 3, cursor == C_SPECTRUM);
+        drawNavItem(canvas, "ENV MONITOR", 4, cursor == C_ENV_MONITOR);
+        drawNavItem(canvas, "MEMORY", 5, cursor == C_MEMORY);
     }
 
     void drawFooter(GFXcanvas16& canvas) {
@@ -150,7 +165,9 @@ private:
             case C_PASSTHROUGH:  drawNavItem(canvas, "PASSTHROUGH", 0, sel); break;
             case C_MIDI_PLAYER:  drawNavItem(canvas, "MIDI PLAYER", 1, sel); break;
             case C_OSCILLOSCOPE: drawNavItem(canvas, "OSCILLOSCOPE", 2, sel); break;
-            case C_ENV_MONITOR:  drawNavItem(canvas, "ENV MONITOR", 3, sel); break;
+            case C_SPECTRUM:     drawNavItem(canvas, "SPECTRUM", 3, sel); break;
+            case C_ENV_MONITOR:  drawNavItem(canvas, "ENV MONITOR", 4, sel); break;
+            case C_MEMORY:       drawNavItem(canvas, "MEMORY", 5, sel); break;
             case C_BACK:         drawBackButton(canvas, sel); break;
             case C_RESTART:      drawRestartButton(canvas, sel); break;
         }
@@ -39,6 +39,7 @@ private:
     }
 
 public:
+    const char* name() const override { return "MIDI PLAYER"; }
     MIDIPlayerScreen() = default;
 
     void onEnter(UIManager* manager) override {
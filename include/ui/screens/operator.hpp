@@ -29,6 +29,7 @@ private:
     int8_t cursor = C_RATE1;
 
 public:
+    const char* name() const override { return "OPERATOR ENVELOPE"; }
     OperatorEnvelopeScreen(uint8_t opIndex = 0) : operatorIndex(opIndex) {
         if (operatorIndex >= 6) operatorIndex = 0;
     }
@@ -338,7 +339,7 @@ private:
 
     void adjustParameter(int8_t direction) {
         Synth& synth = Synth::getInstance();
-        Envelope& env = const_cast<Envelope&>(synth.getOperatorEnv(operatorIndex));
+        Envelope& env = synth.editOperatorEnv(operatorIndex);
 
         auto adjustValue = [](uint8_t current, int8_t dir) -> uint8_t {
             int16_t newVal = current + dir;
@@ -397,6 +398,7 @@ private:
     int8_t cursor = C_MODE;
 
 public:
+    const char* name() const override { return "OPERATOR PITCH"; }
     OperatorPitchScreen(uint8_t opIndex = 0) : operatorIndex(opIndex) {
         if (operatorIndex >= 6) operatorIndex = 0;
     }
@@ -440,7 +442,7 @@ public:
             if (cursor == C_MODE) {
                 // MODEをトグル
                 Synth& synth = Synth::getInstance();
-                Oscillator& osc = const_cast<Oscillator&>(synth.getOperatorOsc(operatorIndex));
+                Oscillator& osc = synth.editOperatorOsc(operatorIndex);
                 osc.setFixed(!osc.isFixed());
                 changed = true;
             }
@@ -601,7 +603,7 @@ private:
 
     void adjustParameter(int8_t direction) {
         Synth& synth = Synth::getInstance();
-        Oscillator& osc = const_cast<Oscillator&>(synth.getOperatorOsc(operatorIndex));
+        Oscillator& osc = synth.editOperatorOsc(operatorIndex);
 
         switch (cursor) {
             case C_MODE: {
@@ -677,6 +679,7 @@ private:
     }
 
 public:
+    const char* name() const override { return "OPERATOR SENS"; }
     OperatorSensScreen(uint8_t opIndex = 0) : operatorIndex(opIndex) {
         if (operatorIndex >= 6) operatorIndex = 0;
     }
@@ -896,7 +899,7 @@ private:
 
     void adjustParameter(int8_t direction) {
         Synth& synth = Synth::getInstance();
-        Envelope& env = const_cast<Envelope&>(synth.getOperatorEnv(operatorIndex));
+        Envelope& env = synth.editOperatorEnv(operatorIndex);
 
         auto clamp = [](int16_t val, int16_t lo, int16_t hi) -> uint8_t {
             if (val < lo) val = lo;
@@ -981,6 +984,7 @@ private:
     int8_t cursor = C_ENABLED;
 
 public:
+    const char* name() const override { return "OPERATOR"; }
     OperatorScreen(uint8_t opIndex = 0) : operatorIndex(opIndex) {
         if (operatorIndex >= 6) operatorIndex = 0;
     }
@@ -1028,7 +1032,7 @@ public:
         else if (button == BTN_ET) {
             if (cursor == C_ENABLED) {
                 Synth& synth = Synth::getInstance();
-                Oscillator& osc = const_cast<Oscillator&>(synth.getOperatorOsc(operatorIndex));
+                Oscillator& osc = synth.editOperatorOsc(operatorIndex);
                 if (osc.isEnabled()) {
                     osc.disable();
                 } else {
@@ -1260,7 +1264,7 @@ private:
      */
     void adjustParameter(int8_t direction) {
         Synth& synth = Synth::getInstance();
-        Oscillator& osc = const_cast<Oscillator&>(synth.getOperatorOsc(operatorIndex));
+        Oscillator& osc = synth.editOperatorOsc(operatorIndex);
 
         switch (cursor) {
             case C_WAVE: {
@@ -2,22 +2,23 @@
 
 #include "ui/ui.hpp"
 #include "handlers/audio.hpp"
-#include "modules/synth.hpp"
+#include "modules/scope.hpp"
 #include <algorithm>
-#include <cstring>
 
 /**
  * @brief オシロスコープ画面
  * オーディオ出力波形をリアルタイム表示する。
+ * 波形は出力段の ScopeTap が取り込んだフレームを読む（トリガー判定と間引きは出力段で行う）。
  * L/R/L+R の3モード切り替え、フリーズ（一時停止）、
- * ゼロクロストリガーによる安定表示、時間軸ズームに対応。
+ * トリガー (EDGE / LEVEL / NOTE / FREE)、時間軸ズーム（約0.5ms〜370ms）に対応。
  *
  * 操作:
  *   UP / DN        : チャンネル切替 (L+R / L / R)
  *   UP_LONG        : 時間軸ズームイン (波形を大きく表示)
- *   DN_LONG        : 時間軸ズームアウト
+ *   DN_LONG        : 時間軸ズームアウト (長い時間を間引いて表示)
  *   LEFT / RIGHT   : 振幅ゲイン 下 / 上
  *   ENTER          : フリーズ / 解除
+ *   ENTER_LONG     : トリガー切替
  *   CANCEL         : 戻る
  */
 class OscilloscopeScreen : public Screen {
@@ -30,19 +31,27 @@ private:
     static constexpr int16_t WAVE_HEIGHT = WAVE_BOTTOM - WAVE_TOP;
     static constexpr int16_t WAVE_CENTER = WAVE_TOP + WAVE_HEIGHT / 2;
 
-    // 最大描画サンプル数（トリガー探索32サンプル分を除いた残り）
-    static constexpr int16_t SAMPLE_COUNT = BUFFER_SIZE - BUFFER_SIZE / 4; // 96
-
-    // トリガー探索範囲
-    static constexpr int16_t MAX_TRIGGER_SEARCH = BUFFER_SIZE / 4; // 32
-
     // === 時間軸ズーム ===
-    // ズームインするほど少ないサンプルを128pxに引き伸ばす。
-    // 例: 48サンプルを128pxに → 1サンプルが約2.7pxになり波形が2倍大きく見える。
-    static constexpr uint8_t ZOOM_STEPS = 5;
-    static constexpr int16_t ZOOM_SAMPLES[ZOOM_STEPS] = { 96, 64, 48, 32, 24 };
-    static constexpr const char* ZOOM_LABELS[ZOOM_STEPS] = { "1x", "1.5x", "2x", "3x", "4x" };
-    uint8_t zoomIndex = 0;
+    // 128点までは少ない点を128pxに引き伸ばし、それより長い時間は出力段で間引いた128点を表示する。
+    // 例: 48点を128pxに → 1点が約2.7pxになり波形が2倍大きく見える。
+    // ラベルは画面幅の時間 (points × decimation / 44.1kHz)。
+    struct Zoom {
+        int16_t points;
+        uint8_t decimation;
+        const char* label;
+    };
+    static constexpr uint8_t ZOOM_STEPS = 13;
+    static constexpr Zoom ZOOMS[ZOOM_STEPS] = {
+        {  24,   1, "0.5ms" }, {  32,   1, "0.7ms" }, {  48,   1, "1.1ms" }, {  64,   1, "1.5ms" },
+        {  96,   1, "2.2ms" }, { 128,   1, "2.9ms" }, { 128,   2, "5.8ms" }, { 128,   4, "12ms"  },
+        { 128,   8, "23ms"  }, { 128,  16, "46ms"  }, { 128,  32, "93ms"  }, { 128,  64, "186ms" },
+        { 128, 128, "372ms" },
+    };
+    static constexpr uint8_t ZOOM_DEFAULT = 4;  // 96点
+    uint8_t zoomIndex = ZOOM_DEFAULT;
+
+    // === トリガー ===
+    ScopeTap::Trigger trigger = ScopeTap::EDGE;
 
     // === 表示モード ===
     enum DisplayMode : uint8_t {
@@ -55,11 +64,6 @@ private:
     DisplayMode displayMode = MODE_LR;
     bool frozen = false;
 
-    // 波形バッファ（描画用）
-    int16_t waveL[SAMPLE_COUNT];
-    int16_t waveR[SAMPLE_COUNT];
-    bool hasData = false;
-
     // === 振幅ゲイン ===
     static constexpr uint8_t GAIN_STEPS = 7;
     static constexpr int16_t GAIN_TABLE[GAIN_STEPS] = { 1, 2, 4, 6, 8, 12, 16 };
@@ -73,41 +77,28 @@ private:
     }
 
     /**
-     * @brief ゼロクロストリガー
-     * 先頭 MAX_TRIGGER_SEARCH サンプル内で負→正の交差を探しオフセットを返す。
+     * @brief 出力段のトリガーと間引きを設定
+     * トリガーはR表示のときRで、それ以外はLで判定する。
+     * LEVEL の閾値は現在のゲインで波形エリアの 1/4 の高さ。
      */
-    int16_t findTriggerOffset(const Sample16_t* buf) const {
-        for (int16_t i = 1; i < MAX_TRIGGER_SEARCH; i++) {
-            if (buf[i - 1] < 0 && buf[i] >= 0) return i;
-        }
-        return 0;
+    void configureTap() {
+        const ScopeTap::Source source = (displayMode == MODE_R) ? ScopeTap::RIGHT : ScopeTap::LEFT;
+        const Sample16_t level = (trigger == ScopeTap::LEVEL)
+            ? static_cast<Sample16_t>(SAMPLE16_MAX / (2 * GAIN_TABLE[gainIndex]))
+            : 0;
+        ScopeTap::configure(trigger, source, level, ZOOMS[zoomIndex].decimation);
     }
 
-    /**
-     * @brief 波形キャプチャ
-     * 128サンプルのスナップショットからトリガー後の96サンプルを取得。
-     */
-    void captureWaveform() {
-        Sample16_t snapL[BUFFER_SIZE];
-        Sample16_t snapR[BUFFER_SIZE];
-        memcpy(snapL, samples_L, sizeof(snapL));
-        memcpy(snapR, samples_R, sizeof(snapR));
-
-        const Sample16_t* trigBuf = (displayMode == MODE_R) ? snapR : snapL;
-        int16_t offset = findTriggerOffset(trigBuf);
-
-        for (int16_t i = 0; i < SAMPLE_COUNT; i++) {
-            waveL[i] = snapL[i + offset];
-            waveR[i] = snapR[i + offset];
-        }
-        hasData = true;
+    /** @brief 表示する点の先頭（トリガー点が左から 1/8 の位置に来るように） */
+    int16_t firstPoint() const {
+        return ScopeTap::PRE_POINTS - ZOOMS[zoomIndex].points / 8;
     }
 
     /** @brief 線形補間でサンプル値を取得 */
-    inline int16_t interpolateSample(const int16_t* wave, int32_t idx_x256) const {
+    inline int16_t interpolateSample(const int16_t* wave, int16_t count, int32_t idx_x256) const {
         int16_t idx  = static_cast<int16_t>(idx_x256 >> 8);
         int16_t frac = static_cast<int16_t>(idx_x256 & 0xFF);
-        if (idx >= SAMPLE_COUNT - 1) return wave[SAMPLE_COUNT - 1];
+        if (idx >= count - 1) return wave[count - 1];
         int32_t a = wave[idx];
         int32_t b = wave[idx + 1];
         return static_cast<int16_t>(a + ((b - a) * frac >> 8));
@@ -115,17 +106,18 @@ private:
 
     /**
      * @brief 波形描画
-     * ZOOM_SAMPLES[zoomIndex] サンプルを 128px に引き伸ばして描画。
-     * ズームインするほど少ないサンプルを画面幅に引き伸ばすため波形が拡大される。
+     * フレームの firstPoint() から ZOOMS[zoomIndex].points 点を 128px に引き伸ばして描画。
+     * ズームインするほど少ない点を画面幅に引き伸ばすため波形が拡大される。
      */
-    void drawWaveform(GFXcanvas16& canvas, const int16_t* wave, uint16_t color) {
-        const int16_t numSamples = ZOOM_SAMPLES[zoomIndex];
+    void drawWaveform(GFXcanvas16& canvas, const int16_t* frameWave, uint16_t color) {
+        const int16_t numSamples = ZOOMS[zoomIndex].points;
+        const int16_t* wave = frameWave + firstPoint();
         const int32_t step = ((numSamples - 1) * 256) / (SCREEN_WIDTH - 1);
 
-        int16_t prevY = sampleToY(interpolateSample(wave, 0));
+        int16_t prevY = sampleToY(interpolateSample(wave, numSamples, 0));
         for (int16_t x = 1; x < SCREEN_WIDTH; x++) {
             int32_t sampleIdx = static_cast<int32_t>(x) * step;
-            int16_t y = sampleToY(interpolateSample(wave, sampleIdx));
+            int16_t y = sampleToY(interpolateSample(wave, numSamples, sampleIdx));
             canvas.drawLine(x - 1, prevY, x, y, color);
             prevY = y;
         }
@@ -136,13 +128,8 @@ private:
         canvas.fillRect(0, 0, SCREEN_WIDTH, HEADER_H, Color::BLACK);
         canvas.setTextSize(1);
 
-        // タイトル
-        canvas.setTextColor(Color::WHITE);
-        canvas.setCursor(2, 2);
-        canvas.print("SCOPE");
-
         // チャンネル
-        canvas.setCursor(42, 2);
+        canvas.setCursor(2, 2);
         switch (displayMode) {
             case MODE_LR:
                 canvas.setTextColor(Color::CYAN);   canvas.print("L");
@@ -156,14 +143,22 @@ private:
             default: break;
         }
 
-        // 時間軸ズーム（1x以外のとき表示）
-        if (zoomIndex > 0) {
-            canvas.setTextColor(Color::YELLOW);
-            canvas.setCursor(64, 2);
-            canvas.print("T");
-            canvas.print(ZOOM_LABELS[zoomIndex]);
+        // トリガー（トリガーが来ずに出したフレームは AUTO）
+        const ScopeTap::Frame& frame = ScopeTap::frame();
+        canvas.setCursor(24, 2);
+        if (trigger != ScopeTap::FREE && frame.seq != 0 && !frame.triggered) {
+            canvas.setTextColor(Color::MD_GRAY);
+            canvas.print("AUTO");
+        } else {
+            canvas.setTextColor(Color::WHITE);
+            canvas.print(ScopeTap::name(trigger));
         }
 
+        // 時間軸（画面幅の時間）
+        canvas.setTextColor(Color::YELLOW);
+        canvas.setCursor(58, 2);
+        canvas.print(ZOOMS[zoomIndex].label);
+
         // フリーズ
         if (frozen) {
             canvas.setTextColor(Color::MD_RED);
@@ -190,24 +185,30 @@ private:
         canvas.setTextColor(Color::MD_GRAY);
         canvas.setCursor(2, footerY + 2);
         canvas.print("\x18\x19:CH \x1b\x1a:AMP");
-        canvas.setCursor(90, footerY + 2);
-        canvas.print("ET:FRZ");
+        canvas.setCursor(80, footerY + 2);
+        canvas.print("ET:FRZ/TRG");
     }
 
 public:
-    OscilloscopeScreen() {
-        memset(waveL, 0, sizeof(waveL));
-        memset(waveR, 0, sizeof(waveR));
+    const char* name() const override { return "OSCILLOSCOPE"; }
+    // 画面を閉じたら取り込みを止める
+    ~OscilloscopeScreen() override {
+        ScopeTap::setEnabled(false);
     }
 
     void onEnter(UIManager* manager) override {
         this->manager = manager;
         frozen = false;
-        hasData = false;
+        configureTap();
+        ScopeTap::setEnabled(true);
         manager->invalidate();
         manager->triggerFullTransfer();
     }
 
+    void onExit() override {
+        ScopeTap::setEnabled(false);
+    }
+
     bool isAnimated() const override { return true; }
 
     void handleInput(uint8_t button) override {
@@ -216,26 +217,31 @@ public:
             displayMode = static_cast<DisplayMode>(
                 (static_cast<uint8_t>(displayMode) + 1) % MODE_COUNT
             );
+            configureTap();
             manager->invalidate();
         }
         // UP 長押し: 時間軸ズームイン（波形を拡大）
         else if (button == BTN_UP_LONG) {
-            if (zoomIndex < ZOOM_STEPS - 1) zoomIndex++;
+            if (zoomIndex > 0) zoomIndex--;
+            configureTap();
             manager->invalidate();
         }
         // DN 長押し: 時間軸ズームアウト
         else if (button == BTN_DN_LONG) {
-            if (zoomIndex > 0) zoomIndex--;
+            if (zoomIndex < ZOOM_STEPS - 1) zoomIndex++;
+            configureTap();
             manager->invalidate();
         }
         // LEFT: 振幅ゲイン下げ
         else if (button == BTN_L || button == BTN_L_LONG) {
             if (gainIndex > 0) gainIndex--;
+            configureTap();
             manager->invalidate();
         }
         // RIGHT: 振幅ゲイン上げ
         else if (button == BTN_R || button == BTN_R_LONG) {
             if (gainIndex < GAIN_STEPS - 1) gainIndex++;
+            configureTap();
             manager->invalidate();
         }
         // ENTER: フリーズ / 解除
@@ -243,6 +249,12 @@ public:
             frozen = !frozen;
             manager->invalidate();
         }
+        // ENTER 長押し: トリガー切替 (FREE → EDGE → LEVEL → NOTE)
+        else if (button == BTN_ET_LONG) {
+            trigger = static_cast<ScopeTap::Trigger>((trigger + 1) % ScopeTap::TRIGGER_COUNT);
+            configureTap();
+            manager->invalidate();
+        }
         // CANCEL: 戻る
         else if (button == BTN_CXL) {
             manager->popScreen();
@@ -250,7 +262,8 @@ public:
     }
 
     void draw(GFXcanvas16& canvas) override {
-        if (!frozen) captureWaveform();
+        if (!frozen) ScopeTap::acquire();
+        const ScopeTap::Frame& frame = ScopeTap::frame();
 
         // 波形エリアクリア
         canvas.fillRect(0, WAVE_TOP, SCREEN_WIDTH, WAVE_HEIGHT + 1, Color::BLACK);
@@ -263,18 +276,27 @@ public:
             canvas.drawPixel(i, WAVE_CENTER + qH, Color::CHARCOAL);
         }
 
+        // トリガー位置
+        if (frame.seq != 0 && frame.triggered) {
+            const int16_t points = ZOOMS[zoomIndex].points;
+            const int16_t trigX = static_cast<int16_t>((points / 8) * (SCREEN_WIDTH - 1) / (points - 1));
+            for (int16_t y = WAVE_TOP; y <= WAVE_BOTTOM; y += 4) {
+                canvas.drawPixel(trigX, y, Color::CHARCOAL);
+            }
+        }
+
         // 波形描画
-        if (hasData) {
+        if (frame.seq != 0) {
             switch (displayMode) {
                 case MODE_LR:
-                    drawWaveform(canvas, waveR, Color::GREEN);
-                    drawWaveform(canvas, waveL, Color::CYAN);
+                    drawWaveform(canvas, frame.r, Color::GREEN);
+                    drawWaveform(canvas, frame.l, Color::CYAN);
                     break;
                 case MODE_L:
-                    drawWaveform(canvas, waveL, Color::CYAN);
+                    drawWaveform(canvas, frame.l, Color::CYAN);
                     break;
                 case MODE_R:
-                    drawWaveform(canvas, waveR, Color::GREEN);
+                    drawWaveform(canvas, frame.r, Color::GREEN);
                     break;
                 default: break;
             }
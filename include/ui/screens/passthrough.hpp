@@ -30,6 +30,7 @@ private:
     int8_t cursor = C_LPF;
 
 public:
+    const char* name() const override { return "PASSTHROUGH FXLIST"; }
     PassthroughFXListScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -224,6 +225,7 @@ private:
     bool pushingSubscreen_ = false;
 
 public:
+    const char* name() const override { return "PASSTHROUGH"; }
     PassthroughScreen() = default;
 
     void onEnter(UIManager* manager) override {
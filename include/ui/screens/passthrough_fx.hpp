@@ -31,6 +31,7 @@ private:
     const Gain_t MIX_STEP = 1024;
 
 public:
+    const char* name() const override { return "PASSTHROUGH LPF"; }
     PassthroughLPFScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -295,6 +296,7 @@ private:
     const Gain_t MIX_STEP = 1024;
 
 public:
+    const char* name() const override { return "PASSTHROUGH HPF"; }
     PassthroughHPFScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -558,6 +560,7 @@ private:
     const Gain_t FEEDBACK_STEP = Q15_MAX / 100;
 
 public:
+    const char* name() const override { return "PASSTHROUGH DELAY"; }
     PassthroughDelayScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -616,7 +619,8 @@ public:
             }
             else if (cursor == C_TIME) {
                 int32_t time = delay.getTime() + TIME_STEP;
-                if (time > MAX_TIME) time = MAX_TIME;
+                const int32_t max_time = delay.getMaxTime(); // アリーナの配分で変わる
+                if (time > max_time) time = max_time;
                 delay.setTime(time);
                 changed = true;
             }
@@ -785,6 +789,7 @@ private:
     const Gain_t MIX_STEP = 1024;
 
 public:
+    const char* name() const override { return "PASSTHROUGH CHORUS"; }
     PassthroughChorusScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -1037,6 +1042,7 @@ private:
     const Gain_t MIX_STEP = 1024;
 
 public:
+    const char* name() const override { return "PASSTHROUGH REVERB"; }
     PassthroughReverbScreen() = default;
 
     void onEnter(UIManager* manager) override {
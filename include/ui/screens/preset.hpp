@@ -21,6 +21,7 @@ private:
     // CPU使用率表示用
     float lastCpuUsage = 0.0f;
     uint32_t lastCpuUpdateMs = 0;
+    uint32_t lastUnderruns = 0;
     static constexpr uint32_t CPU_UPDATE_INTERVAL = 500; // 500msごとに更新
 
     // カーソル位置
@@ -37,6 +38,7 @@ private:
     int8_t cursor = C_PRESET;
 
 public:
+    const char* name() const override { return "PRESET"; }
     PresetScreen() = default;
 
     void onEnter(UIManager* manager) override {
@@ -239,7 +241,8 @@ public:
         float currentCpu = manager->getState().getCpuUsage();
         // 1%以上の変化があった場合、または500ms経過した場合に更新
         uint32_t now = millis();
-        if (abs(currentCpu - lastCpuUsage) >= 1.0f || (now - lastCpuUpdateMs >= CPU_UPDATE_INTERVAL)) {
+        if (abs(currentCpu - lastCpuUsage) >= 1.0f || (now - lastCpuUpdateMs >= CPU_UPDATE_INTERVAL)
+            || manager->getState().getUnderrunCount() != lastUnderruns) {
             lastCpuUsage = currentCpu;
             lastCpuUpdateMs = now;
             drawCpuUsage(canvas);
@@ -461,17 +464,27 @@ private:
 
     /**
      * @brief CPU使用率を画面右下（MENUの上）に描画
+     *
+     * アンダーランが起きていれば回数を赤で前に付ける (例: "X3 12%")
      */
     void drawCpuUsage(GFXcanvas16& canvas) {
         // Stateから現在のCPU使用率を取得
         float cpuUsage = manager->getState().getCpuUsage();
         lastCpuUsage = cpuUsage;
+        uint32_t underruns = manager->getState().getUnderrunCount();
+        lastUnderruns = underruns;
 
-        // 表示文字列作成 (例: "DSP:12%")
+        // 表示文字列作成 (例: "DSP:12%")  アンダーランありは "X3 12%" （99回で頭打ち）
+        char xrunStr[6] = "";
         char cpuStr[12];
-        sprintf(cpuStr, "DSP:%d%%", (int)cpuUsage);
+        if (underruns > 0) {
+            sprintf(xrunStr, "X%u", (unsigned)(underruns > 99 ? 99 : underruns));
+            sprintf(cpuStr, " %d%%", (int)cpuUsage);
+        } else {
+            sprintf(cpuStr, "DSP:%d%%", (int)cpuUsage);
+        }
 
-        int16_t strWidth = strlen(cpuStr) * 6;
+        int16_t strWidth = (strlen(xrunStr) + strlen(cpuStr)) * 6;
         int16_t x = SCREEN_WIDTH - strWidth - 4;  // 右寄せ
         int16_t y = FOOTER_Y - 10;  // MENUの上
 
@@ -491,8 +504,12 @@ private:
             color = Color::MD_GRAY;  // 通常
         }
 
-        canvas.setTextColor(color);
         canvas.setCursor(x, y);
+        if (xrunStr[0]) {
+            canvas.setTextColor(Color::RED);
+            canvas.print(xrunStr);
+        }
+        canvas.setTextColor(color);
         canvas.print(cpuStr);
 
         manager->transferPartial(clearX, y - 1, clearW, 10);
@@ -28,6 +28,9 @@ public:
     virtual void draw(GFXcanvas16& canvas) = 0;
     virtual bool isAnimated() const { return false; }
 
+    // クラッシュレポート用の画面名
+    virtual const char* name() const = 0;
+
     // シリアルコマンドなど外部からのパラメータ変更を画面に通知する
     virtual void notifyParamChanged() {
         if (manager) onEnter(manager);
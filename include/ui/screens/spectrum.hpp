@@ -0,0 +1,242 @@
+#pragma once
+
+#include "ui/ui.hpp"
+#include "modules/spectrum.hpp"
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief スペクトラム画面
+ * オーディオ出力（シンセ / パススルー）のスペクトルを対数周波数軸でリアルタイム表示する。
+ * FFT は画面ではなくメインループの FFT タスク (Spectrum::step()) が少しずつ進め、
+ * 画面は出来上がった列ごとのレベルを読むだけ。
+ *
+ * 操作:
+ *   UP / DN        : 周波数範囲 (20k / 11k / 5.5k / 2.7k。狭いほど低域が細かい)
+ *   LEFT / RIGHT   : FFT 点数 256 / 512
+ *   ENTER          : フリーズ / 解除
+ *   CANCEL         : 戻る
+ */
+class SpectrumScreen : public Screen {
+private:
+    // === レイアウト定数 ===
+    static constexpr int16_t HEADER_H    = 12;
+    static constexpr int16_t FOOTER_H    = 12;
+    static constexpr int16_t GRAPH_TOP    = HEADER_H + 1;
+    static constexpr int16_t GRAPH_BOTTOM = SCREEN_HEIGHT - FOOTER_H - 1;
+    static constexpr int16_t GRAPH_HEIGHT = GRAPH_BOTTOM - GRAPH_TOP;
+
+    // === 周波数範囲（間引き） ===
+    struct Range {
+        uint8_t decimation;
+        const char* label;  // 上限の周波数
+    };
+    static constexpr uint8_t RANGE_COUNT = 4;
+    static constexpr Range RANGES[RANGE_COUNT] = {
+        { 1, "20k" }, { 2, "11k" }, { 4, "5.5k" }, { 8, "2.7k" },
+    };
+    uint8_t rangeIndex = 0;
+
+    uint16_t fftSize = SpectrumTap::MAX_SIZE;
+    bool frozen = false;
+
+    // === 表示の減衰 ===
+    static constexpr uint8_t FALL_DB = 2;         // 1フレームで下がる量
+    static constexpr uint8_t PEAK_HOLD_FRAMES = 30;
+    uint8_t display[Spectrum::COLUMNS] = {};
+    uint8_t peak[Spectrum::COLUMNS] = {};
+    uint8_t peakHold[Spectrum::COLUMNS] = {};
+
+    // 目盛りの周波数
+    static constexpr uint8_t MARK_COUNT = 3;
+    static constexpr float MARK_HZ[MARK_COUNT] = { 100.0f, 1000.0f, 10000.0f };
+    static constexpr const char* MARK_LABELS[MARK_COUNT] = { "100", "1k", "10k" };
+
+    inline int16_t levelToY(uint8_t level) const {
+        return GRAPH_BOTTOM - static_cast<int16_t>(static_cast<int32_t>(level) * GRAPH_HEIGHT / Spectrum::DB_RANGE);
+    }
+
+    void configureAnalyzer() {
+        Spectrum::configure(fftSize, RANGES[rangeIndex].decimation);
+    }
+
+    /** @brief 新しいレベルを取り込み、下がるときはゆっくり下げる */
+    void updateLevels() {
+        const uint8_t* levels = Spectrum::levels();
+        for (uint16_t c = 0; c < Spectrum::COLUMNS; c++) {
+            const uint8_t fallen = display[c] > FALL_DB ? display[c] - FALL_DB : 0;
+            display[c] = levels[c] > fallen ? levels[c] : fallen;
+
+            if (display[c] >= peak[c]) {
+                peak[c] = display[c];
+                peakHold[c] = PEAK_HOLD_FRAMES;
+            } else if (peakHold[c] > 0) {
+                peakHold[c]--;
+            } else if (peak[c] > 0) {
+                peak[c]--;
+            }
+        }
+    }
+
+    // === グリッド描画 ===
+    void drawGrid(GFXcanvas16& canvas) {
+        // 20dB ごとの横線
+        for (uint8_t db = 20; db < Spectrum::DB_RANGE; db += 20) {
+            const int16_t y = levelToY(db);
+            for (int16_t x = 0; x < SCREEN_WIDTH; x += 4) {
+                canvas.drawPixel(x, y, Color::CHARCOAL);
+            }
+        }
+
+        // 100Hz / 1kHz / 10kHz の縦線とラベル
+        canvas.setTextSize(1);
+        canvas.setTextColor(Color::MD_GRAY);
+        for (uint8_t i = 0; i < MARK_COUNT; i++) {
+            const int16_t x = Spectrum::columnOf(MARK_HZ[i]);
+            if (x < 0) continue;
+            canvas.drawFastVLine(x, GRAPH_TOP, GRAPH_HEIGHT + 1, Color::DARK_SLATE);
+            canvas.setCursor(x + 2, GRAPH_TOP + 2);
+            canvas.print(MARK_LABELS[i]);
+        }
+    }
+
+    // === スペクトル描画 ===
+    void drawBars(GFXcanvas16& canvas) {
+        for (int16_t x = 0; x < Spectrum::COLUMNS; x++) {
+            if (display[x] > 0) {
+                const int16_t y = levelToY(display[x]);
+                const uint16_t color = display[x] >= Spectrum::DB_RANGE - 6 ? Color::MD_RED
+                                     : display[x] >= Spectrum::DB_RANGE - 20 ? Color::MD_YELLOW
+                                     : Color::MD_GREEN;
+                canvas.drawFastVLine(x, y, GRAPH_BOTTOM - y + 1, color);
+            }
+            if (peak[x] > 0) {
+                canvas.drawPixel(x, levelToY(peak[x]), Color::WHITE);
+            }
+        }
+    }
+
+    // === ヘッダー描画 ===
+    void drawHeader(GFXcanvas16& canvas) {
+        canvas.fillRect(0, 0, SCREEN_WIDTH, HEADER_H, Color::BLACK);
+        canvas.setTextSize(1);
+
+        // FFT 点数
+        canvas.setTextColor(Color::WHITE);
+        canvas.setCursor(2, 2);
+        canvas.print("N");
+        canvas.print(fftSize);
+
+        // 周波数範囲
+        canvas.setTextColor(Color::YELLOW);
+        canvas.setCursor(32, 2);
+        canvas.print(RANGES[rangeIndex].label);
+
+        // フリーズ
+        if (frozen) {
+            canvas.setTextColor(Color::MD_RED);
+            canvas.setCursor(64, 2);
+            canvas.print("FRZ");
+        }
+
+        // 1フレーム分の FFT の所要時間
+        char usStr[16];
+        snprintf(usStr, sizeof(usStr), "%luus", (unsigned long)Spectrum::frameUs());
+        canvas.setTextColor(Color::MD_GRAY);
+        canvas.setCursor(SCREEN_WIDTH - 2 - static_cast<int16_t>(strlen(usStr)) * 6, 2);
+        canvas.print(usStr);
+
+        canvas.drawFastHLine(0, HEADER_H, SCREEN_WIDTH, Color::DARK_SLATE);
+    }
+
+    // === フッター描画（CPU 使用率の横に FFT の分を並べる） ===
+    void drawFooter(GFXcanvas16& canvas) {
+        int16_t footerY = SCREEN_HEIGHT - FOOTER_H;
+        canvas.fillRect(0, footerY, SCREEN_WIDTH, FOOTER_H, Color::BLACK);
+        canvas.drawFastHLine(0, footerY, SCREEN_WIDTH, Color::DARK_SLATE);
+
+        char str[12];
+        canvas.setTextSize(1);
+        canvas.setTextColor(Color::MD_GRAY);
+        canvas.setCursor(2, footerY + 2);
+        snprintf(str, sizeof(str), "DSP:%d%%", (int)manager->getState().getCpuUsage());
+        canvas.print(str);
+
+        canvas.setCursor(56, footerY + 2);
+        snprintf(str, sizeof(str), "FFT:%.1f%%", Spectrum::load());
+        canvas.print(str);
+    }
+
+public:
+    const char* name() const override { return "SPECTRUM"; }
+    SpectrumScreen() = default;
+
+    // 画面を閉じたら解析を止める
+    ~SpectrumScreen() override {
+        Spectrum::setEnabled(false);
+    }
+
+    void onEnter(UIManager* manager) override {
+        this->manager = manager;
+        frozen = false;
+        memset(display, 0, sizeof(display));
+        memset(peak, 0, sizeof(peak));
+        memset(peakHold, 0, sizeof(peakHold));
+        configureAnalyzer();
+        Spectrum::setEnabled(true);
+        manager->invalidate();
+        manager->triggerFullTransfer();
+    }
+
+    void onExit() override {
+        Spectrum::setEnabled(false);
+    }
+
+    bool isAnimated() const override { return true; }
+
+    void handleInput(uint8_t button) override {
+        // UP / DN: 周波数範囲
+        if (button == BTN_UP || button == BTN_UP_LONG) {
+            if (rangeIndex > 0) rangeIndex--;
+            configureAnalyzer();
+            manager->invalidate();
+        }
+        else if (button == BTN_DN || button == BTN_DN_LONG) {
+            if (rangeIndex < RANGE_COUNT - 1) rangeIndex++;
+            configureAnalyzer();
+            manager->invalidate();
+        }
+        // LEFT / RIGHT: FFT 点数
+        else if (button == BTN_L || button == BTN_L_LONG) {
+            fftSize = 256;
+            configureAnalyzer();
+            manager->invalidate();
+        }
+        else if (button == BTN_R || button == BTN_R_LONG) {
+            fftSize = SpectrumTap::MAX_SIZE;
+            configureAnalyzer();
+            manager->invalidate();
+        }
+        // ENTER: フリーズ / 解除
+        else if (button == BTN_ET) {
+            frozen = !frozen;
+            manager->invalidate();
+        }
+        // CANCEL: 戻る
+        else if (button == BTN_CXL) {
+            manager->popScreen();
+        }
+    }
+
+    void draw(GFXcanvas16& canvas) override {
+        if (!frozen) updateLevels();
+
+        canvas.fillRect(0, GRAPH_TOP, SCREEN_WIDTH, GRAPH_HEIGHT + 1, Color::BLACK);
+        drawGrid(canvas);
+        drawBars(canvas);
+
+        drawHeader(canvas);
+        drawFooter(canvas);
+        manager->triggerFullTransfer();
+    }
+};
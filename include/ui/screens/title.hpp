@@ -10,6 +10,7 @@ private:
     const uint32_t UPDATE_INTERVAL = 33;
 
 public:
+    const char* name() const override { return "TITLE"; }
     void onEnter(UIManager* manager) override {
         this->manager = manager;
         frameCount = 0;
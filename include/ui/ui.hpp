@@ -10,13 +10,14 @@
 #include "display/gfx.hpp"
 #include "utils/state.hpp"
 #include "ui/screens/screen.hpp"
+#include "tools/postmortem.hpp"
 
 // #include "tools/midi_player.hpp"
 
 class UIManager {
 private:
     std::stack<Screen*> screenStack; // 画面をポインタで管理するスタック
-    GFXcanvas16 canvas;              // 描画用のキャンバス
+    TrackedCanvas canvas;            // 描画用のキャンバス（書き換えた範囲を記録）
     State& state_;
 
     int8_t playing = 0; //TODO TEST
@@ -24,12 +25,13 @@ private:
     bool renderRequired = true;
     bool fullTransferRequired = false;
 
+    uint32_t requestedBytes = 0;     // 以前の方式で送っていた転送量（GET DISPLAY の比較用）
+
     uint32_t lastFrameTime = 0;
-    static constexpr uint32_t MIN_FRAME_TIME = 66; // 15FPS制限
+    static constexpr uint32_t MIN_FRAME_TIME = 16; // 60FPS上限（実際の間隔はスケジューラが再生キューの余裕で決める）
 
 public:
-    UIManager(State& state)
-        : canvas(SCREEN_WIDTH, SCREEN_HEIGHT), state_(state) {}
+    UIManager(State& state) : state_(state) {}
 
     // スタックに残っている画面を全て削除
     ~UIManager() {
@@ -45,6 +47,7 @@ public:
             screenStack.top()->onExit();
         }
         screenStack.push(newScreen);
+        PostMortem::setScreen(newScreen->name());
         newScreen->onEnter(this);
         invalidate();
         triggerFullTransfer();
@@ -61,6 +64,7 @@ public:
             lastFrameTime = 0;
         }
         if (!screenStack.empty()) {
+            PostMortem::setScreen(screenStack.top()->name());
             screenStack.top()->onEnter(this);
         }
     }
@@ -89,8 +93,8 @@ public:
         //TODO ------------------------------------------------
     }
 
-    // 描画処理（ループ）
-    void render() {
+    // 入力処理（ループ）。描画より先に、描画を延ばしている間も呼ぶ
+    void poll() {
         // Stateを確認してボタンが押されていたらhandleInputを呼び出す
         auto btn_state = state_.getBtnState();
         if (btn_state != BTN_NONE) {
@@ -109,7 +113,10 @@ public:
         if (state_.consumeParamChanged() && !screenStack.empty()) {
             screenStack.top()->notifyParamChanged();
         }
+    }
 
+    // 描画処理（ループ）
+    void render() {
         // FPS制限
         uint32_t now = millis();
         if (now - lastFrameTime < MIN_FRAME_TIME) {
@@ -129,16 +136,19 @@ public:
         }
 
         if (fullTransferRequired) {
-            // 全画面転送
             if (!currentScreen) canvas.fillScreen(Color::BLACK);
-            GFX_SSD1351::flash(canvas);
+            requestedBytes += GFX_SSD1351::FULL_FRAME_BYTES;
             fullTransferRequired = false;
         }
+
+        // 描画で実際に変わった部分だけを転送
+        GFX_SSD1351::flashDirty(canvas, currentScreen ? currentScreen->name() : "-", requestedBytes);
+        requestedBytes = 0;
     }
 
     /**
      * @brief Canvasの再描画を要求 (draw()が呼ばれる)
-     * ディスプレイへの転送は予約しない。Screen::draw内で明示する必要がある。
+     * 描いて変わった部分はそのフレームの最後にディスプレイへ転送される。
      */
     void invalidate() {
         renderRequired = true;
@@ -146,18 +156,30 @@ public:
 
     /**
      * @brief 次のフレームで「全画面」をディスプレイに転送予約する
+     *
+     * 転送はキャンバスに描いた範囲から自動で決まるので、実際に送るのは変わった部分だけ。
+     * transferPartial() と合わせて、以前の方式の転送量として GET DISPLAY で比較に使う。
      */
     void triggerFullTransfer() {
         fullTransferRequired = true;
     }
 
     void transferPartial(int16_t x, int16_t y, int16_t w, int16_t h) {
-        if (!fullTransferRequired) {
-            GFX_SSD1351::flashWindow(canvas, x, y, w, h);
-        }
+        if (fullTransferRequired) return;
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+        if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+        if (w <= 0 || h <= 0) return;
+        requestedBytes += static_cast<uint32_t>(w) * h * 2 + h * GFX_SSD1351::WINDOW_BYTES;
     }
 
     State& getState() {
         return state_;
     }
+
+    // 描画用キャンバス（ホストの panel コマンドが転送結果と照合する）
+    const TrackedCanvas& getCanvas() const {
+        return canvas;
+    }
 };
\ No newline at end of file
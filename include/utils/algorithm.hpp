@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include "utils/placement.hpp"
 
 constexpr uint8_t MAX_OPERATORS = 6;
 
@@ -44,7 +45,7 @@ public:
 
 private:
     // ヘッダ内で実体を定義するために inline を使用 (C++17~)
-    static inline const Algorithm algorithms_[32] = {
+    static inline const Algorithm algorithms_[32] PLACE_HOT = {
 
         // --- No.1 ---
         // [1]->[0], [5*]->[4]->[3]->[2]
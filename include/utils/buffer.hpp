@@ -96,4 +96,73 @@ public:
         read_idx = (read_idx + 1) % RB_SIZE;
         write_idx = (write_idx + 1) % RB_SIZE;
     }
-};
\ No newline at end of file
+};
+
+/**
+ * @brief 外部メモリを使う IntervalRingBuffer
+ *
+ * バッファ本体を持たず、attach() で貸し出された領域を使用する。
+ * サイズは実行時に決まる（EffectArena からの貸し出し用）。
+ */
+template <typename T>
+class ExternalIntervalRingBuffer {
+private:
+    int32_t read_idx = 0;
+    int32_t write_idx = 0;
+    int32_t size = 0;
+    T* buff = nullptr;
+
+public:
+    /**
+     * @brief バッファ領域を割り当てる（内容はクリアされる）
+     *
+     * @param mem バッファ領域 (nullptr で切り離し)
+     * @param len 要素数
+     */
+    void attach(T* mem, int32_t len) {
+        buff = mem;
+        size = (mem != nullptr) ? len : 0;
+        reset();
+    }
+
+    bool isAttached() const { return buff != nullptr && size > 0; }
+    int32_t capacity() const { return size; }
+
+    void reset() {
+        write_idx = 0;
+        read_idx = size / 2;
+
+        // バッファを初期化
+        for (int32_t i = 0; i < size; ++i) {
+            buff[i] = T();  // 型Tの初期値で埋める
+        }
+    }
+
+    void setInterval(int32_t interval) {
+        if (size <= 0) return;
+        interval = interval % size;
+        if(interval <= 0) {
+            interval = 1;
+        }
+        write_idx = (read_idx + interval) % size;
+    }
+
+    void write(T in) {
+        buff[write_idx] = in;
+    }
+
+    T read(int32_t index = 0) {
+        int32_t tmp = read_idx + index;
+        while(tmp < 0) {
+            tmp += size;
+        }
+        tmp = tmp % size;
+
+        return buff[tmp];
+    }
+
+    void update() {
+        if (++read_idx >= size) read_idx = 0;
+        if (++write_idx >= size) write_idx = 0;
+    }
+};
@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include "types.hpp"
+#include "utils/placement.hpp"
 
 /** ベロシティカーブの種類 */
 enum class VelocityCurve : uint8_t {
@@ -15,7 +16,7 @@ enum class VelocityCurve : uint8_t {
 class AudioMath {
 public:
     // 0 = L100%, 100 = C, 200 = R100%
-    static inline const int16_t PAN_SIN_TABLE[201] = {
+    static inline const int16_t PAN_SIN_TABLE[201] PLACE_COLD = {
             0,   257,   515,   772,  1029,  1286,  1544,  1801,  2057,  2314,
          2571,  2827,  3084,  3340,  3596,  3851,  4107,  4362,  4617,  4872,
          5126,  5380,  5634,  5887,  6140,  6393,  6645,  6897,  7148,  7399,
@@ -40,7 +41,7 @@ public:
     };
 
     // 0 = L100%, 100 = C, 200 = R100%
-    static inline const int16_t PAN_COS_TABLE[201] = {
+    static inline const int16_t PAN_COS_TABLE[201] PLACE_COLD = {
         32767, 32766, 32763, 32758, 32751, 32742, 32731, 32717, 32702, 32685,
         32666, 32645, 32622, 32596, 32569, 32540, 32509, 32475, 32440, 32403,
         32364, 32322, 32279, 32234, 32187, 32137, 32086, 32033, 31978, 31921,
@@ -65,7 +66,7 @@ public:
     };
 
     // MIDI Note (0-127) to Frequency Table
-    static inline const float NOTE_FREQ_TABLE[128] = {
+    static inline const float NOTE_FREQ_TABLE[128] PLACE_COLD = {
            8.176f,    8.662f,    9.177f,    9.723f,    10.301f,    10.913f,    11.562f,    12.250f,   12.978f,   13.750f,   14.568f,   15.434f,
           16.352f,   17.324f,   18.354f,   19.445f,    20.602f,    21.827f,    23.125f,    24.500f,   25.957f,   27.500f,   29.135f,   30.868f,
           32.703f,   34.648f,   36.708f,   38.891f,    41.203f,    43.654f,    46.249f,    49.000f,   51.913f,   55.000f,   58.270f,   61.735f,
@@ -85,7 +86,7 @@ public:
     // ベロシティテーブル
     // velocity 0-127 を 64エントリに圧縮（velocity >> 1 でインデックス）
     // 出力は 0-254 の範囲、非線形カーブで低ベロシティの感度が高い
-    static inline const uint8_t VELOCITY_TABLE[64] = {
+    static inline const uint8_t VELOCITY_TABLE[64] PLACE_COLD = {
         0, 70, 86, 97, 106, 114, 121, 126, 132, 138, 142, 148, 152, 156, 160, 163,
         166, 170, 173, 174, 178, 181, 184, 186, 189, 190, 194, 196, 198, 200, 202,
         205, 206, 209, 211, 214, 216, 218, 220, 222, 224, 225, 227, 229, 230, 232,
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+// ============================================
+// メモリ配置ポリシー (Teensy 4.1 / i.MX RT1062)
+// ============================================
+//
+// | 領域   | アドレス     | 速度                   | 用途                          |
+// |--------|--------------|------------------------|-------------------------------|
+// | ITCM   | 0x00000000～ | 1サイクル (命令)       | FASTRUN 関数                  |
+// | DTCM   | 0x20000000～ | 1サイクル (データ)     | 毎サンプル参照するテーブル    |
+// | OCRAM  | 0x20200000～ | キャッシュ経由         | 大きな作業バッファ            |
+// | FLASH  | 0x60000000～ | キャッシュ経由・低速   | 初期化/UI でのみ読むデータ    |
+//
+// Teensy 4 のリンカスクリプトでは .data / .rodata / .bss は既定で DTCM に置かれる。
+// そのため const を付けただけのテーブルはフラッシュではなく DTCM を消費する。
+// 以下のマクロで「どこに置きたいか」を宣言側に明示し、
+// ビルド後に extra_script.py の配置レポートで実際の配置を確認する。
+
+// 毎サンプル参照するテーブル → DTCM
+// 目印だけのマクロで、何にも展開されない。DTCM に置かれるのはリンカスクリプトの既定配置によるもので、
+// 付けても外しても配置は変わらない。実際に DTCM に載ったかは配置レポートで確かめる
+#define PLACE_HOT
+
+// ノートオン時・プリセットロード時・UI でのみ参照するデータ → フラッシュ
+#define PLACE_COLD PROGMEM
+
+// 大きな作業バッファ → OCRAM（起動時に初期化されないので使用前にクリアすること）
+#define PLACE_BULK DMAMEM
+
+// リセットをまたいで残すデータ → OCRAM（起動時に初期化されない性質を使う）
+// キャッシュ経由なので、書いたらリセットの前に arm_dcache_flush() すること。電源投入直後は不定値
+#define PLACE_RETAINED DMAMEM
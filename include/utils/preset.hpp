@@ -4,6 +4,7 @@
 #include <cmath>
 #include <array>
 #include "types.hpp"
+#include "utils/placement.hpp"
 
 // プリセット最大数
 constexpr uint8_t MAX_PRESETS = 39;
@@ -201,7 +202,7 @@ public:
 
 private:
     // デフォルトプリセットデータ
-    static inline const SynthPreset presets_[MAX_PRESETS] = {
+    static inline const SynthPreset presets_[MAX_PRESETS] PLACE_COLD = {
         // --- Preset 1: Simple Sine ---
         {
             "Simple Sine",  // name
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "modules/effect_arena.hpp"
+
+// ============================================
+// エンジン状態スナップショットの形式
+// ============================================
+//
+// [SnapshotHeader][Synth のフィールド列][Delay][Filter][Chorus][Reverb][エフェクトバッファ (任意)]
+//
+// フィールドはメモリイメージのまま並べる。オシレーターの波形テーブルや
+// エフェクトのバッファはポインタで持っているので、同じビルドの中でだけ復元できる
+// （build_id で確認する）。ビルドをまたいで音色を持ち出すのはプリセットの役目。
+
+constexpr uint16_t SNAPSHOT_VERSION = 1;
+
+// SnapshotHeader::flags
+constexpr uint16_t SNAPSHOT_FX_BUFFERS = 1 << 0;  // エフェクトバッファ（残響テール）を含む
+
+struct SnapshotHeader {
+    char     magic[4];   // "CRSN"
+    uint16_t version;
+    uint16_t flags;
+    uint32_t size;       // ヘッダを含む全体のバイト数
+    uint32_t build_id;   // 型サイズと静的テーブルの位置から作る。一致しなければ復元しない
+    EffectArena::Layout layout;  // 保存時のエフェクトバッファ配置
+};
+
+enum class SnapshotStatus : uint8_t {
+    OK = 0,
+    NO_SPACE,        // 保存先が小さい
+    BAD_MAGIC,
+    BAD_VERSION,
+    BUILD_MISMATCH,  // 別のビルドで保存された
+    TRUNCATED,       // 長さがヘッダと合わない
+};
+
+inline const char* snapshotStatusName(SnapshotStatus s) {
+    switch (s) {
+        case SnapshotStatus::OK:             return "OK";
+        case SnapshotStatus::NO_SPACE:       return "NO SPACE";
+        case SnapshotStatus::BAD_MAGIC:      return "BAD MAGIC";
+        case SnapshotStatus::BAD_VERSION:    return "BAD VERSION";
+        case SnapshotStatus::BUILD_MISMATCH: return "BUILD MISMATCH";
+        case SnapshotStatus::TRUNCATED:      return "TRUNCATED";
+    }
+    return "?";
+}
+
+// --------------
+// フィールド列の読み書き
+// --------------
+// 同じフィールド列を SnapshotSizer / SnapshotWriter / SnapshotReader に通すことで
+// サイズ計算・保存・復元の並びが食い違わないようにする。
+
+class SnapshotSizer {
+public:
+    size_t size = 0;
+
+    template <typename T>
+    void field(T&) {
+        static_assert(std::is_trivially_copyable<std::remove_volatile_t<std::remove_all_extents_t<T>>>::value,
+                      "snapshot fields must be trivially copyable");
+        size += sizeof(T);
+    }
+    void bytes(void*, size_t len) { size += len; }
+};
+
+class SnapshotWriter {
+private:
+    uint8_t* p_;
+
+public:
+    explicit SnapshotWriter(uint8_t* dst) : p_(dst) {}
+
+    template <typename T>
+    void field(T& v) {
+        std::memcpy(p_, const_cast<const std::remove_volatile_t<T>*>(&v), sizeof(T));
+        p_ += sizeof(T);
+    }
+    void bytes(void* src, size_t len) {
+        std::memcpy(p_, src, len);
+        p_ += len;
+    }
+};
+
+class SnapshotReader {
+private:
+    const uint8_t* p_;
+
+public:
+    explicit SnapshotReader(const uint8_t* src) : p_(src) {}
+
+    template <typename T>
+    void field(T& v) {
+        std::memcpy(const_cast<std::remove_volatile_t<T>*>(&v), p_, sizeof(T));
+        p_ += sizeof(T);
+    }
+    void bytes(void* dst, size_t len) {
+        std::memcpy(dst, p_, len);
+        p_ += len;
+    }
+};
@@ -54,6 +54,10 @@ public:
     float getCpuUsage() const { return cpu_usage; }
     void setCpuUsage(float value) { cpu_usage = value; }
 
+    // アンダーラン（出力の途切れ）回数
+    uint32_t getUnderrunCount() const { return underrun_count; }
+    void setUnderrunCount(uint32_t value) { underrun_count = value; }
+
     // エンコーダーデルタ（回転量蓄積）
     void addEncoderDelta(int16_t d) {
         encoder_delta_.fetch_add(d, std::memory_order_relaxed);
@@ -73,6 +77,7 @@ private:
     uint8_t mode_state = MODE_TITLE;
     uint8_t btn_state = BTN_NONE;
     float cpu_usage = 0.0f;
+    uint32_t underrun_count = 0;
     std::atomic<int16_t> encoder_delta_{0};
     std::atomic<bool> param_changed_{false};
 };
\ No newline at end of file
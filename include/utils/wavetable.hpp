@@ -1,10 +1,11 @@
 #pragma once
 
 #include "types.hpp"
+#include "utils/placement.hpp"
 
 class Wavetable {
 public:
-	static inline const Audio24_t sine[512] = {
+	static inline const Audio24_t sine[512] PLACE_HOT = {
 		        0,    102941,    205867,    308761,    411609,    514396,    617104,    719720,
 		   822227,    924611,   1026855,   1128945,   1230864,   1332599,   1434132,   1535450,
 		  1636536,   1737376,   1837954,   1938256,   2038265,   2137968,   2237349,   2336392,
@@ -71,7 +72,7 @@ public:
 		  -822227,   -719720,   -617104,   -514396,   -411609,   -308761,   -205867,   -102941,
 	};
 
-	static inline const Audio24_t triangle[512] = {
+	static inline const Audio24_t triangle[512] PLACE_HOT = {
 		        0,     65536,    131072,    196608,    262144,    327680,    393216,    458752,
 		   524288,    589824,    655360,    720896,    786432,    851968,    917504,    983040,
 		  1048576,   1114112,   1179648,   1245184,   1310720,   1376256,   1441792,   1507328,
@@ -138,7 +139,7 @@ public:
 		  -524288,   -458752,   -393216,   -327680,   -262144,   -196608,   -131072,    -65536,
 	};
 
-	static inline const Audio24_t saw[512] = {
+	static inline const Audio24_t saw[512] PLACE_HOT = {
 		  8388607,   8355839,   8323071,   8290303,   8257535,   8224767,   8191999,   8159231,
 		  8126463,   8093695,   8060927,   8028159,   7995391,   7962623,   7929855,   7897087,
 		  7864319,   7831551,   7798783,   7766015,   7733247,   7700479,   7667711,   7634943,
@@ -205,7 +206,7 @@ public:
 		 -8126463,  -8159231,  -8191999,  -8224767,  -8257535,  -8290303,  -8323071,  -8355839,
 	};
 
-	static inline const Audio24_t square[512] = {
+	static inline const Audio24_t square[512] PLACE_HOT = {
 		  8388607,   8388607,   8388607,   8388607,   8388607,   8388607,   8388607,   8388607,
 		  8388607,   8388607,   8388607,   8388607,   8388607,   8388607,   8388607,   8388607,
 		  8388607,   8388607,   8388607,   8388607,   8388607,   8388607,   8388607,   8388607,
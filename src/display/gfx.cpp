@@ -0,0 +1,130 @@
+#include "display/gfx.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/placement.hpp"
+
+PLACE_BULK uint16_t GFX_SSD1351::shadow_[SCREEN_WIDTH * SCREEN_HEIGHT];
+TransferStat GFX_SSD1351::stats_[STAT_SCREENS] = {};
+
+void GFX_SSD1351::begin() {
+    display.begin(OLED_SPI_SPEED);
+    display.setRotation(0);
+    display.fillScreen(Color::BLACK);
+
+    // DMAMEM は起動時に初期化されないので、消した画面に合わせておく
+    std::fill(shadow_, shadow_ + SCREEN_WIDTH * SCREEN_HEIGHT, Color::BLACK);
+}
+
+// 1つの窓に矩形を送り、送った内容を写しに残す
+void GFX_SSD1351::sendRect(TrackedCanvas& canvas, int16_t x, int16_t y, int16_t w, int16_t h,
+                           int16_t& rows, uint32_t& windows) {
+    Profiler::Scope probe(Profiler::FLASH);
+    uint16_t* buf = canvas.getBuffer();
+
+    display.startWrite();
+    display.setAddrWindow(x, y, w, h);
+    ++windows;
+    for (int16_t row = y; row < y + h; ++row) {
+        uint16_t* ptr = buf + row * SCREEN_WIDTH + x;
+        display.writePixels(ptr, w);
+        std::memcpy(shadow_ + row * SCREEN_WIDTH + x, ptr, w * sizeof(uint16_t));
+
+        // オーディオ処理を挟んだら残りの行で窓を設定し直す
+        if (audioBreak(rows, row) && row + 1 < y + h) {
+            display.setAddrWindow(x, row + 1, w, y + h - row - 1);
+            ++windows;
+        }
+    }
+    display.endWrite();
+}
+
+void GFX_SSD1351::flashDirty(TrackedCanvas& canvas, const char* screen, uint32_t requested) {
+    const uint16_t* buf = canvas.getBuffer();
+    uint32_t sent = 0;
+    uint32_t windows = 0;
+    int16_t rows = 0;
+
+    // まとめている矩形 [bx0, bx1] x [by0, y - 1]
+    bool open = false;
+    int16_t bx0 = 0, bx1 = 0, by0 = 0;
+    auto emit = [&](int16_t by1) {
+        const int16_t w = bx1 - bx0 + 1;
+        const int16_t h = by1 - by0 + 1;
+        sendRect(canvas, bx0, by0, w, h, rows, windows);
+        sent += static_cast<uint32_t>(w) * h * 2;
+    };
+
+    for (int16_t y = 0; y < SCREEN_HEIGHT; ++y) {
+        int16_t l, r;
+        bool changed = canvas.dirtyRow(y, l, r);
+        if (changed) {
+            // 前回送った内容と同じ両端を削る
+            const uint16_t* now = buf + y * SCREEN_WIDTH;
+            const uint16_t* old = shadow_ + y * SCREEN_WIDTH;
+            while (l <= r && now[l] == old[l]) ++l;
+            while (r >= l && now[r] == old[r]) --r;
+            changed = l <= r;
+        }
+        if (!changed) {
+            if (open) emit(y - 1);
+            open = false;
+            continue;
+        }
+
+        if (open) {
+            // 広げてまとめるほうが、窓を分けるより安ければまとめる
+            const int16_t nx0 = std::min(bx0, l);
+            const int16_t nx1 = std::max(bx1, r);
+            const uint32_t band_rows = y - by0;
+            const uint32_t merged = static_cast<uint32_t>(nx1 - nx0 + 1) * (band_rows + 1) * 2;
+            const uint32_t apart = static_cast<uint32_t>(bx1 - bx0 + 1) * band_rows * 2
+                                 + static_cast<uint32_t>(r - l + 1) * 2 + WINDOW_BYTES;
+            if (merged <= apart) {
+                bx0 = nx0;
+                bx1 = nx1;
+                continue;
+            }
+            emit(y - 1);
+        }
+        bx0 = l;
+        bx1 = r;
+        by0 = y;
+        open = true;
+    }
+    if (open) emit(SCREEN_HEIGHT - 1);
+    canvas.clearDirty();
+
+    if (requested == 0 && windows == 0) return;
+    sent += windows * WINDOW_BYTES;
+
+    for (TransferStat& st : stats_) {
+        if (st.screen && std::strcmp(st.screen, screen) != 0) continue;
+        st.screen = screen;
+        ++st.frames;
+        st.requested += requested;
+        st.sent += sent;
+        st.windows += windows;
+        return;
+    }
+    // 表が埋まったら集計しない
+}
+
+void GFX_SSD1351::printStats() {
+    Serial.printf("DISPLAY: bytes/frame (full frame %lu)\n", (unsigned long)FULL_FRAME_BYTES);
+    Serial.printf("  %-14s %7s %8s %8s %6s %6s\n", "SCREEN", "FRAMES", "BEFORE", "AFTER", "SAVED", "WIN/F");
+    for (const TransferStat& st : stats_) {
+        if (!st.screen || st.frames == 0) continue;
+        const double before = static_cast<double>(st.requested) / st.frames;
+        const double after = static_cast<double>(st.sent) / st.frames;
+        Serial.printf("  %-14s %7lu %8lu %8lu %5.1f%% %6.1f\n", st.screen, (unsigned long)st.frames,
+            (unsigned long)before, (unsigned long)after,
+            before > 0 ? 100.0 * (before - after) / before : 0.0,
+            static_cast<double>(st.windows) / st.frames);
+    }
+}
+
+void GFX_SSD1351::clearStats() {
+    for (TransferStat& st : stats_) st = TransferStat{};
+}
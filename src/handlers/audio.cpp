@@ -1,4 +1,7 @@
 #include "handlers/audio.hpp"
+#include "tools/trace.hpp"
+
+#include <cstring>
 
 Sample16_t samples_L[BUFFER_SIZE];
 Sample16_t samples_R[BUFFER_SIZE];
@@ -15,21 +18,186 @@ void AudioHandler::init() {
     AudioMemory(AUDIO_MEMORY);
 }
 
+/**
+ * @brief 再生キューの出力を1ブロックぶん監視（オーディオ割り込み）
+ *
+ * queue_L が送り出したブロックを受け取れなければ、そのサイクルは I2S が無音を出している。
+ */
+void AudioQueueProbe::update() {
+    audio_block_t* block = receiveReadOnly(0);
+    if (block) {
+        ++consumed_;
+        release(block);
+        was_starved_ = false;
+        return;
+    }
+    if (!armed_) {
+        was_starved_ = false;
+        return;
+    }
+    ++starved_;
+    if (!was_starved_) {
+        event_time_ms_ = millis();
+        ++events_;
+        was_starved_ = true;
+    }
+}
+
 /** @brief バッファに格納されたオーディオデータを再生 */
 void AudioHandler::process() {
-    if(!samples_ready_flags.load()) return;
+    // パススルーが直接キューへ送った分などで数がずれたら合わせ直す
+    const uint32_t consumed = probe.consumed();
+    if (static_cast<int32_t>(pushed_ - consumed) < 0) pushed_ = consumed;
+
+    // オーディオ割り込みで検出した枯渇をイベントとして記録
+    const uint32_t events = probe.events();
+    if (events != seen_events_) {
+        seen_events_ = events;
+        logEvent(UNDERRUN_STARVED, probe.eventTimeMs());
+        recovering_ = true;
+        if (policy_ == UnderrunPolicy::SHED && source_voices_ > 1) {
+            ++shed_request_;
+            ++shed_;
+        }
+    }
+
+    if(!samples_ready_flags.load()) {
+        // 音源が間に合っていない: キューが空になるたびに1ブロックずつ補填
+        if (recovering_ && armed_ && policy_ != UnderrunPolicy::NONE && queueDepth() == 0) {
+            fillBlock();
+        }
+        return;
+    }
 
     if(queue_L.available() && queue_R.available()
         && queue_LM.available() && queue_RM.available()){
+        if (source_active_ && !armed_) {
+            // 連続再生の開始（ここから先の空のキューを枯渇として数える）
+            armed_ = true;
+            probe.arm(true);
+        }
+        else if (armed_ && !recovering_ && queueDepth() == 0) {
+            ++late_;
+            logEvent(UNDERRUN_LATE, millis());
+        }
+
         state_.setLedAudio(true);
-        queue_L.play(samples_L, BUFFER_SIZE);
-        queue_R.play(samples_R, BUFFER_SIZE);
-        queue_LM.play(samples_LM, BUFFER_SIZE);
-        queue_RM.play(samples_RM, BUFFER_SIZE);
+        playBlock(samples_L, samples_R, samples_LM, samples_RM);
         samples_ready_flags.store(false);
+
+        if (policy_ == UnderrunPolicy::REPEAT) {
+            memcpy(last_L_, samples_L, sizeof(last_L_));
+            memcpy(last_R_, samples_R, sizeof(last_R_));
+            fade_gain_ = Q15_MAX;
+        }
+        recovering_ = false;
+    }
+}
+
+/**
+ * @brief 音源の状態を伝える
+ *
+ * 音源が止まったら監視を解除する（最後のブロックを出し切ってキューが空になるのは正常）。
+ */
+void AudioHandler::setSource(bool active, uint8_t voices, uint8_t fx) {
+    source_active_ = active;
+    source_voices_ = voices;
+    source_fx_ = fx;
+    if (!active && armed_) {
+        armed_ = false;
+        recovering_ = false;
+        fade_gain_ = 0;
+        probe.arm(false);
     }
 }
 
+uint32_t AudioHandler::queueDepth() const {
+    const uint32_t consumed = probe.consumed();
+    return static_cast<int32_t>(pushed_ - consumed) > 0 ? pushed_ - consumed : 0;
+}
+
+uint32_t AudioHandler::headroomUs() const {
+    if (!source_active_) return UINT32_MAX;
+    constexpr uint32_t BLOCK_US = static_cast<uint32_t>(1000000ULL * BUFFER_SIZE / SAMPLE_RATE);
+    return (queueDepth() + (samples_ready_flags.load() ? 1 : 0)) * BLOCK_US;
+}
+
+void AudioHandler::playBlock(const Sample16_t* l, const Sample16_t* r, const Sample16_t* lm, const Sample16_t* rm) {
+    queue_L.play(l, BUFFER_SIZE);
+    queue_R.play(r, BUFFER_SIZE);
+    queue_LM.play(lm, BUFFER_SIZE);
+    queue_RM.play(rm, BUFFER_SIZE);
+    ++pushed_;
+}
+
+/**
+ * @brief 補填ブロックを送る
+ *
+ * REPEAT: 直前の実ブロックを、1ブロックごとにゲインが半分になるよう直線で絞りながら繰り返す。
+ *         -42dB を下回ったら無音に切り替える。
+ * SILENCE / SHED: 無音ブロック。
+ */
+void AudioHandler::fillBlock() {
+    if(!(queue_L.available() && queue_R.available()
+        && queue_LM.available() && queue_RM.available())) return;
+
+    Sample16_t l[BUFFER_SIZE], r[BUFFER_SIZE], lm[BUFFER_SIZE], rm[BUFFER_SIZE];
+
+    if (policy_ == UnderrunPolicy::REPEAT && fade_gain_ > 0) {
+        constexpr Gain_t FADE_FLOOR = 256;  // ≈ -42dB
+        const int32_t g0 = fade_gain_;
+        const int32_t g1 = g0 >> 1;
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            const int32_t g = g0 - static_cast<int32_t>((g0 - g1) * static_cast<int32_t>(i) / static_cast<int32_t>(BUFFER_SIZE));
+            l[i] = static_cast<Sample16_t>((static_cast<int32_t>(last_L_[i]) * g) >> 15);
+            r[i] = static_cast<Sample16_t>((static_cast<int32_t>(last_R_[i]) * g) >> 15);
+        }
+        fade_gain_ = g1 < FADE_FLOOR ? 0 : static_cast<Gain_t>(g1);
+    }
+    else {
+        memset(l, 0, sizeof(l));
+        memset(r, 0, sizeof(r));
+    }
+
+    for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+        lm[i] = static_cast<Sample16_t>(-l[i]);
+        rm[i] = static_cast<Sample16_t>(-r[i]);
+    }
+
+    playBlock(l, r, lm, rm);
+    ++filled_;
+}
+
+void AudioHandler::logEvent(uint8_t kind, uint32_t time_ms) {
+    UnderrunEvent& e = log_[log_head_];
+    e.time_ms = time_ms;
+    e.kind = kind;
+    e.voices = source_voices_;
+    e.fx = source_fx_;
+    log_head_ = (log_head_ + 1) % UNDERRUN_LOG_SIZE;
+    ++log_total_;
+    Trace::event(Trace::UNDERRUN, kind);
+
+    if (kind == UNDERRUN_STARVED) state_.setUnderrunCount(getStarvedEvents());
+}
+
+const UnderrunEvent* AudioHandler::getEvent(uint8_t index) const {
+    const uint32_t stored = log_total_ < UNDERRUN_LOG_SIZE ? log_total_ : UNDERRUN_LOG_SIZE;
+    if (index >= stored) return nullptr;
+    return &log_[(log_head_ + UNDERRUN_LOG_SIZE - 1 - index) % UNDERRUN_LOG_SIZE];
+}
+
+void AudioHandler::clearUnderrunStats() {
+    starved_base_ = probe.starved();
+    events_base_ = probe.events();
+    late_ = 0;
+    filled_ = 0;
+    shed_ = 0;
+    log_head_ = 0;
+    log_total_ = 0;
+    state_.setUnderrunCount(0);
+}
+
 /** @brief 録音開始 */ // TODO
 void AudioHandler::beginRecord() {
     rec_L.clear();
@@ -48,6 +48,7 @@ void MIDIHandler::handleNoteOn(uint8_t ch, uint8_t note, uint8_t velocity) {
     if(!isValidNoteOn(note, velocity)) return;
 
     if (state_.getModeState() == MODE_SYNTH) {
+        Capture::midi(source_, 0x90, ch, note, velocity);
         Synth::getInstance().noteOn(note, velocity, ch);
     }
 }
@@ -63,6 +64,7 @@ void MIDIHandler::handleNoteOff(uint8_t ch, uint8_t note, uint8_t velocity) {
     if(!isValidNoteOff(note, velocity)) return;
 
     if (state_.getModeState() == MODE_SYNTH) {
+        Capture::midi(source_, 0x80, ch, note, velocity);
         Synth::getInstance().noteOff(note, ch);
     }
 }
@@ -73,11 +75,13 @@ void MIDIHandler::process() {
 
     // USB MIDI: バッファ内の全メッセージを処理（whileで排出）
     // Note On/Off, Pitch Bend はすべてコールバックで自動処理
+    source_ = Capture::SRC_USB;
     while(usbMIDI.read()) {
         midi_activity = true;
     }
 
     // Serial MIDI: バッファ内の全メッセージを処理
+    source_ = Capture::SRC_SERIAL7;
     while(MIDI.read()) {
         midi_activity = true;
     }
@@ -103,6 +107,7 @@ void MIDIHandler::handleNoteOffStatic(uint8_t ch, uint8_t note, uint8_t velocity
  */
 void MIDIHandler::handlePitchBendStaticUsb(uint8_t ch, int bend) {
     if (instance && instance->state_.getModeState() == MODE_SYNTH) {
+        Capture::pitchBend(Capture::SRC_USB, ch, static_cast<int16_t>(bend - 8192));
         Synth::getInstance().setPitchBend(static_cast<int16_t>(bend - 8192));
     }
 }
@@ -113,6 +118,7 @@ void MIDIHandler::handlePitchBendStaticUsb(uint8_t ch, int bend) {
  */
 void MIDIHandler::handlePitchBendStaticSerial(uint8_t ch, int bend) {
     if (instance && instance->state_.getModeState() == MODE_SYNTH) {
+        Capture::pitchBend(Capture::SRC_SERIAL7, ch, static_cast<int16_t>(bend));
         Synth::getInstance().setPitchBend(static_cast<int16_t>(bend));
     }
 }
@@ -145,6 +151,7 @@ void MIDIHandler::handleControlChangeStaticSerial(uint8_t ch, uint8_t cc, uint8_
  * @param value 値
  */
 void MIDIHandler::handleControlChange(uint8_t ch, uint8_t cc, uint8_t value) {
+    Capture::midi(source_, 0xB0, ch, cc, value);
     switch (cc) {
         case 120: // All Sound Off — 即座に全ノートリセット
             Synth::getInstance().reset();
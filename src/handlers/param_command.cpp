@@ -0,0 +1,380 @@
+#include "handlers/param_command.hpp"
+#include "handlers/command_parse.hpp"
+#include "modules/synth.hpp"
+
+// =============================================
+// SET MASTER
+// =============================================
+static void handleSetMaster(const char* s, uint8_t len) {
+    Synth& synth = Synth::getInstance();
+    const char* arg;
+
+    if ((arg = match(s, len, "LEVEL "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 127)) { Serial.println("ERR: LEVEL 0-127"); return; }
+        synth.setMasterLevel(static_cast<Gain_t>(static_cast<int32_t>(v) * Q15_MAX / 127));
+        Serial.printf("OK: MASTER LEVEL %d\n", v); return;
+    }
+    if ((arg = match(s, len, "TRANSPOSE "))) {
+        int8_t v; if (!parseI8(arg, v, -24, 24)) { Serial.println("ERR: TRANSPOSE -24..24"); return; }
+        synth.setTranspose(v);
+        Serial.printf("OK: MASTER TRANSPOSE %d\n", v); return;
+    }
+    if ((arg = match(s, len, "ALGO "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 31)) { Serial.println("ERR: ALGO 0-31"); return; }
+        synth.setAlgorithm(v);
+        Serial.printf("OK: MASTER ALGO %d\n", v); return;
+    }
+    if ((arg = match(s, len, "FB "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 7)) { Serial.println("ERR: FB 0-7"); return; }
+        synth.setFeedback(v);
+        Serial.printf("OK: MASTER FB %d\n", v); return;
+    }
+    if ((arg = match(s, len, "BEND "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 24)) { Serial.println("ERR: BEND 0-24"); return; }
+        synth.setPitchBendRange(v);
+        Serial.printf("OK: MASTER BEND %d\n", v); return;
+    }
+    if ((arg = match(s, len, "VEL "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: VEL 0-3"); return; }
+        synth.setVelocityCurve(v);
+        Serial.printf("OK: MASTER VEL %d\n", v); return;
+    }
+    if ((arg = match(s, len, "PMRAMP "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 1)) { Serial.println("ERR: PMRAMP 0-1"); return; }
+        synth.setPitchModRamp(v != 0);
+        Serial.printf("OK: MASTER PMRAMP %d\n", v); return;
+    }
+    if ((arg = match(s, len, "EGRATE "))) {
+        uint8_t v; if (!parseU8(arg, v, 16, 64) || (v != 16 && v != 32 && v != 64)) {
+            Serial.println("ERR: EGRATE 16|32|64"); return;
+        }
+        synth.setEnvControlRate(v);
+        Serial.printf("OK: MASTER EGRATE %d\n", synth.getEnvControlRate()); return;
+    }
+    if ((arg = match(s, len, "PRESET "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, MAX_PRESETS - 1)) {
+            Serial.printf("ERR: PRESET 0-%d\n", MAX_PRESETS - 1); return;
+        }
+        synth.loadPreset(v);
+        Serial.printf("OK: MASTER PRESET %d (%s)\n", v, synth.getCurrentPresetName()); return;
+    }
+
+    Serial.println("ERR: SET MASTER LEVEL|TRANSPOSE|ALGO|FB|BEND|VEL|PMRAMP|EGRATE|PRESET <value>");
+}
+
+// =============================================
+// SET OP <1-6>
+// =============================================
+static void handleSetOp(const char* s, uint8_t len) {
+    Synth& synth = Synth::getInstance();
+
+    if (len < 3 || s[0] < '1' || s[0] > '6' || s[1] != ' ') {
+        Serial.println("ERR: SET OP <1-6> <param> <value>"); return;
+    }
+    uint8_t opIdx = s[0] - '1';
+    const char* param = s + 2;
+    uint8_t paramLen = len - 2;
+
+    Oscillator& osc = synth.editOperatorOsc(opIdx);
+    Envelope&   env = synth.editOperatorEnv(opIdx);
+    const char* arg;
+
+    if ((arg = match(param, paramLen, "LEVEL "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: LEVEL 0-99"); return; }
+        osc.setLevelNonLinear(v);
+        Serial.printf("OK: OP %d LEVEL %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "WAVE "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: WAVE 0=sine 1=tri 2=saw 3=sqr"); return; }
+        osc.setWavetable(v);
+        Serial.printf("OK: OP %d WAVE %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "COARSE "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 31)) { Serial.println("ERR: COARSE 0-31"); return; }
+        osc.setCoarse(static_cast<float>(v));
+        Serial.printf("OK: OP %d COARSE %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "FINE "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: FINE 0-99"); return; }
+        osc.setFine(static_cast<float>(v));
+        Serial.printf("OK: OP %d FINE %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "DETUNE "))) {
+        int8_t v; if (!parseI8(arg, v, -50, 50)) { Serial.println("ERR: DETUNE -50..50 (DX7互換: -7..7)"); return; }
+        osc.setDetune(v);
+        Serial.printf("OK: OP %d DETUNE %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "FIXED "))) {
+        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: FIXED 0/1"); return; }
+        osc.setFixed(v);
+        Serial.printf("OK: OP %d FIXED %d\n", opIdx + 1, (int)v); return;
+    }
+    if ((arg = match(param, paramLen, "ENABLE "))) {
+        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
+        v ? osc.enable() : osc.disable();
+        Serial.printf("OK: OP %d ENABLE %d\n", opIdx + 1, (int)v); return;
+    }
+    if ((arg = match(param, paramLen, "AMS "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: AMS 0-3"); return; }
+        synth.setOperatorAms(opIdx, v);
+        Serial.printf("OK: OP %d AMS %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "RS "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 7)) { Serial.println("ERR: RS 0-7"); return; }
+        env.setRateScaling(v);
+        Serial.printf("OK: OP %d RS %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "VS "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 7)) { Serial.println("ERR: VS 0-7"); return; }
+        env.setVelocitySens(v);
+        Serial.printf("OK: OP %d VS %d\n", opIdx + 1, v); return;
+    }
+    // EG Rate / Level
+    if ((arg = match(param, paramLen, "R1 "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: R1 0-99"); return; }
+        env.setRate1(v); Serial.printf("OK: OP %d R1 %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "R2 "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: R2 0-99"); return; }
+        env.setRate2(v); Serial.printf("OK: OP %d R2 %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "R3 "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: R3 0-99"); return; }
+        env.setRate3(v); Serial.printf("OK: OP %d R3 %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "R4 "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: R4 0-99"); return; }
+        env.setRate4(v); Serial.printf("OK: OP %d R4 %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "L1 "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: L1 0-99"); return; }
+        env.setLevel1(v); Serial.printf("OK: OP %d L1 %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "L2 "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: L2 0-99"); return; }
+        env.setLevel2(v); Serial.printf("OK: OP %d L2 %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "L3 "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: L3 0-99"); return; }
+        env.setLevel3(v); Serial.printf("OK: OP %d L3 %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "L4 "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: L4 0-99"); return; }
+        env.setLevel4(v); Serial.printf("OK: OP %d L4 %d\n", opIdx + 1, v); return;
+    }
+    // KLS (Keyboard Level Scaling)
+    if ((arg = match(param, paramLen, "KBP "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: KBP 0-99 (39=C3)"); return; }
+        env.setBreakPoint(v); Serial.printf("OK: OP %d KBP %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "KLD "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: KLD 0-99"); return; }
+        env.setLeftDepth(v); Serial.printf("OK: OP %d KLD %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "KRD "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: KRD 0-99"); return; }
+        env.setRightDepth(v); Serial.printf("OK: OP %d KRD %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "KLC "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: KLC 0-3 (0=-LN 1=-EX 2=+EX 3=+LN)"); return; }
+        env.setLeftCurve(v); Serial.printf("OK: OP %d KLC %d\n", opIdx + 1, v); return;
+    }
+    if ((arg = match(param, paramLen, "KRC "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: KRC 0-3 (0=-LN 1=-EX 2=+EX 3=+LN)"); return; }
+        env.setRightCurve(v); Serial.printf("OK: OP %d KRC %d\n", opIdx + 1, v); return;
+    }
+
+    Serial.println("ERR: SET OP <1-6>: LEVEL|WAVE|COARSE|FINE|DETUNE|FIXED|ENABLE|AMS|RS|VS");
+    Serial.println("                   R1-R4|L1-L4|KBP|KLD|KRD|KLC|KRC <value>");
+}
+
+// =============================================
+// SET LFO
+// =============================================
+static void handleSetLfo(const char* s, uint8_t len) {
+    Lfo& lfo = Synth::getInstance().getLfo();
+    const char* arg;
+
+    if ((arg = match(s, len, "WAVE "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 5)) { Serial.println("ERR: WAVE 0=tri 1=sawdn 2=sawup 3=sqr 4=sine 5=s&h"); return; }
+        lfo.setWave(v); Serial.printf("OK: LFO WAVE %d\n", v); return;
+    }
+    if ((arg = match(s, len, "SPEED "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: SPEED 0-99"); return; }
+        lfo.setSpeed(v); Serial.printf("OK: LFO SPEED %d\n", v); return;
+    }
+    if ((arg = match(s, len, "DELAY "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: DELAY 0-99"); return; }
+        lfo.setDelay(v); Serial.printf("OK: LFO DELAY %d\n", v); return;
+    }
+    if ((arg = match(s, len, "PMD "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: PMD 0-99"); return; }
+        lfo.setPmDepth(v); Serial.printf("OK: LFO PMD %d\n", v); return;
+    }
+    if ((arg = match(s, len, "AMD "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: AMD 0-99"); return; }
+        lfo.setAmDepth(v); Serial.printf("OK: LFO AMD %d\n", v); return;
+    }
+    if ((arg = match(s, len, "PMS "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 7)) { Serial.println("ERR: PMS 0-7"); return; }
+        lfo.setPitchModSens(v); Serial.printf("OK: LFO PMS %d\n", v); return;
+    }
+    if ((arg = match(s, len, "SYNC "))) {
+        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: SYNC 0/1"); return; }
+        lfo.setKeySync(v); Serial.printf("OK: LFO SYNC %d\n", (int)v); return;
+    }
+
+    Serial.println("ERR: SET LFO WAVE|SPEED|DELAY|PMD|AMD|PMS|SYNC <value>");
+}
+
+// =============================================
+// SET DELAY / LPF / HPF / CHORUS / REVERB
+// =============================================
+static void handleSetDelay(const char* s, uint8_t len) {
+    Synth& synth = Synth::getInstance();
+    const char* arg;
+
+    if ((arg = match(s, len, "ENABLE "))) {
+        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
+        synth.setDelayEnabled(v); Serial.printf("OK: DELAY ENABLE %d\n", (int)v); return;
+    }
+    if ((arg = match(s, len, "TIME "))) {
+        int t = atoi(arg);
+        const int max_time = synth.getDelay().getMaxTime();
+        if (t < 1 || t > max_time) { Serial.printf("ERR: TIME 1-%d (ms)\n", max_time); return; }
+        synth.getDelay().setTime(t); Serial.printf("OK: DELAY TIME %d\n", t); return;
+    }
+    if ((arg = match(s, len, "LEVEL "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: LEVEL 0-99"); return; }
+        synth.getDelay().setLevel(EffectPreset::toQ15(v));
+        Serial.printf("OK: DELAY LEVEL %d\n", v); return;
+    }
+    if ((arg = match(s, len, "FB "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: FB 0-99"); return; }
+        synth.getDelay().setFeedback(EffectPreset::toQ15(v));
+        Serial.printf("OK: DELAY FB %d\n", v); return;
+    }
+
+    Serial.println("ERR: SET DELAY ENABLE|TIME|LEVEL|FB <value>");
+}
+
+static void handleSetLpf(const char* s, uint8_t len) {
+    Synth& synth = Synth::getInstance();
+    Filter& f = synth.getFilter();
+    const char* arg;
+
+    if ((arg = match(s, len, "ENABLE "))) {
+        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
+        synth.setLpfEnabled(v); Serial.printf("OK: LPF ENABLE %d\n", (int)v); return;
+    }
+    if ((arg = match(s, len, "CUTOFF "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: CUTOFF 0-99"); return; }
+        f.setLowPass(EffectPreset::cutoffToHz(v), f.getLpfResonance());
+        Serial.printf("OK: LPF CUTOFF %d\n", v); return;
+    }
+    if ((arg = match(s, len, "RES "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: RES 0-99"); return; }
+        f.setLowPass(f.getLpfCutoff(), EffectPreset::resonanceToQ(v));
+        Serial.printf("OK: LPF RES %d\n", v); return;
+    }
+    if ((arg = match(s, len, "MIX "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: MIX 0-99"); return; }
+        f.setLpfMix(EffectPreset::toQ15(v)); Serial.printf("OK: LPF MIX %d\n", v); return;
+    }
+
+    Serial.println("ERR: SET LPF ENABLE|CUTOFF|RES|MIX <value>");
+}
+
+static void handleSetHpf(const char* s, uint8_t len) {
+    Synth& synth = Synth::getInstance();
+    Filter& f = synth.getFilter();
+    const char* arg;
+
+    if ((arg = match(s, len, "ENABLE "))) {
+        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
+        synth.setHpfEnabled(v); Serial.printf("OK: HPF ENABLE %d\n", (int)v); return;
+    }
+    if ((arg = match(s, len, "CUTOFF "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: CUTOFF 0-99"); return; }
+        f.setHighPass(EffectPreset::cutoffToHz(v), f.getHpfResonance());
+        Serial.printf("OK: HPF CUTOFF %d\n", v); return;
+    }
+    if ((arg = match(s, len, "RES "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: RES 0-99"); return; }
+        f.setHighPass(f.getHpfCutoff(), EffectPreset::resonanceToQ(v));
+        Serial.printf("OK: HPF RES %d\n", v); return;
+    }
+    if ((arg = match(s, len, "MIX "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: MIX 0-99"); return; }
+        f.setHpfMix(EffectPreset::toQ15(v)); Serial.printf("OK: HPF MIX %d\n", v); return;
+    }
+
+    Serial.println("ERR: SET HPF ENABLE|CUTOFF|RES|MIX <value>");
+}
+
+static void handleSetChorus(const char* s, uint8_t len) {
+    Synth& synth = Synth::getInstance();
+    const char* arg;
+
+    if ((arg = match(s, len, "ENABLE "))) {
+        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
+        synth.setChorusEnabled(v); Serial.printf("OK: CHORUS ENABLE %d\n", (int)v); return;
+    }
+    if ((arg = match(s, len, "RATE "))) {
+        uint8_t v; if (!parseU8(arg, v, 1, 99)) { Serial.println("ERR: RATE 1-99"); return; }
+        synth.getChorus().setRate(v); Serial.printf("OK: CHORUS RATE %d\n", v); return;
+    }
+    if ((arg = match(s, len, "DEPTH "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: DEPTH 0-99"); return; }
+        synth.getChorus().setDepth(v); Serial.printf("OK: CHORUS DEPTH %d\n", v); return;
+    }
+    if ((arg = match(s, len, "MIX "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: MIX 0-99"); return; }
+        synth.getChorus().setMix(EffectPreset::toQ15(v));
+        Serial.printf("OK: CHORUS MIX %d\n", v); return;
+    }
+
+    Serial.println("ERR: SET CHORUS ENABLE|RATE|DEPTH|MIX <value>");
+}
+
+static void handleSetReverb(const char* s, uint8_t len) {
+    Synth& synth = Synth::getInstance();
+    const char* arg;
+
+    if ((arg = match(s, len, "ENABLE "))) {
+        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
+        synth.setReverbEnabled(v); Serial.printf("OK: REVERB ENABLE %d\n", (int)v); return;
+    }
+    if ((arg = match(s, len, "ROOM "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: ROOM 0-99"); return; }
+        synth.getReverb().setRoomSize(v); Serial.printf("OK: REVERB ROOM %d\n", v); return;
+    }
+    if ((arg = match(s, len, "DAMP "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: DAMP 0-99"); return; }
+        synth.getReverb().setDamping(v); Serial.printf("OK: REVERB DAMP %d\n", v); return;
+    }
+    if ((arg = match(s, len, "MIX "))) {
+        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: MIX 0-99"); return; }
+        synth.getReverb().setMix(EffectPreset::toQ15(v));
+        Serial.printf("OK: REVERB MIX %d\n", v); return;
+    }
+
+    Serial.println("ERR: SET REVERB ENABLE|ROOM|DAMP|MIX <value>");
+}
+
+// =============================================
+// ディスパッチ
+// =============================================
+bool ParamCommand::set(const char* s, uint8_t len) {
+    const char* sub;
+    if ((sub = match(s, len, "MASTER ")))       handleSetMaster(sub, len - 7);
+    else if ((sub = match(s, len, "OP ")))      handleSetOp(sub, len - 3);
+    else if ((sub = match(s, len, "LFO ")))     handleSetLfo(sub, len - 4);
+    else if ((sub = match(s, len, "DELAY ")))   handleSetDelay(sub, len - 6);
+    else if ((sub = match(s, len, "LPF ")))     handleSetLpf(sub, len - 4);
+    else if ((sub = match(s, len, "HPF ")))     handleSetHpf(sub, len - 4);
+    else if ((sub = match(s, len, "CHORUS ")))  handleSetChorus(sub, len - 7);
+    else if ((sub = match(s, len, "REVERB ")))  handleSetReverb(sub, len - 7);
+    else return false;
+    return true;
+}
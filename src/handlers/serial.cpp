@@ -1,10 +1,24 @@
 #include "handlers/serial.hpp"
+#include "handlers/audio.hpp"
+#include "handlers/command_parse.hpp"
+#include "handlers/param_command.hpp"
 #include "modules/synth.hpp"
+#include "tools/memory_monitor.hpp"
+#include "tools/bench.hpp"
+#include "tools/capture.hpp"
+#include "tools/postmortem.hpp"
+#include "tools/profiler.hpp"
+#include "tools/scheduler.hpp"
+#include "tools/stress.hpp"
+#include "tools/trace.hpp"
+#include "utils/placement.hpp"
 #include <cstring>
 #include <cstdlib>
 
 SerialHandler serial_hdl;
 
+extern AudioHandler audio_hdl;
+
 // =============================================
 // ボタン名テーブル
 // =============================================
@@ -21,385 +35,33 @@ static const BtnEntry BTN_TABLE[] = {
 static constexpr uint8_t BTN_TABLE_SIZE = sizeof(BTN_TABLE) / sizeof(BTN_TABLE[0]);
 
 // =============================================
-// パーサーユーティリティ
+// SET XRUN
 // =============================================
+static const char* const UNDERRUN_POLICY_NAMES[] = {"NONE", "REPEAT", "SILENCE", "SHED"};
+static_assert(sizeof(UNDERRUN_POLICY_NAMES) / sizeof(UNDERRUN_POLICY_NAMES[0])
+    == static_cast<size_t>(UnderrunPolicy::COUNT), "UnderrunPolicy names");
 
-// s が prefix で始まれば残り文字列を返す、マッチしなければ nullptr
-static const char* match(const char* s, uint8_t len, const char* prefix) {
-    uint8_t plen = strlen(prefix);
-    if (len < plen || strncmp(s, prefix, plen) != 0) return nullptr;
-    return s + plen;
-}
-
-static bool parseU8(const char* s, uint8_t& out, uint8_t lo, uint8_t hi) {
-    if (!s || !*s) return false;
-    int v = atoi(s);
-    if (v < lo || v > hi) return false;
-    out = static_cast<uint8_t>(v);
-    return true;
-}
-
-static bool parseI8(const char* s, int8_t& out, int8_t lo, int8_t hi) {
-    if (!s || !*s) return false;
-    int v = atoi(s);
-    if (v < lo || v > hi) return false;
-    out = static_cast<int8_t>(v);
-    return true;
-}
-
-static bool parseBool(const char* s, bool& out) {
-    if (!s || !*s) return false;
-    int v = atoi(s);
-    if (v != 0 && v != 1) return false;
-    out = (v == 1);
-    return true;
-}
-
-// =============================================
-// SET MASTER
-// =============================================
-static void handleSetMaster(const char* s, uint8_t len) {
-    Synth& synth = Synth::getInstance();
+static void handleSetXrun(const char* s, uint8_t len) {
     const char* arg;
 
-    if ((arg = match(s, len, "LEVEL "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 127)) { Serial.println("ERR: LEVEL 0-127"); return; }
-        synth.setMasterLevel(static_cast<Gain_t>(static_cast<int32_t>(v) * Q15_MAX / 127));
-        Serial.printf("OK: MASTER LEVEL %d\n", v); return;
-    }
-    if ((arg = match(s, len, "TRANSPOSE "))) {
-        int8_t v; if (!parseI8(arg, v, -24, 24)) { Serial.println("ERR: TRANSPOSE -24..24"); return; }
-        synth.setTranspose(v);
-        Serial.printf("OK: MASTER TRANSPOSE %d\n", v); return;
-    }
-    if ((arg = match(s, len, "ALGO "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 31)) { Serial.println("ERR: ALGO 0-31"); return; }
-        synth.setAlgorithm(v);
-        Serial.printf("OK: MASTER ALGO %d\n", v); return;
-    }
-    if ((arg = match(s, len, "FB "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 7)) { Serial.println("ERR: FB 0-7"); return; }
-        synth.setFeedback(v);
-        Serial.printf("OK: MASTER FB %d\n", v); return;
-    }
-    if ((arg = match(s, len, "BEND "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 24)) { Serial.println("ERR: BEND 0-24"); return; }
-        synth.setPitchBendRange(v);
-        Serial.printf("OK: MASTER BEND %d\n", v); return;
-    }
-    if ((arg = match(s, len, "VEL "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: VEL 0-3"); return; }
-        synth.setVelocityCurve(v);
-        Serial.printf("OK: MASTER VEL %d\n", v); return;
-    }
-    if ((arg = match(s, len, "PRESET "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, MAX_PRESETS - 1)) {
-            Serial.printf("ERR: PRESET 0-%d\n", MAX_PRESETS - 1); return;
+    if ((arg = match(s, len, "POLICY "))) {
+        for (uint8_t i = 0; i < static_cast<uint8_t>(UnderrunPolicy::COUNT); ++i) {
+            if (strcmp(arg, UNDERRUN_POLICY_NAMES[i]) == 0) {
+                audio_hdl.setUnderrunPolicy(static_cast<UnderrunPolicy>(i));
+                Serial.printf("OK: XRUN POLICY %s\n", UNDERRUN_POLICY_NAMES[i]);
+                return;
+            }
         }
-        synth.loadPreset(v);
-        Serial.printf("OK: MASTER PRESET %d (%s)\n", v, synth.getCurrentPresetName()); return;
-    }
-
-    Serial.println("ERR: SET MASTER LEVEL|TRANSPOSE|ALGO|FB|BEND|VEL|PRESET <value>");
-}
-
-// =============================================
-// SET OP <1-6>
-// =============================================
-static void handleSetOp(const char* s, uint8_t len) {
-    Synth& synth = Synth::getInstance();
-
-    if (len < 3 || s[0] < '1' || s[0] > '6' || s[1] != ' ') {
-        Serial.println("ERR: SET OP <1-6> <param> <value>"); return;
-    }
-    uint8_t opIdx = s[0] - '1';
-    const char* param = s + 2;
-    uint8_t paramLen = len - 2;
-
-    Oscillator& osc = const_cast<Oscillator&>(synth.getOperatorOsc(opIdx));
-    Envelope&   env = const_cast<Envelope&>(synth.getOperatorEnv(opIdx));
-    const char* arg;
-
-    if ((arg = match(param, paramLen, "LEVEL "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: LEVEL 0-99"); return; }
-        osc.setLevelNonLinear(v);
-        Serial.printf("OK: OP %d LEVEL %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "WAVE "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: WAVE 0=sine 1=tri 2=saw 3=sqr"); return; }
-        osc.setWavetable(v);
-        Serial.printf("OK: OP %d WAVE %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "COARSE "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 31)) { Serial.println("ERR: COARSE 0-31"); return; }
-        osc.setCoarse(static_cast<float>(v));
-        Serial.printf("OK: OP %d COARSE %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "FINE "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: FINE 0-99"); return; }
-        osc.setFine(static_cast<float>(v));
-        Serial.printf("OK: OP %d FINE %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "DETUNE "))) {
-        int8_t v; if (!parseI8(arg, v, -50, 50)) { Serial.println("ERR: DETUNE -50..50 (DX7互換: -7..7)"); return; }
-        osc.setDetune(v);
-        Serial.printf("OK: OP %d DETUNE %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "FIXED "))) {
-        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: FIXED 0/1"); return; }
-        osc.setFixed(v);
-        Serial.printf("OK: OP %d FIXED %d\n", opIdx + 1, (int)v); return;
-    }
-    if ((arg = match(param, paramLen, "ENABLE "))) {
-        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
-        v ? osc.enable() : osc.disable();
-        Serial.printf("OK: OP %d ENABLE %d\n", opIdx + 1, (int)v); return;
-    }
-    if ((arg = match(param, paramLen, "AMS "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: AMS 0-3"); return; }
-        synth.setOperatorAms(opIdx, v);
-        Serial.printf("OK: OP %d AMS %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "RS "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 7)) { Serial.println("ERR: RS 0-7"); return; }
-        env.setRateScaling(v);
-        Serial.printf("OK: OP %d RS %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "VS "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 7)) { Serial.println("ERR: VS 0-7"); return; }
-        env.setVelocitySens(v);
-        Serial.printf("OK: OP %d VS %d\n", opIdx + 1, v); return;
-    }
-    // EG Rate / Level
-    if ((arg = match(param, paramLen, "R1 "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: R1 0-99"); return; }
-        env.setRate1(v); Serial.printf("OK: OP %d R1 %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "R2 "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: R2 0-99"); return; }
-        env.setRate2(v); Serial.printf("OK: OP %d R2 %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "R3 "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: R3 0-99"); return; }
-        env.setRate3(v); Serial.printf("OK: OP %d R3 %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "R4 "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: R4 0-99"); return; }
-        env.setRate4(v); Serial.printf("OK: OP %d R4 %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "L1 "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: L1 0-99"); return; }
-        env.setLevel1(v); Serial.printf("OK: OP %d L1 %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "L2 "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: L2 0-99"); return; }
-        env.setLevel2(v); Serial.printf("OK: OP %d L2 %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "L3 "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: L3 0-99"); return; }
-        env.setLevel3(v); Serial.printf("OK: OP %d L3 %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "L4 "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: L4 0-99"); return; }
-        env.setLevel4(v); Serial.printf("OK: OP %d L4 %d\n", opIdx + 1, v); return;
-    }
-    // KLS (Keyboard Level Scaling)
-    if ((arg = match(param, paramLen, "KBP "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: KBP 0-99 (39=C3)"); return; }
-        env.setBreakPoint(v); Serial.printf("OK: OP %d KBP %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "KLD "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: KLD 0-99"); return; }
-        env.setLeftDepth(v); Serial.printf("OK: OP %d KLD %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "KRD "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: KRD 0-99"); return; }
-        env.setRightDepth(v); Serial.printf("OK: OP %d KRD %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "KLC "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: KLC 0-3 (0=-LN 1=-EX 2=+EX 3=+LN)"); return; }
-        env.setLeftCurve(v); Serial.printf("OK: OP %d KLC %d\n", opIdx + 1, v); return;
-    }
-    if ((arg = match(param, paramLen, "KRC "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 3)) { Serial.println("ERR: KRC 0-3 (0=-LN 1=-EX 2=+EX 3=+LN)"); return; }
-        env.setRightCurve(v); Serial.printf("OK: OP %d KRC %d\n", opIdx + 1, v); return;
-    }
-
-    Serial.println("ERR: SET OP <1-6>: LEVEL|WAVE|COARSE|FINE|DETUNE|FIXED|ENABLE|AMS|RS|VS");
-    Serial.println("                   R1-R4|L1-L4|KBP|KLD|KRD|KLC|KRC <value>");
-}
-
-// =============================================
-// SET LFO
-// =============================================
-static void handleSetLfo(const char* s, uint8_t len) {
-    Lfo& lfo = Synth::getInstance().getLfo();
-    const char* arg;
-
-    if ((arg = match(s, len, "WAVE "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 5)) { Serial.println("ERR: WAVE 0=tri 1=sawdn 2=sawup 3=sqr 4=sine 5=s&h"); return; }
-        lfo.setWave(v); Serial.printf("OK: LFO WAVE %d\n", v); return;
-    }
-    if ((arg = match(s, len, "SPEED "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: SPEED 0-99"); return; }
-        lfo.setSpeed(v); Serial.printf("OK: LFO SPEED %d\n", v); return;
-    }
-    if ((arg = match(s, len, "DELAY "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: DELAY 0-99"); return; }
-        lfo.setDelay(v); Serial.printf("OK: LFO DELAY %d\n", v); return;
-    }
-    if ((arg = match(s, len, "PMD "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: PMD 0-99"); return; }
-        lfo.setPmDepth(v); Serial.printf("OK: LFO PMD %d\n", v); return;
-    }
-    if ((arg = match(s, len, "AMD "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: AMD 0-99"); return; }
-        lfo.setAmDepth(v); Serial.printf("OK: LFO AMD %d\n", v); return;
-    }
-    if ((arg = match(s, len, "PMS "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 7)) { Serial.println("ERR: PMS 0-7"); return; }
-        lfo.setPitchModSens(v); Serial.printf("OK: LFO PMS %d\n", v); return;
-    }
-    if ((arg = match(s, len, "SYNC "))) {
-        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: SYNC 0/1"); return; }
-        lfo.setKeySync(v); Serial.printf("OK: LFO SYNC %d\n", (int)v); return;
-    }
-
-    Serial.println("ERR: SET LFO WAVE|SPEED|DELAY|PMD|AMD|PMS|SYNC <value>");
-}
-
-// =============================================
-// SET DELAY / LPF / HPF / CHORUS / REVERB
-// =============================================
-static void handleSetDelay(const char* s, uint8_t len) {
-    Synth& synth = Synth::getInstance();
-    const char* arg;
-
-    if ((arg = match(s, len, "ENABLE "))) {
-        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
-        synth.setDelayEnabled(v); Serial.printf("OK: DELAY ENABLE %d\n", (int)v); return;
-    }
-    if ((arg = match(s, len, "TIME "))) {
-        int t = atoi(arg);
-        if (t < 1 || t > 300) { Serial.println("ERR: TIME 1-300 (ms)"); return; }
-        synth.getDelay().setTime(t); Serial.printf("OK: DELAY TIME %d\n", t); return;
-    }
-    if ((arg = match(s, len, "LEVEL "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: LEVEL 0-99"); return; }
-        synth.getDelay().setLevel(EffectPreset::toQ15(v));
-        Serial.printf("OK: DELAY LEVEL %d\n", v); return;
-    }
-    if ((arg = match(s, len, "FB "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: FB 0-99"); return; }
-        synth.getDelay().setFeedback(EffectPreset::toQ15(v));
-        Serial.printf("OK: DELAY FB %d\n", v); return;
-    }
-
-    Serial.println("ERR: SET DELAY ENABLE|TIME|LEVEL|FB <value>");
-}
-
-static void handleSetLpf(const char* s, uint8_t len) {
-    Synth& synth = Synth::getInstance();
-    Filter& f = synth.getFilter();
-    const char* arg;
-
-    if ((arg = match(s, len, "ENABLE "))) {
-        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
-        synth.setLpfEnabled(v); Serial.printf("OK: LPF ENABLE %d\n", (int)v); return;
-    }
-    if ((arg = match(s, len, "CUTOFF "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: CUTOFF 0-99"); return; }
-        f.setLowPass(EffectPreset::cutoffToHz(v), f.getLpfResonance());
-        Serial.printf("OK: LPF CUTOFF %d\n", v); return;
-    }
-    if ((arg = match(s, len, "RES "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: RES 0-99"); return; }
-        f.setLowPass(f.getLpfCutoff(), EffectPreset::resonanceToQ(v));
-        Serial.printf("OK: LPF RES %d\n", v); return;
-    }
-    if ((arg = match(s, len, "MIX "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: MIX 0-99"); return; }
-        f.setLpfMix(EffectPreset::toQ15(v)); Serial.printf("OK: LPF MIX %d\n", v); return;
-    }
-
-    Serial.println("ERR: SET LPF ENABLE|CUTOFF|RES|MIX <value>");
-}
-
-static void handleSetHpf(const char* s, uint8_t len) {
-    Synth& synth = Synth::getInstance();
-    Filter& f = synth.getFilter();
-    const char* arg;
-
-    if ((arg = match(s, len, "ENABLE "))) {
-        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
-        synth.setHpfEnabled(v); Serial.printf("OK: HPF ENABLE %d\n", (int)v); return;
-    }
-    if ((arg = match(s, len, "CUTOFF "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: CUTOFF 0-99"); return; }
-        f.setHighPass(EffectPreset::cutoffToHz(v), f.getHpfResonance());
-        Serial.printf("OK: HPF CUTOFF %d\n", v); return;
-    }
-    if ((arg = match(s, len, "RES "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: RES 0-99"); return; }
-        f.setHighPass(f.getHpfCutoff(), EffectPreset::resonanceToQ(v));
-        Serial.printf("OK: HPF RES %d\n", v); return;
-    }
-    if ((arg = match(s, len, "MIX "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: MIX 0-99"); return; }
-        f.setHpfMix(EffectPreset::toQ15(v)); Serial.printf("OK: HPF MIX %d\n", v); return;
-    }
-
-    Serial.println("ERR: SET HPF ENABLE|CUTOFF|RES|MIX <value>");
-}
-
-static void handleSetChorus(const char* s, uint8_t len) {
-    Synth& synth = Synth::getInstance();
-    const char* arg;
-
-    if ((arg = match(s, len, "ENABLE "))) {
-        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
-        synth.setChorusEnabled(v); Serial.printf("OK: CHORUS ENABLE %d\n", (int)v); return;
-    }
-    if ((arg = match(s, len, "RATE "))) {
-        uint8_t v; if (!parseU8(arg, v, 1, 99)) { Serial.println("ERR: RATE 1-99"); return; }
-        synth.getChorus().setRate(v); Serial.printf("OK: CHORUS RATE %d\n", v); return;
-    }
-    if ((arg = match(s, len, "DEPTH "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: DEPTH 0-99"); return; }
-        synth.getChorus().setDepth(v); Serial.printf("OK: CHORUS DEPTH %d\n", v); return;
-    }
-    if ((arg = match(s, len, "MIX "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: MIX 0-99"); return; }
-        synth.getChorus().setMix(EffectPreset::toQ15(v));
-        Serial.printf("OK: CHORUS MIX %d\n", v); return;
-    }
-
-    Serial.println("ERR: SET CHORUS ENABLE|RATE|DEPTH|MIX <value>");
-}
-
-static void handleSetReverb(const char* s, uint8_t len) {
-    Synth& synth = Synth::getInstance();
-    const char* arg;
-
-    if ((arg = match(s, len, "ENABLE "))) {
-        bool v; if (!parseBool(arg, v)) { Serial.println("ERR: ENABLE 0/1"); return; }
-        synth.setReverbEnabled(v); Serial.printf("OK: REVERB ENABLE %d\n", (int)v); return;
-    }
-    if ((arg = match(s, len, "ROOM "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: ROOM 0-99"); return; }
-        synth.getReverb().setRoomSize(v); Serial.printf("OK: REVERB ROOM %d\n", v); return;
-    }
-    if ((arg = match(s, len, "DAMP "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: DAMP 0-99"); return; }
-        synth.getReverb().setDamping(v); Serial.printf("OK: REVERB DAMP %d\n", v); return;
+        Serial.println("ERR: POLICY NONE|REPEAT|SILENCE|SHED");
+        return;
     }
-    if ((arg = match(s, len, "MIX "))) {
-        uint8_t v; if (!parseU8(arg, v, 0, 99)) { Serial.println("ERR: MIX 0-99"); return; }
-        synth.getReverb().setMix(EffectPreset::toQ15(v));
-        Serial.printf("OK: REVERB MIX %d\n", v); return;
+    if (match(s, len, "CLEAR")) {
+        audio_hdl.clearUnderrunStats();
+        Serial.println("OK: XRUN CLEAR");
+        return;
     }
 
-    Serial.println("ERR: SET REVERB ENABLE|ROOM|DAMP|MIX <value>");
+    Serial.println("ERR: SET XRUN POLICY <NONE|REPEAT|SILENCE|SHED> | SET XRUN CLEAR");
 }
 
 // =============================================
@@ -415,6 +77,9 @@ static void handleGetMaster() {
     Serial.printf("  TRANSPOSE %d\n", synth.getTranspose());
     Serial.printf("  BEND      %d\n", synth.getPitchBendRange());
     Serial.printf("  VEL       %d\n", static_cast<uint8_t>(synth.getVelocityCurve()));
+    Serial.printf("  PMRAMP    %d\n", synth.isPitchModRamp() ? 1 : 0);
+    Serial.printf("  EGRATE    %d\n", synth.getEnvControlRate());
+    Serial.printf("  LIMIT GR  %.1f dB\n", synth.getLimiter().takeGainReductionDb());
 }
 
 static void handleGetOp(const char* s) {
@@ -471,6 +136,323 @@ static void handleGetFx() {
         synth.getReverbDamping(), EffectPreset::fromQ15(synth.getReverbMix()));
 }
 
+static void handleGetArena() {
+    Synth& synth = Synth::getInstance();
+    const EffectArena& arena = synth.getEffectArena();
+    const EffectArena::Layout& layout = arena.getLayout();
+    Serial.printf("ARENA: %u / %u samples (%u bytes)\n",
+        (unsigned)arena.used(), (unsigned)EffectArena::capacity(),
+        (unsigned)(EffectArena::capacity() * sizeof(Sample16_t)));
+    Serial.printf("  REVERB OFS=%u LEN=%u SCALE=%u%%\n",
+        (unsigned)layout.reverb.offset, (unsigned)layout.reverb.length,
+        (unsigned)(layout.reverb_scale * 100 / REVERB_SCALE_ONE));
+    Serial.printf("  CHORUS OFS=%u LEN=%u\n",
+        (unsigned)layout.chorus.offset, (unsigned)layout.chorus.length);
+    Serial.printf("  DELAY  OFS=%u LEN=%u MAX=%dms\n",
+        (unsigned)layout.delay.offset, (unsigned)layout.delay.length,
+        (int)(layout.delay.length > 0 ? ((layout.delay.length / 2 - 1) * 1000 / SAMPLE_RATE) : 0));
+    Serial.printf("  FREE   %u\n", (unsigned)(EffectArena::capacity() - arena.used()));
+}
+
+static void handleGetMem() {
+    MemoryMonitor::Snapshot m;
+    MemoryMonitor::capture(m);
+    Serial.printf("MEM:\n");
+    Serial.printf("  ITCM  CODE   %6u / %6u\n", (unsigned)m.itcm_used, (unsigned)m.itcm_size);
+    Serial.printf("  DTCM  STATIC %6u / %6u\n", (unsigned)m.dtcm_static, (unsigned)m.dtcm_size);
+    Serial.printf("  DTCM  STACK  %6u / %6u (peak)\n", (unsigned)m.stack_peak, (unsigned)m.stack_size);
+    Serial.printf("  RAM2  DMAMEM %6u / %6u\n", (unsigned)m.ram2_static, (unsigned)m.ram2_size);
+    Serial.printf("  RAM2  HEAP   %6u used, %6u free / %6u\n",
+        (unsigned)m.heap_used, (unsigned)m.heap_free, (unsigned)m.heap_size);
+    Serial.printf("  FLASH IMAGE  %7u / %7u\n", (unsigned)m.flash_used, (unsigned)m.flash_size);
+
+    size_t count = 0;
+    const MemoryMonitor::ModuleUsage* mods = MemoryMonitor::modules(count);
+    Serial.printf("MODULES:\n");
+    for (size_t i = 0; i < count; ++i) {
+        Serial.printf("  %-10s %6u %s\n", mods[i].name, (unsigned)mods[i].bytes, mods[i].region);
+    }
+}
+
+static void handleGetXrun() {
+    Serial.printf("XRUN:\n");
+    Serial.printf("  POLICY  %s\n", UNDERRUN_POLICY_NAMES[static_cast<uint8_t>(audio_hdl.getUnderrunPolicy())]);
+    Serial.printf("  STARVED %lu events, %lu blocks\n",
+        (unsigned long)audio_hdl.getStarvedEvents(), (unsigned long)audio_hdl.getStarvedBlocks());
+    Serial.printf("  LATE    %lu blocks\n", (unsigned long)audio_hdl.getLateBlocks());
+    Serial.printf("  FILLED  %lu blocks\n", (unsigned long)audio_hdl.getFilledBlocks());
+    Serial.printf("  SHED    %lu voices\n", (unsigned long)audio_hdl.getShedVoices());
+
+    // 新しい順。FX は L=LPF H=HPF D=DELAY C=CHORUS R=REVERB
+    Serial.printf("EVENTS: %lu total\n", (unsigned long)audio_hdl.getEventTotal());
+    static const char FX_CHARS[] = "LHDCR";
+    for (uint8_t i = 0; i < UNDERRUN_LOG_SIZE; ++i) {
+        const UnderrunEvent* e = audio_hdl.getEvent(i);
+        if (!e) break;
+        char fx[6];
+        for (uint8_t b = 0; b < 5; ++b) fx[b] = (e->fx & (1 << b)) ? FX_CHARS[b] : '-';
+        fx[5] = '\0';
+        Serial.printf("  %10lu ms  %-7s POLY=%2u FX=%s\n",
+            (unsigned long)e->time_ms, e->kind == UNDERRUN_STARVED ? "STARVED" : "LATE",
+            (unsigned)e->voices, fx);
+    }
+}
+
+static void handleGetCapture() {
+    Serial.printf("CAPTURE: %s\n", Capture::enabled() ? "ON" : "OFF");
+    Serial.printf("  Entries: %lu (%lu dropped)\n", (unsigned long)Capture::count(), (unsigned long)Capture::dropped());
+    Serial.printf("  Used:    %lu / %lu bytes\n", (unsigned long)Capture::bytes(), (unsigned long)Capture::CAPACITY);
+    Serial.printf("  Block:   %lu\n", (unsigned long)Synth::getInstance().getBlockCount());
+}
+
+// 表示したら計測をリセットする（次の GET PERF までの区間になる）
+static void handleGetPerf() {
+    Profiler::print();
+    Profiler::reset();
+}
+
+// 表示したら集計をクリアする
+static void handleGetDisplay() {
+    GFX_SSD1351::printStats();
+    GFX_SSD1351::clearStats();
+}
+
+// 表示したら統計をクリアする（所要時間の見込みは残る）
+static void handleGetSched() {
+    Scheduler::print();
+    Scheduler::clearStats();
+}
+
+// =============================================
+// BENCH
+// =============================================
+// BENCH [グループ] [FULL]   計測中は発音が止まる
+static void handleBench(const char* s) {
+    char group[8] = {};
+    bool full = false;
+
+    while (*s == ' ') ++s;
+    if (strncmp(s, "FULL", 4) == 0 && (s[4] == '\0' || s[4] == ' ')) {
+        full = true;
+    } else {
+        uint8_t n = 0;
+        while (*s && *s != ' ' && n < sizeof(group) - 1) group[n++] = *s++;
+        while (*s == ' ') ++s;
+        full = (strcmp(s, "FULL") == 0);
+    }
+
+    if (Stress::active()) { Serial.println("ERR: STRESS running"); return; }
+    PostMortem::Suspend suspend;  // 数秒かかる
+    if (!Bench::run(Synth::getInstance(), group, full)) {
+        Serial.println("ERR: BENCH [OSC|ENV|SYNTH|FILTER|DELAY|CHORUS|REVERB|LFO|WARM] [FULL]");
+        return;
+    }
+    if (Bench::invalidCases() > 0) {
+        Serial.printf("ERR: BENCH %u case(s) produced no output\n", (unsigned)Bench::invalidCases());
+        return;
+    }
+    Serial.println("OK: BENCH");
+}
+
+// =============================================
+// STRESS
+// =============================================
+// STRESS [シナリオ|ALL] [ブロック数]   結果はシナリオが終わるたびに出る
+// STRESS STOP
+static void handleStress(const char* s, bool synth_mode) {
+    Synth& synth = Synth::getInstance();
+    while (*s == ' ') ++s;
+
+    if (strcmp(s, "STOP") == 0) {
+        if (!Stress::active()) { Serial.println("ERR: STRESS not running"); return; }
+        Stress::stop(synth);
+        Serial.println("OK: STRESS STOP");
+        return;
+    }
+
+    char name[8] = {};
+    uint8_t n = 0;
+    while (*s && *s != ' ' && n < sizeof(name) - 1) name[n++] = *s++;
+    while (*s == ' ') ++s;
+
+    const bool all = (name[0] == '\0' || strcmp(name, "ALL") == 0);
+    Stress::Scenario scenario = Stress::CHORD;
+    if (!all && !Stress::parse(name, scenario)) {
+        Serial.println("ERR: STRESS [CHORD|BEND|CC|FX|PRESET|UI|MIX|ALL] [blocks] | STRESS STOP");
+        return;
+    }
+    uint16_t blocks = Stress::DEFAULT_BLOCKS;
+    if (*s) {
+        const int v = atoi(s);
+        if (v < 1 || v > Stress::MAX_BLOCKS) { Serial.printf("ERR: STRESS blocks 1-%u\n", (unsigned)Stress::MAX_BLOCKS); return; }
+        blocks = static_cast<uint16_t>(v);
+    }
+    if (!synth_mode) { Serial.println("ERR: STRESS requires synth mode"); return; }
+    if (Stress::active()) { Serial.println("ERR: STRESS running"); return; }
+    if (!Stress::start(synth, scenario, all, blocks)) { Serial.println("ERR: STRESS could not start"); return; }
+    Serial.printf("OK: STRESS %s (%u blocks)\n", all ? "ALL" : Stress::name(scenario), (unsigned)blocks);
+}
+
+// =============================================
+// TRACE
+// =============================================
+// TRACE ON|ARM [最短区間 us]   ARM はアンダーランの後しばらくして自動停止
+// TRACE OFF / TRACE DUMP
+static void handleTrace(const char* s, uint8_t len) {
+    constexpr uint16_t DEFAULT_MIN_US = 2;
+    const char* arg;
+    const bool on = (arg = match(s, len, "ON")) != nullptr;
+    const bool arm = !on && (arg = match(s, len, "ARM")) != nullptr;
+
+    if (on || arm) {
+        uint16_t min_us = DEFAULT_MIN_US;
+        while (*arg == ' ') ++arg;
+        if (*arg) {
+            int v = atoi(arg);
+            if (v < 0 || v > 10000) { Serial.println("ERR: TRACE ON|ARM [0-10000 us]"); return; }
+            min_us = static_cast<uint16_t>(v);
+        }
+        const uint32_t min_ticks = static_cast<uint32_t>(
+            static_cast<uint64_t>(Profiler::ticksPerSecond()) * min_us / 1000000);
+        Trace::start(min_ticks, arm);
+        Serial.printf("OK: TRACE %s MIN %uus\n", arm ? "ARM" : "ON", (unsigned)min_us);
+        return;
+    }
+    if (match(s, len, "OFF")) {
+        Trace::stop();
+        Serial.printf("OK: TRACE OFF (%u events)\n", (unsigned)Trace::count());
+        return;
+    }
+    if (match(s, len, "DUMP")) {
+        PostMortem::Suspend suspend;
+        Trace::dump();
+        Serial.println("OK: TRACE DUMP");
+        return;
+    }
+
+    Serial.println("ERR: TRACE ON|ARM [min_us] | TRACE OFF | TRACE DUMP");
+}
+
+// =============================================
+// SNAP
+// =============================================
+// SNAP SAVE|LOAD <A|B>   エンジン状態（発音中のノートを含む）を2つのスロットで切り替える
+// SNAP INFO
+// エフェクトバッファは含めない（残響テールは切り替え後も今の音が続く）
+static constexpr uint8_t SNAP_SLOTS = 2;
+PLACE_BULK static uint8_t snap_data[SNAP_SLOTS][SYNTH_SNAPSHOT_MAX_BYTES];
+static size_t snap_len[SNAP_SLOTS] = {};
+
+static void handleSnap(const char* s, uint8_t len, bool synth_mode) {
+    Synth& synth = Synth::getInstance();
+    const char* arg;
+    const bool save = (arg = match(s, len, "SAVE ")) != nullptr;
+    const bool load = !save && (arg = match(s, len, "LOAD ")) != nullptr;
+
+    if (save || load) {
+        const uint8_t slot = static_cast<uint8_t>(arg[0] - 'A');
+        if (slot >= SNAP_SLOTS || arg[1] != '\0') { Serial.println("ERR: SNAP SAVE|LOAD <A|B>"); return; }
+        // エフェクトはパススルーと共有しているのでシンセモードでだけ触る
+        if (!synth_mode) { Serial.println("ERR: SNAP requires synth mode"); return; }
+        if (load && snap_len[slot] == 0) { Serial.printf("ERR: SNAP LOAD %c: EMPTY\n", 'A' + slot); return; }
+
+        const uint32_t t0 = Profiler::now();
+        SnapshotStatus st;
+        if (save) {
+            st = synth.saveSnapshot(snap_data[slot], sizeof(snap_data[slot]), false, snap_len[slot]);
+        } else {
+            st = synth.restoreSnapshot(snap_data[slot], snap_len[slot]);
+        }
+        const uint32_t us = static_cast<uint32_t>(
+            static_cast<uint64_t>(Profiler::now() - t0) * 1000000 / Profiler::ticksPerSecond());
+
+        if (st != SnapshotStatus::OK) {
+            Serial.printf("ERR: SNAP %s %c: %s\n", save ? "SAVE" : "LOAD", 'A' + slot, snapshotStatusName(st));
+            return;
+        }
+        Serial.printf("OK: SNAP %s %c (%s, %u voices, %u bytes, %lu us)\n", save ? "SAVE" : "LOAD", 'A' + slot,
+            synth.getCurrentPresetName(), (unsigned)synth.getActiveNoteCount(), (unsigned)snap_len[slot],
+            (unsigned long)us);
+        return;
+    }
+    if (match(s, len, "INFO")) {
+        Serial.printf("SNAP: build %08lx, %u bytes max\n", (unsigned long)Synth::snapshotBuildId(),
+            (unsigned)SYNTH_SNAPSHOT_MAX_BYTES);
+        for (uint8_t i = 0; i < SNAP_SLOTS; ++i) {
+            if (snap_len[i]) Serial.printf("  %c  %u bytes\n", 'A' + i, (unsigned)snap_len[i]);
+            else             Serial.printf("  %c  EMPTY\n", 'A' + i);
+        }
+        return;
+    }
+
+    Serial.println("ERR: SNAP SAVE|LOAD <A|B> | SNAP INFO");
+}
+
+// =============================================
+// CRASH
+// =============================================
+// CRASH CLEAR / CRASH WDOG ON|OFF
+// CRASH TEST FAULT|STALL   監視の確認用。レポートを書いてリセットする
+static void handleCrash(const char* s, uint8_t len) {
+    const char* arg;
+
+    if (match(s, len, "CLEAR")) {
+        PostMortem::clear();
+        Serial.println("OK: CRASH CLEAR");
+        return;
+    }
+    if ((arg = match(s, len, "WDOG "))) {
+        if (strcmp(arg, "ON") == 0 || strcmp(arg, "OFF") == 0) {
+            PostMortem::setEnabled(arg[1] == 'N');
+            Serial.printf("OK: CRASH WDOG %s\n", arg);
+            return;
+        }
+    }
+    if ((arg = match(s, len, "TEST "))) {
+        if (strcmp(arg, "FAULT") == 0) {
+            Serial.println("OK: CRASH TEST FAULT");
+            PostMortem::testFault();
+        }
+        if (strcmp(arg, "STALL") == 0) {
+            Serial.printf("OK: CRASH TEST STALL (%lu ms)\n", (unsigned long)PostMortem::LOOP_DEADLINE_MS);
+            PostMortem::testStall();
+        }
+    }
+
+    Serial.println("ERR: CRASH CLEAR | CRASH WDOG ON|OFF | CRASH TEST FAULT|STALL");
+}
+
+// =============================================
+// CAPTURE
+// =============================================
+// CAPTURE ON (記録し直す) / CAPTURE OFF / CAPTURE SAVE [path]
+static void handleCapture(const char* s, uint8_t len) {
+    constexpr const char* DEFAULT_PATH = "/capture.crb";
+    const char* arg;
+
+    if (match(s, len, "ON")) {
+        Capture::start();
+        Serial.printf("OK: CAPTURE ON (block %lu)\n", (unsigned long)Synth::getInstance().getBlockCount());
+        return;
+    }
+    if (match(s, len, "OFF")) {
+        Capture::stop();
+        Serial.printf("OK: CAPTURE OFF (%lu entries)\n", (unsigned long)Capture::count());
+        return;
+    }
+    if ((arg = match(s, len, "SAVE"))) {
+        while (*arg == ' ') ++arg;
+        const char* path = *arg ? arg : DEFAULT_PATH;
+        PostMortem::Suspend suspend;
+        if (!Capture::save(path)) { Serial.printf("ERR: CAPTURE SAVE %s failed\n", path); return; }
+        Serial.printf("OK: CAPTURE SAVE %s (%lu entries, %lu dropped)\n", path,
+            (unsigned long)Capture::count(), (unsigned long)Capture::dropped());
+        return;
+    }
+
+    Serial.println("ERR: CAPTURE ON|OFF | CAPTURE SAVE [path]");
+}
+
 // =============================================
 // HELP
 // =============================================
@@ -479,7 +461,7 @@ static void printHelp() {
     Serial.println("  BTN UP|DN|L|R|ET|CXL|EC [LONG]");
     Serial.println("  ENC <+/-delta>");
     Serial.println("--- SET ---");
-    Serial.println("  SET MASTER LEVEL|TRANSPOSE|ALGO|FB|BEND|VEL|PRESET <value>");
+    Serial.println("  SET MASTER LEVEL|TRANSPOSE|ALGO|FB|BEND|VEL|PMRAMP|EGRATE|PRESET <value>");
     Serial.println("  SET OP <1-6> LEVEL|WAVE|COARSE|FINE|DETUNE|FIXED|ENABLE|AMS|RS|VS <value>");
     Serial.println("  SET OP <1-6> R1-R4|L1-L4 <value>");
     Serial.println("  SET OP <1-6> KBP|KLD|KRD|KLC|KRC <value>");
@@ -488,11 +470,40 @@ static void printHelp() {
     Serial.println("  SET LPF|HPF ENABLE|CUTOFF|RES|MIX <value>");
     Serial.println("  SET CHORUS ENABLE|RATE|DEPTH|MIX <value>");
     Serial.println("  SET REVERB ENABLE|ROOM|DAMP|MIX <value>");
+    Serial.println("  SET XRUN POLICY NONE|REPEAT|SILENCE|SHED");
+    Serial.println("  SET XRUN CLEAR");
     Serial.println("--- GET ---");
     Serial.println("  GET MASTER");
     Serial.println("  GET OP <1-6>");
     Serial.println("  GET LFO");
     Serial.println("  GET FX");
+    Serial.println("  GET ARENA");
+    Serial.println("  GET MEM");
+    Serial.println("  GET PERF");
+    Serial.println("  GET SCHED");
+    Serial.println("  GET DISPLAY");
+    Serial.println("  GET XRUN");
+    Serial.println("--- BENCH ---");
+    Serial.println("  BENCH [OSC|ENV|SYNTH|FILTER|DELAY|CHORUS|REVERB|LFO|WARM] [FULL]");
+    Serial.println("--- STRESS ---");
+    Serial.println("  STRESS [CHORD|BEND|CC|FX|PRESET|UI|MIX|ALL] [blocks]");
+    Serial.println("  STRESS STOP");
+    Serial.println("--- TRACE ---");
+    Serial.println("  TRACE ON|ARM [min_us]");
+    Serial.println("  TRACE OFF");
+    Serial.println("  TRACE DUMP");
+    Serial.println("--- SNAP ---");
+    Serial.println("  SNAP SAVE|LOAD <A|B>");
+    Serial.println("  SNAP INFO");
+    Serial.println("--- CAPTURE ---");
+    Serial.println("  CAPTURE ON|OFF");
+    Serial.println("  CAPTURE SAVE [path]");
+    Serial.println("  GET CAPTURE");
+    Serial.println("--- CRASH ---");
+    Serial.println("  GET CRASH");
+    Serial.println("  CRASH CLEAR");
+    Serial.println("  CRASH WDOG ON|OFF");
+    Serial.println("  CRASH TEST FAULT|STALL");
 }
 
 // =============================================
@@ -535,15 +546,12 @@ void SerialHandler::executeCommand(const uint8_t* cmd, uint8_t len) {
     if ((arg = match(s, len, "SET "))) {
         uint8_t argLen = len - 4;
         const char* sub;
-        if ((sub = match(arg, argLen, "MASTER ")))       handleSetMaster(sub, argLen - 7);
-        else if ((sub = match(arg, argLen, "OP ")))      handleSetOp(sub, argLen - 3);
-        else if ((sub = match(arg, argLen, "LFO ")))     handleSetLfo(sub, argLen - 4);
-        else if ((sub = match(arg, argLen, "DELAY ")))   handleSetDelay(sub, argLen - 6);
-        else if ((sub = match(arg, argLen, "LPF ")))     handleSetLpf(sub, argLen - 4);
-        else if ((sub = match(arg, argLen, "HPF ")))     handleSetHpf(sub, argLen - 4);
-        else if ((sub = match(arg, argLen, "CHORUS ")))  handleSetChorus(sub, argLen - 7);
-        else if ((sub = match(arg, argLen, "REVERB ")))  handleSetReverb(sub, argLen - 7);
-        else { Serial.println("ERR: SET MASTER|OP|LFO|DELAY|LPF|HPF|CHORUS|REVERB ..."); return; }
+        if ((sub = match(arg, argLen, "XRUN "))) { handleSetXrun(sub, argLen - 5); return; }
+        if (!ParamCommand::set(arg, argLen)) {
+            Serial.println("ERR: SET MASTER|OP|LFO|DELAY|LPF|HPF|CHORUS|REVERB|XRUN ..."); return;
+        }
+        // プリセット変更は loadPreset() 側で記録される
+        if (!match(arg, argLen, "MASTER PRESET ")) Capture::command(s, len);
         if (state_) state_->setParamChanged();
         return;
     }
@@ -555,7 +563,51 @@ void SerialHandler::executeCommand(const uint8_t* cmd, uint8_t len) {
         else if (match(arg, argLen, "OP "))   handleGetOp(arg + 3);
         else if (match(arg, argLen, "LFO"))   handleGetLfo();
         else if (match(arg, argLen, "FX"))    handleGetFx();
-        else Serial.println("ERR: GET MASTER|OP <1-6>|LFO|FX");
+        else if (match(arg, argLen, "ARENA")) handleGetArena();
+        else if (match(arg, argLen, "MEM"))   handleGetMem();
+        else if (match(arg, argLen, "PERF"))  handleGetPerf();
+        else if (match(arg, argLen, "SCHED")) handleGetSched();
+        else if (match(arg, argLen, "DISPLAY")) handleGetDisplay();
+        else if (match(arg, argLen, "XRUN"))  handleGetXrun();
+        else if (match(arg, argLen, "CAPTURE")) handleGetCapture();
+        else if (match(arg, argLen, "CRASH")) PostMortem::print();
+        else Serial.println("ERR: GET MASTER|OP <1-6>|LFO|FX|ARENA|MEM|PERF|SCHED|DISPLAY|XRUN|CAPTURE|CRASH");
+        return;
+    }
+
+    // BENCH
+    if (match(s, len, "BENCH") && (len == 5 || s[5] == ' ')) {
+        handleBench(s + 5);
+        return;
+    }
+
+    // STRESS
+    if (match(s, len, "STRESS") && (len == 6 || s[6] == ' ')) {
+        handleStress(s + 6, state_ && state_->getModeState() == MODE_SYNTH);
+        return;
+    }
+
+    // TRACE
+    if ((arg = match(s, len, "TRACE "))) {
+        handleTrace(arg, len - 6);
+        return;
+    }
+
+    // SNAP
+    if ((arg = match(s, len, "SNAP "))) {
+        handleSnap(arg, len - 5, state_ && state_->getModeState() == MODE_SYNTH);
+        return;
+    }
+
+    // CRASH
+    if ((arg = match(s, len, "CRASH "))) {
+        handleCrash(arg, len - 6);
+        return;
+    }
+
+    // CAPTURE
+    if ((arg = match(s, len, "CAPTURE "))) {
+        handleCapture(arg, len - 8);
         return;
     }
 
@@ -0,0 +1,39 @@
+#include "host.hpp"
+#include "tools/bench.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <string>
+
+/**
+ * @brief Bench をホストで実行する
+ *
+ * 引数は実機の BENCH コマンドと同じ（大文字小文字は区別しない）。
+ * プリセットは起動時の 0 番で計測する。
+ */
+int runBench(int argc, char** argv) {
+    std::string group;
+    bool full = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        for (char& c : a) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (a == "FULL") full = true;
+        else if (group.empty()) group = a;
+        else {
+            std::printf("usage: bench [GROUP] [FULL]\n");
+            return 2;
+        }
+    }
+
+    HostEngine engine;
+    if (!Bench::run(engine.synth(), group.c_str(), full)) {
+        std::printf("ERR: bench [OSC|ENV|SYNTH|FILTER|DELAY|CHORUS|REVERB|LFO|WARM] [FULL]\n");
+        return 2;
+    }
+    if (Bench::invalidCases() > 0) {
+        std::printf("ERR: %u case(s) produced no output\n", (unsigned)Bench::invalidCases());
+        return 1;
+    }
+    return 0;
+}
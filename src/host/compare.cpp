@@ -0,0 +1,377 @@
+#include "host.hpp"
+#include "reference.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief 固定小数点エンジンと倍精度リファレンスの比較
+ *
+ * 各プリセットで同じ単音を hold 秒保持 → ノートオフ → release 秒鳴らし、
+ * 実エンジンの 16bit 出力と ReferenceVoice の出力（同じマスターゲインで 16bit 単位に換算、
+ * 量子化なし）を比べる。
+ *
+ * - SNR: 全区間の (リファレンス電力) / (差分電力)、SUS は保持区間の後半だけで求めたもの
+ * - THD: 保持区間の後半で 2〜10 次倍音 / 基音 (Hann 窓 + Goertzel)、両エンジンそれぞれ。
+ *   基音はキャリアの実際の位相増分から求めた最低周波数。他のキャリアが
+ *   その整数倍に乗らない（非整数比・デチューン・固定周波数）ときは n/a
+ * - ATK: ピーク -1dB に達するまで、REL: ノートオフ時点から -40dB まで (64サンプル RMS)
+ *
+ * LFO の深さは 0、エフェクトは OFF にする（リファレンスは扱わないため）。
+ * リミッターが動いたプリセットは LIM、16bit でクリップしたものは CLIP を付ける。
+ */
+
+namespace {
+
+constexpr double DEFAULT_HOLD_SEC = 1.0;
+constexpr double DEFAULT_RELEASE_SEC = 1.0;
+constexpr int THD_HARMONICS = 10;
+constexpr size_t ENV_FRAME = 64;
+constexpr double ATTACK_DB = -1.0;
+constexpr double RELEASE_DB = -40.0;
+constexpr double SILENT_RMS = 1.0;      // 1LSB 未満の区間は測定しない
+
+// -ffast-math では NaN/Inf が使えないので番兵値で表す
+constexpr double SNR_EXACT = 999.0;
+constexpr double NOT_MEASURED = -1e9;
+constexpr double THD_FLOOR = -300.0;
+constexpr double NOT_HARMONIC = -2e9;   // キャリアが倍音列にならない音色の THD
+
+struct CompareOptions {
+    int preset = -1;        // -1: 全プリセット
+    int note = 60;
+    int velocity = 100;
+    double hold = DEFAULT_HOLD_SEC;
+    double release = DEFAULT_RELEASE_SEC;
+    ReferenceVoice::Pitch pitch = ReferenceVoice::Pitch::Shared;
+    bool check = false;
+    double min_snr = 0.0;
+};
+
+struct Metrics {
+    double snr = SNR_EXACT;
+    double snr_sustain = SNR_EXACT;
+    double thd_ref = NOT_MEASURED;
+    double thd_fix = NOT_MEASURED;
+    double atk_ref = NOT_MEASURED;
+    double atk_fix = NOT_MEASURED;
+    double rel_ref = NOT_MEASURED;
+    double rel_fix = NOT_MEASURED;
+    bool limited = false;
+    bool clipped = false;
+};
+
+bool parseInt(const char* s, int lo, int hi, int& out) {
+    char* end;
+    long v = std::strtol(s, &end, 10);
+    if (*s == '\0' || *end != '\0' || v < lo || v > hi) return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+bool parseOptions(int argc, char** argv, CompareOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!v) return false;
+        ++i;
+
+        bool ok = true;
+        if (std::strcmp(a, "-p") == 0) ok = parseInt(v, 0, MAX_PRESETS - 1, opt.preset);
+        else if (std::strcmp(a, "-n") == 0) ok = parseInt(v, 0, 127, opt.note);
+        else if (std::strcmp(a, "-v") == 0) ok = parseInt(v, 1, 127, opt.velocity);
+        else if (std::strcmp(a, "--hold") == 0) { opt.hold = std::atof(v); ok = opt.hold > 0.0; }
+        else if (std::strcmp(a, "--release") == 0) { opt.release = std::atof(v); ok = opt.release > 0.0; }
+        else if (std::strcmp(a, "--min-snr") == 0) { opt.min_snr = std::atof(v); opt.check = true; }
+        else if (std::strcmp(a, "--pitch") == 0) {
+            if (std::strcmp(v, "shared") == 0) opt.pitch = ReferenceVoice::Pitch::Shared;
+            else if (std::strcmp(v, "exact") == 0) opt.pitch = ReferenceVoice::Pitch::Exact;
+            else ok = false;
+        }
+        else ok = false;
+
+        if (!ok) return false;
+    }
+    return true;
+}
+
+void printUsage() {
+    std::printf("usage: compare [-p preset 0-%d] [-n note] [-v velocity] [--hold sec] [--release sec]\n"
+                "               [--pitch shared|exact] [--min-snr dB]\n", MAX_PRESETS - 1);
+}
+
+double snrDb(const std::vector<double>& ref, const std::vector<double>& fix, size_t begin, size_t end) {
+    double signal = 0.0, noise = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+        const double d = fix[i] - ref[i];
+        signal += ref[i] * ref[i];
+        noise += d * d;
+    }
+    if (noise == 0.0) return SNR_EXACT;
+    if (signal == 0.0) return -SNR_EXACT;
+    return 10.0 * std::log10(signal / noise);
+}
+
+// Goertzel で freq の電力を求める（x は窓掛け済み）
+double tonePower(const std::vector<double>& x, double freq) {
+    const double coeff = 2.0 * std::cos(2.0 * M_PI * freq / SAMPLE_RATE);
+    double s1 = 0.0, s2 = 0.0;
+    for (double v : x) {
+        const double s0 = v + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    return s1 * s1 + s2 * s2 - coeff * s1 * s2;
+}
+
+double thdDb(const double* x, size_t n, double f0) {
+    double energy = 0.0;
+    for (size_t i = 0; i < n; ++i) energy += x[i] * x[i];
+    if (n < 2 || std::sqrt(energy / n) < SILENT_RMS) return NOT_MEASURED;
+
+    std::vector<double> w(n);
+    for (size_t i = 0; i < n; ++i) {
+        w[i] = x[i] * (0.5 - 0.5 * std::cos(2.0 * M_PI * i / (n - 1)));
+    }
+
+    const double fundamental = tonePower(w, f0);
+    double harmonics = 0.0;
+    for (int k = 2; k <= THD_HARMONICS && k * f0 < SAMPLE_RATE / 2.0; ++k) {
+        harmonics += tonePower(w, k * f0);
+    }
+    if (fundamental <= 0.0) return NOT_MEASURED;
+    return std::max(10.0 * std::log10(std::max(harmonics, 1e-30) / fundamental), THD_FLOOR);
+}
+
+/**
+ * @brief THD の基音をキャリアの実際の位相増分から求める
+ *
+ * 有効でレベルが 0 でないキャリアの周波数を Synth::generate() と同じ
+ * delta テーブルから求め、最低周波数を基音とする。他のキャリアが整数倍から
+ * tolerance_hz（Goertzel の分解能）以上ずれていれば NOT_HARMONIC。
+ */
+double fundamentalHz(const Synth& synth, uint8_t note, double tolerance_hz) {
+    const Algorithm& algo = Algorithms::get(synth.getCurrentAlgorithmId());
+    double freq[MAX_OPERATORS];
+    uint8_t count = 0;
+    for (uint8_t op = 0; op < MAX_OPERATORS; ++op) {
+        if (!(algo.output_mask & (1 << op))) continue;
+        Oscillator osc = synth.getOperatorOsc(op);  // コピーに対して呼ぶ
+        if (!osc.isEnabled() || osc.getLevel() == 0) continue;
+        Oscillator::Memory mem;
+        osc.setFrequency(mem, note);
+        if (mem.delta == 0) continue;
+        freq[count++] = mem.delta / 4294967296.0 * SAMPLE_RATE;
+    }
+    if (count == 0) return NOT_MEASURED;
+
+    const double f0 = *std::min_element(freq, freq + count);
+    for (uint8_t i = 0; i < count; ++i) {
+        const double harmonic = std::round(freq[i] / f0) * f0;
+        if (std::fabs(freq[i] - harmonic) > tolerance_hz) return NOT_HARMONIC;
+    }
+    return f0;
+}
+
+std::vector<double> rmsFrames(const std::vector<double>& x) {
+    std::vector<double> frames(x.size() / ENV_FRAME);
+    for (size_t f = 0; f < frames.size(); ++f) {
+        double e = 0.0;
+        for (size_t i = 0; i < ENV_FRAME; ++i) {
+            const double v = x[f * ENV_FRAME + i];
+            e += v * v;
+        }
+        frames[f] = std::sqrt(e / ENV_FRAME);
+    }
+    return frames;
+}
+
+double framesToMs(size_t frames) {
+    return 1000.0 * static_cast<double>(frames * ENV_FRAME) / SAMPLE_RATE;
+}
+
+// 保持区間のピーク -1dB に達するまでの時間
+double attackMs(const std::vector<double>& frames, size_t hold_frames) {
+    const double peak = *std::max_element(frames.begin(), frames.begin() + hold_frames);
+    if (peak < SILENT_RMS) return NOT_MEASURED;
+    const double threshold = peak * std::pow(10.0, ATTACK_DB / 20.0);
+    for (size_t f = 0; f < hold_frames; ++f) {
+        if (frames[f] >= threshold) return framesToMs(f + 1);
+    }
+    return NOT_MEASURED;
+}
+
+// ノートオフ直前のレベルから -40dB まで下がる時間
+double releaseMs(const std::vector<double>& frames, size_t hold_frames) {
+    const double start = frames[hold_frames - 1];
+    if (start < SILENT_RMS) return NOT_MEASURED;
+    const double threshold = start * std::pow(10.0, RELEASE_DB / 20.0);
+    for (size_t f = hold_frames; f < frames.size(); ++f) {
+        if (frames[f] < threshold) return framesToMs(f - hold_frames + 1);
+    }
+    return NOT_MEASURED;
+}
+
+void printValue(double v, const char* fmt) {
+    if (v == NOT_HARMONIC) std::printf("%8s", "n/a");
+    else if (v == NOT_MEASURED) std::printf("%8s", "-");
+    else std::printf(fmt, v);
+}
+
+void printDelta(double fix, double ref) {
+    if (fix == NOT_HARMONIC || ref == NOT_HARMONIC) std::printf("%7s", "n/a");
+    else if (fix == NOT_MEASURED || ref == NOT_MEASURED) std::printf("%7s", "-");
+    else std::printf(" %+6.1f", fix - ref);
+}
+
+} // namespace
+
+int runCompare(int argc, char** argv) {
+    CompareOptions opt;
+    if (!parseOptions(argc, argv, opt)) {
+        printUsage();
+        return 2;
+    }
+
+    HostEngine engine;
+    Synth& synth = engine.synth();
+    ReferenceVoice reference;
+
+    const uint64_t hold_blocks = static_cast<uint64_t>(std::ceil(opt.hold * SAMPLE_RATE / BUFFER_SIZE));
+    const uint64_t release_blocks = static_cast<uint64_t>(std::ceil(opt.release * SAMPLE_RATE / BUFFER_SIZE));
+    const size_t hold_samples = hold_blocks * BUFFER_SIZE;
+    const size_t total_samples = (hold_blocks + release_blocks) * BUFFER_SIZE;
+    const size_t hold_frames = hold_samples / ENV_FRAME;
+
+    const uint8_t first = opt.preset >= 0 ? static_cast<uint8_t>(opt.preset) : 0;
+    const uint8_t last = opt.preset >= 0 ? static_cast<uint8_t>(opt.preset) : MAX_PRESETS - 1;
+
+    using Clock = std::chrono::steady_clock;
+    double fixed_sec = 0.0;
+    double reference_sec = 0.0;
+    uint64_t blocks = 0;
+
+    std::vector<double> fix(total_samples), ref(total_samples);
+    std::vector<double> snrs;
+    double worst_snr = SNR_EXACT;
+    uint8_t worst_preset = first;
+    int failures = 0;
+
+    std::printf("note %d velocity %d  hold %.2f s  release %.2f s  pitch %s\n\n",
+                opt.note, opt.velocity, opt.hold, opt.release,
+                opt.pitch == ReferenceVoice::Pitch::Shared ? "shared" : "exact");
+    std::printf(" # NAME          SNR dB  SUS dB THD ref THD fix   dTHD  ATK ms   dATK  REL ms   dREL\n");
+
+    for (uint8_t p = first; p <= last; ++p) {
+        synth.reset();
+        synth.loadPreset(p);
+        synth.setDelayEnabled(false);
+        synth.setChorusEnabled(false);
+        synth.setReverbEnabled(false);
+        synth.setLpfEnabled(false);
+        synth.setHpfEnabled(false);
+        synth.getLfo().setPmDepth(0);
+        synth.getLfo().setAmDepth(0);
+        synth.setPitchBend(0);
+        synth.setOscKeySync(true);
+
+        const uint8_t note = static_cast<uint8_t>(opt.note);
+        const uint8_t velocity = static_cast<uint8_t>(opt.velocity);
+        synth.noteOn(note, velocity, 1);
+        reference.noteOn(synth, note, velocity, opt.pitch);
+
+        // マスターゲイン (Q24) と Q23 フルスケール → 16bit (2^23 >> 8 = 2^15)
+        const EnvGain_t makeup = synth.getLimiter().getMakeupGain();
+        const double out_scale = static_cast<double>(makeup) / (1 << ENVGAIN_SHIFT) * (1 << 15);
+
+        Metrics m;
+        for (uint64_t b = 0; b < hold_blocks + release_blocks; ++b) {
+            if (b == hold_blocks) {
+                synth.noteOff(note, 1);
+                reference.noteOff();
+            }
+
+            auto t0 = Clock::now();
+            engine.renderBlock();
+            fixed_sec += std::chrono::duration<double>(Clock::now() - t0).count();
+
+            t0 = Clock::now();
+            double* r = &ref[b * BUFFER_SIZE];
+            for (size_t i = 0; i < BUFFER_SIZE; ++i) r[i] = reference.next() * out_scale;
+            reference_sec += std::chrono::duration<double>(Clock::now() - t0).count();
+            ++blocks;
+
+            if (synth.getLimiter().getGain() < makeup) m.limited = true;
+            for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+                const Sample16_t s = engine.left()[i];
+                if (s == SAMPLE16_MAX || s == SAMPLE16_MIN) m.clipped = true;
+                fix[b * BUFFER_SIZE + i] = s;
+            }
+        }
+
+        // 基音はトランスポーズ後のノートでオペレーターが実際に鳴らす周波数
+        const size_t thd_begin = hold_samples / 2;
+        const size_t thd_len = hold_samples - thd_begin;
+        const int actual_note = std::clamp(opt.note + synth.getTranspose(), 0, 127);
+        const double f0 = fundamentalHz(synth, static_cast<uint8_t>(actual_note),
+                                        static_cast<double>(SAMPLE_RATE) / thd_len);
+
+        m.snr = snrDb(ref, fix, 0, total_samples);
+        m.snr_sustain = snrDb(ref, fix, thd_begin, hold_samples);
+        if (f0 == NOT_HARMONIC || f0 == NOT_MEASURED) {
+            m.thd_ref = m.thd_fix = f0;
+        } else {
+            m.thd_ref = thdDb(&ref[thd_begin], thd_len, f0);
+            m.thd_fix = thdDb(&fix[thd_begin], thd_len, f0);
+        }
+        const std::vector<double> ref_frames = rmsFrames(ref);
+        const std::vector<double> fix_frames = rmsFrames(fix);
+        m.atk_ref = attackMs(ref_frames, hold_frames);
+        m.atk_fix = attackMs(fix_frames, hold_frames);
+        m.rel_ref = releaseMs(ref_frames, hold_frames);
+        m.rel_fix = releaseMs(fix_frames, hold_frames);
+
+        snrs.push_back(m.snr);
+        if (m.snr < worst_snr) {
+            worst_snr = m.snr;
+            worst_preset = p;
+        }
+        const bool below = opt.check && m.snr < opt.min_snr;
+        if (below) ++failures;
+
+        std::printf("%2u %-12s %7.1f %7.1f", p, synth.getCurrentPresetName(), m.snr, m.snr_sustain);
+        printValue(m.thd_ref, " %7.1f");
+        printValue(m.thd_fix, " %7.1f");
+        printDelta(m.thd_fix, m.thd_ref);
+        printValue(m.atk_ref, " %7.1f");
+        printDelta(m.atk_fix, m.atk_ref);
+        printValue(m.rel_ref, " %7.1f");
+        printDelta(m.rel_fix, m.rel_ref);
+        std::printf("%s%s%s\n", m.limited ? "  LIM" : "", m.clipped ? "  CLIP" : "",
+                    below ? "  <-- below --min-snr" : "");
+    }
+    synth.reset();
+
+    std::vector<double> sorted = snrs;
+    std::sort(sorted.begin(), sorted.end());
+    const double median = sorted[sorted.size() / 2];
+    const double fixed_us = blocks ? 1e6 * fixed_sec / blocks : 0.0;
+    const double reference_us = blocks ? 1e6 * reference_sec / blocks : 0.0;
+
+    std::printf("\nSNR      min %.1f dB (%u %s)  median %.1f dB\n", worst_snr, worst_preset,
+                DefaultPresets::get(worst_preset).name, median);
+    std::printf("speed    fixed %.1f us/block  reference %.1f us/block  (x%.1f)\n",
+                fixed_us, reference_us, fixed_us > 0.0 ? reference_us / fixed_us : 0.0);
+
+    if (failures) {
+        std::printf("ERR: %d preset(s) below %.1f dB\n", failures, opt.min_snr);
+        return 1;
+    }
+    std::printf("OK: %zu presets\n", snrs.size());
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "host.hpp"
+
+HostEngine::HostEngine() {
+    Synth::getInstance().init(delay_, filter_, chorus_, reverb_, arena_);
+}
+
+/** @brief 1ブロック生成 (AudioHandler::process() が消費した扱いにして update() を呼ぶ) */
+void HostEngine::renderBlock() {
+    samples_ready_flags.store(false);
+    Synth::getInstance().update();
+}
+
+/**
+ * @brief MIDI メッセージを MIDIHandler と同じ解釈でシンセに渡す
+ *
+ * ピッチベンドは 14bit (d1 = 下位7bit, d2 = 上位7bit, 中心 8192)。
+ */
+void dispatchMidi(Synth& synth, uint8_t type, uint8_t ch, uint8_t d1, uint8_t d2) {
+    switch (type) {
+        case 0x90:
+            if (d2 == 0) synth.noteOff(d1, ch);
+            else synth.noteOn(d1, d2, ch);
+            break;
+        case 0x80:
+            synth.noteOff(d1, ch);
+            break;
+        case 0xE0:
+            synth.setPitchBend(static_cast<int16_t>(((d2 << 7) | d1) - 8192));
+            break;
+        case 0xB0:
+            if (d1 == 120) {
+                synth.reset();
+                synth.setPitchBend(0);
+            } else if (d1 == 123) {
+                synth.allNotesOff();
+            }
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,350 @@
+#include "host.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @brief ゴールデン出力による回帰チェック
+ *
+ * 固定のノート/ベロシティ/ピッチベンドのスクリプトを
+ * - 全プリセット × エフェクト全ON/全OFF
+ * - 全アルゴリズム (GOLDEN_ALGO_PRESET の音色) × エフェクト全ON/全OFF
+ * で鳴らし、ケースごとの出力ハッシュを記録・比較する。
+ *
+ *   golden record <file> [--pcm]       記録（--pcm で PCM も保存）
+ *   golden check <file> [--max N] [--snr dB]
+ *
+ * check は既定でビット一致を要求する。--max / --snr を指定すると、
+ * PCM 付きで記録したファイルに対して最大誤差 / SNR の許容範囲で判定する
+ * （意図的に近似するカーネル用）。
+ *
+ * ファイルはホストのエンディアンそのままで書く。同じマシンで
+ * 変更前に record、変更後に check する使い方を想定している。
+ */
+
+namespace {
+
+constexpr char GOLDEN_MAGIC[8] = {'C', 'R', 'G', 'O', 'L', 'D', '1', '\0'};
+constexpr uint32_t GOLDEN_BLOCKS = 160;           // 約0.46秒
+constexpr uint32_t GOLDEN_SAMPLES = GOLDEN_BLOCKS * BUFFER_SIZE * 2; // L/R インターリーブ
+constexpr uint8_t GOLDEN_ALGO_PRESET = 5;         // 6オペレーターすべて有効な音色
+constexpr uint32_t GOLDEN_SEED = 1;               // S/H LFO などの乱数を固定
+constexpr size_t NAME_LEN = 24;
+
+struct Case {
+    char name[NAME_LEN];
+    uint64_t hash;
+    std::vector<int16_t> pcm;   // record --pcm のときのみ
+};
+
+struct ScriptEvent {
+    uint32_t block;
+    enum Type : uint8_t { NOTE_ON, NOTE_OFF, BEND } type;
+    uint8_t note;
+    uint8_t velocity;
+    int16_t bend;
+};
+
+// 和音・ベロシティ違い・重ね弾き・ピッチベンド・リトリガー・リリースを一通り通す
+const ScriptEvent SCRIPT[] = {
+    {0,   ScriptEvent::NOTE_ON,  48, 40,  0},
+    {0,   ScriptEvent::NOTE_ON,  60, 100, 0},
+    {0,   ScriptEvent::NOTE_ON,  64, 127, 0},
+    {20,  ScriptEvent::NOTE_ON,  72, 80,  0},
+    {20,  ScriptEvent::NOTE_ON,  91, 64,  0},
+    {40,  ScriptEvent::BEND,     0,  0,   4096},
+    {60,  ScriptEvent::NOTE_OFF, 60, 0,   0},
+    {60,  ScriptEvent::BEND,     0,  0,   -2048},
+    {80,  ScriptEvent::NOTE_ON,  60, 110, 0},
+    {80,  ScriptEvent::NOTE_ON,  64, 20,  0},
+    {100, ScriptEvent::NOTE_OFF, 48, 0,   0},
+    {100, ScriptEvent::NOTE_OFF, 60, 0,   0},
+    {100, ScriptEvent::NOTE_OFF, 64, 0,   0},
+    {100, ScriptEvent::NOTE_OFF, 72, 0,   0},
+    {100, ScriptEvent::NOTE_OFF, 91, 0,   0},
+    {100, ScriptEvent::BEND,     0,  0,   0},
+};
+
+void setAllEffects(Synth& synth, bool on) {
+    synth.setDelayEnabled(on);
+    synth.setChorusEnabled(on);
+    synth.setReverbEnabled(on);
+    synth.setLpfEnabled(on);
+    synth.setHpfEnabled(on);
+}
+
+/**
+ * @brief 1ケース分スクリプトを鳴らす
+ *
+ * @param preset プリセット
+ * @param algo アルゴリズム (-1: プリセットのまま)
+ * @param fx エフェクト全ON / 全OFF
+ */
+void renderCase(HostEngine& engine, uint8_t preset, int algo, bool fx, Case& out, bool keep_pcm) {
+    Synth& synth = engine.synth();
+    randomSeed(GOLDEN_SEED);
+    synth.reset();
+    synth.setPitchBend(0);
+    synth.loadPreset(preset);
+    if (algo >= 0) synth.setAlgorithm(static_cast<uint8_t>(algo));
+    setAllEffects(synth, fx);
+    synth.reset(); // エフェクトの状態を揃える
+
+    out.hash = HASH_INIT;
+    out.pcm.clear();
+    if (keep_pcm) out.pcm.reserve(GOLDEN_SAMPLES);
+
+    size_t next = 0;
+    for (uint32_t b = 0; b < GOLDEN_BLOCKS; ++b) {
+        for (; next < sizeof(SCRIPT) / sizeof(SCRIPT[0]) && SCRIPT[next].block == b; ++next) {
+            const ScriptEvent& e = SCRIPT[next];
+            switch (e.type) {
+                case ScriptEvent::NOTE_ON:  synth.noteOn(e.note, e.velocity, 1); break;
+                case ScriptEvent::NOTE_OFF: synth.noteOff(e.note, 1); break;
+                case ScriptEvent::BEND:     synth.setPitchBend(e.bend); break;
+            }
+        }
+
+        engine.renderBlock();
+        out.hash = hashBlock(out.hash, engine.left(), engine.right(), BUFFER_SIZE);
+        if (keep_pcm) {
+            for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+                out.pcm.push_back(engine.left()[i]);
+                out.pcm.push_back(engine.right()[i]);
+            }
+        }
+    }
+}
+
+void renderAll(std::vector<Case>& cases, bool keep_pcm) {
+    HostEngine engine;
+    cases.clear();
+
+    for (uint8_t p = 0; p < MAX_PRESETS; ++p) {
+        for (int fx = 0; fx < 2; ++fx) {
+            Case c = {};
+            snprintf(c.name, NAME_LEN, "PRESET %02u FX %s", p, fx ? "ON" : "OFF");
+            renderCase(engine, p, -1, fx, c, keep_pcm);
+            cases.push_back(std::move(c));
+        }
+    }
+    for (int a = 0; a < 32; ++a) {
+        for (int fx = 0; fx < 2; ++fx) {
+            Case c = {};
+            snprintf(c.name, NAME_LEN, "ALGO %02d FX %s", a, fx ? "ON" : "OFF");
+            renderCase(engine, GOLDEN_ALGO_PRESET, a, fx, c, keep_pcm);
+            cases.push_back(std::move(c));
+        }
+    }
+    engine.synth().reset();
+}
+
+// --------------
+// ファイル入出力
+// --------------
+bool writeGolden(const char* path, const std::vector<Case>& cases, bool has_pcm) {
+    FILE* fp = std::fopen(path, "wb");
+    if (!fp) return false;
+
+    const uint32_t count = static_cast<uint32_t>(cases.size());
+    const uint32_t blocks = GOLDEN_BLOCKS;
+    const uint8_t pcm_flag = has_pcm ? 1 : 0;
+    bool ok = std::fwrite(GOLDEN_MAGIC, sizeof(GOLDEN_MAGIC), 1, fp) == 1
+           && std::fwrite(&count, sizeof(count), 1, fp) == 1
+           && std::fwrite(&blocks, sizeof(blocks), 1, fp) == 1
+           && std::fwrite(&pcm_flag, sizeof(pcm_flag), 1, fp) == 1;
+
+    for (const Case& c : cases) {
+        if (!ok) break;
+        ok = std::fwrite(c.name, NAME_LEN, 1, fp) == 1
+          && std::fwrite(&c.hash, sizeof(c.hash), 1, fp) == 1;
+        if (ok && has_pcm) {
+            ok = std::fwrite(c.pcm.data(), sizeof(int16_t), c.pcm.size(), fp) == c.pcm.size();
+        }
+    }
+    return std::fclose(fp) == 0 && ok;
+}
+
+bool readGolden(const char* path, std::vector<Case>& cases, bool& has_pcm, std::string& error) {
+    FILE* fp = std::fopen(path, "rb");
+    if (!fp) { error = "cannot open file"; return false; }
+
+    char magic[8];
+    uint32_t count = 0, blocks = 0;
+    uint8_t pcm_flag = 0;
+    if (std::fread(magic, sizeof(magic), 1, fp) != 1 || std::memcmp(magic, GOLDEN_MAGIC, sizeof(magic)) != 0
+        || std::fread(&count, sizeof(count), 1, fp) != 1
+        || std::fread(&blocks, sizeof(blocks), 1, fp) != 1
+        || std::fread(&pcm_flag, sizeof(pcm_flag), 1, fp) != 1) {
+        std::fclose(fp);
+        error = "not a golden file";
+        return false;
+    }
+    if (blocks != GOLDEN_BLOCKS) {
+        std::fclose(fp);
+        error = "recorded with a different script length";
+        return false;
+    }
+
+    has_pcm = pcm_flag != 0;
+    cases.resize(count);
+    for (Case& c : cases) {
+        bool ok = std::fread(c.name, NAME_LEN, 1, fp) == 1
+               && std::fread(&c.hash, sizeof(c.hash), 1, fp) == 1;
+        c.name[NAME_LEN - 1] = '\0';
+        if (ok && has_pcm) {
+            c.pcm.resize(GOLDEN_SAMPLES);
+            ok = std::fread(c.pcm.data(), sizeof(int16_t), GOLDEN_SAMPLES, fp) == GOLDEN_SAMPLES;
+        }
+        if (!ok) {
+            std::fclose(fp);
+            error = "truncated file";
+            return false;
+        }
+    }
+    std::fclose(fp);
+    return true;
+}
+
+// --------------
+// 差分評価
+// --------------
+// -ffast-math 下では inf / NaN を比較に使えないので番兵値で表す
+constexpr double SNR_EXACT = 999.0;
+constexpr double SNR_SILENT_REF = -999.0;
+
+struct Diff {
+    int32_t max_abs = 0;
+    double snr_db = SNR_EXACT;
+    uint32_t first = 0;     // 最初に異なったサンプル位置（フレーム）
+};
+
+Diff compare(const std::vector<int16_t>& ref, const std::vector<int16_t>& out) {
+    Diff d;
+    double sig = 0.0, err = 0.0;
+    bool found = false;
+    for (size_t i = 0; i < ref.size() && i < out.size(); ++i) {
+        const int32_t e = static_cast<int32_t>(out[i]) - ref[i];
+        if (e != 0 && !found) {
+            d.first = static_cast<uint32_t>(i / 2);
+            found = true;
+        }
+        d.max_abs = std::max(d.max_abs, std::abs(e));
+        sig += static_cast<double>(ref[i]) * ref[i];
+        err += static_cast<double>(e) * e;
+    }
+    if (err > 0.0) d.snr_db = (sig > 0.0) ? 10.0 * std::log10(sig / err) : SNR_SILENT_REF;
+    return d;
+}
+
+void printUsage() {
+    std::printf("usage: golden record <file> [--pcm]\n"
+                "       golden check <file> [--max N] [--snr dB]\n");
+}
+
+int record(const char* path, bool keep_pcm) {
+    std::vector<Case> cases;
+    renderAll(cases, keep_pcm);
+    if (!writeGolden(path, cases, keep_pcm)) {
+        std::printf("ERR: cannot write %s\n", path);
+        return 1;
+    }
+    std::printf("OK: recorded %zu cases to %s%s\n", cases.size(), path, keep_pcm ? " (with PCM)" : "");
+    return 0;
+}
+
+/**
+ * @param max_abs 許容最大誤差 (-1: 判定しない)
+ * @param use_snr SNR で判定する
+ * @param min_snr 許容最小 SNR (dB)
+ */
+int check(const char* path, int32_t max_abs, bool use_snr, double min_snr) {
+    const bool tolerant = max_abs >= 0 || use_snr;
+
+    std::vector<Case> ref;
+    bool has_pcm = false;
+    std::string error;
+    if (!readGolden(path, ref, has_pcm, error)) {
+        std::printf("ERR: %s: %s\n", path, error.c_str());
+        return 1;
+    }
+    if (tolerant && !has_pcm) {
+        std::printf("ERR: --max/--snr need a golden file recorded with --pcm\n");
+        return 1;
+    }
+
+    std::vector<Case> out;
+    renderAll(out, has_pcm);
+    if (out.size() != ref.size()) {
+        std::printf("ERR: case count differs (golden %zu, now %zu)\n", ref.size(), out.size());
+        return 1;
+    }
+
+    int failures = 0;
+    int approx = 0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+        if (out[i].hash == ref[i].hash) continue;
+
+        if (!has_pcm) {
+            std::printf("  %-22s hash %016llx != %016llx\n", ref[i].name,
+                        static_cast<unsigned long long>(out[i].hash),
+                        static_cast<unsigned long long>(ref[i].hash));
+            ++failures;
+            continue;
+        }
+
+        const Diff d = compare(ref[i].pcm, out[i].pcm);
+        const bool pass = tolerant
+            && (max_abs < 0 || d.max_abs <= max_abs)
+            && (!use_snr || d.snr_db >= min_snr);
+        std::printf("  %-22s max %5d  snr %6.1f dB  first @%u%s\n", ref[i].name,
+                    d.max_abs, d.snr_db, d.first, pass ? "" : "  <-- FAIL");
+        if (pass) ++approx;
+        else ++failures;
+    }
+
+    if (failures) {
+        std::printf("ERR: %d of %zu cases differ\n", failures, ref.size());
+        return 1;
+    }
+    std::printf("OK: %zu cases (%zu bit-exact, %d within tolerance)\n",
+                ref.size(), ref.size() - approx, approx);
+    return 0;
+}
+
+} // namespace
+
+int runGolden(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 2;
+    }
+    const char* mode = argv[1];
+    const char* path = argv[2];
+
+    bool keep_pcm = false;
+    int32_t max_abs = -1;
+    bool use_snr = false;
+    double min_snr = 0.0;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--pcm") == 0) keep_pcm = true;
+        else if (std::strcmp(argv[i], "--max") == 0 && i + 1 < argc) max_abs = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--snr") == 0 && i + 1 < argc) {
+            use_snr = true;
+            min_snr = std::atof(argv[++i]);
+        }
+        else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (std::strcmp(mode, "record") == 0) return record(path, keep_pcm);
+    if (std::strcmp(mode, "check") == 0) return check(path, max_abs, use_snr, min_snr);
+    printUsage();
+    return 2;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// ============================================
+// ホストツール共通 ([env:native] 専用)
+// ============================================
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "modules/synth.hpp"
+#include "modules/delay.hpp"
+#include "modules/filter.hpp"
+#include "modules/chorus.hpp"
+#include "modules/reverb.hpp"
+#include "modules/effect_arena.hpp"
+#include "tools/trace.hpp"
+
+/**
+ * @brief ホスト上でシンセを駆動するためのエンジン
+ *
+ * main.cpp と同じ順序でエフェクトを共有させて Synth を初期化し、
+ * AudioHandler の代わりに 1 ブロックずつ生成結果を取り出す。
+ * Synth はシングルトンなので、プロセス内で1つだけ作ること。
+ */
+class HostEngine {
+private:
+    Delay delay_ = {};
+    Filter filter_ = {};
+    Chorus chorus_ = {};
+    Reverb reverb_ = {};
+    EffectArena arena_ = {delay_, chorus_, reverb_};
+
+public:
+    HostEngine();
+
+    Synth& synth() { return Synth::getInstance(); }
+
+    /** @brief 1ブロック (BUFFER_SIZE サンプル) 生成する */
+    void renderBlock();
+
+    /** @brief 直前に生成したブロック */
+    const Sample16_t* left() const { return samples_L; }
+    const Sample16_t* right() const { return samples_R; }
+};
+
+/** @brief MIDI メッセージを MIDIHandler と同じ解釈でシンセに渡す (ch: 1-16) */
+void dispatchMidi(Synth& synth, uint8_t type, uint8_t ch, uint8_t d1, uint8_t d2);
+
+// --------------
+// 出力ハッシュ (FNV-1a 64bit)
+// --------------
+constexpr uint64_t HASH_INIT = 1469598103934665603ULL;
+
+inline uint64_t hashBlock(uint64_t h, const Sample16_t* left, const Sample16_t* right, size_t n) {
+    constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+    for (size_t i = 0; i < n; ++i) {
+        h = (h ^ static_cast<uint16_t>(left[i])) * FNV_PRIME;
+        h = (h ^ static_cast<uint16_t>(right[i])) * FNV_PRIME;
+    }
+    return h;
+}
+
+// --------------
+// トレース出力 (trace.cpp)
+// --------------
+bool writeChromeTrace(const char* path, const Trace::Record* records, size_t count,
+                      uint32_t ticks_per_sec, std::string& error);
+
+// --------------
+// サブコマンド
+// --------------
+int runSmoke(int argc, char** argv);
+int runRender(int argc, char** argv);
+int runBench(int argc, char** argv);
+int runGolden(int argc, char** argv);
+int runCompare(int argc, char** argv);
+int runTrace(int argc, char** argv);
+int runReplay(int argc, char** argv);
+int runStress(int argc, char** argv);
+int runPanel(int argc, char** argv);
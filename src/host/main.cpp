@@ -0,0 +1,55 @@
+/** Cranberry Synth - host tools **/
+/** [env:native] 用のエントリポイント。DSPコアを PC 上で動かす **/
+/** pio test ではテストの main() を使うので外す **/
+
+#ifndef PIO_UNIT_TESTING
+
+#include <cstdio>
+#include <cstring>
+
+#include "host.hpp"
+
+struct HostCommand {
+    const char* name;
+    const char* usage;
+    int (*run)(int argc, char** argv);
+};
+
+static const HostCommand COMMANDS[] = {
+    {"smoke",  "smoke                    全プリセットを鳴らして出力を確認", runSmoke},
+    {"render", "render <in.mid> [opts]   SMF を WAV に書き出し、処理時間を表示", runRender},
+    {"bench",  "bench [GROUP] [FULL]     モジュール別ベンチマーク (実機の BENCH と同じ表)", runBench},
+    {"golden", "golden record|check <file> [opts]  全プリセット/全アルゴリズムの出力回帰チェック", runGolden},
+    {"compare", "compare [opts]           固定小数点エンジンと倍精度リファレンスの比較 (SNR/THD/エンベロープ時間)", runCompare},
+    {"trace",  "trace <capture> [-o out.json]  TRACE DUMP を Chrome / Perfetto のトレース JSON に変換", runTrace},
+    {"replay", "replay <capture.crb> [opts]  CAPTURE SAVE の入力を同じブロック境界で再生し、遅いブロックを表示", runReplay},
+    {"stress", "stress [SCENARIO] [-n blocks]  最悪ケースの入力でブロック時間を計測 (実機の STRESS と同じ表)", runStress},
+    {"panel",  "panel [-n frames]        模擬パネルで UI を回し、画面ごとの転送量と転送結果を確認", runPanel},
+};
+
+static void printUsage(const char* prog) {
+    std::printf("usage: %s <command> [args]\n\n", prog);
+    for (const HostCommand& cmd : COMMANDS) {
+        std::printf("  %s\n", cmd.usage);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    for (const HostCommand& cmd : COMMANDS) {
+        if (std::strcmp(argv[1], cmd.name) == 0) {
+            // サブコマンド以降の引数を渡す (argv[0] はコマンド名)
+            return cmd.run(argc - 1, argv + 1);
+        }
+    }
+
+    std::printf("ERR: unknown command '%s'\n\n", argv[1]);
+    printUsage(argv[0]);
+    return 2;
+}
+
+#endif // PIO_UNIT_TESTING
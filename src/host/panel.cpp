@@ -0,0 +1,196 @@
+#include "host.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "ui/screens/preset.hpp"
+#include "ui/screens/operator.hpp"
+#include "ui/screens/oscilloscope.hpp"
+
+/**
+ * @brief 模擬パネルで UI を回し、転送量と転送結果を確認する
+ *
+ * PRESET / OPERATOR / OSCILLOSCOPE の各画面で、ボタン操作とノートを決まった順に入れながら
+ * UIManager::render() を 60FPS 相当で回す。ディスプレイは Adafruit_SSD1351 シムの模擬パネルで、
+ * 毎フレーム後にパネルの全画素がキャンバスと一致し、窓の外に画素が来ていないことを確かめる。
+ *
+ * 1回目はオーディオ処理を GFX_CHUNK_H 行ごとに挟み（実機で再生キューに余裕がないとき）、
+ * 画面ごとの転送量を GET DISPLAY と同じ表で出す。2回目は挟む位置を乱数で変え、
+ * 窓を設定し直す経路を一通り通す。
+ */
+static constexpr int PANEL_DEFAULT_FRAMES = 300;  // 画面ごと (60FPS で 5秒)
+static constexpr uint32_t PANEL_FRAME_US = 16667;
+
+// main.cpp の代わりに持つもの（ホストでは postmortem.cpp / midi_player.cpp をビルドしない）
+// パススルーと MIDI プレイヤーの画面には入らないので、つなぐだけ
+AudioCallback gfxAudioCallback = nullptr;
+AudioDueCheck gfxAudioDue = nullptr;
+const char* volatile PostMortem::screen_ = "";
+
+static State passthrough_state;
+static AudioHandler passthrough_audio(passthrough_state);
+static Delay passthrough_delay;
+static Filter passthrough_filter;
+static Chorus passthrough_chorus;
+static Reverb passthrough_reverb;
+static EffectArena passthrough_arena(passthrough_delay, passthrough_chorus, passthrough_reverb);
+Passthrough passthrough(passthrough_audio, passthrough_filter, passthrough_delay, passthrough_chorus,
+                        passthrough_reverb, passthrough_arena);
+
+void MIDIPlayer::play(const char*) {}
+void MIDIPlayer::stop() {}
+
+namespace {
+
+uint32_t g_breaks = 0;
+uint32_t g_rng = 1;
+
+void countBreak() { ++g_breaks; }
+
+// 2回目: 1〜GFX_CHUNK_H_MAX 行のばらばらな位置で挟む
+bool randomDue(int16_t rows) {
+    (void)rows;
+    g_rng = g_rng * 1103515245u + 12345u;
+    return ((g_rng >> 16) & 7) == 0;
+}
+
+enum PanelScreen : uint8_t { P_PRESET = 0, P_OPERATOR, P_OSCILLOSCOPE, P_COUNT };
+const char* const SCREEN_NAMES[P_COUNT] = {"PRESET", "OPERATOR", "OSCILLOSCOPE"};
+
+Screen* makeScreen(PanelScreen s) {
+    switch (s) {
+        case P_PRESET:   return new PresetScreen();
+        case P_OPERATOR: return new OperatorScreen(0);
+        default:         return new OscilloscopeScreen();
+    }
+}
+
+// 画面ごとの操作。f はその画面に入ってからのフレーム
+void feedInput(PanelScreen s, int f, State& state, Synth& synth) {
+    static const uint8_t CHORD[] = {48, 55, 64, 71};
+    const uint8_t root = static_cast<uint8_t>(f / 60 % 3 * 2);
+
+    // 1秒ごとに和音を弾き直す（PRESET は発音数、OSCILLOSCOPE は波形が動く）
+    if (f % 60 == 0) {
+        for (uint8_t note : CHORD) synth.noteOn(note + root, 100, 1);
+    } else if (f % 60 == 45) {
+        for (uint8_t note : CHORD) synth.noteOff(note + root, 1);
+    }
+
+    uint8_t button = BTN_NONE;
+    switch (s) {
+        case P_PRESET:
+            // プリセットを送り、ときどきカーソルを動かして戻す
+            if (f % 40 == 20) button = BTN_R;
+            else if (f % 120 == 70) button = BTN_DN;
+            else if (f % 120 == 90) button = BTN_UP;
+            state.setCpuUsage(20.0f + static_cast<float>(f % 50) * 0.3f);
+            break;
+        case P_OPERATOR: {
+            // カーソルを進めながら値を上げ下げする
+            static const uint8_t SEQ[] = {BTN_DN, BTN_R, BTN_R, BTN_L, BTN_R_LONG, BTN_L_LONG};
+            if (f % 10 == 5) button = SEQ[f / 10 % (sizeof(SEQ) / sizeof(SEQ[0]))];
+            break;
+        }
+        default:
+            // チャンネル・ゲイン・ズームを切り替える
+            if (f % 90 == 30) button = BTN_DN;
+            else if (f % 90 == 60) button = (f / 90 % 2) ? BTN_L : BTN_R;
+            else if (f % 180 == 80) button = BTN_DN_LONG;
+            break;
+    }
+    if (button != BTN_NONE) state.setBtnState(button);
+}
+
+// パネルとキャンバスの最初の食い違い。一致すれば -1
+int firstMismatch(const UIManager& ui) {
+    const HostPanel& panel = HostPanel::get();
+    const uint16_t* canvas = ui.getCanvas().getBuffer();
+    for (int i = 0; i < HostPanel::WIDTH * HostPanel::HEIGHT; ++i) {
+        if (panel.pixels[i] != canvas[i]) return i;
+    }
+    return -1;
+}
+
+// 3画面を順に回す。食い違いがあれば false
+bool runPass(HostEngine& engine, int frames, const char* label) {
+    Synth& synth = engine.synth();
+    State state;
+    UIManager ui(state);
+
+    synth.reset();
+    synth.loadPreset(0);
+    GFX_SSD1351::clearStats();
+    HostPanel::get().resetCounters();
+    g_breaks = 0;
+
+    double block_debt = 0.0;
+    int total = 0;
+    for (uint8_t s = 0; s < P_COUNT; ++s) {
+        const PanelScreen screen = static_cast<PanelScreen>(s);
+        ui.popScreen();
+        ui.pushScreen(makeScreen(screen));
+
+        for (int f = 0; f < frames; ++f, ++total) {
+            feedInput(screen, f, state, synth);
+            ui.poll();
+
+            // 1フレーム分の音を進めてから描く
+            hostAdvanceClock(PANEL_FRAME_US);
+            block_debt += PANEL_FRAME_US * 1e-6 * SAMPLE_RATE / BUFFER_SIZE;
+            for (; block_debt >= 1.0; block_debt -= 1.0) engine.renderBlock();
+            ui.render();
+
+            const int bad = firstMismatch(ui);
+            if (bad >= 0 || HostPanel::get().stray != 0) {
+                std::printf("ERR: %s, %s frame %d: ", label, SCREEN_NAMES[screen], f);
+                if (bad >= 0) std::printf("panel differs from canvas at (%d,%d)\n",
+                                          bad % HostPanel::WIDTH, bad / HostPanel::WIDTH);
+                else std::printf("%lu pixels outside the window\n", (unsigned long)HostPanel::get().stray);
+                return false;
+            }
+        }
+    }
+    ui.popScreen();
+
+    const HostPanel& panel = HostPanel::get();
+    std::printf("%s: %d frames, %lu audio breaks, %lu windows, %llu bytes sent, panel matches canvas\n",
+                label, total, (unsigned long)g_breaks, (unsigned long)panel.windows,
+                static_cast<unsigned long long>(panel.sentBytes()));
+    GFX_SSD1351::printStats();
+    return true;
+}
+
+} // namespace
+
+int runPanel(int argc, char** argv) {
+    long frames = PANEL_DEFAULT_FRAMES;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-n" && i + 1 < argc) {
+            frames = std::strtol(argv[++i], nullptr, 10);
+            continue;
+        }
+        std::printf("usage: panel [-n frames]\n");
+        return 2;
+    }
+    if (frames < 1 || frames > 100000) {
+        std::printf("ERR: -n 1-100000\n");
+        return 2;
+    }
+
+    HostEngine engine;
+    GFX_SSD1351::begin();
+    gfxAudioCallback = countBreak;
+
+    gfxAudioDue = nullptr;
+    if (!runPass(engine, static_cast<int>(frames), "breaks every 4 rows")) return 1;
+
+    gfxAudioDue = randomDue;
+    g_rng = 1;
+    if (!runPass(engine, static_cast<int>(frames), "random breaks")) return 1;
+
+    std::printf("OK: panel matches canvas (%d screens x %ld frames x 2)\n", (int)P_COUNT, frames);
+    return 0;
+}
@@ -0,0 +1,297 @@
+#include "reference.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace {
+
+constexpr double TWO_PI = 6.283185307179586;
+constexpr double Q23_SCALE = 1.0 / (1 << 23);
+constexpr double LEVEL_OCTAVE = 1 << 24;   // Q24 対数レベルの1オクターブ
+constexpr uint32_t SOURCE_HARMONICS = Oscillator::MIP_TABLE_SIZE / 2 - 1;  // 元テーブルの倍音上限 (255)
+
+// Envelope::stageInc() と同じ式（64サンプルあたりの増分）
+double stageRate(uint8_t rate_param, int8_t rate_scaling_delta) {
+    int qrate = (static_cast<int>(rate_param) * 41) >> 6;
+    qrate += rate_scaling_delta;
+    qrate = std::clamp(qrate, 0, 63);
+    const double inc = static_cast<double>((4 + (qrate & 3)) << (2 + Envelope::ENV_LG_BLOCK_MAX + (qrate >> 2)));
+    return inc / Envelope::ENV_BLOCK_MAX;
+}
+
+// AudioMath::ratioToFrequency / fixedToFrequency と同じ式を 12平均律の基準周波数で計算
+double exactFrequency(const Oscillator& osc, uint8_t note) {
+    const double detune = osc.getDetune();
+    if (osc.isFixed()) {
+        static constexpr double FIXED_BASE[4] = {1.0, 10.0, 100.0, 1000.0};
+        const double base = FIXED_BASE[static_cast<uint8_t>(osc.getCoarse()) & 0x03];
+        return base * std::exp(std::log(10.0) * osc.getFine() * 0.01) * std::exp2(detune * 0.00083333333);
+    }
+    const double coarse = (osc.getCoarse() == 0.0f) ? 0.5 : osc.getCoarse();
+    const double ratio = coarse * (1.0 + osc.getFine() * 0.01);
+    return 440.0 * std::exp2((note - 69) / 12.0) * ratio * std::exp2(detune * 0.00084833);
+}
+
+const Audio24_t* sourceTable(uint8_t wave) {
+    switch (wave) {
+        case 1: return Wavetable::triangle;
+        case 2: return Wavetable::saw;
+        default: return Wavetable::square;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 帯域制限波形テーブル（キャッシュ）
+ *
+ * 元テーブル (512サンプル) を倍精度 DFT で倍音分解し、harmonics 次までを
+ * TABLE_SIZE 点で再合成する。ミップテーブルと同様、ギブス現象で
+ * 元テーブルのピークを超える場合はピークに合わせて縮小する。
+ */
+const double* ReferenceVoice::bandLimitedTable(uint8_t wave, uint32_t harmonics) {
+    static std::map<uint32_t, std::vector<double>> cache;
+    static std::vector<double> sin_table;
+
+    harmonics = std::min(harmonics, SOURCE_HARMONICS);
+    const uint32_t key = (static_cast<uint32_t>(wave) << 16) | harmonics;
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second.data();
+
+    if (sin_table.empty()) {
+        sin_table.resize(TABLE_SIZE);
+        for (size_t n = 0; n < TABLE_SIZE; ++n) {
+            sin_table[n] = std::sin(TWO_PI * n / TABLE_SIZE);
+        }
+    }
+
+    // 元テーブルの倍音係数
+    const Audio24_t* src = sourceTable(wave);
+    constexpr size_t SRC_N = Oscillator::MIP_TABLE_SIZE;
+    double dc = 0.0;
+    double src_peak = 0.0;
+    for (size_t n = 0; n < SRC_N; ++n) {
+        dc += src[n];
+        src_peak = std::max(src_peak, std::fabs(static_cast<double>(src[n])));
+    }
+    dc /= SRC_N;
+
+    std::vector<double> re(harmonics + 1), im(harmonics + 1);
+    for (uint32_t k = 1; k <= harmonics; ++k) {
+        double c = 0.0, s = 0.0;
+        for (size_t n = 0; n < SRC_N; ++n) {
+            const double w = TWO_PI * static_cast<double>((k * n) % SRC_N) / SRC_N;
+            c += src[n] * std::cos(w);
+            s += src[n] * std::sin(w);
+        }
+        re[k] = 2.0 * c / SRC_N;
+        im[k] = 2.0 * s / SRC_N;
+    }
+
+    // 再合成 (cos は sin テーブルの 1/4 周期先)
+    std::vector<double>& table = cache[key];
+    table.assign(TABLE_SIZE, dc);
+    constexpr size_t MASK = TABLE_SIZE - 1;
+    constexpr size_t QUARTER = TABLE_SIZE / 4;
+    double peak = 0.0;
+    for (size_t n = 0; n < TABLE_SIZE; ++n) {
+        double y = dc;
+        for (uint32_t k = 1; k <= harmonics; ++k) {
+            const size_t idx = (k * n) & MASK;
+            y += re[k] * sin_table[(idx + QUARTER) & MASK] + im[k] * sin_table[idx];
+        }
+        table[n] = y;
+        peak = std::max(peak, std::fabs(y));
+    }
+
+    const double scale = (peak > src_peak ? src_peak / peak : 1.0) * Q23_SCALE;
+    for (double& v : table) v *= scale;
+    return table.data();
+}
+
+/** @brief ノートオン */
+void ReferenceVoice::noteOn(const Synth& synth, uint8_t note, uint8_t velocity, Pitch pitch) {
+    // Synth::noteOn() と同じくベロシティカーブとトランスポーズを適用
+    const uint8_t vel = AudioMath::applyVelocityCurve(velocity > 127 ? 127 : velocity, synth.getVelocityCurve());
+    const int16_t transposed = std::clamp<int16_t>(note + synth.getTranspose(), 0, 127);
+    const uint8_t actual_note = static_cast<uint8_t>(transposed);
+
+    algo_ = &Algorithms::get(synth.getCurrentAlgorithmId());
+    feedback_ = synth.getFeedbackAmount();
+    fb_h0_ = fb_h1_ = 0.0;
+
+    // フィードバックソース (Synth::generate() と同じ判定)
+    const int8_t feedback_op = algo_->feedback_op;
+    fb_source_ = feedback_op;
+    if (feedback_op >= 0 && algo_->mod_mask[feedback_op] != 0) {
+        for (uint8_t src = 0; src < MAX_OPERATORS; ++src) {
+            if (algo_->mod_mask[feedback_op] & (1 << src)) {
+                fb_source_ = src;
+                break;
+            }
+        }
+    }
+
+    double sine_peak = 0.0;
+    for (Audio24_t v : Wavetable::sine) sine_peak = std::max(sine_peak, std::fabs(static_cast<double>(v)));
+
+    for (uint8_t i = 0; i < MAX_OPERATORS; ++i) {
+        Op& op = ops_[i];
+
+        // レベル計算は Envelope に任せる（コピーに対して呼ぶので Synth 側は変わらない）
+        Oscillator osc = synth.getOperatorOsc(i);
+        Envelope env = synth.getOperatorEnv(i);
+        Envelope::Memory mem;
+        env.setOutlevel(osc.getLevel(), vel, actual_note, env.getVelocitySens());
+        env.calcNoteTargetLevels(mem);
+        env.applyRateScaling(mem, actual_note);
+
+        op.target[0] = mem.target_level1;
+        op.target[1] = mem.target_level2;
+        op.target[2] = mem.target_level3;
+        op.target[3] = mem.target_level4;
+        op.rate[0] = stageRate(env.getRate1(), mem.rate_scaling_delta);
+        op.rate[1] = stageRate(env.getRate2(), mem.rate_scaling_delta);
+        op.rate[2] = stageRate(env.getRate3(), mem.rate_scaling_delta);
+        op.rate[3] = stageRate(env.getRate4(), mem.rate_scaling_delta);
+        op.level = 0.0;
+        op.stage = STAGE1;
+
+        if (pitch == Pitch::Shared) {
+            Oscillator::Memory osc_mem;
+            osc.setFrequency(osc_mem, actual_note);
+            op.inc = osc_mem.delta / 4294967296.0;
+        } else {
+            op.inc = exactFrequency(osc, actual_note) / SAMPLE_RATE;
+        }
+        op.phase = 0.0;
+        op.out = 0.0;
+        op.enabled = osc.isEnabled();
+
+        const uint8_t wave = osc.getWavetableId();
+        if (wave == 0) {
+            op.table = nullptr;
+            op.amplitude = sine_peak * Q23_SCALE;
+        } else {
+            // ナイキスト未満の倍音だけを含める
+            uint32_t harmonics = 1;
+            if (op.inc > 0.0) {
+                harmonics = static_cast<uint32_t>(std::max(1.0, std::ceil(0.5 / op.inc) - 1.0));
+            }
+            op.table = bandLimitedTable(wave, harmonics);
+        }
+    }
+}
+
+/** @brief 全オペレーターをリリースへ */
+void ReferenceVoice::noteOff() {
+    for (Op& op : ops_) {
+        if (op.stage != STAGE4 && op.stage != IDLE) op.stage = STAGE4;
+    }
+}
+
+/**
+ * @brief エンベロープを1サンプル進める
+ *
+ * Envelope::update() の状態遷移を 1/64 の増分で毎サンプル行う。
+ * 上昇時の (17 - level) の切り捨ては DX7 型アタックカーブの定義なのでそのまま使う。
+ */
+void ReferenceVoice::advanceEnvelope(Op& op) {
+    if (op.stage == IDLE) {
+        op.level = op.target[3];
+        return;
+    }
+
+    const double tgt = op.target[op.stage];
+    const double inc = op.rate[op.stage];
+    bool reached = false;
+
+    if (op.level > tgt && op.stage != STAGE1) {
+        op.level -= inc;
+        if (op.level <= tgt) {
+            op.level = tgt;
+            reached = true;
+        }
+    } else if (op.level < tgt) {
+        if (op.level < ENV_JUMPTARGET) op.level = ENV_JUMPTARGET;
+        op.level += std::floor(17.0 - op.level / LEVEL_OCTAVE) * inc;
+        if (op.level >= tgt) {
+            op.level = tgt;
+            reached = true;
+        }
+    } else {
+        reached = true;
+    }
+
+    // Phase3 は到達してもサステインを維持
+    if (reached && op.stage != STAGE3) {
+        op.stage = (op.stage == STAGE4) ? IDLE : static_cast<Stage>(op.stage + 1);
+    }
+}
+
+/** @brief 対数レベル → 線形ゲイン (Q24 の 1.0 = 1.0) */
+double ReferenceVoice::envelopeGain(const Op& op) {
+    const double gain = std::exp2(op.level / LEVEL_OCTAVE - 14.0);
+    return std::min(gain, static_cast<double>(ENVGAIN_MAX) / LEVEL_OCTAVE);
+}
+
+/**
+ * @brief 1サンプル生成
+ *
+ * 変調入力 1.0 (= Q23 フルスケール) で半周期の位相オフセット
+ * （固定小数点版の MOD_PHASE_SHIFT と同じスケール）。
+ */
+double ReferenceVoice::next() {
+    if (algo_ == nullptr) return 0.0;
+
+    const bool fb_enabled = feedback_ > 0 && feedback_ <= 7;
+    const double fb_scale = fb_enabled ? std::ldexp(1.0, -(8 - feedback_ + 1)) : 0.0;
+    double mix = 0.0;
+
+    for (uint8_t k = 0; k < MAX_OPERATORS; ++k) {
+        const uint8_t idx = algo_->exec_order[k];
+        Op& op = ops_[idx];
+        const uint8_t mask = algo_->mod_mask[idx];
+        const bool is_fb_target = fb_enabled && idx == algo_->feedback_op;
+        const bool is_fb_source = fb_enabled && idx == fb_source_;
+
+        double mod = 0.0;
+        for (uint8_t src = 0; src < MAX_OPERATORS; ++src) {
+            if (!(mask & (1 << src))) continue;
+            if (is_fb_target && src == fb_source_) continue;
+            mod += ops_[src].out;
+        }
+        if (is_fb_target) mod += (fb_h0_ + fb_h1_) * fb_scale;
+
+        advanceEnvelope(op);
+
+        double wave = 0.0;
+        if (op.enabled) {
+            double p = op.phase + mod * 0.5;
+            p -= std::floor(p);
+            if (op.table == nullptr) {
+                wave = op.amplitude * std::sin(TWO_PI * p);
+            } else {
+                const double x = p * TABLE_SIZE;
+                const size_t i0 = static_cast<size_t>(x) & (TABLE_SIZE - 1);
+                const size_t i1 = (i0 + 1) & (TABLE_SIZE - 1);
+                const double frac = x - std::floor(x);
+                wave = op.table[i0] + (op.table[i1] - op.table[i0]) * frac;
+            }
+        }
+        op.out = wave * envelopeGain(op);
+
+        if (is_fb_source) {
+            fb_h1_ = fb_h0_;
+            fb_h0_ = op.out;
+        }
+
+        op.phase += op.inc;
+        op.phase -= std::floor(op.phase);
+
+        if (algo_->output_mask & (1 << idx)) mix += op.out;
+    }
+    return mix;
+}
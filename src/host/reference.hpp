@@ -0,0 +1,87 @@
+#pragma once
+
+// ============================================
+// 倍精度リファレンスエンジン ([env:native] 専用)
+// ============================================
+
+#include <cstdint>
+#include <cstddef>
+
+#include "modules/synth.hpp"
+
+/**
+ * @brief 倍精度のリファレンス FM ボイス
+ *
+ * Synth に読み込まれたプリセット（オペレーター/エンベロープ/アルゴリズム/フィードバック）を
+ * そのまま読み取り、同じボイス構成を double で計算する。固定小数点版との違い:
+ *
+ * - エンベロープは 64 サンプルごとではなく毎サンプル進め、ゲインは 2^(level - 14) を直接計算
+ * - サイン波は sin()、三角波/ノコギリ波/矩形波はナイキストまでの全倍音を持つ帯域制限波形
+ * - 変調・フィードバック・ミックスは飽和なしの double
+ * - クロスフィードバックもブロック単位ではなく毎サンプル最新の値を使う
+ *
+ * レベル計算（Output Level / KLS / ベロシティ / Rate Scaling）は Envelope と同じ式を
+ * 使う（仕様そのものなので）。LFO / ピッチベンド / エフェクト / リミッターは扱わない。
+ * 出力単位は Q23 と同じ（1.0 = 2^23）。
+ */
+class ReferenceVoice {
+public:
+    // 位相増分の求め方
+    enum class Pitch : uint8_t {
+        Shared,  // 固定小数点版と同じ位相増分 (信号経路の誤差だけを見る)
+        Exact    // 12平均律 A4=440Hz から double で計算
+    };
+
+    static constexpr size_t TABLE_SIZE = 1 << 16;  // 帯域制限波形テーブル長
+
+    /**
+     * @brief ノートオン
+     *
+     * @param synth パラメータの読み出し元
+     * @param note MIDIノート番号（トランスポーズ前）
+     * @param velocity MIDIベロシティ（カーブ適用前）
+     * @param pitch 位相増分の求め方
+     */
+    void noteOn(const Synth& synth, uint8_t note, uint8_t velocity, Pitch pitch = Pitch::Shared);
+
+    /** @brief 全オペレーターをリリースへ */
+    void noteOff();
+
+    /** @brief 1サンプル生成（キャリアの合計、Q23 単位） */
+    double next();
+
+private:
+    enum Stage : uint8_t { STAGE1 = 0, STAGE2, STAGE3, STAGE4, IDLE };
+
+    struct Op {
+        bool enabled = false;
+        const double* table = nullptr;  // nullptr ならサイン波
+        double amplitude = 0.0;         // サイン波の振幅
+        double phase = 0.0;             // [0, 1) 周期
+        double inc = 0.0;               // 1サンプルあたりの周期
+        // エンベロープ (Q24 対数レベルを double で保持)
+        Stage stage = IDLE;
+        double level = 0.0;
+        double target[4] = {};
+        double rate[4] = {};            // 1サンプルあたりの増分
+        double out = 0.0;
+    };
+
+    Op ops_[MAX_OPERATORS];
+    const Algorithm* algo_ = nullptr;
+    uint8_t feedback_ = 0;
+    int8_t fb_source_ = -1;
+    double fb_h0_ = 0.0;
+    double fb_h1_ = 0.0;
+
+    static void advanceEnvelope(Op& op);
+    static double envelopeGain(const Op& op);
+
+    /**
+     * @brief 帯域制限波形テーブル（キャッシュ）
+     *
+     * @param wave 波形ID (1-3)
+     * @param harmonics 倍音数の上限
+     */
+    static const double* bandLimitedTable(uint8_t wave, uint32_t harmonics);
+};
@@ -0,0 +1,195 @@
+#include "host.hpp"
+#include "smf.hpp"
+#include "wav.hpp"
+#include "tools/profiler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief SMF を実エンジンで WAV に書き出す
+ *
+ * イベントはブロック境界で適用する（実機でも MIDI は update() の間に処理されるため）。
+ * update() 1回ごとの所要時間を計測し、リアルタイム比とブロック最大時間を表示する。
+ */
+
+namespace {
+
+constexpr double DEFAULT_TAIL_SEC = 2.0;
+
+struct RenderOptions {
+    const char* input = nullptr;
+    const char* output = "out.wav";
+    const char* trace = nullptr;  // 最後の Trace::CAPACITY 件を Chrome トレースに書き出す
+    int preset = 0;
+    int algo = -1;          // -1: プリセットのまま
+    double tail = DEFAULT_TAIL_SEC;
+    // -1: プリセットのまま, 0: OFF, 1: ON
+    int delay = -1;
+    int chorus = -1;
+    int reverb = -1;
+    int lpf = -1;
+    int hpf = -1;
+};
+
+bool parseSwitch(const char* s, int& out) {
+    if (std::strcmp(s, "on") == 0 || std::strcmp(s, "1") == 0) { out = 1; return true; }
+    if (std::strcmp(s, "off") == 0 || std::strcmp(s, "0") == 0) { out = 0; return true; }
+    return false;
+}
+
+bool parseInt(const char* s, int lo, int hi, int& out) {
+    char* end;
+    long v = std::strtol(s, &end, 10);
+    if (*s == '\0' || *end != '\0' || v < lo || v > hi) return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+bool parseOptions(int argc, char** argv, RenderOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool ok = true;
+
+        if (a[0] != '-') {
+            if (opt.input) return false;
+            opt.input = a;
+            continue;
+        }
+        if (!v) return false;
+        ++i;
+
+        if (std::strcmp(a, "-o") == 0) opt.output = v;
+        else if (std::strcmp(a, "--trace") == 0) opt.trace = v;
+        else if (std::strcmp(a, "-p") == 0) ok = parseInt(v, 0, MAX_PRESETS - 1, opt.preset);
+        else if (std::strcmp(a, "-a") == 0) ok = parseInt(v, 0, 31, opt.algo);
+        else if (std::strcmp(a, "--tail") == 0) { opt.tail = std::atof(v); ok = opt.tail >= 0.0; }
+        else if (std::strcmp(a, "--fx") == 0) {
+            int s;
+            ok = parseSwitch(v, s);
+            opt.delay = opt.chorus = opt.reverb = opt.lpf = opt.hpf = s;
+        }
+        else if (std::strcmp(a, "--delay") == 0)  ok = parseSwitch(v, opt.delay);
+        else if (std::strcmp(a, "--chorus") == 0) ok = parseSwitch(v, opt.chorus);
+        else if (std::strcmp(a, "--reverb") == 0) ok = parseSwitch(v, opt.reverb);
+        else if (std::strcmp(a, "--lpf") == 0)    ok = parseSwitch(v, opt.lpf);
+        else if (std::strcmp(a, "--hpf") == 0)    ok = parseSwitch(v, opt.hpf);
+        else ok = false;
+
+        if (!ok) return false;
+    }
+    return opt.input != nullptr;
+}
+
+void printUsage() {
+    std::printf("usage: render <in.mid> [-o out.wav] [-p preset 0-%d] [-a algo 0-31]\n"
+                "              [--fx on|off] [--delay|--chorus|--reverb|--lpf|--hpf on|off]\n"
+                "              [--tail sec] [--trace out.json]\n", MAX_PRESETS - 1);
+}
+
+} // namespace
+
+int runRender(int argc, char** argv) {
+    RenderOptions opt;
+    if (!parseOptions(argc, argv, opt)) {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<SmfEvent> events;
+    std::string error;
+    if (!loadSmf(opt.input, events, error)) {
+        std::printf("ERR: %s: %s\n", opt.input, error.c_str());
+        return 1;
+    }
+
+    HostEngine engine;
+    Synth& synth = engine.synth();
+    synth.loadPreset(static_cast<uint8_t>(opt.preset));
+    if (opt.algo >= 0)   synth.setAlgorithm(static_cast<uint8_t>(opt.algo));
+    if (opt.delay >= 0)  synth.setDelayEnabled(opt.delay);
+    if (opt.chorus >= 0) synth.setChorusEnabled(opt.chorus);
+    if (opt.reverb >= 0) synth.setReverbEnabled(opt.reverb);
+    if (opt.lpf >= 0)    synth.setLpfEnabled(opt.lpf);
+    if (opt.hpf >= 0)    synth.setHpfEnabled(opt.hpf);
+
+    WavWriter wav;
+    if (!wav.open(opt.output, SAMPLE_RATE)) {
+        std::printf("ERR: cannot write %s\n", opt.output);
+        return 1;
+    }
+
+    if (opt.trace) Trace::start(0, false);
+
+    const double end_sec = (events.empty() ? 0.0 : events.back().seconds) + opt.tail;
+    const uint64_t total_blocks = static_cast<uint64_t>(std::ceil(end_sec * SAMPLE_RATE / BUFFER_SIZE));
+
+    using Clock = std::chrono::steady_clock;
+    double render_sec = 0.0;
+    double block_max = 0.0;
+    uint64_t block_max_index = 0;
+    int32_t peak = 0;
+    size_t next = 0;
+
+    for (uint64_t b = 0; b < total_blocks; ++b) {
+        // このブロック内に来るイベントを、ブロック生成前にまとめて適用
+        const double block_end = static_cast<double>((b + 1) * BUFFER_SIZE) / SAMPLE_RATE;
+        while (next < events.size() && events[next].seconds < block_end) {
+            const SmfEvent& e = events[next++];
+            dispatchMidi(synth, e.type(), e.channel(), e.data1, e.data2);
+        }
+
+        const auto t0 = Clock::now();
+        engine.renderBlock();
+        const double dt = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        render_sec += dt;
+        if (dt > block_max) {
+            block_max = dt;
+            block_max_index = b;
+        }
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            peak = std::max(peak, std::max(std::abs(static_cast<int32_t>(engine.left()[i])),
+                                           std::abs(static_cast<int32_t>(engine.right()[i]))));
+        }
+        if (!wav.writeStereo(engine.left(), engine.right(), BUFFER_SIZE)) {
+            std::printf("ERR: write failed: %s\n", opt.output);
+            return 1;
+        }
+    }
+    wav.close();
+    Trace::stop();
+
+    const double audio_sec = static_cast<double>(total_blocks * BUFFER_SIZE) / SAMPLE_RATE;
+    const double budget_us = 1e6 * BUFFER_SIZE / SAMPLE_RATE;
+    const double peak_db = peak > 0 ? 20.0 * std::log10(peak / 32767.0) : -INFINITY;
+
+    std::printf("input    %s (%zu events)\n", opt.input, events.size());
+    std::printf("output   %s\n", opt.output);
+    std::printf("preset   %d %s  algo %d\n", opt.preset, synth.getCurrentPresetName(),
+                synth.getCurrentAlgorithmId());
+    std::printf("audio    %.3f s (%llu blocks)\n", audio_sec, static_cast<unsigned long long>(total_blocks));
+    std::printf("render   %.3f s  realtime x%.1f\n", render_sec,
+                render_sec > 0.0 ? audio_sec / render_sec : 0.0);
+    std::printf("block    avg %.1f us  max %.1f us @ %.3f s  (budget %.0f us)\n",
+                total_blocks ? 1e6 * render_sec / total_blocks : 0.0, 1e6 * block_max,
+                static_cast<double>(block_max_index * BUFFER_SIZE) / SAMPLE_RATE, budget_us);
+    std::printf("peak     %.1f dBFS\n", peak_db);
+    if (opt.trace) {
+        std::vector<Trace::Record> records(Trace::count());
+        for (uint16_t i = 0; i < Trace::count(); ++i) records[i] = Trace::at(i);
+        if (!writeChromeTrace(opt.trace, records.data(), records.size(), Profiler::ticksPerSecond(), error)) {
+            std::printf("ERR: %s: %s\n", opt.trace, error.c_str());
+            return 1;
+        }
+        std::printf("trace    %s (last %zu events, %lu dropped)\n", opt.trace, records.size(),
+                    (unsigned long)Trace::dropped());
+    }
+    std::printf("\n");
+    Profiler::print();  // 実機の GET PERF と同じ表 (ns)
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include "host.hpp"
+#include "wav.hpp"
+#include "handlers/param_command.hpp"
+#include "tools/capture.hpp"
+#include "tools/profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @brief CAPTURE SAVE のファイルを実エンジンで再生する
+ *
+ * 記録されたブロック数の位置でイベントを適用しながら generate() を回すので、
+ * 実機と同じブロック境界で同じ入力が入り、出力はビット単位で一致する。
+ * 各ブロックの所要時間を測り、予算を超えたブロックと直前に入ったイベントを表示する。
+ *
+ * 無音で generate() が止まっている区間は時間軸に含まれない（実機でも進まないため）。
+ * 記録されていない操作（UI でのパラメータ編集など）が挟まると、そこから先は一致しない。
+ * 実機でリングから捨てたエントリがある、または記録開始前に音色を編集していた場合は
+ * 起点の状態を再現できないので警告し、--expect は失敗にする。
+ */
+
+namespace {
+
+constexpr double DEFAULT_TAIL_SEC = 2.0;
+constexpr size_t DEFAULT_TOP = 5;
+
+struct ReplayOptions {
+    const char* input = nullptr;
+    const char* output = nullptr;     // 指定時のみ WAV を書く
+    double budget_us = 1e6 * BUFFER_SIZE / SAMPLE_RATE;
+    double tail = DEFAULT_TAIL_SEC;   // 最後のイベントの後に鳴らし続ける上限
+    size_t top = DEFAULT_TOP;
+    const char* expect = nullptr;     // 出力ハッシュの期待値 (16進)
+};
+
+struct Entry {
+    uint32_t block;    // first_block からの相対
+    uint8_t offset;
+    uint8_t kind;
+    uint8_t source;
+    std::string payload;
+};
+
+struct BlockStat {
+    uint32_t block;
+    double us;
+    size_t first_event;  // このブロックの直前に適用したイベント [first_event, end_event)
+    size_t end_event;
+};
+
+bool parseOptions(int argc, char** argv, ReplayOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (a[0] != '-') {
+            if (opt.input) return false;
+            opt.input = a;
+            continue;
+        }
+        if (!v) return false;
+        ++i;
+
+        if (std::strcmp(a, "-o") == 0) opt.output = v;
+        else if (std::strcmp(a, "--budget-us") == 0) { opt.budget_us = std::atof(v); if (opt.budget_us <= 0.0) return false; }
+        else if (std::strcmp(a, "--tail") == 0) { opt.tail = std::atof(v); if (opt.tail < 0.0) return false; }
+        else if (std::strcmp(a, "--top") == 0) opt.top = static_cast<size_t>(std::atoi(v));
+        else if (std::strcmp(a, "--expect") == 0) opt.expect = v;
+        else return false;
+    }
+    return opt.input != nullptr;
+}
+
+void printUsage() {
+    std::printf("usage: replay <capture.crb> [-o out.wav] [--budget-us N] [--top N] [--tail sec]\n"
+                "              [--expect <hash>]\n"
+                "       capture.crb: 実機の CAPTURE SAVE で保存したファイル\n");
+}
+
+bool loadCapture(const char* path, Capture::FileHeader& header, std::vector<Entry>& entries, std::string& error) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) { error = "cannot open file"; return false; }
+
+    bool ok = std::fread(&header, sizeof(header), 1, f) == 1;
+    if (!ok) error = "truncated header";
+    else if (std::memcmp(header.magic, "CRBC", 4) != 0) { error = "not a capture file"; ok = false; }
+    else if (header.version == 0 || header.version > Capture::FORMAT_VERSION) {
+        error = "unsupported format version " + std::to_string(header.version);
+        ok = false;
+    }
+    else if (header.block_size != BUFFER_SIZE || header.sample_rate != SAMPLE_RATE) {
+        error = "block size / sample rate mismatch";
+        ok = false;
+    }
+
+    for (uint32_t i = 0; ok && i < header.entries; ++i) {
+        Capture::EntryHeader h;
+        char payload[256];
+        if (std::fread(&h, sizeof(h), 1, f) != 1 || std::fread(payload, 1, h.len, f) != h.len) {
+            error = "truncated entry " + std::to_string(i);
+            ok = false;
+            break;
+        }
+        entries.push_back({h.block - header.first_block, h.offset, h.kind, h.source, std::string(payload, h.len)});
+    }
+    std::fclose(f);
+    return ok;
+}
+
+const char* sourceName(uint8_t source) {
+    static const char* const NAMES[] = {"USB", "SER7", "PLAY", "CMD", "SYNTH"};
+    return source < Capture::SOURCE_COUNT ? NAMES[source] : "?";
+}
+
+std::string describe(const Entry& e) {
+    char buf[96];
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(e.payload.data());
+    switch (e.kind) {
+        case Capture::MIDI:
+            if (e.payload.size() < 4) return "MIDI ?";
+            switch (p[0]) {
+                case 0x90: std::snprintf(buf, sizeof(buf), "NOTE_ON  ch%u %u v%u", p[1], p[2], p[3]); break;
+                case 0x80: std::snprintf(buf, sizeof(buf), "NOTE_OFF ch%u %u", p[1], p[2]); break;
+                case 0xE0: std::snprintf(buf, sizeof(buf), "BEND     ch%u %d", p[1], ((p[3] << 7) | p[2]) - 8192); break;
+                case 0xB0: std::snprintf(buf, sizeof(buf), "CC       ch%u #%u=%u", p[1], p[2], p[3]); break;
+                default:   std::snprintf(buf, sizeof(buf), "MIDI %02X", p[0]); break;
+            }
+            return buf;
+        case Capture::COMMAND:
+            return e.payload;
+        case Capture::PRESET:
+            std::snprintf(buf, sizeof(buf), "PRESET   %u", e.payload.empty() ? 0 : p[0]);
+            return buf;
+        case Capture::RANDOM_PRESET: {
+            uint32_t seed = 0;
+            std::memcpy(&seed, e.payload.data(), std::min<size_t>(e.payload.size(), sizeof(seed)));
+            std::snprintf(buf, sizeof(buf), "RANDOM   seed %08lx", (unsigned long)seed);
+            return buf;
+        }
+        case Capture::RESET:
+            return "RESET";
+        default:
+            std::snprintf(buf, sizeof(buf), "UNKNOWN %u", e.kind);
+            return buf;
+    }
+}
+
+// 実機で各入力を受けたときと同じ経路でシンセに渡す
+void apply(Synth& synth, const Entry& e) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(e.payload.data());
+    switch (e.kind) {
+        case Capture::MIDI:
+            if (e.payload.size() >= 4) dispatchMidi(synth, p[0], p[1], p[2], p[3]);
+            break;
+        case Capture::COMMAND:
+            // "SET " を除いて SerialHandler と同じ処理へ（応答は捨てる）
+            if (e.payload.compare(0, 4, "SET ") == 0) {
+                const std::string arg = e.payload.substr(4);
+                Serial.setMuted(true);
+                ParamCommand::set(arg.c_str(), static_cast<uint8_t>(arg.size()));
+                Serial.setMuted(false);
+            }
+            break;
+        case Capture::PRESET:
+            if (!e.payload.empty()) synth.loadPreset(p[0]);
+            break;
+        case Capture::RANDOM_PRESET: {
+            uint32_t seed = 0;
+            std::memcpy(&seed, e.payload.data(), std::min<size_t>(e.payload.size(), sizeof(seed)));
+            synth.randomizePreset(seed);
+            break;
+        }
+        case Capture::RESET:
+            synth.reset();
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace
+
+int runReplay(int argc, char** argv) {
+    ReplayOptions opt;
+    if (!parseOptions(argc, argv, opt)) {
+        printUsage();
+        return 2;
+    }
+
+    Capture::FileHeader header;
+    std::vector<Entry> entries;
+    std::string error;
+    if (!loadCapture(opt.input, header, entries, error)) {
+        std::printf("ERR: %s: %s\n", opt.input, error.c_str());
+        return 1;
+    }
+
+    HostEngine engine;
+    Synth& synth = engine.synth();
+    if (header.base_seed != 0) synth.randomizePreset(header.base_seed);
+    else synth.loadPreset(header.base_preset);
+
+    WavWriter wav;
+    if (opt.output && !wav.open(opt.output, SAMPLE_RATE)) {
+        std::printf("ERR: cannot write %s\n", opt.output);
+        return 1;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const uint32_t tail_blocks = static_cast<uint32_t>(opt.tail * SAMPLE_RATE / BUFFER_SIZE);
+    std::vector<BlockStat> blocks;
+    uint64_t hash = HASH_INIT;
+    double render_sec = 0.0;
+    size_t next = 0;
+    uint32_t forced = 0;  // 生成が止まったのに先のブロックのイベントが残っていた回数（不一致の兆候）
+    uint32_t tail = 0;
+    size_t first = 0;     // 次に生成するブロックの直前に適用したイベントの先頭
+
+    while (next < entries.size() || tail < tail_blocks) {
+        const uint32_t count = synth.getBlockCount();
+        const size_t applied = next;
+        while (next < entries.size() && entries[next].block <= count) apply(synth, entries[next++]);
+
+        const auto t0 = Clock::now();
+        engine.renderBlock();
+        const double dt = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        if (synth.getBlockCount() == count) {
+            // 生成が止まった。イベントが残っていれば次を強制的に適用して進める
+            if (next >= entries.size()) break;
+            if (applied == next) {
+                apply(synth, entries[next++]);
+                ++forced;
+            }
+            continue;
+        }
+
+        render_sec += dt;
+        blocks.push_back({count, 1e6 * dt, first, next});
+        first = next;
+        hash = hashBlock(hash, engine.left(), engine.right(), BUFFER_SIZE);
+        if (opt.output && !wav.writeStereo(engine.left(), engine.right(), BUFFER_SIZE)) {
+            std::printf("ERR: write failed: %s\n", opt.output);
+            return 1;
+        }
+        if (next >= entries.size()) ++tail;
+    }
+    wav.close();
+
+    size_t over = 0;
+    for (const BlockStat& b : blocks) {
+        if (b.us > opt.budget_us) ++over;
+    }
+
+    std::printf("input    %s (%zu entries, %lu dropped on device)\n", opt.input, entries.size(),
+                (unsigned long)header.dropped);
+    if (header.base_seed != 0) {
+        std::printf("base     block %lu  random seed %08lx\n", (unsigned long)header.first_block,
+                    (unsigned long)header.base_seed);
+    } else {
+        std::printf("base     block %lu  preset %u\n", (unsigned long)header.first_block, header.base_preset);
+    }
+    if (opt.output) std::printf("output   %s\n", opt.output);
+    std::printf("audio    %.3f s (%zu blocks)\n", static_cast<double>(blocks.size() * BUFFER_SIZE) / SAMPLE_RATE,
+                blocks.size());
+    std::printf("block    avg %.1f us  budget %.0f us  over %zu\n",
+                blocks.empty() ? 0.0 : 1e6 * render_sec / blocks.size(), opt.budget_us, over);
+    if (forced) std::printf("WARN     %lu events applied while idle (capture may be incomplete)\n", (unsigned long)forced);
+    // 起点が実機の状態と一致しないなら、ハッシュが合うことはない
+    const bool base_edited = (header.base_flags & Capture::BASE_EDITED) != 0;
+    if (header.dropped) {
+        std::printf("WARN     %lu entries dropped on device; parameter changes before the base are lost\n",
+                    (unsigned long)header.dropped);
+    }
+    if (base_edited) std::printf("WARN     voice was edited before CAPTURE START; the base preset does not include it\n");
+
+    // 遅いブロックと、その直前に入ったイベント
+    std::vector<BlockStat> slowest = blocks;
+    const size_t top = std::min(opt.top, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + top, slowest.end(),
+                      [](const BlockStat& a, const BlockStat& b) { return a.us > b.us; });
+    if (top) std::printf("\nslowest blocks (device block = base + n):\n");
+    for (size_t i = 0; i < top; ++i) {
+        const BlockStat& b = slowest[i];
+        std::printf("  %8lu  %8.1f us%s  events %zu\n", (unsigned long)b.block, b.us,
+                    b.us > opt.budget_us ? " OVER" : "     ", b.end_event - b.first_event);
+        for (size_t e = b.first_event; e < b.end_event; ++e) {
+            std::printf("            +%3u %-5s %s\n", entries[e].offset, sourceName(entries[e].source),
+                        describe(entries[e]).c_str());
+        }
+    }
+
+    std::printf("\nhash     %016llx\n", static_cast<unsigned long long>(hash));
+    if (opt.expect) {
+        const unsigned long long expected = std::strtoull(opt.expect, nullptr, 16);
+        if (header.dropped || base_edited) {
+            std::printf("FAIL     capture base is not exact (see WARN), cannot check --expect\n");
+            return 1;
+        }
+        if (expected != hash) {
+            std::printf("FAIL     expected %016llx\n", expected);
+            return 1;
+        }
+        std::printf("OK       matches expected hash\n");
+    }
+    return 0;
+}
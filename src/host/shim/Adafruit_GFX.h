@@ -0,0 +1,230 @@
+#pragma once
+
+// ============================================
+// ホストビルド用 Adafruit_GFX シム
+// ============================================
+// UI の描画をホストで回すための置き換え（panel コマンド用）。
+// 図形は Adafruit_GFX と同じく点・水平線・垂直線・矩形に分解して描く。
+// 文字は標準フォントと同じ 6x8 のセルに、文字コードから作った 5x7 の模様を描く
+// （グリフの形は違うが、書き換わる範囲と画素数の傾向は同じ）。
+
+#include <Arduino.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class Adafruit_GFX {
+protected:
+    int16_t width_;
+    int16_t height_;
+    int16_t cursor_x_ = 0;
+    int16_t cursor_y_ = 0;
+    uint16_t text_color_ = 0xFFFF;
+    uint16_t text_bg_ = 0xFFFF;  // text_color_ と同じなら背景を塗らない
+    uint8_t text_size_ = 1;
+    bool wrap_ = true;
+
+    // 文字コードから 5 列分の模様（下位 7bit）を作る。空白は何も描かない
+    static uint8_t glyphColumn(unsigned char c, uint8_t col) {
+        if (c == ' ') return 0;
+        uint32_t h = (c + 1u) * 2654435761u ^ (col + 1u) * 40503u;
+        h ^= h >> 13;
+        return static_cast<uint8_t>((h & 0x7F) | (col == 2 ? 0x08 : 0));
+    }
+
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : width_(w), height_(h) {}
+    virtual ~Adafruit_GFX() = default;
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+        for (int16_t i = 0; i < w; ++i) drawPixel(x + i, y, color);
+    }
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+        for (int16_t i = 0; i < h; ++i) drawPixel(x, y + i, color);
+    }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        for (int16_t i = x; i < x + w; ++i) drawFastVLine(i, y, h, color);
+    }
+    virtual void fillScreen(uint16_t color) { fillRect(0, 0, width_, height_, color); }
+
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        if (x0 == x1) {
+            if (y0 > y1) std::swap(y0, y1);
+            drawFastVLine(x0, y0, y1 - y0 + 1, color);
+            return;
+        }
+        if (y0 == y1) {
+            if (x0 > x1) std::swap(x0, x1);
+            drawFastHLine(x0, y0, x1 - x0 + 1, color);
+            return;
+        }
+        const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+        if (steep) { std::swap(x0, y0); std::swap(x1, y1); }
+        if (x0 > x1) { std::swap(x0, x1); std::swap(y0, y1); }
+        const int16_t dx = x1 - x0;
+        const int16_t dy = std::abs(y1 - y0);
+        const int16_t ystep = y0 < y1 ? 1 : -1;
+        int16_t err = dx / 2;
+        for (; x0 <= x1; ++x0) {
+            if (steep) drawPixel(y0, x0, color);
+            else drawPixel(x0, y0, color);
+            err -= dy;
+            if (err < 0) { y0 += ystep; err += dx; }
+        }
+    }
+
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        drawFastHLine(x, y, w, color);
+        drawFastHLine(x, y + h - 1, w, color);
+        drawFastVLine(x, y, h, color);
+        drawFastVLine(x + w - 1, y, h, color);
+    }
+
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+        drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+        for (int16_t dx = 1; dx <= r; ++dx) {
+            int16_t dy = 0;
+            while ((dy + 1) * (dy + 1) + dx * dx <= r * r) ++dy;
+            drawFastVLine(x0 + dx, y0 - dy, 2 * dy + 1, color);
+            drawFastVLine(x0 - dx, y0 - dy, 2 * dy + 1, color);
+        }
+    }
+
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+        // 行ごとに3辺との交点の範囲を塗る
+        const int16_t top = std::min({y0, y1, y2});
+        const int16_t bottom = std::max({y0, y1, y2});
+        const int16_t px[3] = {x0, x1, x2};
+        const int16_t py[3] = {y0, y1, y2};
+        for (int16_t y = top; y <= bottom; ++y) {
+            int16_t a = INT16_MAX, b = INT16_MIN;
+            for (int e = 0; e < 3; ++e) {
+                const int16_t xa = px[e], ya = py[e], xb = px[(e + 1) % 3], yb = py[(e + 1) % 3];
+                if (y < std::min(ya, yb) || y > std::max(ya, yb)) continue;
+                const int16_t x = (ya == yb) ? xa : static_cast<int16_t>(xa + (xb - xa) * (y - ya) / (yb - ya));
+                a = std::min({a, x, ya == yb ? xb : x});
+                b = std::max({b, x, ya == yb ? xb : x});
+            }
+            if (a <= b) drawFastHLine(a, y, b - a + 1, color);
+        }
+    }
+
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t* bitmap, int16_t w, int16_t h) {
+        for (int16_t j = 0; j < h; ++j) {
+            for (int16_t i = 0; i < w; ++i) drawPixel(x + i, y + j, bitmap[j * w + i]);
+        }
+    }
+
+    void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color) {
+        const int16_t stride = (w + 7) / 8;
+        for (int16_t j = 0; j < h; ++j) {
+            for (int16_t i = 0; i < w; ++i) {
+                if (bitmap[j * stride + i / 8] & (0x80 >> (i & 7))) drawPixel(x + i, y + j, color);
+            }
+        }
+    }
+
+    // --- 文字 ---
+    void setCursor(int16_t x, int16_t y) { cursor_x_ = x; cursor_y_ = y; }
+    void setTextColor(uint16_t c) { text_color_ = text_bg_ = c; }
+    void setTextColor(uint16_t c, uint16_t bg) { text_color_ = c; text_bg_ = bg; }
+    void setTextSize(uint8_t s) { text_size_ = s > 0 ? s : 1; }
+    void setTextWrap(bool w) { wrap_ = w; }
+    int16_t getCursorX() const { return cursor_x_; }
+    int16_t getCursorY() const { return cursor_y_; }
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+        for (uint8_t col = 0; col < 6; ++col) {
+            const uint8_t line = col < 5 ? glyphColumn(c, col) : 0;
+            for (uint8_t row = 0; row < 8; ++row) {
+                const bool on = line & (1 << row);
+                if (!on && bg == color) continue;
+                const uint16_t pixel = on ? color : bg;
+                if (size == 1) drawPixel(x + col, y + row, pixel);
+                else fillRect(x + col * size, y + row * size, size, size, pixel);
+            }
+        }
+    }
+
+    size_t write(uint8_t c) {
+        if (c == '\n') {
+            cursor_x_ = 0;
+            cursor_y_ += 8 * text_size_;
+            return 1;
+        }
+        if (c == '\r') return 1;
+        if (wrap_ && cursor_x_ + 6 * text_size_ > width_) {
+            cursor_x_ = 0;
+            cursor_y_ += 8 * text_size_;
+        }
+        drawChar(cursor_x_, cursor_y_, c, text_color_, text_bg_, text_size_);
+        cursor_x_ += 6 * text_size_;
+        return 1;
+    }
+
+    size_t print(const char* s) {
+        size_t n = 0;
+        while (*s) n += write(static_cast<uint8_t>(*s++));
+        return n;
+    }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(int v) { return print(String(v)); }
+    size_t print(unsigned int v) { return print(String(v)); }
+    size_t print(long v) { return print(String(v)); }
+    size_t print(unsigned long v) { return print(String(v)); }
+    size_t print(double v, int digits = 2) { return print(String(v, digits)); }
+    template <typename T>
+    size_t println(T v) { size_t n = print(v); return n + write('\n'); }
+
+    void getTextBounds(const char* s, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+        int16_t cx = x, maxx = x, lines = 1;
+        for (; *s; ++s) {
+            if (*s == '\n') { cx = x; ++lines; continue; }
+            cx += 6 * text_size_;
+            maxx = std::max(maxx, cx);
+        }
+        *x1 = x;
+        *y1 = y;
+        *w = maxx > x ? static_cast<uint16_t>(maxx - x - 1) : 0;
+        *h = maxx > x ? static_cast<uint16_t>(8 * text_size_ * lines) : 0;
+    }
+    void getTextBounds(const String& s, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+        getTextBounds(s.c_str(), x, y, x1, y1, w, h);
+    }
+
+    int16_t width() const { return width_; }
+    int16_t height() const { return height_; }
+};
+
+class GFXcanvas16 : public Adafruit_GFX {
+private:
+    std::vector<uint16_t> buffer_;
+
+public:
+    GFXcanvas16(int16_t w, int16_t h) : Adafruit_GFX(w, h), buffer_(static_cast<size_t>(w) * h, 0) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x < 0 || y < 0 || x >= width_ || y >= height_) return;
+        buffer_[y * width_ + x] = color;
+    }
+    void fillScreen(uint16_t color) override { std::fill(buffer_.begin(), buffer_.end(), color); }
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+        if (w < 0) { x += w + 1; w = -w; }
+        for (int16_t i = 0; i < w; ++i) GFXcanvas16::drawPixel(x + i, y, color);
+    }
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+        if (h < 0) { y += h + 1; h = -h; }
+        for (int16_t i = 0; i < h; ++i) GFXcanvas16::drawPixel(x, y + i, color);
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+        for (int16_t j = 0; j < h; ++j) GFXcanvas16::drawFastHLine(x, y + j, w, color);
+    }
+
+    uint16_t* getBuffer() const { return const_cast<uint16_t*>(buffer_.data()); }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+// ============================================
+// ホストビルド用 Adafruit_SSD1351 シム（模擬パネル）
+// ============================================
+// 実機と同じく setAddrWindow() で窓を開き、writePixels() の画素を窓の中へ
+// 左上から順に書く。書いた画素は HostPanel に残り、送ったバイト数も数える
+// （窓の設定は GFX_SSD1351::WINDOW_BYTES と同じ 7 バイト）。
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#include <cstdint>
+
+#include "Adafruit_GFX.h"
+
+struct HostPanel {
+    static constexpr int16_t WIDTH = 128;
+    static constexpr int16_t HEIGHT = 128;
+    static constexpr uint32_t WINDOW_BYTES = 7;
+
+    uint16_t pixels[WIDTH * HEIGHT] = {};
+    uint64_t pixel_bytes = 0;
+    uint32_t windows = 0;
+    bool writing = false;      // startWrite() 〜 endWrite() の間
+    uint32_t stray = 0;        // 窓の外 / 書き込み区間の外に来た画素（転送の誤り）
+
+    // 現在の窓と書き込み位置
+    int16_t wx = 0, wy = 0, ww = 0, wh = 0;
+    int32_t pos = 0;
+
+    static HostPanel& get() {
+        static HostPanel panel;
+        return panel;
+    }
+
+    uint64_t sentBytes() const { return pixel_bytes + static_cast<uint64_t>(windows) * WINDOW_BYTES; }
+    void resetCounters() { pixel_bytes = 0; windows = 0; stray = 0; }
+};
+
+class Adafruit_SSD1351 : public Adafruit_GFX {
+public:
+    Adafruit_SSD1351(uint16_t w, uint16_t h, HostSPIClass*, int8_t, int8_t, int8_t) : Adafruit_GFX(w, h) {}
+
+    void begin(uint32_t = 0) {}
+    void setRotation(uint8_t) {}
+
+    void startWrite() { HostPanel::get().writing = true; }
+    void endWrite() { HostPanel::get().writing = false; }
+
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+        HostPanel& p = HostPanel::get();
+        p.wx = x; p.wy = y; p.ww = w; p.wh = h;
+        p.pos = 0;
+        ++p.windows;
+    }
+
+    void writePixels(const uint16_t* colors, uint32_t len) {
+        HostPanel& p = HostPanel::get();
+        p.pixel_bytes += static_cast<uint64_t>(len) * 2;
+        for (uint32_t i = 0; i < len; ++i, ++p.pos) {
+            if (!p.writing || p.ww <= 0 || p.pos >= static_cast<int32_t>(p.ww) * p.wh) {
+                ++p.stray;
+                continue;
+            }
+            const int16_t x = p.wx + p.pos % p.ww;
+            const int16_t y = p.wy + p.pos / p.ww;
+            p.pixels[y * HostPanel::WIDTH + x] = colors[i];
+        }
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x < 0 || y < 0 || x >= HostPanel::WIDTH || y >= HostPanel::HEIGHT) return;
+        HostPanel::get().pixels[y * HostPanel::WIDTH + x] = color;
+    }
+};
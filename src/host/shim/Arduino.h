@@ -0,0 +1,157 @@
+#pragma once
+
+// ============================================
+// ホストビルド用 Arduino.h シム
+// ============================================
+// [env:native] でDSPコアをPC上でビルドするための最小限の置き換え。
+// Teensy固有の配置属性は空にし、時間・乱数・Serial は標準ライブラリで代用する。
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "WString.h"
+
+// --- 配置属性（ホストでは意味を持たない） ---
+#define FASTRUN
+#define FLASHMEM
+#define PROGMEM
+#define DMAMEM
+#define EXTMEM
+
+#define __disable_irq()
+#define __enable_irq()
+
+// UI の再起動メニューが書くシステムリセットのレジスタ（ホストでは何も起きない）
+inline volatile uint32_t SCB_AIRCR = 0;
+
+// --- Arduino の min / max（型の違う引数も受ける） ---
+template <typename A, typename B>
+constexpr auto min(const A& a, const B& b) -> decltype(a < b ? a : b) { return b < a ? b : a; }
+template <typename A, typename B>
+constexpr auto max(const A& a, const B& b) -> decltype(a < b ? a : b) { return a < b ? b : a; }
+
+// --- 時間 ---
+// ホストツールは hostAdvanceClock() で時計を進められる（UI のフレーム間隔を実時間を待たずに回す）
+namespace host_detail {
+    inline std::chrono::steady_clock::time_point startTime() {
+        static const auto t0 = std::chrono::steady_clock::now();
+        return t0;
+    }
+    inline uint64_t& clockOffsetUs() {
+        static uint64_t offset = 0;
+        return offset;
+    }
+    inline uint64_t elapsedUs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime()).count()) + clockOffsetUs();
+    }
+}
+
+inline void hostAdvanceClock(uint32_t us) {
+    host_detail::clockOffsetUs() += us;
+}
+
+inline uint32_t millis() {
+    return static_cast<uint32_t>(host_detail::elapsedUs() / 1000);
+}
+
+inline uint32_t micros() {
+    return static_cast<uint32_t>(host_detail::elapsedUs());
+}
+
+inline void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+// --- 乱数 ---
+// 実行ごとに結果が変わらないよう、標準の rand() ではなく固定シードの LCG を使う
+namespace host_detail {
+    inline uint32_t& randomState() {
+        static uint32_t state = 1;
+        return state;
+    }
+    inline uint32_t nextRandom() {
+        uint32_t& s = randomState();
+        s = s * 1103515245u + 12345u;
+        return s >> 1;
+    }
+}
+
+inline void randomSeed(uint32_t seed) {
+    host_detail::randomState() = seed ? seed : 1;
+}
+
+inline long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return static_cast<long>(host_detail::nextRandom() % static_cast<uint32_t>(howbig));
+}
+
+inline long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+// --- Serial ---
+// 出力は stdout へ。入力は持たない（available() は常に 0）
+// ホストツールがファームのコマンド処理を流用するときは setMuted() で応答を捨てられる
+class HostSerial {
+private:
+    bool muted_ = false;
+
+public:
+    void begin(uint32_t) {}
+    operator bool() const { return true; }
+
+    void setMuted(bool muted) { muted_ = muted; }
+
+    int available() { return 0; }
+    int read() { return -1; }
+    void flush() { std::fflush(stdout); }
+
+    size_t write(uint8_t c) {
+        if (muted_) return 1;
+        return std::fputc(c, stdout) == EOF ? 0 : 1;
+    }
+    size_t write(const uint8_t* buf, size_t len) {
+        if (muted_) return len;
+        return std::fwrite(buf, 1, len, stdout);
+    }
+
+    size_t print(const char* s) {
+        if (muted_) return std::strlen(s);
+        return static_cast<size_t>(std::fputs(s, stdout) < 0 ? 0 : std::strlen(s));
+    }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+    template <typename T>
+    size_t println(T v) { size_t n = print(v); return n + print('\n'); }
+    size_t println() { return print('\n'); }
+
+    int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = muted_ ? std::vsnprintf(nullptr, 0, fmt, ap) : std::vprintf(fmt, ap);
+        va_end(ap);
+        return n;
+    }
+};
+
+inline HostSerial Serial;
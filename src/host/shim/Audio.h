@@ -0,0 +1,58 @@
+#pragma once
+
+// ============================================
+// ホストビルド用 Audio.h シム
+// ============================================
+// Teensy Audio Library のうち AudioHandler が使うクラスだけを置き換える。
+// 再生キューは常に空きあり・受け取ったデータは捨てる。
+// 録音キューはデータを持たない（パススルーは何も出力しない）。
+// AudioStream の update() はホストでは呼ばれない。
+
+#include <Arduino.h>
+
+constexpr int AUDIO_BLOCK_SAMPLES = 128;
+constexpr float AUDIO_SAMPLE_RATE_EXACT = 44117.64706f;
+
+struct audio_block_t {
+    int16_t data[AUDIO_BLOCK_SAMPLES];
+};
+
+class AudioStream {
+public:
+    AudioStream() {}
+    AudioStream(unsigned char, audio_block_t**) {}
+    virtual ~AudioStream() {}
+    virtual void update() {}
+protected:
+    audio_block_t* receiveReadOnly(unsigned int = 0) { return nullptr; }
+    void release(audio_block_t*) {}
+};
+
+class AudioInputI2S : public AudioStream {};
+class AudioOutputI2SQuad : public AudioStream {};
+
+class AudioRecordQueue : public AudioStream {
+public:
+    int available() { return 0; }
+    int16_t* readBuffer() { return nullptr; }
+    void freeBuffer() {}
+    void begin() {}
+    void end() {}
+    void clear() {}
+};
+
+class AudioPlayQueue : public AudioStream {
+public:
+    bool available() { return true; }
+    void play(const int16_t*, uint32_t) {}
+    void setMaxBuffers(uint8_t) {}
+};
+
+class AudioConnection {
+public:
+    AudioConnection(AudioStream&, unsigned char, AudioStream&, unsigned char) {}
+};
+
+#define AudioMemory(num)
+#define AudioNoInterrupts()
+#define AudioInterrupts()
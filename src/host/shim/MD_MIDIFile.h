@@ -0,0 +1,18 @@
+#pragma once
+
+// ============================================
+// ホストビルド用 MD_MIDIFile シム
+// ============================================
+// ホストでは SMF の再生に render コマンド (smf.cpp) を使うので、
+// MIDIPlayer の宣言を通すための型だけを置く。
+
+#include <cstdint>
+
+struct midi_event {
+    int16_t track;
+    uint8_t channel;
+    uint8_t size;
+    uint8_t data[4];
+};
+
+class MD_MIDIFile {};
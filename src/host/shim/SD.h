@@ -0,0 +1,51 @@
+#pragma once
+
+// ============================================
+// ホストビルド用 SD.h シム
+// ============================================
+// カードは常に存在しない扱い。ファイル入出力が必要なホストツールは stdio を直接使う。
+
+#include <Arduino.h>
+
+#define BUILTIN_SDCARD 254
+
+#define FILE_READ  0
+#define FILE_WRITE 1
+
+class File {
+public:
+    operator bool() const { return false; }
+    int available() { return 0; }
+    int read() { return -1; }
+    int read(void*, size_t) { return 0; }
+    size_t write(uint8_t) { return 0; }
+    size_t write(const uint8_t*, size_t) { return 0; }
+    bool seek(uint32_t) { return false; }
+    uint32_t position() { return 0; }
+    uint32_t size() { return 0; }
+    void flush() {}
+    void close() {}
+};
+
+#define O_RDONLY 0
+
+// SdFat のディレクトリ走査 (MIDIPlayer::listFiles)。常に開けない
+class SdFile {
+public:
+    bool open(const char*, uint8_t = O_RDONLY) { return false; }
+    bool openNext(SdFile*, uint8_t = O_RDONLY) { return false; }
+    bool isDir() const { return false; }
+    size_t getName(char* name, size_t size) { if (size) name[0] = '\0'; return 0; }
+    bool close() { return true; }
+};
+
+class SDClass {
+public:
+    bool begin(uint8_t) { return false; }
+    bool exists(const char*) { return false; }
+    bool remove(const char*) { return false; }
+    bool mkdir(const char*) { return false; }
+    File open(const char*, uint8_t = FILE_READ) { return File(); }
+};
+
+inline SDClass SD;
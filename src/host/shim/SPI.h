@@ -0,0 +1,5 @@
+#pragma once
+
+// ホストビルド用シム: DSPコアからは使わない。模擬パネル (Adafruit_SSD1351.h) の引数に合わせるだけ
+struct HostSPIClass {};
+inline HostSPIClass SPI1;
@@ -0,0 +1,3 @@
+#pragma once
+
+// ホストビルド用シム: DSPコアからは使われないので空
@@ -0,0 +1,39 @@
+#pragma once
+
+// ============================================
+// ホストビルド用 String シム
+// ============================================
+// UI が使う範囲（数値からの変換・連結・length() / c_str()）だけを std::string で置き換える。
+
+#include <cstdio>
+#include <string>
+
+class String : public std::string {
+public:
+    String() = default;
+    String(const char* s) : std::string(s ? s : "") {}
+    String(const std::string& s) : std::string(s) {}
+    explicit String(char c) : std::string(1, c) {}
+    String(int v) : std::string(std::to_string(v)) {}
+    String(unsigned int v) : std::string(std::to_string(v)) {}
+    String(long v) : std::string(std::to_string(v)) {}
+    String(unsigned long v) : std::string(std::to_string(v)) {}
+    String(double v, int digits = 2) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.*f", digits, v);
+        assign(buf);
+    }
+
+    unsigned int length() const { return static_cast<unsigned int>(size()); }
+
+    String& operator+=(const String& s) { append(s); return *this; }
+    String& operator+=(const char* s) { append(s); return *this; }
+    String& operator+=(char c) { push_back(c); return *this; }
+    String& operator+=(int v) { append(std::to_string(v)); return *this; }
+};
+
+inline String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+inline String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, char b) { String r(a); r += b; return r; }
+inline String operator+(const String& a, int b) { String r(a); r += b; return r; }
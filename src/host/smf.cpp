@@ -0,0 +1,190 @@
+#include "smf.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+constexpr uint32_t DEFAULT_TEMPO = 500000; // 120 BPM (µs / 四分音符)
+
+// トラックマージ用の中間表現（テンポはまだ適用しない）
+struct RawEvent {
+    uint64_t tick;
+    uint32_t order;     // 同一tick内の元の順序
+    uint32_t tempo;     // 0 以外ならテンポ変更
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+};
+
+class Reader {
+private:
+    const std::vector<uint8_t>& buf_;
+    size_t pos_;
+    size_t end_;
+
+public:
+    Reader(const std::vector<uint8_t>& buf, size_t pos, size_t end) : buf_(buf), pos_(pos), end_(end) {}
+
+    bool eof() const { return pos_ >= end_; }
+    size_t pos() const { return pos_; }
+
+    bool u8(uint8_t& v) {
+        if (pos_ >= end_) return false;
+        v = buf_[pos_++];
+        return true;
+    }
+
+    bool be(uint32_t& v, int bytes) {
+        if (pos_ + bytes > end_) return false;
+        v = 0;
+        for (int i = 0; i < bytes; ++i) v = (v << 8) | buf_[pos_++];
+        return true;
+    }
+
+    // 可変長数値（最大4バイト）
+    bool vlq(uint32_t& v) {
+        v = 0;
+        for (int i = 0; i < 4; ++i) {
+            uint8_t b;
+            if (!u8(b)) return false;
+            v = (v << 7) | (b & 0x7F);
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool skip(uint32_t n) {
+        if (pos_ + n > end_) return false;
+        pos_ += n;
+        return true;
+    }
+};
+
+bool readTrack(Reader& r, uint32_t& order, std::vector<RawEvent>& out, std::string& error) {
+    uint64_t tick = 0;
+    uint8_t running = 0;
+
+    while (!r.eof()) {
+        uint32_t delta;
+        if (!r.vlq(delta)) { error = "truncated delta time"; return false; }
+        tick += delta;
+
+        uint8_t b;
+        if (!r.u8(b)) { error = "truncated event"; return false; }
+
+        if (b == 0xFF) {
+            // メタイベント
+            uint8_t type;
+            uint32_t len;
+            if (!r.u8(type) || !r.vlq(len)) { error = "truncated meta event"; return false; }
+            if (type == 0x2F) return true; // End of Track
+            if (type == 0x51 && len == 3) {
+                uint32_t tempo = 0;
+                if (!r.be(tempo, 3)) { error = "truncated tempo"; return false; }
+                out.push_back({tick, order++, tempo ? tempo : DEFAULT_TEMPO, 0, 0, 0});
+            } else if (!r.skip(len)) {
+                error = "truncated meta event";
+                return false;
+            }
+            continue;
+        }
+
+        if (b == 0xF0 || b == 0xF7) {
+            // SysEx
+            uint32_t len;
+            if (!r.vlq(len) || !r.skip(len)) { error = "truncated sysex"; return false; }
+            continue;
+        }
+
+        uint8_t status = b;
+        uint8_t d1 = 0, d2 = 0;
+        if (b & 0x80) {
+            running = status;
+            if (!r.u8(d1)) { error = "truncated channel event"; return false; }
+        } else {
+            // ランニングステータス
+            if (!running) { error = "data byte without status"; return false; }
+            status = running;
+            d1 = b;
+        }
+
+        const uint8_t type = status & 0xF0;
+        if (type != 0xC0 && type != 0xD0) {
+            if (!r.u8(d2)) { error = "truncated channel event"; return false; }
+        }
+        out.push_back({tick, order++, 0, status, static_cast<uint8_t>(d1 & 0x7F), static_cast<uint8_t>(d2 & 0x7F)});
+    }
+    return true; // End of Track なしで終わっていても受け入れる
+}
+
+} // namespace
+
+bool loadSmf(const char* path, std::vector<SmfEvent>& events, std::string& error) {
+    events.clear();
+
+    FILE* fp = std::fopen(path, "rb");
+    if (!fp) { error = "cannot open file"; return false; }
+    std::vector<uint8_t> buf;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), fp)) > 0) buf.insert(buf.end(), chunk, chunk + n);
+    std::fclose(fp);
+
+    Reader header(buf, 0, buf.size());
+    uint32_t magic, len, format, ntrks, division;
+    if (!header.be(magic, 4) || magic != 0x4D546864 /* MThd */ || !header.be(len, 4) || len < 6
+        || !header.be(format, 2) || !header.be(ntrks, 2) || !header.be(division, 2)
+        || !header.skip(len - 6)) {
+        error = "not a standard MIDI file";
+        return false;
+    }
+    if (format > 1) { error = "format 2 is not supported"; return false; }
+
+    std::vector<RawEvent> raw;
+    uint32_t order = 0;
+    size_t pos = header.pos();
+    for (uint32_t t = 0; t < ntrks && pos + 8 <= buf.size(); ++t) {
+        Reader chunk_header(buf, pos, buf.size());
+        uint32_t id = 0, size = 0;
+        chunk_header.be(id, 4);
+        chunk_header.be(size, 4);
+        const size_t body = chunk_header.pos();
+        const size_t end = std::min(buf.size(), body + size);
+        if (id == 0x4D54726B /* MTrk */) {
+            Reader track(buf, body, end);
+            if (!readTrack(track, order, raw, error)) return false;
+        }
+        pos = end;
+    }
+
+    std::stable_sort(raw.begin(), raw.end(), [](const RawEvent& a, const RawEvent& b) {
+        return a.tick < b.tick;
+    });
+
+    // tick → 秒
+    // division の最上位ビットが立っていれば SMPTE (フレーム/秒 × tick/フレーム)
+    double sec_per_tick;
+    const bool smpte = (division & 0x8000) != 0;
+    if (smpte) {
+        const int fps = -static_cast<int8_t>(division >> 8);
+        const int tpf = division & 0xFF;
+        sec_per_tick = 1.0 / (fps * tpf);
+    } else {
+        if (division == 0) { error = "invalid division"; return false; }
+        sec_per_tick = DEFAULT_TEMPO * 1e-6 / division;
+    }
+
+    uint64_t last_tick = 0;
+    double seconds = 0.0;
+    for (const RawEvent& e : raw) {
+        seconds += (e.tick - last_tick) * sec_per_tick;
+        last_tick = e.tick;
+        if (e.tempo) {
+            if (!smpte) sec_per_tick = e.tempo * 1e-6 / division;
+            continue;
+        }
+        events.push_back({seconds, e.status, e.data1, e.data2});
+    }
+    return true;
+}
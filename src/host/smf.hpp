@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Standard MIDI File のチャンネルイベント
+ *
+ * 全トラックをマージし、テンポマップを適用した絶対時刻付きで保持する。
+ */
+struct SmfEvent {
+    double seconds;     // 曲頭からの時刻
+    uint8_t status;     // 0x80-0xEF（チャンネル込み）
+    uint8_t data1;
+    uint8_t data2;
+
+    uint8_t type() const { return status & 0xF0; }
+    uint8_t channel() const { return (status & 0x0F) + 1; } // 1-16
+};
+
+/**
+ * @brief SMF (format 0/1) を読み込む
+ *
+ * チャンネルメッセージだけを時刻順に返す。SysEx とテンポ以外のメタイベントは読み飛ばす。
+ *
+ * @param path ファイルパス
+ * @param events 出力先（時刻順）
+ * @param error 失敗時の理由
+ * @return true 成功
+ */
+bool loadSmf(const char* path, std::vector<SmfEvent>& events, std::string& error);
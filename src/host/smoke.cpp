@@ -0,0 +1,125 @@
+#include "host.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * @brief 全プリセットを鳴らして出力を確認する
+ *
+ * 各プリセットで和音を SMOKE_HOLD_BLOCKS ブロック保持 → ノートオフ →
+ * SMOKE_RELEASE_BLOCKS ブロック生成し、ピーク値と FNV-1a ハッシュを表示する。
+ * 保持中に無音のプリセットがあれば失敗とする。
+ * 最後にエフェクトを全部有効にしてスナップショットの保存→復元で出力が一致するかも確認する。
+ */
+static constexpr int SMOKE_HOLD_BLOCKS = 300;
+static constexpr int SMOKE_RELEASE_BLOCKS = 200;
+static constexpr int SMOKE_SNAPSHOT_BLOCKS = 100;
+
+// エフェクトバッファ込みで保存して復元し、同じ続きが出るか
+static bool checkSnapshot(HostEngine& engine) {
+    Synth& synth = engine.synth();
+    static const uint8_t CHORD[] = {48, 55, 64, 71};
+
+    synth.reset();
+    synth.loadPreset(0);
+    synth.setDelayEnabled(true);
+    synth.setLpfEnabled(true);
+    synth.setHpfEnabled(true);
+    synth.setChorusEnabled(true);
+    synth.setReverbEnabled(true);
+    for (uint8_t note : CHORD) synth.noteOn(note, 100, 1);
+    for (int b = 0; b < SMOKE_SNAPSHOT_BLOCKS; ++b) engine.renderBlock();
+
+    std::vector<uint8_t> state(synth.snapshotSize(true));
+    size_t written = 0;
+    SnapshotStatus st = synth.saveSnapshot(state.data(), state.size(), true, written);
+
+    auto render = [&]() {
+        uint64_t hash = HASH_INIT;
+        for (int b = 0; b < SMOKE_SNAPSHOT_BLOCKS; ++b) {
+            if (b == SMOKE_SNAPSHOT_BLOCKS / 2) {
+                for (uint8_t note : CHORD) synth.noteOff(note, 1);
+            }
+            engine.renderBlock();
+            hash = hashBlock(hash, engine.left(), engine.right(), BUFFER_SIZE);
+        }
+        return hash;
+    };
+
+    uint64_t hashes[2] = {};
+    if (st == SnapshotStatus::OK) {
+        hashes[0] = render();
+        st = synth.restoreSnapshot(state.data(), written);
+        if (st == SnapshotStatus::OK) hashes[1] = render();
+    }
+
+    if (st != SnapshotStatus::OK) {
+        std::printf("snapshot %s\n", snapshotStatusName(st));
+        return false;
+    }
+    std::printf("snapshot %zu bytes hash %016llx / %016llx%s\n", written,
+                static_cast<unsigned long long>(hashes[0]), static_cast<unsigned long long>(hashes[1]),
+                hashes[0] == hashes[1] ? "" : "  <-- mismatch");
+    return hashes[0] == hashes[1];
+}
+
+int runSmoke(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    HostEngine engine;
+    Synth& synth = engine.synth();
+
+    static const uint8_t CHORD[] = {60, 64, 67, 72};
+    int failures = 0;
+
+    for (uint8_t p = 0; p < MAX_PRESETS; ++p) {
+        synth.reset();
+        synth.loadPreset(p);
+        for (uint8_t note : CHORD) synth.noteOn(note, 100, 1);
+
+        uint64_t hash = HASH_INIT;
+        int32_t hold_peak = 0;
+        int32_t release_peak = 0;
+
+        for (int b = 0; b < SMOKE_HOLD_BLOCKS + SMOKE_RELEASE_BLOCKS; ++b) {
+            if (b == SMOKE_HOLD_BLOCKS) {
+                for (uint8_t note : CHORD) synth.noteOff(note, 1);
+            }
+            engine.renderBlock();
+
+            int32_t& peak = (b < SMOKE_HOLD_BLOCKS) ? hold_peak : release_peak;
+            for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+                const int32_t l = engine.left()[i];
+                const int32_t r = engine.right()[i];
+                peak = std::max(peak, std::max(std::abs(l), std::abs(r)));
+            }
+            hash = hashBlock(hash, engine.left(), engine.right(), BUFFER_SIZE);
+        }
+
+        const bool ok = hold_peak > 0;
+        if (!ok) ++failures;
+        std::printf("%2u %-12s peak %5d release %5d hash %016llx%s\n",
+                    p, synth.getCurrentPresetName(), hold_peak, release_peak,
+                    static_cast<unsigned long long>(hash), ok ? "" : "  <-- silent");
+    }
+
+    const bool snapshot_ok = checkSnapshot(engine);
+    synth.setDelayEnabled(false);
+    synth.setLpfEnabled(false);
+    synth.setHpfEnabled(false);
+    synth.setChorusEnabled(false);
+    synth.setReverbEnabled(false);
+    synth.reset();
+    if (!snapshot_ok) {
+        std::printf("ERR: snapshot round trip\n");
+        return 1;
+    }
+    if (failures) {
+        std::printf("ERR: %d preset(s) silent\n", failures);
+        return 1;
+    }
+    std::printf("OK: %u presets\n", MAX_PRESETS);
+    return 0;
+}
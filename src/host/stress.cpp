@@ -0,0 +1,50 @@
+#include "host.hpp"
+#include "tools/stress.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/**
+ * @brief Stress をホストで実行する
+ *
+ * シナリオ名は実機の STRESS コマンドと同じ（大文字小文字は区別しない）。省略または ALL で全部。
+ * UI シナリオは画面がないので飛ばす。プリセットは起動時の 0 番。
+ */
+int runStress(int argc, char** argv) {
+    std::string scenario;
+    long blocks = Stress::DEFAULT_BLOCKS;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-n" && i + 1 < argc) {
+            blocks = std::strtol(argv[++i], nullptr, 10);
+            continue;
+        }
+        for (char& c : a) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (scenario.empty()) scenario = a;
+        else {
+            std::printf("usage: stress [SCENARIO] [-n blocks]\n");
+            return 2;
+        }
+    }
+
+    const bool all = scenario.empty() || scenario == "ALL";
+    Stress::Scenario first = Stress::CHORD;
+    if (!all && (!Stress::parse(scenario.c_str(), first) || !Stress::supported(first))) {
+        std::printf("ERR: stress [CHORD|BEND|CC|FX|PRESET|MIX|ALL] [-n blocks]\n");
+        return 2;
+    }
+    if (blocks < 1 || blocks > Stress::MAX_BLOCKS) {
+        std::printf("ERR: -n 1-%u\n", (unsigned)Stress::MAX_BLOCKS);
+        return 2;
+    }
+
+    HostEngine engine;
+    if (!Stress::run(engine.synth(), first, all, static_cast<uint16_t>(blocks))) {
+        std::printf("ERR: stress could not start\n");
+        return 1;
+    }
+    return 0;
+}
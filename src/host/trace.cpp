@@ -0,0 +1,178 @@
+#include "host.hpp"
+#include "tools/profiler.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @brief TRACE DUMP の出力を Chrome / Perfetto のトレース JSON に変換する
+ *
+ * 入力はシリアルログをそのまま保存したファイルでよい（"TRACE " で始まる行を探す）。
+ * 時刻は 32bit で一周するので、レコードを書いた順（区間なら終了時刻）の差分を積み上げて戻す。
+ * 連続するレコードの間隔が一周 (600MHz で約7秒) を超えると前後関係が崩れる。
+ */
+
+namespace {
+
+bool loadDump(const char* path, std::vector<Trace::Record>& records, uint32_t& ticks_per_sec,
+              uint32_t& dropped, std::string& error) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) { error = "cannot open file"; return false; }
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    std::fclose(f);
+
+    // 行頭の "TRACE " を探す（最後のダンプを使う）
+    size_t header = std::string::npos;
+    for (size_t i = 0; i + 6 <= data.size(); ++i) {
+        if ((i == 0 || data[i - 1] == '\n') && std::memcmp(&data[i], "TRACE ", 6) == 0) header = i;
+    }
+    if (header == std::string::npos) { error = "no TRACE header"; return false; }
+
+    size_t eol = header;
+    while (eol < data.size() && data[eol] != '\n') ++eol;
+    if (eol >= data.size()) { error = "truncated header"; return false; }
+
+    const std::string line(reinterpret_cast<const char*>(&data[header]), eol - header);
+    unsigned version = 0, count = 0;
+    unsigned long hz = 0, lost = 0;
+    if (std::sscanf(line.c_str(), "TRACE %u %u %lu %lu", &version, &count, &hz, &lost) != 4 || hz == 0) {
+        error = "bad header: " + line;
+        return false;
+    }
+    if (version != Trace::FORMAT_VERSION) {
+        error = "unsupported format version " + std::to_string(version);
+        return false;
+    }
+
+    const size_t begin = eol + 1;
+    if (data.size() - begin < static_cast<size_t>(count) * sizeof(Trace::Record)) {
+        error = "truncated records";
+        return false;
+    }
+    records.resize(count);
+    if (count) std::memcpy(records.data(), &data[begin], count * sizeof(Trace::Record));
+    ticks_per_sec = static_cast<uint32_t>(hz);
+    dropped = static_cast<uint32_t>(lost);
+    return true;
+}
+
+void printUsage() {
+    std::printf("usage: trace <capture> [-o out.json]\n"
+                "       capture: TRACE DUMP を含むシリアルログ\n");
+}
+
+} // namespace
+
+/**
+ * @brief レコード列を Chrome トレース JSON (JSON Object Format) として書き出す
+ *
+ * 区間は "X"（開始+所要時間）、単発イベントは "i"。アンダーランは全体に縦線を引く。
+ */
+bool writeChromeTrace(const char* path, const Trace::Record* records, size_t count,
+                      uint32_t ticks_per_sec, std::string& error) {
+    FILE* f = std::fopen(path, "w");
+    if (!f) { error = "cannot write file"; return false; }
+
+    const double us_per_tick = 1e6 / ticks_per_sec;
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Cranberry Synth\"}},\n");
+    std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main loop\"}}");
+
+    // 書き込み時刻（区間なら終了時刻）の差分を積み上げて一周を戻し、最初の開始を 0 にそろえる
+    std::vector<int64_t> starts(count);
+    int64_t now = 0;
+    int64_t origin = 0;
+    uint32_t prev_key = count ? records[0].time + records[0].dur : 0;
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t key = records[i].time + records[i].dur;
+        now += static_cast<uint32_t>(key - prev_key);
+        prev_key = key;
+        starts[i] = now - records[i].dur;
+        if (starts[i] < origin) origin = starts[i];
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const Trace::Record& r = records[i];
+        const double ts = (starts[i] - origin) * us_per_tick;
+
+        std::fprintf(f, ",\n");
+        switch (r.type) {
+            case Trace::SPAN:
+                std::fprintf(f, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                    Profiler::name(static_cast<Profiler::Stage>(r.a)), ts, r.dur * us_per_tick);
+                break;
+            case Trace::NOTE_ON:
+                std::fprintf(f, "{\"name\":\"NOTE_ON\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,\"ts\":%.3f,"
+                    "\"args\":{\"note\":%u,\"velocity\":%u}}", ts, r.a, r.b);
+                break;
+            case Trace::NOTE_OFF:
+                std::fprintf(f, "{\"name\":\"NOTE_OFF\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,\"ts\":%.3f,"
+                    "\"args\":{\"note\":%u}}", ts, r.a);
+                break;
+            case Trace::VOICE_STEAL:
+                std::fprintf(f, "{\"name\":\"VOICE_STEAL\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,\"ts\":%.3f,"
+                    "\"args\":{\"note\":%u,\"releasing\":%u}}", ts, r.a, r.b);
+                break;
+            case Trace::PRESET_LOAD:
+                std::fprintf(f, "{\"name\":\"PRESET_LOAD\",\"ph\":\"i\",\"s\":\"p\",\"pid\":1,\"tid\":1,\"ts\":%.3f,"
+                    "\"args\":{\"preset\":%u}}", ts, r.a);
+                break;
+            case Trace::FLASH_CHUNK:
+                std::fprintf(f, "{\"name\":\"FLASH_CHUNK\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,\"ts\":%.3f,"
+                    "\"args\":{\"rows\":%u}}", ts, r.b);
+                break;
+            case Trace::UNDERRUN:
+                std::fprintf(f, "{\"name\":\"UNDERRUN %s\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":1,\"ts\":%.3f}",
+                    r.a == UNDERRUN_STARVED ? "STARVED" : "LATE", ts);
+                break;
+            default:
+                std::fprintf(f, "{\"name\":\"UNKNOWN %u\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":1,\"ts\":%.3f}",
+                    r.type, ts);
+                break;
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+
+    if (std::fclose(f) != 0) { error = "write failed"; return false; }
+    return true;
+}
+
+int runTrace(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* output = "trace.json";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) output = argv[++i];
+        else if (argv[i][0] != '-' && !input) input = argv[i];
+        else { printUsage(); return 2; }
+    }
+    if (!input) { printUsage(); return 2; }
+
+    std::vector<Trace::Record> records;
+    uint32_t ticks_per_sec = 0;
+    uint32_t dropped = 0;
+    std::string error;
+    if (!loadDump(input, records, ticks_per_sec, dropped, error)) {
+        std::printf("ERR: %s: %s\n", input, error.c_str());
+        return 1;
+    }
+    if (!writeChromeTrace(output, records.data(), records.size(), ticks_per_sec, error)) {
+        std::printf("ERR: %s: %s\n", output, error.c_str());
+        return 1;
+    }
+
+    uint32_t spans = 0, underruns = 0;
+    for (const Trace::Record& r : records) {
+        if (r.type == Trace::SPAN) ++spans;
+        else if (r.type == Trace::UNDERRUN) ++underruns;
+    }
+    std::printf("input    %s (%zu events, %u dropped, %lu ticks/s)\n", input, records.size(),
+                (unsigned)dropped, (unsigned long)ticks_per_sec);
+    std::printf("spans    %u  underruns %u\n", (unsigned)spans, (unsigned)underruns);
+    std::printf("output   %s  (chrome://tracing / ui.perfetto.dev)\n", output);
+    return 0;
+}
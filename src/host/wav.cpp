@@ -0,0 +1,66 @@
+#include "wav.hpp"
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+void WavWriter::writeHeader(uint32_t sample_rate) {
+    const uint32_t data_bytes = frames_ * channels_ * 2;
+    uint8_t h[44] = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+                     'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0};
+    put32(h + 4, 36 + data_bytes);
+    put16(h + 22, channels_);
+    put32(h + 24, sample_rate);
+    put32(h + 28, sample_rate * channels_ * 2);
+    put16(h + 32, channels_ * 2);
+    put16(h + 34, 16);
+    h[36] = 'd'; h[37] = 'a'; h[38] = 't'; h[39] = 'a';
+    put32(h + 40, data_bytes);
+    std::fwrite(h, 1, sizeof(h), fp_);
+}
+
+bool WavWriter::open(const char* path, uint32_t sample_rate, uint16_t channels) {
+    close();
+    fp_ = std::fopen(path, "wb");
+    if (!fp_) return false;
+    channels_ = channels;
+    frames_ = 0;
+    writeHeader(sample_rate); // サイズは close() で書き戻す
+    return true;
+}
+
+bool WavWriter::writeStereo(const int16_t* left, const int16_t* right, size_t n) {
+    if (!fp_) return false;
+    uint8_t buf[4 * 128];
+    size_t done = 0;
+    while (done < n) {
+        const size_t chunk = (n - done < 128) ? n - done : 128;
+        for (size_t i = 0; i < chunk; ++i) {
+            put16(buf + i * 4,     static_cast<uint16_t>(left[done + i]));
+            put16(buf + i * 4 + 2, static_cast<uint16_t>(right[done + i]));
+        }
+        if (std::fwrite(buf, 4, chunk, fp_) != chunk) return false;
+        done += chunk;
+    }
+    frames_ += static_cast<uint32_t>(n);
+    return true;
+}
+
+void WavWriter::close() {
+    if (!fp_) return;
+    // ヘッダのサイズ欄を確定させる
+    uint8_t size[4];
+    put32(size, 36 + frames_ * channels_ * 2);
+    std::fseek(fp_, 4, SEEK_SET);
+    std::fwrite(size, 1, 4, fp_);
+    put32(size, frames_ * channels_ * 2);
+    std::fseek(fp_, 40, SEEK_SET);
+    std::fwrite(size, 1, 4, fp_);
+    std::fclose(fp_);
+    fp_ = nullptr;
+}
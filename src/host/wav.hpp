@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @brief 16bit PCM WAV 書き出し
+ *
+ * データ長はヘッダに後から書き戻すので、close() を呼ぶまで WAV として完結しない。
+ */
+class WavWriter {
+private:
+    FILE* fp_ = nullptr;
+    uint16_t channels_ = 2;
+    uint32_t frames_ = 0;
+
+    void writeHeader(uint32_t sample_rate);
+
+public:
+    WavWriter() = default;
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+    ~WavWriter() { close(); }
+
+    bool open(const char* path, uint32_t sample_rate, uint16_t channels = 2);
+
+    /** @brief ステレオ n フレームをインターリーブして書く */
+    bool writeStereo(const int16_t* left, const int16_t* right, size_t n);
+
+    void close();
+
+    uint32_t frames() const { return frames_; }
+};
@@ -3,7 +3,6 @@
 /** @author Saisana299 **/
 
 // TODO: トラックが違うとリトリガーが正しく動かない問題を修正する（bitwigで確認済み）
-// TODO: クラッシュレポートを生成する機能
 
 #include <Arduino.h>
 #include <Entropy.h>
@@ -22,14 +21,23 @@
 #include "modules/delay.hpp"
 #include "modules/filter.hpp"
 #include "modules/reverb.hpp"
+#include "modules/effect_arena.hpp"
+#include "modules/spectrum.hpp"
 /* UI */
 #include "ui/ui.hpp"
 #include "ui/screens/title.hpp"
+#include "ui/screens/oscilloscope.hpp"
 /* Utils */
 #include "utils/state.hpp"
 #include "utils/color.hpp"
 /* Tools */
 #include "tools/midi_player.hpp"
+#include "tools/memory_monitor.hpp"
+#include "tools/profiler.hpp"
+#include "tools/capture.hpp"
+#include "tools/stress.hpp"
+#include "tools/postmortem.hpp"
+#include "tools/scheduler.hpp"
 
 /* インスタンス生成 */
 State state;
@@ -49,25 +57,131 @@ Delay shared_delay;
 Filter shared_filter;
 Chorus shared_chorus;
 Reverb shared_reverb;
+// エフェクトバッファは有効なものにだけアリーナから貸し出す
+EffectArena shared_arena(shared_delay, shared_chorus, shared_reverb);
 
-Passthrough passthrough(audio_hdl, shared_filter, shared_delay, shared_chorus, shared_reverb);
+Passthrough passthrough(audio_hdl, shared_filter, shared_delay, shared_chorus, shared_reverb, shared_arena);
 
 // SPI転送中のオーディオ処理コールバック
 AudioCallback gfxAudioCallback = nullptr;
+AudioDueCheck gfxAudioDue = nullptr;
 
-void audioProcessCallback() {
-    if (state.getModeState() == MODE_PASSTHROUGH) {
+// 音源の状態をオーディオハンドラへ伝え、SHED ポリシーのボイス解放要求を処理する
+void syncAudioSource() {
+    uint8_t fx = 0;
+    if (synth.isLpfEnabled())    fx |= FX_BIT_LPF;
+    if (synth.isHpfEnabled())    fx |= FX_BIT_HPF;
+    if (synth.isDelayEnabled())  fx |= FX_BIT_DELAY;
+    if (synth.isChorusEnabled()) fx |= FX_BIT_CHORUS;
+    if (synth.isReverbEnabled()) fx |= FX_BIT_REVERB;
+    audio_hdl.setSource(synth.isActive(), synth.getActiveNoteCount(), fx);
+
+    for (uint8_t n = audio_hdl.takeShedRequest(); n > 0; --n) {
+        synth.shedOldestNote();
+    }
+}
+
+// STRESS UI: オシロスコープ画面を開いて毎フレーム描画させる
+void stressUi(bool on) {
+    if (on) ui.pushScreen(new OscilloscopeScreen());
+    else ui.popScreen();
+}
+
+// SPI 転送でオーディオ処理を挟むか: 発音中は音源かキューが次のブロックを待っているとき
+bool audioDue(int16_t rows) {
+    if (state.getModeState() == MODE_PASSTHROUGH || !synth.isActive()) return rows >= GFX_CHUNK_H;
+    return !samples_ready_flags || audio_hdl.hasQueueRoom();
+}
+
+uint32_t audioHeadroom() {
+    return audio_hdl.headroomUs();
+}
+
+// --- スケジューラのタスク ---
+
+// サウンド生成（パススルー中は入力をそのまま出力）
+void synthTask() {
+    const uint8_t mode_state = state.getModeState();
+    if (mode_state == MODE_PASSTHROUGH) {
         passthrough.process();
         return;
     }
-    // 優先度の高い処理をSPI転送中も実行
-    synth.update();        // サウンド生成
-    audio_hdl.process();   // 音声信号処理
-    midi_hdl.process();    // MIDI入力検知
-    midi_player.process(); // MIDI Player 処理
+    if (mode_state != MODE_SYNTH) return;
+
+    Stress::process(synth); // ストレステストの入力
+
+    // CPU使用率計測開始
+    uint32_t t0 = ARM_DWT_CYCCNT;
+    synth.update();
+    uint32_t t1 = ARM_DWT_CYCCNT;
+    syncAudioSource();
+
+    // CPU使用率計算
+    // Teensy 4.1: 600MHz, 1ブロック = 128サンプル @ 44100Hz ≈ 2.9ms
+    // 2.9ms = 600MHz * 0.0029s = 1,740,000 cycles
+    constexpr float CYCLES_PER_BLOCK = 600000000.0f / 44100.0f * 128.0f;
+    // /*debug*/ constexpr float CYCLES_PER_US = 600.0f; // 600MHz = 600 cycles/μs
+    float usage = (float)(t1 - t0) / CYCLES_PER_BLOCK * 100.0f;
+    // /*debug*/ float elapsed_us = (float)(t1 - t0) / CYCLES_PER_US;
+
+    // スムージング (急激な変化を抑える)
+    static float smoothed_usage = 0.0f;
+    // /*debug*/ static float smoothed_us = 0.0f;
+    smoothed_usage = smoothed_usage * 0.9f + usage * 0.1f;
+    // /*debug*/ smoothed_us = smoothed_us * 0.9f + elapsed_us * 0.1f;
+    state.setCpuUsage(smoothed_usage);
+
+    // // デバッグ出力 (500ms間隔)
+    // /*debug*/ static uint32_t last_debug_time = 0;
+    // /*debug*/ if (millis() - last_debug_time >= 500) {
+    // /*debug*/     Serial.printf("[DEBUG] synth.update(): %.1f us (%.1f%% CPU)\n", smoothed_us, smoothed_usage);
+    // /*debug*/     last_debug_time = millis();
+    // /*debug*/ }
+}
+
+// 音声信号処理(AD/DA)
+void audioTask() {
+    if (state.getModeState() != MODE_PASSTHROUGH) audio_hdl.process();
+}
+
+// MIDI入力検知
+void midiTask() {
+    if (state.getModeState() != MODE_PASSTHROUGH) midi_hdl.process();
+}
+
+// 物理ボタンと UI の入力処理
+void inputTask() {
+    physical.process();
+    ui.poll();
 }
 
+void uiTask()     { ui.render(); }
+void playerTask() { midi_player.process(); }
+void serialTask() { serial_hdl.process(); }
+void ledsTask()   { leds.process(); }
+void fftTask()    { Spectrum::step(); }  // スペクトラム画面を開いている間だけ働く
+
+// 優先度と1回の所要時間の見込み。CRITICAL 以外は再生キューの余裕に収まるときだけ実行する
+const Scheduler::Task TASKS[] = {
+    // name      fn          priority             budget_us max_defer_ms stage                  in_yield
+    {"SYNTH",  synthTask,  Scheduler::CRITICAL, 1500,  0,   Profiler::STAGE_COUNT, true},
+    {"AUDIO",  audioTask,  Scheduler::CRITICAL, 100,   0,   Profiler::AUDIO,       true},
+    {"MIDI",   midiTask,   Scheduler::CRITICAL, 100,   0,   Profiler::MIDI,        true},
+    {"PLAYER", playerTask, Scheduler::HIGH,     300,   10,  Profiler::PLAYER,      true},
+    {"INPUT",  inputTask,  Scheduler::HIGH,     100,   20,  Profiler::STAGE_COUNT, false},
+    {"UI",     uiTask,     Scheduler::NORMAL,   2000,  250, Profiler::UI,          false},
+    {"SERIAL", serialTask, Scheduler::LOW,      300,   50,  Profiler::SERIAL_IO,   false},
+    {"FFT",    fftTask,    Scheduler::LOW,      200,   0,   Profiler::FFT,         false},
+    {"LEDS",   ledsTask,   Scheduler::LOW,      50,    100, Profiler::STAGE_COUNT, false},
+};
+
 void setup() {
+    // スタック最大使用量の計測用に未使用領域を塗っておく
+    MemoryMonitor::paintStack();
+
+    // 前回のクラッシュレポートを取り出し、フォールトハンドラを差し替える
+    PostMortem::begin();
+
     pinMode(LED_BUILTIN, OUTPUT);
 
     for(int i = 0; i < 3; i++) {
@@ -86,13 +200,25 @@ void setup() {
     ui.pushScreen(new TitleScreen());
 
     midi_player.init();  // SD.begin() はsetup()内で安全に呼ぶ
-    synth.init(shared_delay, shared_filter, shared_chorus, shared_reverb);
+    synth.init(shared_delay, shared_filter, shared_chorus, shared_reverb, shared_arena);
     audio_hdl.init();
     physical.init();
     leds.init();
 
-    // SPI転送中のオーディオコールバックを設定
-    gfxAudioCallback = audioProcessCallback;
+    // 入力の記録は常時回しておき、グリッチが出たら CAPTURE SAVE で保存する
+    Capture::start();
+    Stress::setUiHook(stressUi);
+
+    // オーディオブロックとメインループのデッドライン監視
+    PostMortem::arm();
+
+    // メインループのタスク
+    for (const Scheduler::Task& task : TASKS) Scheduler::add(task);
+    Scheduler::setHeadroom(audioHeadroom);
+
+    // SPI転送中のオーディオコールバックを設定（キューの状態に合わせて呼ぶ）
+    gfxAudioCallback = Scheduler::yield;
+    gfxAudioDue = audioDue;
 
     // オーディオ割り込み優先度を最高に
     NVIC_SET_PRIORITY(IRQ_SAI1, 0); // Teensy 4.1
@@ -101,19 +227,24 @@ void setup() {
 }
 
 void loop() {
+    PostMortem::process();
+
     static uint8_t last_mode = state.getModeState();
     auto mode_state = state.getModeState();
 
     if (mode_state != last_mode) {
         // --- パススルーに入る ---
         if (mode_state == MODE_PASSTHROUGH) {
+            Stress::stop(synth);   // ストレステストを中断
             midi_hdl.stop();       // MIDI受信を停止
             synth.reset();         // 発音中ノートをすべてリセット
+            audio_hdl.setSource(false, 0, 0); // 枯渇監視を解除
             passthrough.begin();   // パススルー開始
         }
         // --- パススルーから抜ける ---
         if (last_mode == MODE_PASSTHROUGH && mode_state != MODE_PASSTHROUGH) {
             passthrough.end();     // パススルー停止 (バッファもフラッシュ)
+            synth.planEffectMemory(); // シンセ側の有効状態でエフェクトバッファを再配分
         }
         // --- シンセモードに入る ---
         if (mode_state == MODE_SYNTH) {
@@ -122,68 +253,8 @@ void loop() {
         last_mode = mode_state;
     }
 
-    // 優先度0: サウンド生成関連処理
-    switch(mode_state) {
-        case MODE_PASSTHROUGH: {
-            // パススルーモード: 入力をそのまま出力
-            passthrough.process();
-            break;
-        }
-        case MODE_SYNTH: {
-            // CPU使用率計測開始
-            uint32_t t0 = ARM_DWT_CYCCNT;
-            synth.update();
-            uint32_t t1 = ARM_DWT_CYCCNT;
-
-            // CPU使用率計算
-            // Teensy 4.1: 600MHz, 1ブロック = 128サンプル @ 44100Hz ≈ 2.9ms
-            // 2.9ms = 600MHz * 0.0029s = 1,740,000 cycles
-            constexpr float CYCLES_PER_BLOCK = 600000000.0f / 44100.0f * 128.0f;
-            // /*debug*/ constexpr float CYCLES_PER_US = 600.0f; // 600MHz = 600 cycles/μs
-            float usage = (float)(t1 - t0) / CYCLES_PER_BLOCK * 100.0f;
-            // /*debug*/ float elapsed_us = (float)(t1 - t0) / CYCLES_PER_US;
-
-            // スムージング (急激な変化を抑える)
-            static float smoothed_usage = 0.0f;
-            // /*debug*/ static float smoothed_us = 0.0f;
-            smoothed_usage = smoothed_usage * 0.9f + usage * 0.1f;
-            // /*debug*/ smoothed_us = smoothed_us * 0.9f + elapsed_us * 0.1f;
-            state.setCpuUsage(smoothed_usage);
-
-            // // デバッグ出力 (500ms間隔)
-            // /*debug*/ static uint32_t last_debug_time = 0;
-            // /*debug*/ if (millis() - last_debug_time >= 500) {
-            // /*debug*/     Serial.printf("[DEBUG] synth.update(): %.1f us (%.1f%% CPU)\n", smoothed_us, smoothed_usage);
-            // /*debug*/     last_debug_time = millis();
-            // /*debug*/ }
-            break;
-        }
-    }
-
-    // 優先度:1 音声信号処理(AD/DA)
-    if (mode_state != MODE_PASSTHROUGH) {
-        audio_hdl.process();
-    }
-
-    // 優先度:2 MIDI入力検知
-    if (mode_state != MODE_PASSTHROUGH) {
-        midi_hdl.process();
-    }
-
-    // 優先度:3 物理ボタン処理
-    physical.process();
-
-    // 優先度:4 UI処理
-    ui.render();
-
-    // 優先度:5 MIDI Player 処理
-    midi_player.process();
-
-    // 優先度:6 シリアル通信処理(USB)
-    serial_hdl.process();
-
-    // 優先度:7 LED制御
-    leds.process();
+    // サウンド生成・オーディオ・MIDI入力は毎回、それ以外は再生キューの余裕に合わせて
+    Scheduler::run();
 
     asm volatile("yield");
 }
\ No newline at end of file
@@ -38,11 +38,24 @@ const int16_t Chorus::SINE_TABLE[SINE_TABLE_SIZE] = {
      -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804
 };
 
+/**
+ * @brief バッファ領域を割り当てる
+ *
+ * @param mem L/R 連続領域 (CHORUS_BUFFER_SIZE × 2)、nullptr で切り離し
+ */
+void Chorus::attach(Sample16_t* mem) {
+    buffer_L = mem;
+    buffer_R = mem ? mem + CHORUS_BUFFER_SIZE : nullptr;
+    reset();
+}
+
 /** @brief コーラスバッファをリセット */
 void Chorus::reset() {
-    for (uint32_t i = 0; i < CHORUS_BUFFER_SIZE; ++i) {
-        buffer_L[i] = 0;
-        buffer_R[i] = 0;
+    if (buffer_L != nullptr) {
+        for (uint32_t i = 0; i < CHORUS_BUFFER_SIZE; ++i) {
+            buffer_L[i] = 0;
+            buffer_R[i] = 0;
+        }
     }
     write_pos = 0;
     lfo_phase = 0;
@@ -99,6 +112,8 @@ void Chorus::updatePhaseInc() {
  * @param right R入力/出力
  */
 void Chorus::process(Sample16_t& left, Sample16_t& right) {
+    if (buffer_L == nullptr) return; // 未割り当て時はドライのまま
+
     // バッファにドライ信号を書き込み
     buffer_L[write_pos] = left;
     buffer_R[write_pos] = right;
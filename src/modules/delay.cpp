@@ -1,5 +1,29 @@
 #include "modules/delay.hpp"
 
+/**
+ * @brief バッファ領域を割り当てる
+ *
+ * @param mem L/R 連続領域 (samples_per_ch × 2)、nullptr で切り離し
+ * @param samples_per_ch 1chあたりのサンプル数
+ */
+void Delay::attach(Sample16_t* mem, uint32_t samples_per_ch) {
+    buffer_L.attach(mem, static_cast<int32_t>(samples_per_ch));
+    buffer_R.attach(mem ? mem + samples_per_ch : nullptr, static_cast<int32_t>(samples_per_ch));
+    delay_length = 0;
+    // 容量が変わるため、タイムを再クランプしてインターバルを再適用
+    setTime(time);
+}
+
+/** @brief 現在の割り当てで設定可能な最大ディレイタイム (ms) */
+int32_t Delay::getMaxTime() const {
+    // 未割り当て時はパラメータ編集のため標準最大値を返す（有効化時に保証される）
+    if (!buffer_L.isAttached()) return MAX_TIME;
+    int32_t max_ms = static_cast<int32_t>(
+        (static_cast<int64_t>(buffer_L.capacity() - 1) * 1000) / SAMPLE_RATE
+    );
+    return std::max<int32_t>(max_ms, MIN_TIME);
+}
+
 /** @brief ディレイのバッファをリセット */
 void Delay::reset() {
     delay_length = 0;
@@ -21,7 +45,7 @@ void Delay::setDelay(int32_t time, Gain_t level, Gain_t feedback) {
 }
 
 void Delay::setTime(int32_t time) {
-    this->time = std::clamp<int32_t>(time, MIN_TIME, MAX_TIME);
+    this->time = std::clamp<int32_t>(time, MIN_TIME, getMaxTime());
     this->delay_length = getTotalSamples();
 
     uint32_t delay_sample = (static_cast<uint32_t>(this->time) * SAMPLE_RATE) / 1000;
@@ -45,6 +69,8 @@ void Delay::setFeedback(Gain_t feedback) {
  * @return Sample16_t 処理後のサンプル
  */
 Sample16_t Delay::processL(Sample16_t in) {
+    if (!buffer_L.isAttached()) return in; // 未割り当て時はドライのまま
+
     int32_t sample = static_cast<int32_t>(buffer_L.read());
 
     // Q15乗算: sample × level >> 15
@@ -67,6 +93,8 @@ Sample16_t Delay::processL(Sample16_t in) {
  * @return Sample16_t 処理後のサンプル
  */
 Sample16_t Delay::processR(Sample16_t in) {
+    if (!buffer_R.isAttached()) return in; // 未割り当て時はドライのまま
+
     int32_t sample = static_cast<int32_t>(buffer_R.read());
 
     // Q15乗算: sample × level >> 15
@@ -0,0 +1,91 @@
+#include "modules/effect_arena.hpp"
+#include "utils/placement.hpp"
+
+#include <cstring>
+
+// アリーナ本体（Synth / Passthrough 共通で1つ）
+// 約107KB と大きいので OCRAM に置く（起動時は未初期化、attach 時にクリアされる）
+PLACE_BULK static Sample16_t arena_memory[EFFECT_ARENA_SAMPLES];
+
+/**
+ * @brief 有効なエフェクトに合わせて領域を配分し直す
+ *
+ * @param delay_on ディレイ有効
+ * @param chorus_on コーラス有効
+ * @param reverb_on リバーブ有効
+ */
+void EffectArena::plan(bool delay_on, bool chorus_on, bool reverb_on) {
+    Layout next = {};
+    uint32_t cursor = 0;
+
+    // Reverb: ディレイOFFなら拡張サイズ
+    if (reverb_on) {
+        next.reverb_scale = delay_on ? REVERB_SCALE_ONE : REVERB_LARGE_SCALE;
+        next.reverb = {cursor, reverbTotalSamples(next.reverb_scale)};
+        cursor += next.reverb.length;
+    }
+
+    // Chorus: 固定長
+    if (chorus_on) {
+        next.chorus = {cursor, CHORUS_BUFFER_SIZE * 2};
+        cursor += next.chorus.length;
+    }
+
+    // Delay: 残り全部を L/R で等分
+    if (delay_on) {
+        uint32_t per_ch = (EFFECT_ARENA_SAMPLES - cursor) / 2;
+        next.delay = {cursor, per_ch * 2};
+        cursor += next.delay.length;
+    }
+
+    restore(next);
+}
+
+/**
+ * @brief 指定の配置にする（配置が変わったものだけ付け替え、付け替えたバッファはクリア）
+ *
+ * @param next plan() で作った配置（スナップショットに保存したものを含む）
+ */
+void EffectArena::restore(const Layout& next) {
+    const bool reverb_on = next.reverb.length > 0;
+    const bool chorus_on = next.chorus.length > 0;
+    const bool delay_on = next.delay.length > 0;
+
+    if (!sameRegion(next.reverb, layout_.reverb) || next.reverb_scale != layout_.reverb_scale
+        || reverb_on != reverb_.hasMemory()) {
+        reverb_.attach(reverb_on ? arena_memory + next.reverb.offset : nullptr, next.reverb_scale);
+    }
+    if (!sameRegion(next.chorus, layout_.chorus) || chorus_on != chorus_.hasMemory()) {
+        chorus_.attach(chorus_on ? arena_memory + next.chorus.offset : nullptr);
+    }
+    if (!sameRegion(next.delay, layout_.delay) || delay_on != delay_.hasMemory()) {
+        delay_.attach(delay_on ? arena_memory + next.delay.offset : nullptr, next.delay.length / 2);
+    }
+
+    layout_ = next;
+}
+
+// 領域は先頭から詰めて配置しているので used() までを消せばよい
+void EffectArena::clearBuffers() {
+    memset(arena_memory, 0, used() * sizeof(Sample16_t));
+}
+
+/** @brief アリーナ本体の先頭（スナップショットでバッファを丸ごと保存・復元する用） */
+Sample16_t* EffectArena::memory() {
+    return arena_memory;
+}
+
+/**
+ * @brief 指定エフェクトが領域を持っていなければ配分し直す
+ *
+ * @param delay_on ディレイ有効
+ * @param chorus_on コーラス有効
+ * @param reverb_on リバーブ有効
+ */
+void EffectArena::ensure(bool delay_on, bool chorus_on, bool reverb_on) {
+    if ((delay_on && !delay_.hasMemory()) ||
+        (chorus_on && !chorus_.hasMemory()) ||
+        (reverb_on && !reverb_.hasMemory())) {
+        plan(delay_on, chorus_on, reverb_on);
+    }
+}
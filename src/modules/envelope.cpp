@@ -45,19 +45,10 @@ void Envelope::clear(Memory& mem) {
  * level_は対数スケール、大きいほど音が大きい
  * rising時は対数カーブ、falling時は線形カーブ
  */
-FASTRUN void Envelope::update(Memory& mem) {
-    const int8_t rs_delta = mem.rate_scaling_delta;
-
-    // qrate計算とinc計算
-    // 係数: 41
-    auto calcInc = [rs_delta](uint8_t rate_param, int coef = 41) -> int32_t {
-        int qrate = (static_cast<int>(rate_param) * coef) >> 6;
-        qrate += rs_delta;
-        if (qrate < 0) qrate = 0;
-        if (qrate > 63) qrate = 63;
-        constexpr int LG_N = 6;
-        return (4 + (qrate & 3)) << (2 + LG_N + (qrate >> 2));
-    };
+FASTRUN void Envelope::update(Memory& mem, uint8_t rate_shift) {
+    // 増分はステージ/パラメータが変わった時だけ再計算（64サンプル基準）
+    // 制御レートが速い場合は1回あたりの増分をその分小さくする
+    const int32_t inc = stageInc(mem) >> rate_shift;
 
     // ノートごとのターゲットレベル
     const EnvLevel_t tgt1 = mem.target_level1;
@@ -74,7 +65,6 @@ FASTRUN void Envelope::update(Memory& mem) {
                 if (mem.level_ < ENV_JUMPTARGET) {
                     mem.level_ = ENV_JUMPTARGET;
                 }
-                int32_t inc = calcInc(rate1_param);
                 // level += ((17 << 24) - level) >> 24) * inc
                 mem.level_ += (((17 << 24) - mem.level_) >> 24) * inc;
                 if (mem.level_ >= tgt1) {
@@ -89,7 +79,6 @@ FASTRUN void Envelope::update(Memory& mem) {
 
         case EnvelopeState::Phase2: {
             // Phase2: ディケイ1 (target_level1 → target_level2)
-            int32_t inc = calcInc(rate2_param);
             if (mem.level_ > tgt2) {
                 // falling (レベルを下げる)
                 mem.level_ -= inc;
@@ -115,7 +104,6 @@ FASTRUN void Envelope::update(Memory& mem) {
 
         case EnvelopeState::Phase3: {
             // Phase3: ディケイ2/サステイン (target_level2 → target_level3)
-            int32_t inc = calcInc(rate3_param);
             if (mem.level_ > tgt3) {
                 mem.level_ -= inc;
                 if (mem.level_ <= tgt3) {
@@ -136,7 +124,6 @@ FASTRUN void Envelope::update(Memory& mem) {
 
         case EnvelopeState::Phase4: {
             // Phase4: リリース (現在レベル → target_level4)
-            int32_t inc = calcInc(rate4_param);
             if (mem.level_ > tgt4) {
                 mem.level_ -= inc;
                 if (mem.level_ <= tgt4) {
@@ -176,6 +163,7 @@ FASTRUN void Envelope::update(Memory& mem) {
  */
 void Envelope::setRate1(uint8_t rate_0_99) {
     rate1_param = clamp_param(rate_0_99);
+    bumpParamVersion();
 }
 
 /**
@@ -184,6 +172,7 @@ void Envelope::setRate1(uint8_t rate_0_99) {
  */
 void Envelope::setRate2(uint8_t rate_0_99) {
     rate2_param = clamp_param(rate_0_99);
+    bumpParamVersion();
 }
 
 /**
@@ -192,6 +181,7 @@ void Envelope::setRate2(uint8_t rate_0_99) {
  */
 void Envelope::setRate3(uint8_t rate_0_99) {
     rate3_param = clamp_param(rate_0_99);
+    bumpParamVersion();
 }
 
 /**
@@ -200,6 +190,7 @@ void Envelope::setRate3(uint8_t rate_0_99) {
  */
 void Envelope::setRate4(uint8_t rate_0_99) {
     rate4_param = clamp_param(rate_0_99);
+    bumpParamVersion();
 }
 
 // ===== Level設定 =====
@@ -245,6 +236,7 @@ void Envelope::setLevel4(uint8_t level_0_99) {
  */
 void Envelope::setRateScaling(uint8_t sensitivity) {
     rate_scaling_param = (sensitivity > 7) ? 7 : sensitivity;
+    rs_table_dirty_ = true;
 }
 
 /**
@@ -285,7 +277,19 @@ int8_t Envelope::calcRateScalingDelta(uint8_t midinote, uint8_t sensitivity) {
  * @param midinote MIDIノート番号
  */
 void Envelope::applyRateScaling(Memory& mem, uint8_t midinote) {
-    mem.rate_scaling_delta = calcRateScalingDelta(midinote, rate_scaling_param);
+    if (rs_table_dirty_) buildRateScalingTable();
+    mem.rate_scaling_delta = rs_delta_table_[midinote > 127 ? 127 : midinote];
+    mem.inc_version = 0;  // 増分キャッシュを無効化
+}
+
+/**
+ * @brief Rate Scaling増分テーブルを構築
+ */
+void Envelope::buildRateScalingTable() {
+    for (uint8_t n = 0; n < 128; ++n) {
+        rs_delta_table_[n] = calcRateScalingDelta(n, rate_scaling_param);
+    }
+    rs_table_dirty_ = false;
 }
 
 // ===== Keyboard Level Scaling =====
@@ -296,6 +300,7 @@ void Envelope::applyRateScaling(Memory& mem, uint8_t midinote) {
  */
 void Envelope::setBreakPoint(uint8_t break_point) {
     kbd_break_point = (break_point > 99) ? 99 : break_point;
+    kls_table_dirty_ = true;
 }
 
 /**
@@ -304,6 +309,7 @@ void Envelope::setBreakPoint(uint8_t break_point) {
  */
 void Envelope::setLeftDepth(uint8_t depth) {
     kbd_left_depth = (depth > 99) ? 99 : depth;
+    kls_table_dirty_ = true;
 }
 
 /**
@@ -312,6 +318,7 @@ void Envelope::setLeftDepth(uint8_t depth) {
  */
 void Envelope::setRightDepth(uint8_t depth) {
     kbd_right_depth = (depth > 99) ? 99 : depth;
+    kls_table_dirty_ = true;
 }
 
 /**
@@ -320,6 +327,7 @@ void Envelope::setRightDepth(uint8_t depth) {
  */
 void Envelope::setLeftCurve(KeyScaleCurve curve) {
     kbd_left_curve = curve;
+    kls_table_dirty_ = true;
 }
 
 /**
@@ -328,6 +336,7 @@ void Envelope::setLeftCurve(KeyScaleCurve curve) {
  */
 void Envelope::setRightCurve(KeyScaleCurve curve) {
     kbd_right_curve = curve;
+    kls_table_dirty_ = true;
 }
 
 /**
@@ -337,6 +346,7 @@ void Envelope::setRightCurve(KeyScaleCurve curve) {
 void Envelope::setLeftCurve(uint8_t curve) {
     if (curve > 3) curve = 3;
     kbd_left_curve = static_cast<KeyScaleCurve>(curve);
+    kls_table_dirty_ = true;
 }
 
 /**
@@ -346,6 +356,7 @@ void Envelope::setLeftCurve(uint8_t curve) {
 void Envelope::setRightCurve(uint8_t curve) {
     if (curve > 3) curve = 3;
     kbd_right_curve = static_cast<KeyScaleCurve>(curve);
+    kls_table_dirty_ = true;
 }
 
 /**
@@ -435,19 +446,9 @@ int Envelope::calcKeyboardLevelScaling(uint8_t midinote) const {
  * @param velocity_sens ベロシティ感度 (0-7、0=感度なし)
  */
 void Envelope::setOutlevel(uint8_t op_level, uint8_t velocity, uint8_t midinote, uint8_t velocity_sens) {
-    // 1. Output Level → scaleoutlevel (0-127)
-    int outlevel = scaleoutlevel(op_level);
-
-    // 2. Keyboard Level Scaling を適用
-    int level_scaling = calcKeyboardLevelScaling(midinote);
-    outlevel += level_scaling;
-
-    // 3. 0-127 にクランプ
-    if (outlevel > 127) outlevel = 127;
-    if (outlevel < 0) outlevel = 0;
-
-    // 4. 内部精度へ拡張 (<< 5 = ×32)
-    outlevel = outlevel << 5;
+    // 1-4. Output Level + Keyboard Level Scaling（テーブル参照）
+    if (kls_table_dirty_ || op_level != table_op_level_) buildKlsTable(op_level);
+    int outlevel = kls_outlevel_table_[midinote > 127 ? 127 : midinote];
 
     // 5. ベロシティスケーリング
     if (velocity_sens > 0) {
@@ -461,6 +462,30 @@ void Envelope::setOutlevel(uint8_t op_level, uint8_t velocity, uint8_t midinote,
     outlevel_ = outlevel;
 }
 
+/**
+ * @brief Output Level + Keyboard Level Scaling のノート別テーブルを構築
+ *
+ * @param op_level オペレーター出力レベル (0-99)
+ */
+void Envelope::buildKlsTable(uint8_t op_level) {
+    // 1. Output Level → scaleoutlevel (0-127)
+    const int base = scaleoutlevel(op_level);
+
+    for (uint8_t n = 0; n < 128; ++n) {
+        // 2. Keyboard Level Scaling を適用
+        int outlevel = base + calcKeyboardLevelScaling(n);
+
+        // 3. 0-127 にクランプ
+        if (outlevel > 127) outlevel = 127;
+        if (outlevel < 0) outlevel = 0;
+
+        // 4. 内部精度へ拡張 (<< 5 = ×32)
+        kls_outlevel_table_[n] = static_cast<int16_t>(outlevel << 5);
+    }
+    table_op_level_ = op_level;
+    kls_table_dirty_ = false;
+}
+
 /**
  * @brief ノートごとのターゲットレベルを計算
  *
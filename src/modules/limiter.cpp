@@ -0,0 +1,68 @@
+#include "modules/limiter.hpp"
+
+/**
+ * @brief ミックスバッファにゲインを適用（インプレース）
+ *
+ * CONTROL_BLOCK ごとに L/R 共通のピークを求め、
+ * 基準ゲインでスレッショルドを超える場合は目標ゲインを下げる。
+ * ゲインを下げる場合はブロック先頭から即座に適用し、
+ * 戻す場合はブロック内で前回ゲインから線形補間する。
+ *
+ * @param bufL Lチャンネル (Q23、未クリップ)
+ * @param bufR Rチャンネル (Q23、未クリップ)
+ * @param size サンプル数 (CONTROL_BLOCK の倍数)
+ */
+FASTRUN void Limiter::process(Audio24_t* bufL, Audio24_t* bufR, size_t size) {
+    const EnvGain_t makeup = makeup_gain_;
+    EnvGain_t gain = gain_;
+    EnvGain_t min_gain = min_gain_;
+
+    for (size_t base = 0; base < size; base += CONTROL_BLOCK) {
+        Audio24_t* blockL = bufL + base;
+        Audio24_t* blockR = bufR + base;
+
+        // 1. ブロックピーク検出（L/Rリンク）
+        int32_t peak = 0;
+        for (size_t i = 0; i < CONTROL_BLOCK; ++i) {
+            int32_t l = blockL[i];
+            int32_t r = blockR[i];
+            if (l < 0) l = -l;
+            if (r < 0) r = -r;
+            if (l > peak) peak = l;
+            if (r > peak) peak = r;
+        }
+
+        // 2. 目標ゲイン: 基準ゲインで THRESHOLD を超えるなら THRESHOLD / peak
+        EnvGain_t target = makeup;
+        if (((static_cast<int64_t>(peak) * makeup) >> ENVGAIN_SHIFT) > THRESHOLD) {
+            target = static_cast<EnvGain_t>((static_cast<int64_t>(THRESHOLD) << ENVGAIN_SHIFT) / peak);
+        }
+
+        // 3. エンベロープフォロワー: 下げは即時、戻りは1次IIR
+        EnvGain_t next;
+        if (target < gain) {
+            next = target;
+        } else {
+            next = gain + ((target - gain) >> RELEASE_SHIFT);
+            // シフトで0になって基準に届かない場合の端数処理
+            if (next == gain && gain < target) ++next;
+        }
+        if (next < min_gain) min_gain = next;
+
+        // 4. ゲイン適用
+        // 下げる場合はブロック先頭から目標ゲイン（ピークを先読みしているため
+        // オーバーシュートしない）、戻す場合はブロック内で線形補間する
+        if (next < gain) gain = next;
+        const int32_t dgain = (next - gain) >> CONTROL_SHIFT;
+        int32_t g = gain;
+        for (size_t i = 0; i < CONTROL_BLOCK; ++i) {
+            g += dgain;
+            blockL[i] = Q23_mul_EnvGain(blockL[i], g);
+            blockR[i] = Q23_mul_EnvGain(blockR[i], g);
+        }
+        gain = next;
+    }
+
+    gain_ = gain;
+    min_gain_ = min_gain;
+}
@@ -3,9 +3,105 @@
 Gain_t Oscillator::level_table[100] = {};
 bool Oscillator::table_initialized = false;
 
+// 帯域制限ミップテーブル本体（三角波・ノコギリ波・矩形波 × レベル1-8）
+// 毎サンプル参照するので DTCM に置く（以前は DMAMEM）。
+// 移した効果は実機で未計測。移す前後で BENCH OSC の TRI / SAW / SQUARE を比べて確かめること
+PLACE_HOT static Audio24_t mip_memory[Oscillator::MIP_WAVEFORMS][Oscillator::MIP_LEVELS - 1][Oscillator::MIP_TABLE_SIZE];
+
+const Audio24_t* Oscillator::MIP_SETS[4][MIP_LEVELS] = {
+    {Wavetable::sine, Wavetable::sine, Wavetable::sine, Wavetable::sine, Wavetable::sine,
+     Wavetable::sine, Wavetable::sine, Wavetable::sine, Wavetable::sine},
+    {Wavetable::triangle, mip_memory[0][0], mip_memory[0][1], mip_memory[0][2], mip_memory[0][3],
+     mip_memory[0][4], mip_memory[0][5], mip_memory[0][6], mip_memory[0][7]},
+    {Wavetable::saw, mip_memory[1][0], mip_memory[1][1], mip_memory[1][2], mip_memory[1][3],
+     mip_memory[1][4], mip_memory[1][5], mip_memory[1][6], mip_memory[1][7]},
+    {Wavetable::square, mip_memory[2][0], mip_memory[2][1], mip_memory[2][2], mip_memory[2][3],
+     mip_memory[2][4], mip_memory[2][5], mip_memory[2][6], mip_memory[2][7]},
+};
+
+/**
+ * @brief 帯域制限ミップテーブルを生成
+ *
+ * 1. 元テーブル (512サンプル) を DFT で 255次までの倍音係数に分解
+ * 2. レベル L ごとに DC + 2^(8-L) 次までを再合成
+ * 3. ギブス現象で元テーブルのピークを超える場合はピークに合わせて縮小
+ *
+ * cos/sin は sin テーブル（Q23）を添字 (k * n) & 511 で参照するので
+ * 三角関数の呼び出しは無い。
+ */
+void Oscillator::buildMipTables() {
+    constexpr size_t N = MIP_TABLE_SIZE;
+    constexpr size_t HALF = N / 2;
+    constexpr size_t QUARTER = N / 4;
+    constexpr float SIN_SCALE = 1.0f / static_cast<float>(Q23_MAX);
+
+    static_assert(sizeof(Wavetable::sine) / sizeof(Wavetable::sine[0]) == N,
+                  "sine table is used as the DFT basis");
+
+    const Audio24_t* sources[MIP_WAVEFORMS] = {Wavetable::triangle, Wavetable::saw, Wavetable::square};
+
+    for (size_t t = 0; t < MIP_WAVEFORMS; ++t) {
+        const Audio24_t* src = sources[t];
+
+        // 1. 倍音分解
+        float re[HALF];
+        float im[HALF];
+        float dc = 0.0f;
+        Audio24_t src_peak = 0;
+        for (size_t n = 0; n < N; ++n) {
+            dc += static_cast<float>(src[n]);
+            const Audio24_t a = src[n] < 0 ? -src[n] : src[n];
+            if (a > src_peak) src_peak = a;
+        }
+        dc /= static_cast<float>(N);
+
+        for (size_t k = 1; k < HALF; ++k) {
+            float c = 0.0f;
+            float s = 0.0f;
+            for (size_t n = 0; n < N; ++n) {
+                const size_t idx = (k * n) & (N - 1);
+                const float x = static_cast<float>(src[n]);
+                c += x * static_cast<float>(Wavetable::sine[(idx + QUARTER) & (N - 1)]);
+                s += x * static_cast<float>(Wavetable::sine[idx]);
+            }
+            re[k] = c * SIN_SCALE * (2.0f / N);
+            im[k] = s * SIN_SCALE * (2.0f / N);
+        }
+
+        // 2. レベルごとに再合成
+        for (uint8_t level = 1; level < MIP_LEVELS; ++level) {
+            Audio24_t* dst = mip_memory[t][level - 1];
+            const size_t top = static_cast<size_t>(1) << (MIP_TOP_HARMONIC_LG - level);
+
+            float buf[N];
+            float peak = 0.0f;
+            for (size_t n = 0; n < N; ++n) {
+                float y = dc;
+                for (size_t k = 1; k <= top && k < HALF; ++k) {
+                    const size_t idx = (k * n) & (N - 1);
+                    y += re[k] * static_cast<float>(Wavetable::sine[(idx + QUARTER) & (N - 1)]) * SIN_SCALE
+                       + im[k] * static_cast<float>(Wavetable::sine[idx]) * SIN_SCALE;
+                }
+                buf[n] = y;
+                const float a = y < 0.0f ? -y : y;
+                if (a > peak) peak = a;
+            }
+
+            // 3. ピーク合わせ
+            const float gain = (peak > static_cast<float>(src_peak)) ? static_cast<float>(src_peak) / peak : 1.0f;
+            for (size_t n = 0; n < N; ++n) {
+                dst[n] = static_cast<Audio24_t>(buf[n] * gain);
+            }
+        }
+    }
+}
+
 /**
  * @brief oscillatorの周波数を設定
  *
+ * 位相増分はノート別テーブルから取得する。
+ * テーブルが古い場合はここで再構築される（通常はプリセットロード時に構築済み）。
+ *
  * @param mem オシレーターメモリ
  * @param note MIDIノート番号
  */
@@ -13,15 +109,47 @@ void Oscillator::setFrequency(Memory& mem, uint8_t note) {
     // ノート番号を保存（エイリアシング防止用キースケーリングに使用）
     mem.note = note;
 
-    float freq;
+    prepareNoteTable();
+    mem.delta = delta_table[note > 127 ? 127 : note];
+
+    // 倍音がナイキストを超えないミップレベルをノート単位で決定
+    mem.mip = selectMipLevel(mem.delta);
+}
+
+/**
+ * @brief 周波数を位相増分に変換
+ *
+ * 高いノート × 大きいcoarseでは freq * 2^32 / SR が uint32 を超えるため、
+ * Cortex-M7 の vcvt と同じく飽和させる（ホストでも同じ値になるように明示）。
+ */
+static inline Phase_t frequencyToDelta(float freq, float scale) {
+    const float delta = freq * scale;
+    if (delta >= 4294967295.0f) return UINT32_MAX;
+    if (delta <= 0.0f) return 0;
+    return static_cast<Phase_t>(delta);
+}
+
+/**
+ * @brief ノート別位相増分テーブルを構築
+ *
+ * FIXEDモードでは全ノート同じ値になる。
+ */
+void Oscillator::buildDeltaTable() {
     if (is_fixed) {
         // FIXEDモード: MIDIノートに関係なく固定周波数
-        freq = AudioMath::fixedToFrequency(detune_cents, coarse, fine_level);
+        const float freq = AudioMath::fixedToFrequency(detune_cents, coarse, fine_level);
+        const Phase_t delta = frequencyToDelta(freq, PHASE_SCALE_FACTOR);
+        for (size_t n = 0; n < 128; ++n) {
+            delta_table[n] = delta;
+        }
     } else {
         // RATIOモード: MIDIノートに対する比率で周波数を設定
-        freq = AudioMath::ratioToFrequency(note, detune_cents, coarse, fine_level);
+        for (size_t n = 0; n < 128; ++n) {
+            const float freq = AudioMath::ratioToFrequency(static_cast<uint8_t>(n), detune_cents, coarse, fine_level);
+            delta_table[n] = frequencyToDelta(freq, PHASE_SCALE_FACTOR);
+        }
     }
-    mem.delta = static_cast<Phase_t>(freq * PHASE_SCALE_FACTOR);
+    delta_table_dirty = false;
 }
 
 /**
@@ -60,6 +188,7 @@ void Oscillator::reset(Memory& mem) {
     mem.delta = 0;
     mem.vel_vol = 0;
     mem.note = 60;  // デフォルト値にリセット
+    mem.mip = 0;
 }
 
 /**
@@ -85,6 +214,7 @@ void Oscillator::setLevelNonLinear(uint8_t level) {
 void Oscillator::setWavetable(uint8_t table_id) {
     if(table_id < 4) {
         wavetable = WAVETABLES[table_id].data;
+        mip_set = MIP_SETS[table_id];
         wavetable_size = WAVETABLES[table_id].size;
         bit_padding = AudioMath::bitPadding32(wavetable_size);
     }
@@ -92,12 +222,15 @@ void Oscillator::setWavetable(uint8_t table_id) {
 
 void Oscillator::setCoarse(float coarse) {
     this->coarse = clamp_coarse(coarse);
+    delta_table_dirty = true;
 }
 
 void Oscillator::setFine(float fine_level) {
     this->fine_level = clamp_fine(fine_level);
+    delta_table_dirty = true;
 }
 
 void Oscillator::setDetune(int8_t detune_cents) {
     this->detune_cents = clamp_detune(detune_cents);
+    delta_table_dirty = true;
 }
\ No newline at end of file
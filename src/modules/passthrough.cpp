@@ -1,4 +1,6 @@
 #include "modules/passthrough.hpp"
+#include "modules/scope.hpp"
+#include "modules/spectrum.hpp"
 
 /** @brief パススルーモード開始 */
 void Passthrough::begin() {
@@ -13,6 +15,9 @@ void Passthrough::begin() {
     rec_L.begin();
     rec_R.begin();
 
+    // パススルー側の有効状態でエフェクトバッファを配分し直す
+    arena_.plan(delay_enabled_, chorus_enabled_, reverb_enabled_);
+
     // エフェクトの状態をリセット
     filter_.reset();
     delay_.reset();
@@ -131,6 +136,10 @@ void Passthrough::process() {
             }
         }
 
+        // スコープ / スペクトラム画面を開いている間だけ最終出力を取り込む
+        if (ScopeTap::enabled()) ScopeTap::write(samples_L, samples_R, BUFFER_SIZE);
+        if (SpectrumTap::enabled()) SpectrumTap::write(samples_L, samples_R, BUFFER_SIZE);
+
         // --- 無音判定 + 差動出力生成 ---
         int16_t peak = 0;
         for (size_t i = 0; i < BUFFER_SIZE; i++) {
@@ -1,17 +1,53 @@
 #include "modules/reverb.hpp"
 #include <algorithm>
 
+/**
+ * @brief バッファ領域を割り当てる
+ *
+ * @param mem reverbTotalSamples(scale_q8) 分の領域、nullptr で切り離し
+ * @param scale_q8 サイズ倍率 (Q8: 256 = 標準)
+ */
+void Reverb::attach(Sample16_t* mem, uint16_t scale_q8) {
+    memory_ = mem;
+    scale_q8_ = scale_q8;
+
+    // 領域をコム → オールパスの順に切り分ける
+    Sample16_t* p = mem;
+    auto take = [&](uint16_t tuning) -> uint16_t {
+        return static_cast<uint16_t>((static_cast<uint32_t>(tuning) * scale_q8) >> 8);
+    };
+    for (uint8_t i = 0; i < 8; ++i) {
+        comb_L[i].size = mem ? take(COMB_TUNINGS_L[i]) : 0;
+        comb_L[i].buffer = mem ? p : nullptr;
+        p += comb_L[i].size;
+        comb_R[i].size = mem ? take(COMB_TUNINGS_R[i]) : 0;
+        comb_R[i].buffer = mem ? p : nullptr;
+        p += comb_R[i].size;
+    }
+    for (uint8_t i = 0; i < 4; ++i) {
+        allpass_L[i].size = mem ? take(ALLPASS_TUNINGS_L[i]) : 0;
+        allpass_L[i].buffer = mem ? p : nullptr;
+        p += allpass_L[i].size;
+        allpass_R[i].size = mem ? take(ALLPASS_TUNINGS_R[i]) : 0;
+        allpass_R[i].buffer = mem ? p : nullptr;
+        p += allpass_R[i].size;
+    }
+
+    reset();
+}
+
 /**
  * @brief 全バッファをクリア、係数を再計算
  */
 void Reverb::reset() {
-    comb_L1.clear(); comb_L2.clear(); comb_L3.clear(); comb_L4.clear();
-    comb_L5.clear(); comb_L6.clear(); comb_L7.clear(); comb_L8.clear();
-    comb_R1.clear(); comb_R2.clear(); comb_R3.clear(); comb_R4.clear();
-    comb_R5.clear(); comb_R6.clear(); comb_R7.clear(); comb_R8.clear();
-
-    allpass_L1.clear(); allpass_L2.clear(); allpass_L3.clear(); allpass_L4.clear();
-    allpass_R1.clear(); allpass_R2.clear(); allpass_R3.clear(); allpass_R4.clear();
+    for (uint8_t i = 0; i < 8; ++i) {
+        comb_L[i].clear();
+        comb_R[i].clear();
+    }
+    for (uint8_t i = 0; i < 4; ++i) {
+        allpass_L[i].clear();
+        allpass_R[i].clear();
+    }
 
     updateCoefficients();
 }
@@ -83,6 +119,8 @@ void Reverb::updateCoefficients() {
  * @param right R入力/出力
  */
 void Reverb::process(Sample16_t& left, Sample16_t& right) {
+    if (memory_ == nullptr) return; // 未割り当て時はドライのまま
+
     // --- 入力準備: モノラルミックス、ゲインを下げて飽和防止 ---
     // input = (L + R) >> 4  (÷16)
     // コム合算後の >>3 (÷8) と合わせて合計÷128
@@ -93,38 +131,26 @@ void Reverb::process(Sample16_t& left, Sample16_t& right) {
 
     // --- 並列コムフィルタ (L/R各8本) ---
     int32_t out_L = 0;
-    out_L += comb_L1.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_L += comb_L2.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_L += comb_L3.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_L += comb_L4.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_L += comb_L5.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_L += comb_L6.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_L += comb_L7.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_L += comb_L8.process(input_s, feedback_q15, damp1_q15, damp2_q15);
+    for (uint8_t i = 0; i < 8; ++i) {
+        out_L += comb_L[i].process(input_s, feedback_q15, damp1_q15, damp2_q15);
+    }
 
     int32_t out_R = 0;
-    out_R += comb_R1.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_R += comb_R2.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_R += comb_R3.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_R += comb_R4.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_R += comb_R5.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_R += comb_R6.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_R += comb_R7.process(input_s, feedback_q15, damp1_q15, damp2_q15);
-    out_R += comb_R8.process(input_s, feedback_q15, damp1_q15, damp2_q15);
+    for (uint8_t i = 0; i < 8; ++i) {
+        out_R += comb_R[i].process(input_s, feedback_q15, damp1_q15, damp2_q15);
+    }
 
     // --- 直列オールパスフィルタ (L/R各4本) ---
     // 8本のコム合算を÷8して16bit範囲に収める
     Sample16_t wet_L = static_cast<Sample16_t>(std::clamp<int32_t>(out_L >> 3, -32767, 32767));
-    wet_L = allpass_L1.process(wet_L);
-    wet_L = allpass_L2.process(wet_L);
-    wet_L = allpass_L3.process(wet_L);
-    wet_L = allpass_L4.process(wet_L);
+    for (uint8_t i = 0; i < 4; ++i) {
+        wet_L = allpass_L[i].process(wet_L);
+    }
 
     Sample16_t wet_R = static_cast<Sample16_t>(std::clamp<int32_t>(out_R >> 3, -32767, 32767));
-    wet_R = allpass_R1.process(wet_R);
-    wet_R = allpass_R2.process(wet_R);
-    wet_R = allpass_R3.process(wet_R);
-    wet_R = allpass_R4.process(wet_R);
+    for (uint8_t i = 0; i < 4; ++i) {
+        wet_R = allpass_R[i].process(wet_R);
+    }
 
     // --- ドライ/ウェットミックス ---
     // dry_gain = Q15_MAX - mix,  wet_gain = mix
@@ -0,0 +1,172 @@
+#include "modules/scope.hpp"
+
+#include <cstring>
+
+std::atomic<bool> ScopeTap::enabled_{false};
+std::atomic<uint32_t> ScopeTap::config_{ScopeTap::EDGE | 1u << 16};
+std::atomic<Sample16_t> ScopeTap::level_{0};
+std::atomic<bool> ScopeTap::note_pending_{false};
+std::atomic<bool> ScopeTap::restart_{false};
+
+ScopeTap::Frame ScopeTap::frames_[3] = {};
+std::atomic<uint8_t> ScopeTap::middle_{1};
+uint8_t ScopeTap::back_ = 0;
+uint8_t ScopeTap::front_ = 2;
+
+uint32_t ScopeTap::applied_ = UINT32_MAX;
+Sample16_t ScopeTap::ring_l_[RING] = {};
+Sample16_t ScopeTap::ring_r_[RING] = {};
+uint32_t ScopeTap::points_ = 0;
+uint8_t ScopeTap::acc_count_ = 0;
+Sample16_t ScopeTap::peak_l_ = 0;
+Sample16_t ScopeTap::peak_r_ = 0;
+Sample16_t ScopeTap::prev_ = 0;
+bool ScopeTap::armed_ = false;
+bool ScopeTap::capturing_ = false;
+bool ScopeTap::hit_ = false;
+uint32_t ScopeTap::trigger_point_ = 0;
+uint32_t ScopeTap::last_publish_ = 0;
+uint32_t ScopeTap::seq_ = 0;
+
+namespace {
+
+const char* const TRIGGER_NAMES[ScopeTap::TRIGGER_COUNT] = {"FREE", "EDGE", "LEVEL", "NOTE"};
+
+inline Sample16_t magnitude(Sample16_t x) {
+    return x < 0 ? static_cast<Sample16_t>(-x) : x;  // SAMPLE16_MIN は対称なので溢れない
+}
+
+} // namespace
+
+const char* ScopeTap::name(Trigger trigger) {
+    return trigger < TRIGGER_COUNT ? TRIGGER_NAMES[trigger] : "?";
+}
+
+// 読み手側から呼ぶ。書き手の状態は次の write() で取り込み直す
+void ScopeTap::setEnabled(bool enabled) {
+    if (enabled && !enabled_.load(std::memory_order_relaxed)) {
+        frames_[front_].seq = 0;  // 読み手の面は読み手のもの
+        restart_.store(true, std::memory_order_relaxed);
+    }
+    enabled_.store(enabled, std::memory_order_release);
+}
+
+void ScopeTap::configure(Trigger trigger, Source source, Sample16_t level, uint8_t decimation) {
+    if (decimation < 1) decimation = 1;
+    if (decimation > MAX_DECIMATION) decimation = MAX_DECIMATION;
+    level_.store(level, std::memory_order_relaxed);
+    config_.store(static_cast<uint32_t>(trigger) | static_cast<uint32_t>(source) << 8 |
+                  static_cast<uint32_t>(decimation) << 16, std::memory_order_release);
+}
+
+void ScopeTap::reset() {
+    std::memset(ring_l_, 0, sizeof(ring_l_));
+    std::memset(ring_r_, 0, sizeof(ring_r_));
+    points_ = 0;
+    acc_count_ = 0;
+    peak_l_ = 0;
+    peak_r_ = 0;
+    prev_ = 0;
+    armed_ = (applied_ & 0xFF) != NOTE;
+    capturing_ = false;
+    hit_ = false;
+    trigger_point_ = 0;
+    last_publish_ = 0;
+    note_pending_.store(false, std::memory_order_relaxed);
+    // 前の設定で作った未読のフレームは読ませない
+    middle_.fetch_and(static_cast<uint8_t>(~FRESH), std::memory_order_acq_rel);
+}
+
+/**
+ * @brief 1ブロック分を間引いてリングに書き、トリガーを判定する
+ *
+ * ブロックの先頭で設定を読み、変わっていれば取り込み直す。
+ */
+void ScopeTap::write(const Sample16_t* l, const Sample16_t* r, size_t n) {
+    if (!enabled_.load(std::memory_order_acquire)) return;
+
+    const uint32_t config = config_.load(std::memory_order_acquire);
+    if (restart_.exchange(false, std::memory_order_relaxed) || config != applied_) {
+        applied_ = config;
+        reset();
+    }
+    const uint8_t decimation = static_cast<uint8_t>(applied_ >> 16);
+
+    // ノートオン: 次の点から始める
+    if (note_pending_.exchange(false, std::memory_order_relaxed) && (applied_ & 0xFF) == NOTE && !capturing_) {
+        armed_ = true;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        if (acc_count_ == 0 || magnitude(l[i]) > magnitude(peak_l_)) peak_l_ = l[i];
+        if (acc_count_ == 0 || magnitude(r[i]) > magnitude(peak_r_)) peak_r_ = r[i];
+        if (++acc_count_ < decimation) continue;
+        push(peak_l_, peak_r_);
+        acc_count_ = 0;
+    }
+}
+
+void ScopeTap::push(Sample16_t l, Sample16_t r) {
+    const uint16_t at = points_ & (RING - 1);
+    ring_l_[at] = l;
+    ring_r_[at] = r;
+
+    const Trigger trigger = static_cast<Trigger>(applied_ & 0xFF);
+    const Sample16_t x = ((applied_ >> 8) & 0xFF) == RIGHT ? r : l;
+
+    // トリガー前の点がそろってから判定する
+    if (armed_ && points_ >= PRE_POINTS) {
+        const Sample16_t level = level_.load(std::memory_order_relaxed);
+        bool fire = false;
+        bool hit = true;
+        switch (trigger) {
+            case FREE:  fire = true; hit = false; break;
+            case EDGE:  fire = prev_ < level && x >= level; break;
+            case LEVEL: fire = magnitude(x) >= level; break;
+            case NOTE:  fire = true; break;
+            default: break;
+        }
+        if (!fire && (trigger == EDGE || trigger == LEVEL) && points_ - last_publish_ >= AUTO_POINTS) {
+            fire = true;
+            hit = false;
+        }
+        if (fire) {
+            armed_ = false;
+            capturing_ = true;
+            hit_ = hit;
+            trigger_point_ = points_;
+        }
+    }
+    prev_ = x;
+    ++points_;
+
+    if (capturing_ && points_ - trigger_point_ >= POINTS - PRE_POINTS) {
+        publish();
+        capturing_ = false;
+        last_publish_ = points_;
+        armed_ = trigger != NOTE;
+    }
+}
+
+// trigger_point_ の PRE_POINTS 前から POINTS 点を書き手の面に写して真ん中と交換する
+void ScopeTap::publish() {
+    Frame& f = frames_[back_];
+    const uint32_t start = trigger_point_ - PRE_POINTS;
+    for (uint16_t i = 0; i < POINTS; ++i) {
+        const uint16_t at = (start + i) & (RING - 1);
+        f.l[i] = ring_l_[at];
+        f.r[i] = ring_r_[at];
+    }
+    f.seq = ++seq_;
+    f.decimation = static_cast<uint8_t>(applied_ >> 16);
+    f.trigger = static_cast<Trigger>(applied_ & 0xFF);
+    f.triggered = hit_;
+
+    back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+bool ScopeTap::acquire() {
+    if (!(middle_.load(std::memory_order_acquire) & FRESH)) return false;
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~FRESH;
+    return true;
+}
@@ -0,0 +1,387 @@
+#include "modules/spectrum.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "handlers/audio.hpp"
+#include "tools/profiler.hpp"
+#include "utils/placement.hpp"
+
+// ============================================
+// SpectrumTap
+// ============================================
+
+std::atomic<bool> SpectrumTap::enabled_{false};
+std::atomic<uint32_t> SpectrumTap::config_{512u | 1u << 16};
+std::atomic<bool> SpectrumTap::restart_{false};
+
+PLACE_BULK SpectrumTap::Frame SpectrumTap::frames_[3];
+std::atomic<uint8_t> SpectrumTap::middle_{1};
+uint8_t SpectrumTap::back_ = 0;
+uint8_t SpectrumTap::front_ = 2;
+
+uint32_t SpectrumTap::applied_ = UINT32_MAX;
+uint16_t SpectrumTap::fill_ = 0;
+uint8_t SpectrumTap::acc_count_ = 0;
+uint32_t SpectrumTap::integ1_ = 0;
+uint32_t SpectrumTap::integ2_ = 0;
+uint32_t SpectrumTap::comb1_ = 0;
+uint32_t SpectrumTap::comb2_ = 0;
+uint32_t SpectrumTap::seq_ = 0;
+
+// 読み手側から呼ぶ。書き手の状態は次の write() で取り込み直す
+void SpectrumTap::setEnabled(bool enabled) {
+    if (enabled && !enabled_.load(std::memory_order_relaxed)) {
+        frames_[front_].seq = 0;  // DMAMEM は起動時に初期化されない
+        restart_.store(true, std::memory_order_relaxed);
+    }
+    enabled_.store(enabled, std::memory_order_release);
+}
+
+void SpectrumTap::configure(uint16_t size, uint8_t decimation) {
+    if (size != 256) size = MAX_SIZE;
+    if (decimation < 1) decimation = 1;
+    if (decimation > MAX_DECIMATION) decimation = MAX_DECIMATION;
+    config_.store(static_cast<uint32_t>(size) | static_cast<uint32_t>(decimation) << 16,
+                  std::memory_order_release);
+}
+
+void SpectrumTap::reset() {
+    fill_ = 0;
+    acc_count_ = 0;
+    integ1_ = 0;
+    integ2_ = 0;
+    comb1_ = 0;
+    comb2_ = 0;
+    // 前の設定で作った未読のフレームは読ませない
+    middle_.fetch_and(static_cast<uint8_t>(~FRESH), std::memory_order_acq_rel);
+}
+
+/**
+ * @brief 1ブロック分を L+R の平均にして間引き、書き手の面に貯める
+ *
+ * 間引きは2次 CIC（decimation サンプルの移動平均を2回）。
+ * 積分器は uint32 で回り、櫛形の差分で桁あふれが打ち消される。
+ */
+void SpectrumTap::write(const Sample16_t* l, const Sample16_t* r, size_t n) {
+    if (!enabled_.load(std::memory_order_acquire)) return;
+
+    const uint32_t config = config_.load(std::memory_order_acquire);
+    if (restart_.exchange(false, std::memory_order_relaxed) || config != applied_) {
+        applied_ = config;
+        reset();
+    }
+    const uint16_t size = static_cast<uint16_t>(applied_ & 0xFFFF);
+    const uint8_t decimation = static_cast<uint8_t>(applied_ >> 16);
+    const int32_t gain = static_cast<int32_t>(decimation) * decimation;
+
+    Frame* f = &frames_[back_];
+    for (size_t i = 0; i < n; ++i) {
+        const int32_t mono = (static_cast<int32_t>(l[i]) + r[i]) >> 1;
+        int32_t out = mono;
+        if (decimation > 1) {
+            integ1_ += static_cast<uint32_t>(mono);
+            integ2_ += integ1_;
+            if (++acc_count_ < decimation) continue;
+            acc_count_ = 0;
+            const uint32_t y1 = integ2_ - comb1_;
+            comb1_ = integ2_;
+            const uint32_t y2 = y1 - comb2_;
+            comb2_ = y1;
+            out = static_cast<int32_t>(y2) / gain;
+        }
+        f->x[fill_] = static_cast<Sample16_t>(out);
+        if (++fill_ < size) continue;
+
+        // たまったら真ん中と交換して、次の面に書き続ける
+        fill_ = 0;
+        f->seq = ++seq_;
+        f->size = size;
+        f->decimation = decimation;
+        back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & ~FRESH;
+        f = &frames_[back_];
+    }
+}
+
+bool SpectrumTap::acquire() {
+    if (!(middle_.load(std::memory_order_acquire) & FRESH)) return false;
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~FRESH;
+    return true;
+}
+
+// ============================================
+// Spectrum
+// ============================================
+
+bool Spectrum::ready_ = false;
+PLACE_BULK int16_t Spectrum::window_[N_MAX];
+PLACE_BULK int16_t Spectrum::cos_[N_MAX];
+PLACE_BULK int16_t Spectrum::sin_[N_MAX];
+PLACE_BULK int32_t Spectrum::re_[N_MAX];
+PLACE_BULK int32_t Spectrum::im_[N_MAX];
+
+Spectrum::Phase Spectrum::phase_ = Spectrum::IDLE;
+uint16_t Spectrum::size_ = 0;
+uint8_t Spectrum::decimation_ = 0;
+uint8_t Spectrum::pass_ = 0;
+uint16_t Spectrum::span_ = 0;
+uint16_t Spectrum::index_ = 0;
+uint32_t Spectrum::frame_ticks_ = 0;
+
+uint16_t Spectrum::map_size_ = 0;
+uint8_t Spectrum::map_decimation_ = 0;
+uint16_t Spectrum::col_lo_[COLUMNS] = {};
+uint16_t Spectrum::col_hi_[COLUMNS] = {};
+float Spectrum::f_lo_ = 0.0f;
+float Spectrum::f_hi_ = 0.0f;
+
+uint8_t Spectrum::pending_[COLUMNS] = {};
+uint8_t Spectrum::levels_[COLUMNS] = {};
+uint32_t Spectrum::seq_ = 0;
+
+uint32_t Spectrum::busy_ticks_ = 0;
+uint32_t Spectrum::window_start_ms_ = 0;
+float Spectrum::load_ = 0.0f;
+uint32_t Spectrum::frame_us_ = 0;
+
+namespace {
+
+constexpr float TWO_PI = 6.283185307f;
+
+// フルスケールの正弦波のビンの電力 (dB)
+// 振幅 2^15 を 2^INPUT_SHIFT 倍、Hann のコヒーレントゲイン 1/2、DFT の N/2、各段の縮小 1/N → 2^21
+constexpr float FULL_SCALE_DB = 126.43f;
+
+// 1回の時間確認までに進める数
+constexpr uint16_t LOAD_CHUNK = 32;
+constexpr uint16_t BUTTERFLY_CHUNK = 8;
+constexpr uint16_t BIN_CHUNK = 8;
+
+inline int32_t mulQ15(int32_t x, int16_t w) {
+    return static_cast<int32_t>((static_cast<int64_t>(x) * w) >> 15);
+}
+
+// 8bit の値の4進の桁を逆順にする
+inline uint16_t reverseBase4(uint16_t k) {
+    return ((k & 0x03) << 6) | ((k & 0x0C) << 2) | ((k & 0x30) >> 2) | ((k & 0xC0) >> 6);
+}
+
+} // namespace
+
+void Spectrum::buildTables() {
+    for (uint16_t i = 0; i < N_MAX; ++i) {
+        const float phase = TWO_PI * i / N_MAX;
+        window_[i] = static_cast<int16_t>(lrintf((0.5f - 0.5f * cosf(phase)) * 32767.0f));
+        cos_[i] = static_cast<int16_t>(lrintf(cosf(phase) * 32767.0f));
+        sin_[i] = static_cast<int16_t>(lrintf(sinf(phase) * 32767.0f));
+    }
+    ready_ = true;
+}
+
+/**
+ * @brief 列 → ビンの範囲を作る
+ *
+ * 表示範囲は max(20Hz, 1ビン) 〜 min(20kHz, ナイキスト) の対数軸。
+ * 1列がビン1つより狭い低域では、隣り合う列が同じビンを指す。
+ */
+void Spectrum::buildMap(uint16_t size, uint8_t decimation) {
+    const float fs = static_cast<float>(SAMPLE_RATE) / decimation;
+    const float bin_hz = fs / size;
+    f_lo_ = bin_hz > 20.0f ? bin_hz : 20.0f;
+    f_hi_ = fs * 0.5f < 20000.0f ? fs * 0.5f : 20000.0f;
+
+    const float ratio = f_hi_ / f_lo_;
+    const uint16_t last = size / 2;
+    for (uint16_t c = 0; c < COLUMNS; ++c) {
+        const float start = f_lo_ * powf(ratio, static_cast<float>(c) / COLUMNS);
+        const float end = f_lo_ * powf(ratio, static_cast<float>(c + 1) / COLUMNS);
+        long lo = lrintf(start / bin_hz);
+        long hi = lrintf(end / bin_hz) - 1;
+        if (lo < 1) lo = 1;
+        if (lo > last) lo = last;
+        if (hi < lo) hi = lo;
+        if (hi > last) hi = last;
+        col_lo_[c] = static_cast<uint16_t>(lo);
+        col_hi_[c] = static_cast<uint16_t>(hi);
+    }
+    map_size_ = size;
+    map_decimation_ = decimation;
+}
+
+int16_t Spectrum::columnOf(float hz) {
+    if (map_size_ == 0 || hz < f_lo_ || hz > f_hi_) return -1;
+    const int16_t c = static_cast<int16_t>(COLUMNS * logf(hz / f_lo_) / logf(f_hi_ / f_lo_));
+    return c < COLUMNS ? c : COLUMNS - 1;
+}
+
+// 周波数間引きの出力は桁反転順。ビン k が置かれている位置
+uint16_t Spectrum::binPosition(uint16_t k) {
+    if (size_ == 256) return reverseBase4(k);
+    // 512 点: 基数2の段で偶数ビンが前半、奇数ビンが後半に分かれる
+    return (k & 1) * 256 + reverseBase4(k >> 1);
+}
+
+// pass 0 は 512 点なら基数2 (span 512)、以降は基数4で span を 1/4 ずつ
+void Spectrum::beginPass(uint8_t pass) {
+    pass_ = pass;
+    index_ = 0;
+    if (size_ == N_MAX) span_ = pass == 0 ? N_MAX : 256 >> (2 * (pass - 1));
+    else span_ = 256 >> (2 * pass);
+}
+
+uint16_t Spectrum::passButterflies() {
+    return span_ == N_MAX ? N_MAX / 2 : size_ / 4;
+}
+
+void Spectrum::butterfly(uint16_t b) {
+    if (span_ == N_MAX) {
+        // 基数2: x[j] ± x[j + N/2]、差に W^j
+        const uint16_t j = b;
+        const uint16_t h = N_MAX / 2;
+        const int32_t ar = re_[j], ai = im_[j];
+        const int32_t cr = re_[j + h], ci = im_[j + h];
+        re_[j] = (ar + cr) >> 1;
+        im_[j] = (ai + ci) >> 1;
+        const int32_t dr = (ar - cr) >> 1;
+        const int32_t di = (ai - ci) >> 1;
+        re_[j + h] = mulQ15(dr, cos_[j]) + mulQ15(di, sin_[j]);
+        im_[j + h] = mulQ15(di, cos_[j]) - mulQ15(dr, sin_[j]);
+        return;
+    }
+
+    // 基数4: ブロック長 L = span_、Q = L/4
+    const uint16_t q = span_ / 4;
+    const uint16_t j = b % q;
+    const uint16_t i0 = (b / q) * span_ + j;
+    const uint16_t i1 = i0 + q, i2 = i1 + q, i3 = i2 + q;
+
+    const int32_t t0r = re_[i0] + re_[i2], t0i = im_[i0] + im_[i2];
+    const int32_t t1r = re_[i0] - re_[i2], t1i = im_[i0] - im_[i2];
+    const int32_t t2r = re_[i1] + re_[i3], t2i = im_[i1] + im_[i3];
+    const int32_t t3r = re_[i1] - re_[i3], t3i = im_[i1] - im_[i3];
+
+    re_[i0] = (t0r + t2r) >> 2;
+    im_[i0] = (t0i + t2i) >> 2;
+
+    // y1 = t1 - i·t3, y2 = t0 - t2, y3 = t1 + i·t3 に W^j, W^2j, W^3j をかける
+    const int32_t y1r = (t1r + t3i) >> 2, y1i = (t1i - t3r) >> 2;
+    const int32_t y2r = (t0r - t2r) >> 2, y2i = (t0i - t2i) >> 2;
+    const int32_t y3r = (t1r - t3i) >> 2, y3i = (t1i + t3r) >> 2;
+
+    const uint16_t w1 = j * (N_MAX / span_);
+    const uint16_t w2 = w1 * 2;
+    const uint16_t w3 = w1 * 3;
+    re_[i1] = mulQ15(y1r, cos_[w1]) + mulQ15(y1i, sin_[w1]);
+    im_[i1] = mulQ15(y1i, cos_[w1]) - mulQ15(y1r, sin_[w1]);
+    re_[i2] = mulQ15(y2r, cos_[w2]) + mulQ15(y2i, sin_[w2]);
+    im_[i2] = mulQ15(y2i, cos_[w2]) - mulQ15(y2r, sin_[w2]);
+    re_[i3] = mulQ15(y3r, cos_[w3]) + mulQ15(y3i, sin_[w3]);
+    im_[i3] = mulQ15(y3i, cos_[w3]) - mulQ15(y3r, sin_[w3]);
+}
+
+void Spectrum::setEnabled(bool enabled) {
+    if (enabled && !ready_) buildTables();
+    phase_ = IDLE;
+    seq_ = 0;
+    std::memset(levels_, 0, sizeof(levels_));
+    load_ = 0.0f;
+    busy_ticks_ = 0;
+    window_start_ms_ = millis();
+    SpectrumTap::setEnabled(enabled);
+}
+
+/**
+ * @brief STEP_US の間だけ解析を進める
+ *
+ * 窓かけ → バタフライ（段ごと）→ 列まとめの順に、区切りごとに時間を確かめ、
+ * 持ち時間を超えたらその位置で抜ける。1フレーム終えて時間が残っていれば次のフレームに進む。
+ */
+void Spectrum::step() {
+    const uint32_t now_ms = millis();
+    if (now_ms - window_start_ms_ >= 1000) {
+        const float elapsed = static_cast<float>(Profiler::ticksPerSecond()) * (now_ms - window_start_ms_) / 1000.0f;
+        load_ = 100.0f * busy_ticks_ / elapsed;
+        busy_ticks_ = 0;
+        window_start_ms_ = now_ms;
+    }
+    if (!SpectrumTap::enabled()) return;
+
+    const uint32_t budget = static_cast<uint32_t>(
+        static_cast<uint64_t>(STEP_US) * Profiler::ticksPerSecond() / 1000000);
+    const uint32_t start = Profiler::now();
+    uint32_t mark = start;  // このフレームの分を数え始めた時刻
+
+    while (Profiler::now() - start < budget) {
+        if (phase_ == IDLE) {
+            if (!SpectrumTap::acquire()) break;
+            const SpectrumTap::Frame& f = SpectrumTap::frame();
+            size_ = f.size;
+            decimation_ = f.decimation;
+            index_ = 0;
+            frame_ticks_ = 0;
+            mark = Profiler::now();
+            phase_ = LOAD;
+        }
+        else if (phase_ == LOAD) {
+            // Hann 窓をかけて INPUT_SHIFT だけ持ち上げる
+            const SpectrumTap::Frame& f = SpectrumTap::frame();
+            const uint16_t stride = N_MAX / size_;
+            const uint16_t end = index_ + LOAD_CHUNK < size_ ? index_ + LOAD_CHUNK : size_;
+            for (uint16_t i = index_; i < end; ++i) {
+                re_[i] = (static_cast<int32_t>(f.x[i]) * window_[i * stride]) >> (15 - INPUT_SHIFT);
+                im_[i] = 0;
+            }
+            index_ = end;
+            if (index_ == size_) {
+                beginPass(0);
+                phase_ = BUTTERFLY;
+            }
+        }
+        else if (phase_ == BUTTERFLY) {
+            const uint16_t count = passButterflies();
+            const uint16_t end = index_ + BUTTERFLY_CHUNK < count ? index_ + BUTTERFLY_CHUNK : count;
+            for (uint16_t b = index_; b < end; ++b) butterfly(b);
+            index_ = end;
+            if (index_ == count) {
+                if (span_ > 4) {
+                    beginPass(pass_ + 1);
+                } else {
+                    if (map_size_ != size_ || map_decimation_ != decimation_) buildMap(size_, decimation_);
+                    index_ = 0;
+                    phase_ = BIN;
+                }
+            }
+        }
+        else {
+            // 列ごとにビンの電力の最大を dB にする
+            const uint16_t end = index_ + BIN_CHUNK < COLUMNS ? index_ + BIN_CHUNK : COLUMNS;
+            for (uint16_t c = index_; c < end; ++c) {
+                int64_t peak = 0;
+                for (uint16_t k = col_lo_[c]; k <= col_hi_[c]; ++k) {
+                    const uint16_t p = binPosition(k);
+                    const int64_t power = static_cast<int64_t>(re_[p]) * re_[p] + static_cast<int64_t>(im_[p]) * im_[p];
+                    if (power > peak) peak = power;
+                }
+                float db = peak > 0 ? 10.0f * log10f(static_cast<float>(peak)) - FULL_SCALE_DB + DB_RANGE : 0.0f;
+                if (db < 0.0f) db = 0.0f;
+                if (db > DB_RANGE) db = DB_RANGE;
+                pending_[c] = static_cast<uint8_t>(db);
+            }
+            index_ = end;
+            if (index_ == COLUMNS) {
+                std::memcpy(levels_, pending_, sizeof(levels_));
+                ++seq_;
+                const uint32_t t = Profiler::now();
+                frame_ticks_ += t - mark;
+                mark = t;
+                frame_us_ = static_cast<uint32_t>(
+                    static_cast<uint64_t>(frame_ticks_) * 1000000 / Profiler::ticksPerSecond());
+                phase_ = IDLE;
+            }
+        }
+    }
+
+    const uint32_t t = Profiler::now();
+    busy_ticks_ += t - start;
+    if (phase_ != IDLE) frame_ticks_ += t - mark;
+}
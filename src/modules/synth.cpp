@@ -1,30 +1,78 @@
 #include "modules/synth.hpp"
 
+#include <cstring>
+
+#include "tools/profiler.hpp"
+#include "tools/capture.hpp"
+#include "modules/scope.hpp"
+#include "modules/spectrum.hpp"
+
 /** @brief シンセ初期化 */
-void Synth::init(Delay& shared_delay, Filter& shared_filter, Chorus& shared_chorus, Reverb& shared_reverb) {
+void Synth::init(Delay& shared_delay, Filter& shared_filter, Chorus& shared_chorus, Reverb& shared_reverb,
+                 EffectArena& shared_arena) {
     delay_ptr_ = &shared_delay;
     filter_ptr_ = &shared_filter;
     chorus_ptr_ = &shared_chorus;
     reverb_ptr_ = &shared_reverb;
+    arena_ptr_ = &shared_arena;
 
     // ノート情報クリア
     for (int i = 0; i < 128; ++i) {
         midi_note_to_index[i] = -1;
     }
     Oscillator::initTable();
+    buildVelocityTable();
     lfo_.init();
     loadPreset(0);
 }
 
+/** @brief ベロシティカーブ変換テーブルを構築 */
+void Synth::buildVelocityTable() {
+    for (uint8_t c = 0; c < static_cast<uint8_t>(VelocityCurve::COUNT); ++c) {
+        for (uint8_t v = 0; v < 128; ++v) {
+            velocity_lut_[c][v] = AudioMath::applyVelocityCurve(v, static_cast<VelocityCurve>(c));
+        }
+    }
+}
+
+/**
+ * @brief ステージングの変更をライブの面として公開
+ *
+ * 変更がなければ何もしない。あればノートオン用テーブル（位相増分 /
+ * KLS込み出力レベル / Rate Scaling増分）をステージング側で作ってから
+ * params_seq_ を進めて面を入れ替え、新しいステージングを新しいライブで揃える。
+ * generate() の外（ブロックの境目）でだけ呼ぶこと。
+ * generate() に割り込んで呼ぶと、読んでいる途中の面へ書き写してしまう（synth.hpp の params_ 参照）。
+ */
+void Synth::publishParams() {
+    if (!params_pending_) return;
+
+    Operator* staging = stagingParams();
+    for (uint8_t op = 0; op < MAX_OPERATORS; ++op) {
+        staging[op].osc.prepareNoteTable();
+        staging[op].env.prepareNoteTables(staging[op].osc.getLevel());
+    }
+
+    params_seq_.fetch_add(1, std::memory_order_release);
+    std::memcpy(stagingParams(), staging, sizeof(params_[0]));
+    params_pending_ = false;
+}
+
 /** @brief シンセ生成 */
 FASTRUN void Synth::generate() {
     if(samples_ready_flags != false) return;
     if(current_algo == nullptr) return;
 
+    // 1ブロック生成全体を計測（update() は空振りも多いのでこちらで測る）
+    const uint32_t synth_start = Profiler::now();
+    block_start_ = synth_start;
+    ++block_count_;
+
     // LFOを1バッファ分進める（generate内でバッファ1回保証）
     lfo_.advance(BUFFER_SIZE);
 
-    // 定数キャッシュ
+    // 定数キャッシュ（オペレーターパラメータはこのブロックの間ライブの面で固定）
+    Operator* const ops = liveParams();
     const uint8_t* exec_order = current_algo->exec_order;
     const uint8_t* mod_mask = current_algo->mod_mask;
     const uint8_t output_mask = current_algo->output_mask;
@@ -66,11 +114,23 @@ FASTRUN void Synth::generate() {
     // ピッチ変調合計 (LFO + ピッチベンド)
     const int32_t total_pitch_mod = lfo_pitch_mod + pb_mod;
 
+    // ブロック先頭のピッチ変調量
+    // ランプ有効時は前ブロックの値からブロック内で線形補間する
+    const int32_t start_pitch_mod = pitch_mod_ramp_ ? prev_pitch_mod_ : total_pitch_mod;
+    prev_pitch_mod_ = total_pitch_mod;
+
+    // エンベロープ制御レート（バッファ単位で一定）
+    const uint8_t env_rate_shift = env_rate_shift_;
+    const uint8_t env_lg_block = Envelope::ENV_LG_BLOCK_MAX - env_rate_shift;
+    const size_t env_block = Envelope::ENV_BLOCK_MAX >> env_rate_shift;
+    const int32_t env_round = static_cast<int32_t>(env_block >> 1);
+
     // リセット待ちのノートを記録
     uint8_t notes_to_reset[MAX_NOTES];
     uint8_t reset_count = 0;
 
     // ノート毎処理
+    const uint32_t voices_start = Profiler::now();
     for(uint8_t n = 0; n < MAX_NOTES; ++n) {
         if(notes[n].order == 0) continue;
 
@@ -87,7 +147,8 @@ FASTRUN void Synth::generate() {
         // #pragma GCC unroll 6
         for(uint8_t k = 0; k < MAX_OPERATORS; ++k) {
             uint8_t op_idx = exec_order[k];
-            Operator& op_obj = operators[op_idx];
+            Operator& op_obj = ops[op_idx];
+            const Gain_t ams_gain = op_obj.ams_gain;
 
             // ステートへの参照キャッシュ
             auto& osc_mem = ope_states[op_idx].osc_mems[n];
@@ -100,134 +161,85 @@ FASTRUN void Synth::generate() {
             // フィードバック履歴を更新するオペレーター（fb_source）
             bool is_fb_source = (op_idx == fb_source && feedback_amount > 0);
 
-            // エンベロープは64サンプルごとに1回更新
-            // BUFFER_SIZE = 128 なので、2回に分けて処理
-            constexpr size_t ENV_BLOCK_SIZE = 64;
-
-            // --- 前半64サンプル ---
-            // ゲイン補間でクリックノイズを防止
-            EnvGain_t gain1 = op_obj.env.currentLevel(env_mem);
-            op_obj.env.update(env_mem);
-            EnvGain_t gain2 = op_obj.env.currentLevel(env_mem);
-
-            // dgain = (gain2 - gain1 + 32) >> 6 (64サンプルで線形補間)
-            int32_t dgain = (static_cast<int32_t>(gain2) - static_cast<int32_t>(gain1) + 32) >> 6;
-            int32_t gain = static_cast<int32_t>(gain1);
-
-            for(size_t i = 0; i < ENV_BLOCK_SIZE; ++i) {
-                gain += dgain;  // 毎サンプル増分
-                Audio24_t mod_input = 0;
-
-                // 1. 変調入力
-                if (mask) {
-                    for(uint8_t src = 0; src < MAX_OPERATORS; ++src) {
-                         if (mask & (1 << src)) {
-                             if (is_fb_target && src == fb_source) continue;
-                             mod_input += op_buffer[src][i];
-                         }
-                    }
-                }
-
-                // 2. フィードバック入力
-                if (is_fb_target && current_fb_shift < 16) {
-                    mod_input += (fb_h0 + fb_h1) >> (current_fb_shift + 1);
-                }
-
-                // 3. 発音（補間されたゲインを使用）
-                Audio24_t raw_wave = op_obj.osc.getSample(osc_mem, mod_input);
-                Audio24_t output = Q23_mul_EnvGain(raw_wave, static_cast<EnvGain_t>(gain));
-
-                // 4. LFO 振幅モジュレーション（オペレーター単位）
-                if (lfo_amp_mod != 0 && op_ams_gain_[op_idx] != 0) {
-                    Gain_t am_amt = static_cast<Gain_t>(
-                        (static_cast<int32_t>(lfo_amp_mod) * op_ams_gain_[op_idx]) >> Q15_SHIFT
-                    );
-                    output -= static_cast<Audio24_t>(
-                        (static_cast<int64_t>(output) * am_amt) >> Q15_SHIFT
-                    );
-                }
-
-                op_buffer[op_idx][i] = output;
-
-                // 5. FB履歴更新
-                if (is_fb_source) {
-                    fb_h1 = fb_h0;
-                    fb_h0 = output;
-                }
-
-                op_obj.osc.update(osc_mem);
-
-                // 6. LFO + ピッチベンド ピッチモジュレーション（位相オフセット追加）
-                if (total_pitch_mod != 0) {
-                    osc_mem.phase += static_cast<Phase_t>(
-                        (static_cast<int64_t>(osc_mem.delta) * total_pitch_mod) >> Q15_SHIFT
-                    );
-                }
+            // ピッチ変調込みの位相増分（ブロック単位で1回だけ計算）
+            // ランプ無効時は dstep = 0 で一定
+            const Phase_t step_end = op_obj.osc.modulatedDelta(osc_mem, total_pitch_mod);
+            Phase_t step = step_end;
+            Phase_t dstep = 0;
+            if (start_pitch_mod != total_pitch_mod) {
+                step = op_obj.osc.modulatedDelta(osc_mem, start_pitch_mod);
+                dstep = static_cast<Phase_t>(
+                    static_cast<int32_t>(step_end - step) / static_cast<int32_t>(BUFFER_SIZE)
+                );
+                step += dstep;
             }
 
-            // --- 後半64サンプル ---
-            // 前半終了時のgain2を次のgain1として使用
-            gain1 = gain2;
-            op_obj.env.update(env_mem);
-            gain2 = op_obj.env.currentLevel(env_mem);
-
-            dgain = (static_cast<int32_t>(gain2) - static_cast<int32_t>(gain1) + 32) >> 6;
-            gain = static_cast<int32_t>(gain1);
-
-            for(size_t i = ENV_BLOCK_SIZE; i < BUFFER_SIZE; ++i) {
-                gain += dgain;  // 毎サンプル増分
-                Audio24_t mod_input = 0;
-
-                // 1. 変調入力
-                if (mask) {
-                    for(uint8_t src = 0; src < MAX_OPERATORS; ++src) {
-                         if (mask & (1 << src)) {
-                             if (is_fb_target && src == fb_source) continue;
-                             mod_input += op_buffer[src][i];
-                         }
+            // 波形テーブル（ノートごとのミップレベル）はブロック単位で1回だけ取得
+            const Audio24_t* wave_table = op_obj.osc.getTable(osc_mem);
+
+            // エンベロープは制御ブロック（env_block サンプル）ごとに1回更新
+            // 既定は64サンプル（BUFFER_SIZE = 128 なので2回）
+            for(size_t base = 0; base < BUFFER_SIZE; base += env_block) {
+                // ゲイン補間でクリックノイズを防止
+                EnvGain_t gain1 = op_obj.env.currentLevel(env_mem);
+                op_obj.env.update(env_mem, env_rate_shift);
+                EnvGain_t gain2 = op_obj.env.currentLevel(env_mem);
+
+                // dgain = (gain2 - gain1 + N/2) >> log2(N) (N サンプルで線形補間)
+                const int32_t dgain = (static_cast<int32_t>(gain2) - static_cast<int32_t>(gain1) + env_round) >> env_lg_block;
+                int32_t gain = static_cast<int32_t>(gain1);
+
+                for(size_t i = base; i < base + env_block; ++i) {
+                    gain += dgain;  // 毎サンプル増分
+                    Audio24_t mod_input = 0;
+
+                    // 1. 変調入力
+                    if (mask) {
+                        for(uint8_t src = 0; src < MAX_OPERATORS; ++src) {
+                             if (mask & (1 << src)) {
+                                 if (is_fb_target && src == fb_source) continue;
+                                 mod_input += op_buffer[src][i];
+                             }
+                        }
                     }
-                }
-
-                // 2. フィードバック入力
-                if (is_fb_target && current_fb_shift < 16) {
-                    mod_input += (fb_h0 + fb_h1) >> (current_fb_shift + 1);
-                }
 
-                // 3. 発音（補間されたゲインを使用）
-                Audio24_t raw_wave = op_obj.osc.getSample(osc_mem, mod_input);
-                Audio24_t output = Q23_mul_EnvGain(raw_wave, static_cast<EnvGain_t>(gain));
-
-                // 4. LFO 振幅モジュレーション（オペレーター単位）
-                if (lfo_amp_mod != 0 && op_ams_gain_[op_idx] != 0) {
-                    Gain_t am_amt = static_cast<Gain_t>(
-                        (static_cast<int32_t>(lfo_amp_mod) * op_ams_gain_[op_idx]) >> Q15_SHIFT
-                    );
-                    output -= static_cast<Audio24_t>(
-                        (static_cast<int64_t>(output) * am_amt) >> Q15_SHIFT
-                    );
-                }
+                    // 2. フィードバック入力
+                    if (is_fb_target && current_fb_shift < 16) {
+                        mod_input += (fb_h0 + fb_h1) >> (current_fb_shift + 1);
+                    }
 
-                op_buffer[op_idx][i] = output;
+                    // 3. 発音（補間されたゲインを使用）
+                    Audio24_t raw_wave = op_obj.osc.getSample(osc_mem, mod_input, wave_table);
+                    Audio24_t output = Q23_mul_EnvGain(raw_wave, static_cast<EnvGain_t>(gain));
+
+                    // 4. LFO 振幅モジュレーション（オペレーター単位）
+                    if (lfo_amp_mod != 0 && ams_gain != 0) {
+                        Gain_t am_amt = static_cast<Gain_t>(
+                            (static_cast<int32_t>(lfo_amp_mod) * ams_gain) >> Q15_SHIFT
+                        );
+                        output -= static_cast<Audio24_t>(
+                            (static_cast<int64_t>(output) * am_amt) >> Q15_SHIFT
+                        );
+                    }
 
-                // 5. FB履歴更新
-                if (is_fb_source) {
-                    fb_h1 = fb_h0;
-                    fb_h0 = output;
-                }
+                    op_buffer[op_idx][i] = output;
 
-                op_obj.osc.update(osc_mem);
+                    // 5. FB履歴更新
+                    if (is_fb_source) {
+                        fb_h1 = fb_h0;
+                        fb_h0 = output;
+                    }
 
-                // 6. LFO + ピッチベンド ピッチモジュレーション（位相オフセット追加）
-                if (total_pitch_mod != 0) {
-                    osc_mem.phase += static_cast<Phase_t>(
-                        (static_cast<int64_t>(osc_mem.delta) * total_pitch_mod) >> Q15_SHIFT
-                    );
+                    // 6. 位相更新（LFO + ピッチベンド込みの増分）
+                    op_obj.osc.update(osc_mem, step);
+                    step += dstep;
                 }
             }
 
             // キャリアのみでノートアクティブ判定（モジュレーターは無視）
             // モジュレーターが終わっていなくても、キャリアが終われば音は出ない
-            if ((output_mask & (1 << op_idx)) && !op_obj.env.isFinished(env_mem)) {
+            // 無効なオペレーターは前の音色のエンベロープを持ったままなので見ない
+            if ((output_mask & (1 << op_idx)) && op_obj.osc.isEnabled() && !op_obj.env.isFinished(env_mem)) {
                 note_is_active = true;
             }
         }
@@ -280,9 +292,14 @@ FASTRUN void Synth::generate() {
     for(uint8_t r = 0; r < reset_count; ++r) {
         noteReset(notes_to_reset[r]);
     }
+    Profiler::record(Profiler::VOICES, Profiler::now() - voices_start);
+
+    const uint32_t output_start = Profiler::now();
+
+    // マスターゲイン + リミッター (Q23のまま適用)
+    limiter_.process(mix_buffer_L, mix_buffer_R, BUFFER_SIZE);
 
     // 定数キャッシュ
-    const Gain_t current_scale = output_scale;
     const bool enable_lpf = lpf_enabled;
     const bool enable_hpf = hpf_enabled;
     const bool enable_delay = delay_enabled;
@@ -291,61 +308,86 @@ FASTRUN void Synth::generate() {
     // const int32_t pan_gain_l = AudioMath::PAN_COS_TABLE[master_pan];
     // const int32_t pan_gain_r = AudioMath::PAN_SIN_TABLE[master_pan];
 
-    // --- 最終出力段 (Filter, Delay) ---
+    // Q23 → 16bit 変換（エフェクトは16bitで処理）
     for(size_t i = 0; i < BUFFER_SIZE; ++i) {
-        Audio24_t left = mix_buffer_L[i];
-        Audio24_t right = mix_buffer_R[i];
-
-        // マスターボリューム適用 (Q23 × Q15 → Q23)
-        left = Q23_mul_Q15(left, current_scale);
-        right = Q23_mul_Q15(right, current_scale);
-
-        // Q23 → 16bit 変換（フィルター/ディレイは16bitで処理）
-        Sample16_t left_16 = Q23_to_Sample16(left);
-        Sample16_t right_16 = Q23_to_Sample16(right);
-
-        // エフェクト処理 (16bit)
-        // Low-pass filter
-        if(enable_lpf) {
-            left_16 = filter_ptr_->processLpfL(left_16);
-            right_16 = filter_ptr_->processLpfR(right_16);
+        samples_L[i] = Q23_to_Sample16(mix_buffer_L[i]);
+        samples_R[i] = Q23_to_Sample16(mix_buffer_R[i]);
+    }
+    uint32_t output_ticks = Profiler::now() - output_start;
+
+    // --- 最終出力段 (Filter, Delay, Chorus, Reverb) ---
+    // 各エフェクトの状態は独立しているので、段ごとにブロック単位で処理しても
+    // サンプルごとに直列で処理した場合と同じ結果になる（段ごとに計測できる）
+    // Low-pass filter
+    if(enable_lpf) {
+        Profiler::Scope probe(Profiler::LPF);
+        for(size_t i = 0; i < BUFFER_SIZE; ++i) {
+            samples_L[i] = filter_ptr_->processLpfL(samples_L[i]);
+            samples_R[i] = filter_ptr_->processLpfR(samples_R[i]);
         }
-        // High-pass filter
-        if(enable_hpf) {
-            left_16 = filter_ptr_->processHpfL(left_16);
-            right_16 = filter_ptr_->processHpfR(right_16);
+    }
+    // High-pass filter
+    if(enable_hpf) {
+        Profiler::Scope probe(Profiler::HPF);
+        for(size_t i = 0; i < BUFFER_SIZE; ++i) {
+            samples_L[i] = filter_ptr_->processHpfL(samples_L[i]);
+            samples_R[i] = filter_ptr_->processHpfR(samples_R[i]);
         }
-        // Delay
-        if(enable_delay) {
-            left_16 = delay_ptr_->processL(left_16);
-            right_16 = delay_ptr_->processR(right_16);
+    }
+    // Delay
+    if(enable_delay) {
+        Profiler::Scope probe(Profiler::DELAY);
+        for(size_t i = 0; i < BUFFER_SIZE; ++i) {
+            samples_L[i] = delay_ptr_->processL(samples_L[i]);
+            samples_R[i] = delay_ptr_->processR(samples_R[i]);
         }
-        // Chorus
-        if(enable_chorus) {
-            chorus_ptr_->process(left_16, right_16);
+    }
+    // Chorus
+    if(enable_chorus) {
+        Profiler::Scope probe(Profiler::CHORUS);
+        for(size_t i = 0; i < BUFFER_SIZE; ++i) {
+            chorus_ptr_->process(samples_L[i], samples_R[i]);
         }
-        // Reverb
-        if(enable_reverb) {
-            reverb_ptr_->process(left_16, right_16);
+    }
+    // Reverb
+    if(enable_reverb) {
+        Profiler::Scope probe(Profiler::REVERB);
+        for(size_t i = 0; i < BUFFER_SIZE; ++i) {
+            reverb_ptr_->process(samples_L[i], samples_R[i]);
         }
+    }
+
+    const uint32_t invert_start = Profiler::now();
 
-        // 出力バッファへ
-        samples_L[i] = left_16;
-        samples_R[i] = right_16;
+    // スコープ / スペクトラム画面を開いている間だけ最終出力を取り込む
+    if (ScopeTap::enabled()) ScopeTap::write(samples_L, samples_R, BUFFER_SIZE);
+    if (SpectrumTap::enabled()) SpectrumTap::write(samples_L, samples_R, BUFFER_SIZE);
+
+    // バランス接続用反転
+    for(size_t i = 0; i < BUFFER_SIZE; ++i) {
+        const Sample16_t left_16 = samples_L[i];
+        const Sample16_t right_16 = samples_R[i];
 
-        // バランス接続用反転
         if (left_16 == SAMPLE16_MIN) samples_LM[i] = SAMPLE16_MAX;
         else samples_LM[i] = static_cast<Sample16_t>(-left_16);
 
         if (right_16 == SAMPLE16_MIN) samples_RM[i] = SAMPLE16_MAX;
         else samples_RM[i] = static_cast<Sample16_t>(-right_16);
     }
+    output_ticks += Profiler::now() - invert_start;
+    Profiler::record(Profiler::OUTPUT, output_ticks);
 
     samples_ready_flags = true;
+    block_ticks_ = Profiler::now() - synth_start;
+    Profiler::record(Profiler::SYNTH, block_ticks_);
 }
 
 /** @brief シンセ更新 */
 FASTRUN void Synth::update() {
+    // ブロックの境目: UI / シリアルからのパラメータ変更をここで公開する
+    // （ノート別テーブルもノートオン（MIDIコールバック）より先にここで作り直される）
+    publishParams();
+
     if(order_max > 0) {
         tail_silence_count_ = 0;
         tail_total_count_ = 0;
@@ -414,8 +456,11 @@ void Synth::updateOrder(uint8_t removed) {
  * @param channel MIDIチャンネル
  */
 void Synth::noteOn(uint8_t note, uint8_t velocity, uint8_t channel) {
+    Trace::event(Trace::NOTE_ON, note, velocity);
+    ScopeTap::noteOn();
+
     // ベロシティカーブを適用
-    velocity = AudioMath::applyVelocityCurve(velocity, velocity_curve_);
+    velocity = velocity_lut_[static_cast<uint8_t>(velocity_curve_)][velocity > 127 ? 127 : velocity];
 
     // LFO KEY SYNC——ノートオン毎にディレイカウンターをリセット（key_sync_ trueなら位相も）
     lfo_.keyOn();
@@ -426,6 +471,8 @@ void Synth::noteOn(uint8_t note, uint8_t velocity, uint8_t channel) {
     if (transposed_note > 127) transposed_note = 127;
     uint8_t actual_note = static_cast<uint8_t>(transposed_note);
 
+    Operator* const ops = liveParams();
+
     // 既に同じノートを演奏している場合は弾き直し（リトリガー）
     if(midi_note_to_index[note] != -1) {
         uint8_t i = midi_note_to_index[note];
@@ -441,13 +488,13 @@ void Synth::noteOn(uint8_t note, uint8_t velocity, uint8_t channel) {
         for(uint8_t op = 0; op < MAX_OPERATORS; ++op) {
             auto& osc_mem = ope_states[op].osc_mems[i];
             auto& env_mem = ope_states[op].env_mems[i];
-            operators[op].osc.setFrequency(osc_mem, actual_note);
+            ops[op].osc.setFrequency(osc_mem, actual_note);
             // Output Level + Velocity + Keyboard Level Scaling をエンベロープのoutlevelとして設定
-            uint8_t op_level = operators[op].osc.getLevel();
-            operators[op].env.setOutlevel(op_level, velocity, actual_note, operators[op].env.getVelocitySens());
-            operators[op].env.calcNoteTargetLevels(env_mem); // ノートごとのターゲットレベル計算
-            operators[op].env.applyRateScaling(env_mem, actual_note); // Rate Scaling適用
-            operators[op].env.reset(env_mem); // エンベロープをAttackから再開
+            uint8_t op_level = ops[op].osc.getLevel();
+            ops[op].env.setOutlevel(op_level, velocity, actual_note, ops[op].env.getVelocitySens());
+            ops[op].env.calcNoteTargetLevels(env_mem); // ノートごとのターゲットレベル計算
+            ops[op].env.applyRateScaling(env_mem, actual_note); // Rate Scaling適用
+            ops[op].env.reset(env_mem); // エンベロープをAttackから再開
         }
         return;
     }
@@ -483,11 +530,13 @@ void Synth::noteOn(uint8_t note, uint8_t velocity, uint8_t channel) {
 
         // リリース中のノートがあればそれを、なければ最古(order==1)をリセット
         if (releasing_oldest_index >= 0) {
+            Trace::event(Trace::VOICE_STEAL, notes[releasing_oldest_index].note, 1);
             noteReset(releasing_oldest_index);
         } else {
             // order == 1（最古）のノートを探す
             for (uint8_t i = 0; i < MAX_NOTES; ++i) {
                 if (notes[i].order == 1) {
+                    Trace::event(Trace::VOICE_STEAL, notes[i].note, 0);
                     noteReset(i);
                     break;
                 }
@@ -509,16 +558,16 @@ void Synth::noteOn(uint8_t note, uint8_t velocity, uint8_t channel) {
             for(uint8_t op = 0; op < MAX_OPERATORS; ++op) {
                 auto& osc_mem = ope_states[op].osc_mems[i];
                 auto& env_mem = ope_states[op].env_mems[i];
-                operators[op].osc.setFrequency(osc_mem, actual_note);
+                ops[op].osc.setFrequency(osc_mem, actual_note);
                 if (osc_key_sync_) {
-                    operators[op].osc.setPhase(osc_mem, 0);
+                    ops[op].osc.setPhase(osc_mem, 0);
                 }
                 // Output Level + Velocity + Keyboard Level Scaling をエンベロープのoutlevelとして設定
-                uint8_t op_level = operators[op].osc.getLevel();
-                operators[op].env.setOutlevel(op_level, velocity, actual_note, operators[op].env.getVelocitySens());
-                operators[op].env.calcNoteTargetLevels(env_mem); // ノートごとのターゲットレベル計算
-                operators[op].env.applyRateScaling(env_mem, actual_note); // Rate Scaling適用
-                operators[op].env.reset(env_mem); // 初期化IdleからAttackへ
+                uint8_t op_level = ops[op].osc.getLevel();
+                ops[op].env.setOutlevel(op_level, velocity, actual_note, ops[op].env.getVelocitySens());
+                ops[op].env.calcNoteTargetLevels(env_mem); // ノートごとのターゲットレベル計算
+                ops[op].env.applyRateScaling(env_mem, actual_note); // Rate Scaling適用
+                ops[op].env.reset(env_mem); // 初期化IdleからAttackへ
             }
             return;
         }
@@ -532,12 +581,14 @@ void Synth::noteOn(uint8_t note, uint8_t velocity, uint8_t channel) {
  * @param channel MIDIチャンネル
  */
 void Synth::noteOff(uint8_t note, uint8_t channel) {
+    Trace::event(Trace::NOTE_OFF, note);
     if (midi_note_to_index[note] != -1) {
         uint8_t i = midi_note_to_index[note];
         // スロットが有効範囲内かつ、実際にそのノートが割り当てられていることを検証
         if (i < MAX_NOTES && notes[i].note == note && notes[i].order > 0) {
+            Operator* const ops = liveParams();
             for(uint8_t op = 0; op < MAX_OPERATORS; ++op) {
-                auto& oper = operators[op];
+                auto& oper = ops[op];
                 auto& env_mem = ope_states[op].env_mems[i];
                 oper.env.release(env_mem);
             }
@@ -552,15 +603,33 @@ void Synth::noteOff(uint8_t note, uint8_t channel) {
  * CC#123 (All Notes Off) 受信時に使用。
  */
 void Synth::allNotesOff() {
+    Operator* const ops = liveParams();
     for (uint8_t i = 0; i < MAX_NOTES; ++i) {
         if (notes[i].order > 0) {
             for (uint8_t op = 0; op < MAX_OPERATORS; ++op) {
-                operators[op].env.release(ope_states[op].env_mems[i]);
+                ops[op].env.release(ope_states[op].env_mems[i]);
             }
         }
     }
 }
 
+/**
+ * @brief 最も古いノートを即座に解放します
+ *
+ * アンダーラン時の負荷軽減用。リリースを待たずに止めるのでクリックが出る。
+ *
+ * @return 解放したノートがあれば true
+ */
+bool Synth::shedOldestNote() {
+    for(uint8_t i = 0; i < MAX_NOTES; ++i) {
+        if(notes[i].order == 1) {
+            noteReset(i);
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief ノートをリセット
  *
@@ -580,8 +649,9 @@ void Synth::noteReset(uint8_t index) {
     it.note = 255;
     it.velocity = 0;
     it.channel = 0;
+    Operator* const ops = liveParams();
     for(uint8_t op = 0; op < MAX_OPERATORS; ++op) {
-        auto& oper = operators[op];
+        auto& oper = ops[op];
         auto& osc_mem = ope_states[op].osc_mems[index];
         auto& env_mem = ope_states[op].env_mems[index];
         oper.osc.reset(osc_mem);
@@ -595,7 +665,19 @@ void Synth::noteReset(uint8_t index) {
     updateOrder(removed_order);
 }
 
+/**
+ * @brief 全ノートとエフェクト・リミッターの状態を初期化
+ *
+ * MIDI Player の停止やプリセット切り替え、パススルー切り替えから呼ばれるので、
+ * 再生で同じ位置に入るようキャプチャに記録する。
+ */
 void Synth::reset() {
+    Capture::synthReset();
+    resetState();
+}
+
+// ランダムプリセットの内部からはこちら（RANDOM_PRESET の再生が自分で呼ぶので記録しない）
+void Synth::resetState() {
     for(uint8_t i = 0; i < MAX_NOTES; ++i) {
         noteReset(i);
     }
@@ -606,6 +688,9 @@ void Synth::reset() {
     if (filter_ptr_) filter_ptr_->reset();
     if (chorus_ptr_) chorus_ptr_->reset();
     if (reverb_ptr_) reverb_ptr_->reset();
+    limiter_.reset();
+    // generate() と同じ LFO + ピッチベンドの合計から次のブロックのランプを始める
+    prev_pitch_mod_ = lfo_.getPitchMod() + pitch_bend_mod_;
 }
 
 /**
@@ -634,14 +719,19 @@ void Synth::setPitchBend(int16_t value) {
 
 void Synth::setAlgorithm(uint8_t algo_id) {
     current_algo = &Algorithms::get(algo_id);
+    voice_edited_ = true;
 }
 
 void Synth::setFeedback(uint8_t amount) {
     if (amount > 7) amount = 7;
     feedback_amount = amount;
+    voice_edited_ = true;
 }
 
 void Synth::loadPreset(uint8_t preset_id) {
+    Trace::event(Trace::PRESET_LOAD, preset_id);
+    Capture::preset(preset_id);
+
     // プリセットを取得
     const SynthPreset& preset = DefaultPresets::get(preset_id);
 
@@ -652,44 +742,46 @@ void Synth::loadPreset(uint8_t preset_id) {
     setAlgorithm(preset.algorithm_id);
     setFeedback(preset.master.feedback);
 
-    // 各オペレーターの設定を適用
+    // 各オペレーターの設定をステージングの面に書く
+    Operator* const ops = stagingParams();
+    params_pending_ = true;
     active_carriers = 0; // メンバ変数をリセット
     for (uint8_t i = 0; i < MAX_OPERATORS; ++i) {
         const OperatorPreset& op_preset = preset.operators[i];
 
         if (op_preset.enabled) {
             // オシレーター設定
-            operators[i].osc.setWavetable(op_preset.wavetable_id);
-            operators[i].osc.setLevelNonLinear(op_preset.level);
-            operators[i].osc.setCoarse(op_preset.coarse);
-            operators[i].osc.setFine(op_preset.fine);
-            operators[i].osc.setDetune(op_preset.detune);
-            operators[i].osc.setFixed(op_preset.is_fixed);
-            operators[i].osc.enable();
+            ops[i].osc.setWavetable(op_preset.wavetable_id);
+            ops[i].osc.setLevelNonLinear(op_preset.level);
+            ops[i].osc.setCoarse(op_preset.coarse);
+            ops[i].osc.setFine(op_preset.fine);
+            ops[i].osc.setDetune(op_preset.detune);
+            ops[i].osc.setFixed(op_preset.is_fixed);
+            ops[i].osc.enable();
 
             // エンベロープ設定 (Rate/Level)
-            operators[i].env.setRate1(op_preset.rate1);
-            operators[i].env.setRate2(op_preset.rate2);
-            operators[i].env.setRate3(op_preset.rate3);
-            operators[i].env.setRate4(op_preset.rate4);
-            operators[i].env.setLevel1(op_preset.level1);
-            operators[i].env.setLevel2(op_preset.level2);
-            operators[i].env.setLevel3(op_preset.level3);
-            operators[i].env.setLevel4(op_preset.level4);
-            operators[i].env.setRateScaling(op_preset.rate_scaling);
+            ops[i].env.setRate1(op_preset.rate1);
+            ops[i].env.setRate2(op_preset.rate2);
+            ops[i].env.setRate3(op_preset.rate3);
+            ops[i].env.setRate4(op_preset.rate4);
+            ops[i].env.setLevel1(op_preset.level1);
+            ops[i].env.setLevel2(op_preset.level2);
+            ops[i].env.setLevel3(op_preset.level3);
+            ops[i].env.setLevel4(op_preset.level4);
+            ops[i].env.setRateScaling(op_preset.rate_scaling);
 
             // Keyboard Level Scaling設定
-            operators[i].env.setBreakPoint(op_preset.kbd_break_point);
-            operators[i].env.setLeftDepth(op_preset.kbd_left_depth);
-            operators[i].env.setRightDepth(op_preset.kbd_right_depth);
-            operators[i].env.setLeftCurve(op_preset.kbd_left_curve);
-            operators[i].env.setRightCurve(op_preset.kbd_right_curve);
+            ops[i].env.setBreakPoint(op_preset.kbd_break_point);
+            ops[i].env.setLeftDepth(op_preset.kbd_left_depth);
+            ops[i].env.setRightDepth(op_preset.kbd_right_depth);
+            ops[i].env.setLeftCurve(op_preset.kbd_left_curve);
+            ops[i].env.setRightCurve(op_preset.kbd_right_curve);
 
             // ベロシティ感度設定
-            operators[i].env.setVelocitySens(op_preset.velocity_sens);
+            ops[i].env.setVelocitySens(op_preset.velocity_sens);
 
             // AMS感度設定 (0-3)
-            op_ams_gain_[i] = Lfo::AMS_TAB[op_preset.amp_mod_sens & 3];
+            ops[i].ams_gain = Lfo::AMS_TAB[op_preset.amp_mod_sens & 3];
 
             // キャリアの数をカウント
             if (current_algo && (current_algo->output_mask & (1 << i))) {
@@ -697,8 +789,8 @@ void Synth::loadPreset(uint8_t preset_id) {
             }
         } else {
             // オペレーター無効化
-            operators[i].osc.disable();
-            op_ams_gain_[i] = 0;
+            ops[i].osc.disable();
+            ops[i].ams_gain = 0;
         }
     }
 
@@ -740,6 +832,12 @@ void Synth::loadPreset(uint8_t preset_id) {
     reverb_ptr_->setMix(EffectPreset::toQ15(fx.reverb_mix));
     reverb_enabled = fx.reverb_enabled;
 
+    // 有効なエフェクトだけにバッファを配分（配置が変わったものはクリアされる）
+    planEffectMemory();
+
+    // オペレーター設定をまとめて公開（ノートオン用テーブルもここで構築）
+    publishParams();
+
     // LFO設定を適用
     const LfoPreset& lfo_p = preset.lfo;
     lfo_.setWave(lfo_p.wave);
@@ -758,8 +856,13 @@ void Synth::loadPreset(uint8_t preset_id) {
     master_volume = EffectPreset::toQ15(std::clamp<uint8_t>(master_p.level, 0, 99));
     velocity_curve_ = static_cast<VelocityCurve>(master_p.velocity_curve < static_cast<uint8_t>(VelocityCurve::COUNT) ? master_p.velocity_curve : 0);
 
-    // マスタースケールを調整
-    output_scale = static_cast<Gain_t>((static_cast<int32_t>(master_volume) * polyphony_divisor) >> Q15_SHIFT);
+    // マスターゲインを調整
+    limiter_.setMasterLevel(master_volume);
+    limiter_.reset();
+
+    // プリセット ID だけでこの音色を作り直せる
+    random_seed_ = 0;
+    voice_edited_ = false;
 }
 
 const char* Synth::getCurrentPresetName() const {
@@ -783,36 +886,44 @@ uint8_t Synth::getCurrentAlgorithmId() const {
  *
  * アルゴリズム、オペレーター設定、エンベロープ、エフェクト、LFOを
  * ランダムに設定する。音楽的に意味のある結果を得やすいように
- * パラメータ範囲を調整している。
+ * パラメータ範囲を調整している。同じ seed なら同じプリセットになる。
+ *
+ * @param seed 乱数の種
  */
-void Synth::randomizePreset() {
+void Synth::randomizePreset(uint32_t seed) {
+    rng_state_ = seed ? seed : 1;
+    random_seed_ = rng_state_;
+    Capture::randomPreset(seed);
+
     // ノートをリセット
-    reset();
+    resetState();
 
     // === アルゴリズム ===
-    uint8_t algo_id = random(0, 32);
+    uint8_t algo_id = randomRange(0, 32);
     setAlgorithm(algo_id);
-    setFeedback(random(0, 8));  // 0-7
+    setFeedback(randomRange(0, 8));  // 0-7
 
-    // === オペレーター設定 ===
+    // === オペレーター設定（ステージングの面に書く） ===
+    Operator* const ops = stagingParams();
+    params_pending_ = true;
     active_carriers = 0;
     for (uint8_t i = 0; i < MAX_OPERATORS; ++i) {
-        auto& osc = operators[i].osc;
-        auto& env = operators[i].env;
+        auto& osc = ops[i].osc;
+        auto& env = ops[i].env;
 
         // 全オペレーターを有効化
         osc.enable();
 
         // 波形: ランダム (0-3: sine, triangle, saw, square)
-        osc.setWavetable(random(0, 4));
+        osc.setWavetable(randomRange(0, 4));
 
         // レベル: キャリアは高め、モジュレーターは幅広く
         bool is_carrier = current_algo && (current_algo->output_mask & (1 << i));
         if (is_carrier) {
-            osc.setLevelNonLinear(random(85, 100)); // 85-99
+            osc.setLevelNonLinear(randomRange(85, 100)); // 85-99
             active_carriers++;
         } else {
-            osc.setLevelNonLinear(random(40, 100)); // 40-99
+            osc.setLevelNonLinear(randomRange(40, 100)); // 40-99
         }
 
         // コース: 倍音関係を保つ整数比を優先
@@ -820,25 +931,25 @@ void Synth::randomizePreset() {
         if (is_carrier) {
             // キャリア: 1x を基本に、たまに 2x
             float carrier_coarse[] = {1.0f, 1.0f, 1.0f, 2.0f};
-            osc.setCoarse(carrier_coarse[random(0, 4)]);
+            osc.setCoarse(carrier_coarse[randomRange(0, 4)]);
         } else {
             // モジュレーター: 倍音関係の整数比
             float mod_coarse[] = {1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 10.0f, 12.0f, 14.0f};
-            osc.setCoarse(mod_coarse[random(0, 14)]);
+            osc.setCoarse(mod_coarse[randomRange(0, 14)]);
         }
 
         // ファイン: 基本は0（倍音を保つ）、20%の確率で軽い味付け
-        if (random(0, 5) == 0) {
-            osc.setFine(static_cast<float>(random(0, 15))); // 0-14 の控えめな範囲
+        if (randomRange(0, 5) == 0) {
+            osc.setFine(static_cast<float>(randomRange(0, 15))); // 0-14 の控えめな範囲
         } else {
             osc.setFine(0.0f);
         }
 
         // デチューン: 控えめ (-7～+7 基本、たまに広め)
-        if (random(0, 4) == 0) {
-            osc.setDetune(random(-20, 21));  // 25%の確率で広め
+        if (randomRange(0, 4) == 0) {
+            osc.setDetune(randomRange(-20, 21));  // 25%の確率で広め
         } else {
-            osc.setDetune(random(-7, 8));    // 75%は従来のDX7互換範囲
+            osc.setDetune(randomRange(-7, 8));    // 75%は従来のDX7互換範囲
         }
 
         // FIXEDモード: 基本的にRATIO
@@ -847,38 +958,38 @@ void Synth::randomizePreset() {
         // === エンベロープ ===
         if (is_carrier) {
             // キャリア: 音量を維持するためサステイン高め
-            env.setRate1(random(80, 100));       // アタック: 速め
-            env.setRate2(random(30, 80));         // ディケイ1
-            env.setRate3(random(10, 60));         // ディケイ2: ゆっくりめ
-            env.setRate4(random(30, 80));         // リリース
+            env.setRate1(randomRange(80, 100));       // アタック: 速め
+            env.setRate2(randomRange(30, 80));         // ディケイ1
+            env.setRate3(randomRange(10, 60));         // ディケイ2: ゆっくりめ
+            env.setRate4(randomRange(30, 80));         // リリース
 
             env.setLevel1(99);                   // アタックは常に最大
-            env.setLevel2(random(85, 100));       // ディケイ1到達: 高め
-            env.setLevel3(random(70, 99));        // サステイン: 必ず音が残る
+            env.setLevel2(randomRange(85, 100));       // ディケイ1到達: 高め
+            env.setLevel3(randomRange(70, 99));        // サステイン: 必ず音が残る
             env.setLevel4(0);
         } else {
             // モジュレーター: 音色変化のため幅広い範囲
-            env.setRate1(random(60, 100));
-            env.setRate2(random(20, 100));
-            env.setRate3(random(10, 80));
-            env.setRate4(random(20, 99));
-
-            env.setLevel1(random(80, 100));
-            env.setLevel2(random(50, 100));
-            env.setLevel3(random(0, 90));        // 減衰OK（音色が変わるだけ）
+            env.setRate1(randomRange(60, 100));
+            env.setRate2(randomRange(20, 100));
+            env.setRate3(randomRange(10, 80));
+            env.setRate4(randomRange(20, 99));
+
+            env.setLevel1(randomRange(80, 100));
+            env.setLevel2(randomRange(50, 100));
+            env.setLevel3(randomRange(0, 90));        // 減衰OK（音色が変わるだけ）
             env.setLevel4(0);
         }
 
         // Rate Scaling: 0-3 (税めに)
-        env.setRateScaling(random(0, 4));
+        env.setRateScaling(randomRange(0, 4));
 
         // KLS: ランダムで開くか無効か
-        env.setBreakPoint(random(30, 50));
-        if (random(0, 3) == 0) { // 1/3の確率でKLS有効
-            env.setLeftDepth(random(0, 50));
-            env.setRightDepth(random(0, 50));
-            env.setLeftCurve(random(0, 4));
-            env.setRightCurve(random(0, 4));
+        env.setBreakPoint(randomRange(30, 50));
+        if (randomRange(0, 3) == 0) { // 1/3の確率でKLS有効
+            env.setLeftDepth(randomRange(0, 50));
+            env.setRightDepth(randomRange(0, 50));
+            env.setLeftCurve(randomRange(0, 4));
+            env.setRightCurve(randomRange(0, 4));
         } else {
             env.setLeftDepth(0);
             env.setRightDepth(0);
@@ -887,65 +998,71 @@ void Synth::randomizePreset() {
         }
 
         // ベロシティ感度: 3-7 (不感になりすぎないように)
-        env.setVelocitySens(random(3, 8));
+        env.setVelocitySens(randomRange(3, 8));
 
         // AMS: 0-3
-        op_ams_gain_[i] = Lfo::AMS_TAB[random(0, 4)];
+        ops[i].ams_gain = Lfo::AMS_TAB[randomRange(0, 4)];
     }
 
     // === エフェクト ===
     // ディレイ: 50%の確率で有効
-    delay_enabled = (random(0, 2) == 0);
+    delay_enabled = (randomRange(0, 2) == 0);
     if (delay_enabled) {
         delay_ptr_->setDelay(
-            random(30, 250),                            // time: 30-250ms
-            static_cast<Gain_t>(random(3000, 16384)),   // level: ~10-50%
-            static_cast<Gain_t>(random(6554, 22938))    // feedback: 20-70%
+            randomRange(30, 250),                            // time: 30-250ms
+            static_cast<Gain_t>(randomRange(3000, 16384)),   // level: ~10-50%
+            static_cast<Gain_t>(randomRange(6554, 22938))    // feedback: 20-70%
         );
     }
 
     // LPF: 40%の確率で有効
-    lpf_enabled = (random(0, 5) < 2);
+    lpf_enabled = (randomRange(0, 5) < 2);
     if (lpf_enabled) {
-        float cutoff = 500.0f + random(0, 15000);  // 500-15500 Hz
-        filter_ptr_->setLowPass(cutoff, 0.7f + random(0, 30) * 0.1f); // Q: 0.7-3.7
+        float cutoff = 500.0f + randomRange(0, 15000);  // 500-15500 Hz
+        filter_ptr_->setLowPass(cutoff, 0.7f + randomRange(0, 30) * 0.1f); // Q: 0.7-3.7
         filter_ptr_->setLpfMix(Q15_MAX);
     }
 
     // HPF: 20%の確率で有効
-    hpf_enabled = (random(0, 5) == 0);
+    hpf_enabled = (randomRange(0, 5) == 0);
     if (hpf_enabled) {
-        float cutoff = 60.0f + random(0, 500);  // 60-560 Hz
+        float cutoff = 60.0f + randomRange(0, 500);  // 60-560 Hz
         filter_ptr_->setHighPass(cutoff, 0.707f);
         filter_ptr_->setHpfMix(Q15_MAX);
     }
 
     // コーラス: 30%の確率で有効
-    chorus_enabled = (random(0, 10) < 3);
+    chorus_enabled = (randomRange(0, 10) < 3);
     if (chorus_enabled) {
-        chorus_ptr_->setRate(random(10, 60));
-        chorus_ptr_->setDepth(random(20, 80));
-        chorus_ptr_->setMix(static_cast<Gain_t>(random(6554, 19661))); // 20-60%
+        chorus_ptr_->setRate(randomRange(10, 60));
+        chorus_ptr_->setDepth(randomRange(20, 80));
+        chorus_ptr_->setMix(static_cast<Gain_t>(randomRange(6554, 19661))); // 20-60%
     }
 
     // リバーブ: 40%の確率で有効
-    reverb_enabled = (random(0, 5) < 2);
+    reverb_enabled = (randomRange(0, 5) < 2);
     if (reverb_enabled) {
-        reverb_ptr_->setRoomSize(random(20, 80));
-        reverb_ptr_->setDamping(random(20, 80));
-        reverb_ptr_->setMix(static_cast<Gain_t>(random(3277, 13107))); // 10-40%
+        reverb_ptr_->setRoomSize(randomRange(20, 80));
+        reverb_ptr_->setDamping(randomRange(20, 80));
+        reverb_ptr_->setMix(static_cast<Gain_t>(randomRange(3277, 13107))); // 10-40%
     }
 
+    // 有効なエフェクトだけにバッファを配分
+    planEffectMemory();
+
+    // オペレーター設定をまとめて公開（ノートオン用テーブルもここで構築）
+    publishParams();
+
     // === LFO ===
-    lfo_.setWave(random(0, 6));        // 0-5
-    lfo_.setSpeed(random(10, 70));     // 10-69
-    lfo_.setDelay(random(0, 50));      // 0-49
+    lfo_.setWave(randomRange(0, 6));        // 0-5
+    lfo_.setSpeed(randomRange(10, 70));     // 10-69
+    lfo_.setDelay(randomRange(0, 50));      // 0-49
     // PM/AMは控えめに（ピッチの揺れを抑える）
-    lfo_.setPmDepth(random(0, 15));     // ビブラート控えめ
-    lfo_.setAmDepth(random(0, 20));
-    lfo_.setPitchModSens(random(0, 4)); // 0-3
-    lfo_.setKeySync(random(0, 2) == 0);
-    osc_key_sync_ = (random(0, 3) != 0); // 2/3でOSC KEY SYNC ON
+    lfo_.setPmDepth(randomRange(0, 15));     // ビブラート控えめ
+    lfo_.setAmDepth(randomRange(0, 20));
+    lfo_.setPitchModSens(randomRange(0, 4)); // 0-3
+    lfo_.setKeySync(randomRange(0, 2) == 0);
+    osc_key_sync_ = (randomRange(0, 3) != 0); // 2/3でOSC KEY SYNC ON
     lfo_.reset();
 
     // === マスター ===
@@ -953,9 +1070,29 @@ void Synth::randomizePreset() {
     velocity_curve_ = VelocityCurve::Linear;
     master_volume = static_cast<Gain_t>(Q15_MAX * 0.707); // -3dB
 
-    // マスタースケールを調整
-    output_scale = static_cast<Gain_t>((static_cast<int32_t>(master_volume) * polyphony_divisor) >> Q15_SHIFT);
+    // マスターゲインを調整
+    limiter_.setMasterLevel(master_volume);
+    limiter_.reset();
 
     // プリセット名は"RANDOM"を示すため、IDは特殊値に
     current_preset_id = 255;
+    voice_edited_ = false;
+}
+
+/** @brief 乱数の種を選んでランダムプリセットを生成 */
+void Synth::randomizePreset() {
+    randomizePreset(static_cast<uint32_t>(random(1, 0x7FFFFFFF)));
+}
+
+/**
+ * @brief [lo, hi) の乱数 (xorshift32)
+ *
+ * Arduino の random() は実機とホストで系列が違うため、キャプチャの再生で
+ * 同じプリセットになるようランダムプリセットはこちらを使う。
+ */
+long Synth::randomRange(long lo, long hi) {
+    rng_state_ ^= rng_state_ << 13;
+    rng_state_ ^= rng_state_ >> 17;
+    rng_state_ ^= rng_state_ << 5;
+    return lo + static_cast<long>(rng_state_ % static_cast<uint32_t>(hi - lo));
 }
@@ -0,0 +1,168 @@
+#include "modules/synth.hpp"
+
+/**
+ * @brief スナップショットに含めるフィールド列（保存・復元・サイズ計算で共通）
+ *
+ * 含めないもの:
+ * - velocity_lut_ : init() で作る定数表
+ * - left / right  : generate() 内の作業領域
+ * - block_count_ / block_start_ / block_ticks_ : キャプチャの時間軸と計測値なので巻き戻さない
+ * - 共有エフェクト・アリーナへのポインタ
+ * - オペレーターパラメータのステージングの面 : ライブの面だけを保存し、復元後に写す
+ *
+ * @param fx_buffers nullptr 以外なら、この配置で使われているエフェクトバッファも含める
+ */
+template <typename IO>
+void Synth::snapshotFields(IO& io, const EffectArena::Layout* fx_buffers) {
+    // ノートと発音状態
+    io.field(notes);
+    io.field(midi_note_to_index);
+    io.field(order_max);
+    io.field(last_index);
+    io.field(tail_active_);
+    io.field(tail_silence_count_);
+    io.field(tail_total_count_);
+    io.field(ope_states);
+    io.field(fb_history);
+
+    // 音色パラメータ
+    io.field(params_[params_seq_.load(std::memory_order_relaxed) & 1]);
+    io.field(current_algo);
+    io.field(feedback_amount);
+    io.field(current_preset_id);
+    io.field(random_seed_);
+    io.field(voice_edited_);
+    io.field(active_carriers);
+    io.field(lfo_);
+    io.field(osc_key_sync_);
+
+    // マスター
+    io.field(master_volume);
+    io.field(limiter_);
+    io.field(transpose);
+    io.field(velocity_curve_);
+    io.field(pitch_bend_raw_);
+    io.field(pitch_bend_mod_);
+    io.field(pitch_bend_range_);
+    io.field(pitch_mod_ramp_);
+    io.field(prev_pitch_mod_);
+    io.field(env_rate_shift_);
+    io.field(rng_state_);
+
+    // エフェクト（バッファ位置はアリーナの配置と一致している前提）
+    io.field(delay_enabled);
+    io.field(lpf_enabled);
+    io.field(hpf_enabled);
+    io.field(chorus_enabled);
+    io.field(reverb_enabled);
+    io.field(*delay_ptr_);
+    io.field(*filter_ptr_);
+    io.field(*chorus_ptr_);
+    io.field(*reverb_ptr_);
+
+    if (fx_buffers) {
+        Sample16_t* mem = EffectArena::memory();
+        const EffectArena::Region regions[] = {fx_buffers->reverb, fx_buffers->chorus, fx_buffers->delay};
+        for (const EffectArena::Region& r : regions) {
+            if (r.length) io.bytes(mem + r.offset, r.length * sizeof(Sample16_t));
+        }
+    }
+}
+
+/**
+ * @brief 保存したビルドと同じかを見分ける値
+ *
+ * スナップショットは型のメモリイメージと静的テーブルへのポインタを含むので、
+ * 型のサイズかテーブルの位置が変わったビルドでは復元できない。
+ */
+uint32_t Synth::snapshotBuildId() {
+    const uintptr_t values[] = {
+        SNAPSHOT_VERSION,
+        sizeof(Synth), sizeof(Oscillator), sizeof(Envelope), sizeof(Lfo), sizeof(Limiter),
+        sizeof(Delay), sizeof(Filter), sizeof(Chorus), sizeof(Reverb),
+        EffectArena::capacity(),
+        reinterpret_cast<uintptr_t>(Wavetable::sine),
+        reinterpret_cast<uintptr_t>(&Algorithms::get(0)),
+        reinterpret_cast<uintptr_t>(EffectArena::memory()),
+    };
+
+    // FNV-1a (32bit)
+    uint32_t h = 2166136261u;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(values);
+    for (size_t i = 0; i < sizeof(values); ++i) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+/**
+ * @brief スナップショットのバイト数（ヘッダ込み）
+ *
+ * @param with_fx_buffers 現在使っているエフェクトバッファも含める
+ */
+size_t Synth::snapshotSize(bool with_fx_buffers) const {
+    SnapshotSizer sizer;
+    const EffectArena::Layout& layout = arena_ptr_->getLayout();
+    const_cast<Synth*>(this)->snapshotFields(sizer, with_fx_buffers ? &layout : nullptr);
+    return sizeof(SnapshotHeader) + sizer.size;
+}
+
+/**
+ * @brief 現在のエンジン状態を保存
+ *
+ * @param dst 保存先
+ * @param capacity dst のバイト数
+ * @param with_fx_buffers エフェクトバッファ（残響テール）も含める。最大でアリーナ全体 (約107KB) 増える
+ * @param written 書いたバイト数
+ */
+SnapshotStatus Synth::saveSnapshot(uint8_t* dst, size_t capacity, bool with_fx_buffers, size_t& written) const {
+    written = 0;
+    const size_t size = snapshotSize(with_fx_buffers);
+    if (capacity < size) return SnapshotStatus::NO_SPACE;
+
+    const EffectArena::Layout& layout = arena_ptr_->getLayout();
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, "CRSN", 4);
+    header.version = SNAPSHOT_VERSION;
+    header.flags = with_fx_buffers ? SNAPSHOT_FX_BUFFERS : 0;
+    header.size = static_cast<uint32_t>(size);
+    header.build_id = snapshotBuildId();
+    header.layout = layout;
+    std::memcpy(dst, &header, sizeof(header));
+
+    SnapshotWriter writer(dst + sizeof(header));
+    const_cast<Synth*>(this)->snapshotFields(writer, with_fx_buffers ? &layout : nullptr);
+    written = size;
+    return SnapshotStatus::OK;
+}
+
+/**
+ * @brief 保存した状態に戻す
+ *
+ * アリーナを保存時の配置に戻してから各フィールドを書き戻す。
+ * エフェクトバッファを含まないスナップショットでは、配置が変わらなければ
+ * 今の残響テールがそのまま続き、変わればそのエフェクトのバッファは無音から始まる。
+ * 失敗したときは何も変更しない。
+ */
+SnapshotStatus Synth::restoreSnapshot(const uint8_t* src, size_t len) {
+    if (len < sizeof(SnapshotHeader)) return SnapshotStatus::TRUNCATED;
+
+    SnapshotHeader header;
+    std::memcpy(&header, src, sizeof(header));
+    if (std::memcmp(header.magic, "CRSN", 4) != 0) return SnapshotStatus::BAD_MAGIC;
+    if (header.version != SNAPSHOT_VERSION) return SnapshotStatus::BAD_VERSION;
+    if (header.build_id != snapshotBuildId()) return SnapshotStatus::BUILD_MISMATCH;
+
+    const bool with_fx_buffers = (header.flags & SNAPSHOT_FX_BUFFERS) != 0;
+    SnapshotSizer sizer;
+    snapshotFields(sizer, with_fx_buffers ? &header.layout : nullptr);
+    if (header.size != sizeof(header) + sizer.size || len < header.size) return SnapshotStatus::TRUNCATED;
+
+    arena_ptr_->restore(header.layout);
+
+    SnapshotReader reader(src + sizeof(header));
+    snapshotFields(reader, with_fx_buffers ? &header.layout : nullptr);
+
+    // 未公開の編集は捨て、ステージングを復元したライブの面で揃える
+    std::memcpy(stagingParams(), liveParams(), sizeof(params_[0]));
+    params_pending_ = false;
+    return SnapshotStatus::OK;
+}
@@ -0,0 +1,357 @@
+#include "tools/bench.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "modules/synth.hpp"
+#include "modules/oscillator.hpp"
+#include "modules/envelope.hpp"
+#include "modules/lfo.hpp"
+#include "utils/placement.hpp"
+
+#if defined(__IMXRT1062__)
+// DWT サイクルカウンタ (Teensy 4 のスタートアップで有効化済み)
+static inline uint32_t benchNow() {
+    return ARM_DWT_CYCCNT;
+}
+#else
+#include <chrono>
+
+static inline uint32_t benchNow() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+#endif
+
+namespace {
+
+uint32_t samples[Bench::MAX_SAMPLES];
+uint8_t invalid_cases = 0;
+
+// 計測前の状態（終了時に戻す）と WARM の開始状態
+PLACE_BULK uint8_t saved_state[SYNTH_SNAPSHOT_MAX_BYTES];
+PLACE_BULK uint8_t warm_state[SYNTH_SNAPSHOT_MAX_BYTES];
+
+// 効果測定用の入力信号 (ノコギリ波 + 擬似乱数)
+Sample16_t input_L[BUFFER_SIZE];
+Sample16_t input_R[BUFFER_SIZE];
+
+void fillInput() {
+    uint32_t seed = 22222;
+    for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const int32_t saw = static_cast<int32_t>(i * 512) - 32768;
+        input_L[i] = static_cast<Sample16_t>((saw >> 1) + (static_cast<int32_t>(seed >> 16) >> 2) - 8192);
+        input_R[i] = static_cast<Sample16_t>(-input_L[i] / 2);
+    }
+}
+
+bool groupMatches(const char* group, const char* name) {
+    return group == nullptr || group[0] == '\0' || std::strcmp(group, name) == 0;
+}
+
+void printHeader(const Synth& synth) {
+    Serial.printf("BENCH: unit=%s block=%u preset=%u %s\n",
+        Bench::unit(), (unsigned)BUFFER_SIZE,
+        (unsigned)synth.getCurrentPresetId(), synth.getCurrentPresetName());
+    Serial.printf("  %-14s %5s %9s %9s %9s %8s %8s %8s\n",
+        "CASE", "RUNS", "MIN/BLK", "MED/BLK", "MAX/BLK", "MIN/SMP", "MED/SMP", "MAX/SMP");
+}
+
+// samples[offset..offset+n) を集計して1行出力（並べ替えるので集計後の順序は保たれない）
+void printRow(const char* name, uint16_t offset, uint16_t n) {
+    if (n == 0) return;
+    uint32_t* data = samples + offset;
+    std::sort(data, data + n);
+    const uint32_t lo = data[0];
+    const uint32_t med = data[n / 2];
+    const uint32_t hi = data[n - 1];
+    Serial.printf("  %-14s %5u %9lu %9lu %9lu %8.1f %8.1f %8.1f\n",
+        name, (unsigned)n,
+        (unsigned long)lo, (unsigned long)med, (unsigned long)hi,
+        (double)lo / BUFFER_SIZE, (double)med / BUFFER_SIZE, (double)hi / BUFFER_SIZE);
+}
+
+// 計測対象が何も出力しなかったケース（数値に意味がないので行を出さない）
+void printInvalid(const char* name) {
+    Serial.printf("  %-14s ERR: no output\n", name);
+    ++invalid_cases;
+}
+
+// body を WARMUP 回空回ししてから runs 回計測し samples[offset..] に入れる
+template <typename Body>
+void measure(uint16_t offset, uint16_t runs, Body&& body) {
+    for (uint16_t i = 0; i < Bench::WARMUP; ++i) body();
+    for (uint16_t i = 0; i < runs; ++i) {
+        const uint32_t t0 = benchNow();
+        body();
+        samples[offset + i] = benchNow() - t0;
+    }
+}
+
+// 最適化で計算が消えないよう結果を流し込む
+volatile int32_t sink;
+
+// =============================================
+// ケース
+// =============================================
+
+void benchOsc() {
+    static const char* const NAMES[] = {"OSC SINE", "OSC TRI", "OSC SAW", "OSC SQUARE"};
+
+    for (uint8_t w = 0; w < 4; ++w) {
+        Oscillator osc;
+        Oscillator::Memory mem;
+        osc.enable();
+        osc.setWavetable(w);
+        osc.setLevelNonLinear(99);
+        osc.prepareNoteTable();
+        osc.setFrequency(mem, 69);
+
+        // 無効なオシレーターは 0 を返すだけで計測にならないので、先に1ブロック鳴らして確かめる
+        bool sounding = false;
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            sounding |= osc.getSample(mem) != 0;
+            osc.update(mem);
+        }
+        if (!sounding) {
+            printInvalid(NAMES[w]);
+            continue;
+        }
+
+        // generate() と同じくテーブルはブロック先頭で1回取得、前サンプルを変調入力に使う
+        Audio24_t prev = 0;
+        measure(0, Bench::RUNS, [&]() {
+            const Audio24_t* table = osc.getTable(mem);
+            for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+                prev = osc.getSample(mem, prev >> 2, table);
+                osc.update(mem);
+            }
+            sink = prev;
+        });
+        printRow(NAMES[w], 0, Bench::RUNS);
+    }
+}
+
+void benchEnv() {
+    for (uint8_t shift = 0; shift <= Envelope::ENV_RATE_SHIFT_MAX; shift += Envelope::ENV_RATE_SHIFT_MAX) {
+        Envelope env;
+        Envelope::Memory mem;
+        env.setRate1(60);
+        env.setRate2(40);
+        env.setRate3(30);
+        env.setRate4(50);
+        env.setLevel3(70);
+        env.prepareNoteTables(99);
+        env.setOutlevel(99, 100, 60);
+        env.reset(mem);
+
+        const size_t updates = BUFFER_SIZE / (Envelope::ENV_BLOCK_MAX >> shift);
+        measure(0, Bench::RUNS, [&]() {
+            // サステインに入ったら弾き直してアタック/ディケイを計測し続ける
+            if (mem.state == Envelope::EnvelopeState::Phase3) {
+                env.clear(mem);
+                env.reset(mem);
+            }
+            for (size_t k = 0; k < updates; ++k) env.update(mem, shift);
+            sink = mem.current_level;
+        });
+        printRow(shift == 0 ? "ENV /64" : "ENV /16", 0, Bench::RUNS);
+    }
+}
+
+void benchSynth(Synth& synth, bool full) {
+    static const uint8_t VOICES[] = {1, 4, 8, 16};
+    char name[16];
+
+    // 発音部だけを測るためエフェクトは止める（エフェクトは個別に計測）
+    synth.setDelayEnabled(false);
+    synth.setChorusEnabled(false);
+    synth.setReverbEnabled(false);
+    synth.setLpfEnabled(false);
+    synth.setHpfEnabled(false);
+
+    for (uint8_t voices : VOICES) {
+        uint16_t n = 0;
+        for (uint8_t algo = 0; algo < 32; ++algo) {
+            synth.reset();
+            synth.setAlgorithm(algo);
+            for (uint8_t v = 0; v < voices; ++v) synth.noteOn(48 + v * 3, 100, 1);
+
+            measure(n, Bench::SYNTH_RUNS_PER_ALGO, [&]() {
+                samples_ready_flags = false;
+                synth.update();
+            });
+            if (full) {
+                snprintf(name, sizeof(name), "SYNTH V%u A%02u", voices, algo);
+                printRow(name, n, Bench::SYNTH_RUNS_PER_ALGO);
+            }
+            n += Bench::SYNTH_RUNS_PER_ALGO;
+        }
+        snprintf(name, sizeof(name), "SYNTH V%u", voices);
+        printRow(name, 0, n);
+    }
+}
+
+void benchFilter(Synth& synth) {
+    Filter& filter = synth.getFilter();
+
+    measure(0, Bench::RUNS, [&]() {
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            sink = filter.processLpfL(input_L[i]) + filter.processLpfR(input_R[i]);
+        }
+    });
+    printRow("FILTER LPF", 0, Bench::RUNS);
+
+    measure(0, Bench::RUNS, [&]() {
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            sink = filter.processHpfL(input_L[i]) + filter.processHpfR(input_R[i]);
+        }
+    });
+    printRow("FILTER HPF", 0, Bench::RUNS);
+}
+
+void benchDelay(Synth& synth) {
+    synth.setDelayEnabled(true); // アリーナの領域を確保させる
+    Delay& delay = synth.getDelay();
+
+    measure(0, Bench::RUNS, [&]() {
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            sink = delay.processL(input_L[i]) + delay.processR(input_R[i]);
+        }
+    });
+    printRow("DELAY", 0, Bench::RUNS);
+}
+
+void benchChorus(Synth& synth) {
+    synth.setChorusEnabled(true);
+    Chorus& chorus = synth.getChorus();
+
+    measure(0, Bench::RUNS, [&]() {
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            Sample16_t l = input_L[i];
+            Sample16_t r = input_R[i];
+            chorus.process(l, r);
+            sink = l + r;
+        }
+    });
+    printRow("CHORUS", 0, Bench::RUNS);
+}
+
+void benchReverb(Synth& synth) {
+    synth.setReverbEnabled(true);
+    Reverb& reverb = synth.getReverb();
+
+    measure(0, Bench::RUNS, [&]() {
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            Sample16_t l = input_L[i];
+            Sample16_t r = input_R[i];
+            reverb.process(l, r);
+            sink = l + r;
+        }
+    });
+    printRow("REVERB", 0, Bench::RUNS);
+}
+
+// 発音中の状態から generate() を計測する。何も鳴っていなければ和音を鳴らして暖めてから
+// 併せてスナップショットの保存・復元の所要時間も測る（ブロックの合間に収まるかの確認）
+void benchWarm(Synth& synth) {
+    static const uint8_t CHORD[] = {48, 55, 60, 64, 67, 72, 76, 79};
+    constexpr uint16_t WARM_BLOCKS = 100;
+
+    if (!synth.isActive()) {
+        for (uint8_t note : CHORD) synth.noteOn(note, 100, 1);
+        for (uint16_t i = 0; i < WARM_BLOCKS; ++i) {
+            samples_ready_flags = false;
+            synth.update();
+        }
+    }
+
+    size_t len = 0;
+    if (synth.saveSnapshot(warm_state, sizeof(warm_state), false, len) != SnapshotStatus::OK) return;
+
+    char name[16];
+    snprintf(name, sizeof(name), "SYNTH WARM V%u", (unsigned)synth.getActiveNoteCount());
+    measure(0, Bench::RUNS, [&]() {
+        samples_ready_flags = false;
+        synth.update();
+    });
+    printRow(name, 0, Bench::RUNS);
+
+    measure(0, Bench::RUNS, [&]() {
+        synth.saveSnapshot(warm_state, sizeof(warm_state), false, len);
+    });
+    printRow("SNAP SAVE", 0, Bench::RUNS);
+
+    measure(0, Bench::RUNS, [&]() {
+        synth.restoreSnapshot(warm_state, len);
+    });
+    printRow("SNAP RESTORE", 0, Bench::RUNS);
+}
+
+void benchLfo() {
+    Lfo lfo;
+    lfo.init();
+    lfo.setWave(static_cast<uint8_t>(Lfo::Wave::Sine));
+    lfo.setSpeed(70);
+    lfo.setPmDepth(50);
+    lfo.setAmDepth(50);
+
+    measure(0, Bench::RUNS, [&]() {
+        lfo.advance(BUFFER_SIZE);
+        sink = lfo.getPitchMod();
+    });
+    printRow("LFO", 0, Bench::RUNS);
+}
+
+} // namespace
+
+uint8_t Bench::invalidCases() {
+    return invalid_cases;
+}
+
+const char* Bench::unit() {
+#if defined(__IMXRT1062__)
+    return "cyc";
+#else
+    return "ns";
+#endif
+}
+
+/**
+ * @brief ベンチマークを実行して表を出力
+ *
+ * 開始時の状態をスナップショットに取り、終了時に戻す（発音中のノートも続く）。
+ * エフェクトバッファは計測用の信号で上書きされるので無音にする。
+ */
+bool Bench::run(Synth& synth, const char* group, bool full) {
+    static const char* const GROUPS[] = {"OSC", "ENV", "SYNTH", "FILTER", "DELAY", "CHORUS", "REVERB", "LFO", "WARM"};
+    if (group && group[0] != '\0') {
+        bool known = false;
+        for (const char* g : GROUPS) known |= (std::strcmp(group, g) == 0);
+        if (!known) return false;
+    }
+
+    size_t saved_len = 0;
+    if (synth.saveSnapshot(saved_state, sizeof(saved_state), false, saved_len) != SnapshotStatus::OK) return false;
+
+    fillInput();
+    invalid_cases = 0;
+    printHeader(synth);
+
+    // WARM は開始時の発音状態を使うので最初に走らせる
+    if (groupMatches(group, "WARM"))   benchWarm(synth);
+    if (groupMatches(group, "OSC"))    benchOsc();
+    if (groupMatches(group, "ENV"))    benchEnv();
+    if (groupMatches(group, "SYNTH"))  benchSynth(synth, full);
+    if (groupMatches(group, "FILTER")) benchFilter(synth);
+    if (groupMatches(group, "DELAY"))  benchDelay(synth);
+    if (groupMatches(group, "CHORUS")) benchChorus(synth);
+    if (groupMatches(group, "REVERB")) benchReverb(synth);
+    if (groupMatches(group, "LFO"))    benchLfo();
+
+    synth.restoreSnapshot(saved_state, saved_len);
+    synth.clearEffectBuffers();
+    samples_ready_flags = false;
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "tools/capture.hpp"
+
+#include <SD.h>
+#include <cstring>
+
+#include "modules/synth.hpp"
+#include "tools/profiler.hpp"
+#include "utils/placement.hpp"
+
+// 起動時に初期化されない領域だが、used_ の範囲しか読まないのでクリアは不要
+PLACE_BULK uint8_t Capture::ring_[Capture::CAPACITY];
+uint32_t Capture::head_ = 0;
+uint32_t Capture::tail_ = 0;
+uint32_t Capture::used_ = 0;
+uint32_t Capture::entries_ = 0;
+uint32_t Capture::dropped_ = 0;
+uint32_t Capture::first_block_ = 0;
+uint8_t Capture::base_preset_ = 0;
+uint32_t Capture::base_seed_ = 0;
+uint8_t Capture::base_flags_ = 0;
+bool Capture::enabled_ = false;
+
+void Capture::start() {
+    const Synth& synth = Synth::getInstance();
+    enabled_ = false;
+    head_ = 0;
+    tail_ = 0;
+    used_ = 0;
+    entries_ = 0;
+    dropped_ = 0;
+    first_block_ = synth.getBlockCount();
+    base_preset_ = synth.getCurrentPresetId();
+    base_seed_ = synth.getRandomSeed();
+    base_flags_ = synth.isVoiceEdited() ? BASE_EDITED : 0;
+    enabled_ = true;
+}
+
+void Capture::midi(Source source, uint8_t type, uint8_t ch, uint8_t d1, uint8_t d2) {
+    if (!enabled_) return;
+    const uint8_t payload[4] = {type, ch, d1, d2};
+    push(MIDI, source, payload, sizeof(payload));
+}
+
+void Capture::pitchBend(Source source, uint8_t ch, int16_t bend) {
+    const uint16_t v = static_cast<uint16_t>(bend + 8192);
+    midi(source, 0xE0, ch, v & 0x7F, (v >> 7) & 0x7F);
+}
+
+void Capture::command(const char* s, uint8_t len) {
+    if (!enabled_) return;
+    push(COMMAND, SRC_SERIAL_CMD, reinterpret_cast<const uint8_t*>(s), len > MAX_PAYLOAD ? MAX_PAYLOAD : len);
+}
+
+void Capture::preset(uint8_t preset_id) {
+    if (!enabled_) return;
+    push(PRESET, SRC_SYNTH, &preset_id, 1);
+}
+
+void Capture::randomPreset(uint32_t seed) {
+    if (!enabled_) return;
+    uint8_t payload[4];
+    memcpy(payload, &seed, sizeof(seed));
+    push(RANDOM_PRESET, SRC_SYNTH, payload, sizeof(payload));
+}
+
+void Capture::synthReset() {
+    if (!enabled_) return;
+    push(RESET, SRC_SYNTH, nullptr, 0);
+}
+
+void Capture::push(Kind kind, Source source, const uint8_t* payload, uint8_t len) {
+    const Synth& synth = Synth::getInstance();
+
+    // 直近ブロックの生成開始からの経過をサンプル数に換算（1ブロックを超えたら頭打ち）
+    const uint64_t elapsed = Profiler::now() - synth.getBlockStartTicks();
+    const uint64_t offset = elapsed * SAMPLE_RATE / Profiler::ticksPerSecond();
+
+    EntryHeader h;
+    h.block = synth.getBlockCount();
+    h.offset = static_cast<uint8_t>(offset < BUFFER_SIZE ? offset : BUFFER_SIZE - 1);
+    h.kind = kind;
+    h.source = source;
+    h.len = len;
+
+    const uint32_t size = sizeof(EntryHeader) + len;
+    while (CAPACITY - used_ < size) dropOldest();
+
+    copyIn(&h, sizeof(h));
+    if (len) copyIn(payload, len);
+    used_ += size;
+    ++entries_;
+}
+
+/**
+ * @brief 最古のエントリを捨てる
+ *
+ * 再生の起点を次のエントリのブロックへ進め、捨てるのがプリセットなら起点のプリセットにする
+ * （それより前の編集は上書きされたので BASE_EDITED も外す）。
+ */
+void Capture::dropOldest() {
+    EntryHeader h;
+    copyOut(tail_, &h, sizeof(h));
+    if (h.kind == PRESET) {
+        copyOut(tail_ + sizeof(h), &base_preset_, 1);
+        base_seed_ = 0;
+        base_flags_ &= ~BASE_EDITED;
+    } else if (h.kind == RANDOM_PRESET) {
+        copyOut(tail_ + sizeof(h), &base_seed_, sizeof(base_seed_));
+        if (base_seed_ == 0) base_seed_ = 1;  // randomizePreset() と同じく 0 は 1 として扱う
+        base_flags_ &= ~BASE_EDITED;
+    }
+
+    const uint32_t size = sizeof(h) + h.len;
+    tail_ = (tail_ + size) % CAPACITY;
+    used_ -= size;
+    --entries_;
+    ++dropped_;
+
+    if (used_ > 0) {
+        copyOut(tail_, &h, sizeof(h));
+        first_block_ = h.block;
+    }
+}
+
+void Capture::copyIn(const void* src, uint32_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(src);
+    const uint32_t first = (len < CAPACITY - head_) ? len : CAPACITY - head_;
+    memcpy(&ring_[head_], p, first);
+    memcpy(&ring_[0], p + first, len - first);
+    head_ = (head_ + len) % CAPACITY;
+}
+
+void Capture::copyOut(uint32_t pos, void* dst, uint32_t len) {
+    uint8_t* p = static_cast<uint8_t*>(dst);
+    pos %= CAPACITY;
+    const uint32_t first = (len < CAPACITY - pos) ? len : CAPACITY - pos;
+    memcpy(p, &ring_[pos], first);
+    memcpy(p + first, &ring_[0], len - first);
+}
+
+bool Capture::save(const char* path) {
+    const bool was_enabled = enabled_;
+    enabled_ = false;
+
+    FileHeader fh = {};
+    memcpy(fh.magic, "CRBC", 4);
+    fh.version = FORMAT_VERSION;
+    fh.block_size = BUFFER_SIZE;
+    fh.sample_rate = SAMPLE_RATE;
+    fh.entries = entries_;
+    fh.dropped = dropped_;
+    fh.first_block = first_block_;
+    fh.base_preset = base_preset_;
+    fh.base_flags = base_flags_;
+    fh.base_seed = base_seed_;
+
+    SD.remove(path);
+    File file = SD.open(path, FILE_WRITE);
+    bool ok = static_cast<bool>(file);
+    if (ok) {
+        ok = file.write(reinterpret_cast<const uint8_t*>(&fh), sizeof(fh)) == sizeof(fh);
+
+        // リングの折り返しをまたぐ場合は2回に分けて書く
+        const uint32_t first = (used_ < CAPACITY - tail_) ? used_ : CAPACITY - tail_;
+        if (ok && first) ok = file.write(&ring_[tail_], first) == first;
+        if (ok && used_ > first) ok = file.write(&ring_[0], used_ - first) == used_ - first;
+        file.close();
+    }
+
+    enabled_ = was_enabled;
+    return ok;
+}
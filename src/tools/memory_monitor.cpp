@@ -0,0 +1,122 @@
+#include "tools/memory_monitor.hpp"
+
+#include <malloc.h>
+
+#include "display/gfx.hpp"
+#include "modules/synth.hpp"
+#include "modules/effect_arena.hpp"
+#include "utils/preset.hpp"
+
+#if defined(__IMXRT1062__)
+// Teensy 4.x リンカスクリプト (imxrt1062_t41.ld) が定義するシンボル
+extern "C" {
+    extern char _stext, _etext;              // ITCM コード
+    extern char _sdata, _ebss;               // DTCM .data 先頭 / .bss 末尾
+    extern char _estack;                     // スタック上端 (DTCM 末尾)
+    extern char _heap_start, _heap_end;      // ヒープ (RAM2: DMAMEM の後ろ)
+    extern char* __brkval;                   // sbrk の現在位置
+    extern char _itcm_block_count;           // ITCM の 32KB ブロック数（アドレスが値）
+    extern char _flashimagelen;              // フラッシュイメージ長（アドレスが値）
+}
+
+static constexpr uint32_t FLEXRAM_BANK_SIZE = 32 * 1024;
+static constexpr uint32_t FLEXRAM_BANKS = 16;
+static constexpr uint32_t RAM2_START = 0x20200000;
+static constexpr uint32_t RAM2_SIZE = 512 * 1024;
+static constexpr uint32_t FLASH_SIZE = 7936 * 1024;  // Teensy 4.1 (末尾はEEPROMエミュレーション等)
+
+static inline uint32_t addr(const void* p) {
+    return reinterpret_cast<uint32_t>(p);
+}
+#endif
+
+/**
+ * @brief 未使用スタック領域をパターンで塗る
+ *
+ * .bss 末尾から現在のSP - STACK_PAINT_MARGIN までを塗る。
+ * 割り込みも同じスタックを使うので、塗っている間は割り込みを止める。
+ */
+void MemoryMonitor::paintStack() {
+#if defined(__IMXRT1062__)
+    uint32_t sp;
+    asm volatile("mov %0, sp" : "=r"(sp));
+
+    uint32_t* p = reinterpret_cast<uint32_t*>((addr(&_ebss) + 3) & ~3u);
+    uint32_t* end = reinterpret_cast<uint32_t*>(sp - STACK_PAINT_MARGIN);
+
+    __disable_irq();
+    while (p < end) *p++ = STACK_PAINT;
+    __enable_irq();
+#endif
+}
+
+/**
+ * @brief スタック最大使用量
+ *
+ * .bss 末尾から上に向かってパターンが残っている範囲を数え、
+ * 最初に書き換えられていた位置からスタック上端までを使用量とする。
+ *
+ * @return uint32_t 最大使用量 (bytes)
+ */
+uint32_t MemoryMonitor::stackPeak() {
+#if defined(__IMXRT1062__)
+    const uint32_t* p = reinterpret_cast<const uint32_t*>((addr(&_ebss) + 3) & ~3u);
+    const uint32_t* top = reinterpret_cast<const uint32_t*>(&_estack);
+    while (p < top && *p == STACK_PAINT) ++p;
+    return addr(top) - addr(p);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 現在のメモリ使用状況を取得
+ *
+ * @param snap 出力先
+ */
+void MemoryMonitor::capture(Snapshot& snap) {
+    snap = Snapshot{};
+#if defined(__IMXRT1062__)
+    const uint32_t itcm_blocks = addr(&_itcm_block_count);
+
+    snap.itcm_size = itcm_blocks * FLEXRAM_BANK_SIZE;
+    snap.itcm_used = addr(&_etext) - addr(&_stext);
+    snap.dtcm_size = (FLEXRAM_BANKS - itcm_blocks) * FLEXRAM_BANK_SIZE;
+    snap.dtcm_static = addr(&_ebss) - addr(&_sdata);
+    snap.stack_size = addr(&_estack) - addr(&_ebss);
+    snap.stack_peak = stackPeak();
+
+    snap.ram2_size = RAM2_SIZE;
+    snap.ram2_static = addr(&_heap_start) - RAM2_START;
+    snap.heap_size = addr(&_heap_end) - addr(&_heap_start);
+
+    const struct mallinfo mi = mallinfo();
+    snap.heap_used = mi.uordblks;
+    snap.heap_free = (addr(&_heap_end) - addr(__brkval)) + mi.fordblks;
+
+    snap.flash_size = FLASH_SIZE;
+    snap.flash_used = addr(&_flashimagelen);
+#endif
+}
+
+/**
+ * @brief 主要モジュールのバッファサイズ一覧
+ *
+ * @param count 要素数の出力先
+ * @return const ModuleUsage* 一覧の先頭
+ */
+const MemoryMonitor::ModuleUsage* MemoryMonitor::modules(size_t& count) {
+    static const ModuleUsage table[] = {
+        {"SYNTH",     static_cast<uint32_t>(sizeof(Synth)),                                    "DTCM"},
+        {"WAVETABLE", static_cast<uint32_t>(sizeof(Wavetable::sine) * 4),                      "DTCM"},
+        {"MIPTABLE",  static_cast<uint32_t>(Oscillator::MIP_MEMORY_BYTES),                     "DTCM"},
+        {"EXP2TABLE", static_cast<uint32_t>(Envelope::EXP2_N_SAMPLES * 2 * sizeof(int32_t)),   "DTCM"},
+        {"FX ARENA",  static_cast<uint32_t>(EffectArena::capacity() * sizeof(Sample16_t)),     "RAM2"},
+        {"CANVAS",    static_cast<uint32_t>(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t)),  "HEAP"},
+        // generate() 1回あたりのスタック: op_buffer + mix_buffer L/R
+        {"RENDER",    static_cast<uint32_t>((MAX_OPERATORS + 2) * BUFFER_SIZE * sizeof(Audio24_t)), "STACK"},
+        {"PRESETS",   static_cast<uint32_t>(sizeof(SynthPreset) * MAX_PRESETS),                "FLASH"},
+    };
+    count = sizeof(table) / sizeof(table[0]);
+    return table;
+}
@@ -1,4 +1,7 @@
 #include "tools/midi_player.hpp"
+#include "tools/capture.hpp"
+#include "tools/postmortem.hpp"
+#include "tools/profiler.hpp"
 
 void MIDIPlayer::init() {
     if(!SD.begin(BUILTIN_SDCARD)) {
@@ -25,6 +28,10 @@ void MIDIPlayer::midiCallback(midi_event *pev) {
 
     AudioNoInterrupts();
 
+    if (status == 0x90 || status == 0x80) {
+        Capture::midi(Capture::SRC_PLAYER, status, channel+1, note, velocity);
+    }
+
     switch (status) {
         case 0x90:
             if(velocity > 0) {
@@ -54,7 +61,12 @@ void MIDIPlayer::play(const char* path) {
     }
 
     // ファイル読み込みのエラーチェック
-    int err = instance->SMF.load(path);
+    int err;
+    {
+        Profiler::Scope probe(Profiler::SD);
+        PostMortem::Suspend suspend;  // 大きなファイルは読み込みに時間がかかる
+        err = instance->SMF.load(path);
+    }
     if (err != MD_MIDIFile::E_OK) {
         Serial.printf("SMF Load Error: %d\n", err);
         instance->is_playing = false;
@@ -82,6 +94,8 @@ void MIDIPlayer::process() {
     if (!is_initialized || !is_playing) return;
 
     if (!SMF.isEOF()) {
+        // SD からの読み込み（時間が来たイベントのコールバックも含む）
+        Profiler::Scope probe(Profiler::SD);
         SMF.getNextEvent();
     }
 }
\ No newline at end of file
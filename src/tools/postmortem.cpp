@@ -0,0 +1,228 @@
+#include "tools/postmortem.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+#include "utils/placement.hpp"
+
+PLACE_RETAINED PostMortem::Record PostMortem::retained_;
+PostMortem::Record PostMortem::last_ = {};
+uint32_t PostMortem::reset_status_ = 0;
+
+volatile uint32_t PostMortem::loop_ms_ = 0;
+volatile uint32_t PostMortem::block_ms_ = 0;
+volatile uint32_t PostMortem::last_blocks_ = 0;
+volatile uint8_t PostMortem::suspended_ = 0;
+volatile bool PostMortem::enabled_ = true;
+bool PostMortem::report_pending_ = false;
+const char* volatile PostMortem::screen_ = "";
+
+namespace {
+
+IntervalTimer deadline_timer;
+
+// 監視はオーディオライブラリの更新 (IRQ_SOFTWARE) より上、オーディオ割り込み (0) より下
+constexpr uint8_t CHECK_PRIORITY = 16;
+
+const char* const REASON_NAMES[PostMortem::REASON_COUNT] = {
+    "NONE", "BLOCK DEADLINE", "LOOP STALL", "FAULT",
+};
+
+const char* const EVENT_NAMES[Trace::EVENT_COUNT] = {
+    "SPAN", "NOTE_ON", "NOTE_OFF", "STEAL", "PRESET", "FLASH_CHUNK", "UNDERRUN",
+};
+
+} // namespace
+
+// 例外スタックフレーム（MSP / PSP のどちらに積まれたか）を r0 に入れて C++ 側へ
+extern "C" void postMortemFault(const uint32_t* frame) {
+    PostMortem::onFault(frame);
+}
+
+extern "C" __attribute__((naked)) void postMortemFaultIsr() {
+    asm volatile(
+        "tst lr, #4          \n"
+        "ite eq              \n"
+        "mrseq r0, msp       \n"
+        "mrsne r0, psp       \n"
+        "b postMortemFault   \n");
+}
+
+uint32_t PostMortem::checksum(const Record& r) {
+    // FNV-1a (32bit)
+    uint32_t h = 2166136261u;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&r);
+    for (size_t i = 0; i < offsetof(Record, checksum); ++i) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+void PostMortem::begin() {
+    reset_status_ = SRC_SRSR;
+    SRC_SRSR = reset_status_;  // 書き込みでクリア
+
+    // 電源投入直後の不定値は magic とチェックサムで弾く
+    if (retained_.magic == RECORD_MAGIC && retained_.version == RECORD_VERSION &&
+        retained_.reason != NONE && retained_.reason < REASON_COUNT &&
+        retained_.checksum == checksum(retained_)) {
+        last_ = retained_;
+        report_pending_ = true;
+    }
+    retained_.magic = 0;
+    arm_dcache_flush(&retained_, sizeof(retained_));
+
+    // 例外ベクタ (RAM 上) の HardFault / MemManage / BusFault / UsageFault を差し替える
+    for (uint8_t i = 3; i <= 6; ++i) _VectorsRam[i] = postMortemFaultIsr;
+}
+
+void PostMortem::arm() {
+    kick();
+    last_blocks_ = Synth::getInstance().getBlockCount();
+    deadline_timer.priority(CHECK_PRIORITY);
+    deadline_timer.begin(check, CHECK_INTERVAL_US);
+}
+
+// PIT 割り込み
+void PostMortem::check() {
+    const uint32_t now = millis();
+    const Synth& synth = Synth::getInstance();
+    const uint32_t blocks = synth.getBlockCount();
+
+    // 無音で止まっている間はブロックが出なくて正常
+    if (blocks != last_blocks_ || !synth.isActive()) {
+        last_blocks_ = blocks;
+        block_ms_ = now;
+    }
+    if (!enabled_ || suspended_) return;
+
+    if (now - block_ms_ >= BLOCK_DEADLINE_MS) trip(BLOCK_DEADLINE, nullptr);
+    if (now - loop_ms_ >= LOOP_DEADLINE_MS) trip(LOOP_STALL, nullptr);
+}
+
+void PostMortem::onFault(const uint32_t* frame) {
+    trip(FAULT, frame);
+}
+
+/**
+ * @brief 状態を retained_ に書いてリセット
+ *
+ * 割り込み・フォールトハンドラの中から呼ばれる。メインループが書きかけの値を
+ * 読むこともあるが、レポート用なので排他はしない。
+ */
+void PostMortem::trip(Reason reason, const uint32_t* frame) {
+    __disable_irq();
+    const uint32_t now = millis();
+    const Synth& synth = Synth::getInstance();
+    Record& r = retained_;
+
+    std::memset(&r, 0, sizeof(r));
+    r.magic = RECORD_MAGIC;
+    r.version = RECORD_VERSION;
+    r.reason = reason;
+    r.uptime_ms = now;
+    r.block_count = synth.getBlockCount();
+    r.block_age_ms = now - block_ms_;
+    r.loop_age_ms = now - loop_ms_;
+
+    if (frame) {
+        r.cfsr = SCB_CFSR;
+        r.hfsr = SCB_HFSR;
+        r.mmfar = SCB_MMFAR;
+        r.bfar = SCB_BFAR;
+        std::memcpy(r.frame, frame, sizeof(r.frame));
+    }
+
+    r.preset_id = synth.getCurrentPresetId();
+    r.voices = synth.getActiveNotes(r.notes);
+    std::strncpy(r.screen, screen_, sizeof(r.screen) - 1);
+
+    for (uint8_t i = 0; i < Profiler::STAGE_COUNT; ++i) {
+        const Profiler::Stat& s = Profiler::stat(static_cast<Profiler::Stage>(i));
+        r.stages[i].count = s.count;
+        r.stages[i].avg = s.count ? static_cast<uint32_t>(s.total / s.count) : 0;
+        r.stages[i].max = s.max;
+    }
+
+    const uint16_t n = Trace::count() < TRACE_EVENTS ? Trace::count() : TRACE_EVENTS;
+    for (uint16_t i = 0; i < n; ++i) r.trace[i] = Trace::at(Trace::count() - n + i);
+    r.trace_count = n;
+
+    r.checksum = checksum(r);
+    arm_dcache_flush(&r, sizeof(r));
+
+    SCB_AIRCR = 0x05FA0004;  // SYSRESETREQ
+    for (;;) {}
+}
+
+/**
+ * @brief 前回のレポートを出力
+ *
+ * CRASH: の後に要約、フォールトレジスタ、発音中のノート、段ごとの統計、トレースの順。
+ * トレースの時刻は最後のイベントからの差 (Profiler::now() の単位)。
+ */
+void PostMortem::print() {
+    report_pending_ = false;
+    if (!hasReport()) {
+        Serial.printf("CRASH: none (reset status %08lx)\n", (unsigned long)reset_status_);
+        return;
+    }
+    const Record& r = last_;
+
+    Serial.printf("CRASH: %s at %lu ms (reset status %08lx)\n",
+        REASON_NAMES[r.reason], (unsigned long)r.uptime_ms, (unsigned long)reset_status_);
+    Serial.printf("  block %lu, last block %lu ms ago, last loop %lu ms ago\n",
+        (unsigned long)r.block_count, (unsigned long)r.block_age_ms, (unsigned long)r.loop_age_ms);
+    if (r.reason == FAULT) {
+        Serial.printf("  CFSR %08lx HFSR %08lx MMFAR %08lx BFAR %08lx\n",
+            (unsigned long)r.cfsr, (unsigned long)r.hfsr, (unsigned long)r.mmfar, (unsigned long)r.bfar);
+        Serial.printf("  PC %08lx LR %08lx PSR %08lx\n",
+            (unsigned long)r.frame[6], (unsigned long)r.frame[5], (unsigned long)r.frame[7]);
+        Serial.printf("  R0 %08lx R1 %08lx R2 %08lx R3 %08lx R12 %08lx\n",
+            (unsigned long)r.frame[0], (unsigned long)r.frame[1], (unsigned long)r.frame[2],
+            (unsigned long)r.frame[3], (unsigned long)r.frame[4]);
+    }
+    Serial.printf("  screen %s, preset %u, voices %u:", r.screen[0] ? r.screen : "-",
+        (unsigned)r.preset_id, (unsigned)r.voices);
+    for (uint8_t i = 0; i < r.voices && i < MAX_NOTES; ++i) Serial.printf(" %u", (unsigned)r.notes[i]);
+    Serial.printf("\n");
+
+    Serial.printf("  %-7s %8s %9s %9s\n", "STAGE", "COUNT", "AVG", "MAX");
+    for (uint8_t i = 0; i < Profiler::STAGE_COUNT; ++i) {
+        const StageStat& s = r.stages[i];
+        if (s.count == 0) continue;
+        Serial.printf("  %-7s %8lu %9lu %9lu\n", Profiler::name(static_cast<Profiler::Stage>(i)),
+            (unsigned long)s.count, (unsigned long)s.avg, (unsigned long)s.max);
+    }
+
+    if (r.trace_count) {
+        const uint32_t last = r.trace[r.trace_count - 1].time;
+        Serial.printf("  TRACE (%u, time relative to last)\n", (unsigned)r.trace_count);
+        for (uint16_t i = 0; i < r.trace_count && i < TRACE_EVENTS; ++i) {
+            const Trace::Record& e = r.trace[i];
+            const char* type = e.type < Trace::EVENT_COUNT ? EVENT_NAMES[e.type] : "?";
+            if (e.type == Trace::SPAN) {
+                Serial.printf("  %10ld %-11s %-7s dur %lu\n", -(long)(last - e.time), type,
+                    Profiler::name(static_cast<Profiler::Stage>(e.a)), (unsigned long)e.dur);
+            } else {
+                Serial.printf("  %10ld %-11s %u %u\n", -(long)(last - e.time), type,
+                    (unsigned)e.a, (unsigned)e.b);
+            }
+        }
+    }
+}
+
+void PostMortem::clear() {
+    last_ = {};
+    report_pending_ = false;
+}
+
+void PostMortem::testFault() {
+    Serial.flush();
+    // 実装されていないアドレスへの書き込みで BusFault を起こす
+    *reinterpret_cast<volatile uint32_t*>(0xFFFFFFF0) = 0;
+    for (;;) {}
+}
+
+void PostMortem::testStall() {
+    Serial.flush();
+    for (;;) {}
+}
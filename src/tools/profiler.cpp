@@ -0,0 +1,72 @@
+#include "tools/profiler.hpp"
+
+#include "handlers/audio.hpp"
+
+Profiler::Stat Profiler::stats_[Profiler::STAGE_COUNT];
+
+namespace {
+
+const char* const STAGE_NAMES[Profiler::STAGE_COUNT] = {
+    "SYNTH", "VOICES", "OUTPUT", "LPF", "HPF", "DELAY", "CHORUS", "REVERB",
+    "AUDIO", "MIDI", "UI", "FLASH", "PLAYER", "SERIAL", "SD", "FFT",
+};
+
+// 1ブロック (BUFFER_SIZE サンプル) の持ち時間
+uint32_t blockBudget() {
+    return static_cast<uint32_t>(static_cast<uint64_t>(Profiler::ticksPerSecond()) * BUFFER_SIZE / SAMPLE_RATE);
+}
+
+} // namespace
+
+uint32_t Profiler::ticksPerSecond() {
+#if defined(__IMXRT1062__)
+    return F_CPU_ACTUAL;
+#else
+    return 1000000000UL;
+#endif
+}
+
+const char* Profiler::unit() {
+#if defined(__IMXRT1062__)
+    return "cyc";
+#else
+    return "ns";
+#endif
+}
+
+const char* Profiler::name(Stage stage) {
+    return stage < STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
+
+/**
+ * @brief 全段の統計を表で出力する
+ *
+ * 1度も通らなかった段は省略する。MAX% は1ブロックの持ち時間に対する最大値の割合。
+ * ヒストグラムは空でないビンだけを「<2^k:回数」で並べる。
+ */
+void Profiler::print() {
+    const uint32_t budget = blockBudget();
+    Serial.printf("PERF: unit=%s budget=%lu/block\n", unit(), (unsigned long)budget);
+    Serial.printf("  %-7s %8s %9s %9s %9s %6s\n", "STAGE", "COUNT", "MIN", "AVG", "MAX", "MAX%");
+
+    for (uint8_t i = 0; i < STAGE_COUNT; ++i) {
+        const Stat& s = stats_[i];
+        if (s.count == 0) continue;
+
+        Serial.printf("  %-7s %8lu %9lu %9lu %9lu %6.1f\n",
+            STAGE_NAMES[i], (unsigned long)s.count, (unsigned long)s.min,
+            (unsigned long)(s.total / s.count), (unsigned long)s.max,
+            budget ? 100.0 * s.max / budget : 0.0);
+
+        Serial.printf("    hist");
+        for (uint8_t k = 0; k < HIST_BINS; ++k) {
+            if (s.hist[k]) Serial.printf(" <2^%u:%lu", (unsigned)k, (unsigned long)s.hist[k]);
+        }
+        Serial.printf("\n");
+    }
+}
+
+/** @brief 全段の統計をクリア */
+void Profiler::reset() {
+    for (Stat& s : stats_) s = Stat{};
+}
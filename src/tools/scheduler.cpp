@@ -0,0 +1,182 @@
+#include "tools/scheduler.hpp"
+
+Scheduler::Task Scheduler::tasks_[MAX_TASKS] = {};
+Scheduler::Stat Scheduler::stats_[MAX_TASKS] = {};
+uint8_t Scheduler::count_ = 0;
+Scheduler::HeadroomFn Scheduler::headroom_fn_ = nullptr;
+
+bool Scheduler::in_task_ = false;
+uint8_t Scheduler::yield_depth_ = 0;
+uint16_t Scheduler::running_ = 0;
+uint32_t Scheduler::slice_start_ = 0;
+uint32_t Scheduler::slice_max_ = 0;
+uint32_t Scheduler::window_start_ms_ = 0;
+
+namespace {
+
+const char* const PRIORITY_NAMES[Scheduler::PRIORITY_COUNT] = {"CRIT", "HIGH", "NORM", "LOW"};
+
+} // namespace
+
+bool Scheduler::add(const Task& task) {
+    if (count_ >= MAX_TASKS) return false;
+    uint8_t i = count_;
+    while (i > 0 && tasks_[i - 1].priority > task.priority) {
+        tasks_[i] = tasks_[i - 1];
+        stats_[i] = stats_[i - 1];
+        --i;
+    }
+    tasks_[i] = task;
+    stats_[i] = Stat{};
+    stats_[i].last_ms = millis();
+    ++count_;
+    return true;
+}
+
+// budget と直近 1〜2 秒の実測の大きい方
+uint32_t Scheduler::cost(uint8_t i) {
+    const Stat& s = stats_[i];
+    uint32_t c = tasks_[i].budget_us;
+    if (s.window_us[0] > c) c = s.window_us[0];
+    if (s.window_us[1] > c) c = s.window_us[1];
+    return c;
+}
+
+uint32_t Scheduler::criticalCost() {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < count_ && tasks_[i].priority == CRITICAL; ++i) total += cost(i);
+    return total;
+}
+
+/**
+ * @brief タスクを実行しても再生キューが空にならないか
+ *
+ * タスクの後に CRITICAL を回してブロックを生成・送信するまでの分も見込む。
+ */
+bool Scheduler::fits(uint8_t i) {
+    const uint32_t headroom = headroomUs();
+    if (headroom == UINT32_MAX) return true;
+    return cost(i) + criticalCost() + GUARD_US <= headroom;
+}
+
+void Scheduler::runCritical() {
+    for (uint8_t i = 0; i < count_ && tasks_[i].priority == CRITICAL; ++i) execute(i);
+}
+
+/**
+ * @brief タスクを1回実行し、途中で yield() を挟まない最長区間を所要時間として記録
+ *
+ * yield() の中から呼ばれたときは、外側のタスクの区間計測を退避して戻す。
+ */
+void Scheduler::execute(uint8_t i) {
+    const Task& t = tasks_[i];
+    Stat& s = stats_[i];
+
+    const bool outer_in_task = in_task_;
+    const uint32_t outer_max = slice_max_;
+    in_task_ = true;
+    slice_max_ = 0;
+    running_ |= 1u << i;
+
+    slice_start_ = micros();
+    if (t.stage < Profiler::STAGE_COUNT) {
+        Profiler::Scope probe(t.stage);
+        t.fn();
+    } else {
+        t.fn();
+    }
+    closeSlice();
+
+    running_ &= ~(1u << i);
+    const uint32_t us = slice_max_;
+    ++s.runs;
+    s.last_ms = millis();
+    if (us > s.peak_us) s.peak_us = us;
+    if (us > s.window_us[1]) s.window_us[1] = us;
+    if (us > t.budget_us) ++s.overruns;
+
+    in_task_ = outer_in_task;
+    slice_max_ = outer_max;
+    slice_start_ = micros();
+}
+
+void Scheduler::closeSlice() {
+    const uint32_t us = micros() - slice_start_;
+    if (us > slice_max_) slice_max_ = us;
+}
+
+void Scheduler::yield() {
+    if (yield_depth_ > 0) return;
+    ++yield_depth_;
+    if (in_task_) closeSlice();
+
+    runCritical();
+    for (uint8_t i = 0; i < count_; ++i) {
+        const Task& t = tasks_[i];
+        if (t.priority == CRITICAL || !t.in_yield || (running_ & (1u << i))) continue;
+        if (fits(i)) execute(i);
+    }
+
+    slice_start_ = micros();
+    --yield_depth_;
+}
+
+void Scheduler::run() {
+    const uint32_t now = millis();
+    if (now - window_start_ms_ >= WINDOW_MS) {
+        window_start_ms_ = now;
+        for (uint8_t i = 0; i < count_; ++i) {
+            stats_[i].window_us[0] = stats_[i].window_us[1];
+            stats_[i].window_us[1] = 0;
+        }
+    }
+
+    runCritical();
+    for (uint8_t i = 0; i < count_; ++i) {
+        const Task& t = tasks_[i];
+        if (t.priority == CRITICAL) continue;
+        Stat& s = stats_[i];
+
+        if (!fits(i)) {
+            if (t.max_defer_ms == 0 || millis() - s.last_ms < t.max_defer_ms) {
+                ++s.deferred;
+                continue;
+            }
+            ++s.forced;
+        }
+        execute(i);
+        runCritical();  // 次のタスクの前にキューを満たす
+    }
+}
+
+void Scheduler::print() {
+    const uint32_t headroom = headroomUs();
+    if (headroom == UINT32_MAX) {
+        Serial.printf("SCHED: headroom=- critical=%lu us guard=%lu us\n",
+            (unsigned long)criticalCost(), (unsigned long)GUARD_US);
+    } else {
+        Serial.printf("SCHED: headroom=%lu us critical=%lu us guard=%lu us\n",
+            (unsigned long)headroom, (unsigned long)criticalCost(), (unsigned long)GUARD_US);
+    }
+    Serial.printf("  %-7s %-4s %7s %7s %7s %9s %9s %7s %7s\n",
+        "TASK", "PRI", "BUDGET", "COST", "PEAK", "RUNS", "DEFER", "FORCED", "OVER");
+    for (uint8_t i = 0; i < count_; ++i) {
+        const Task& t = tasks_[i];
+        const Stat& s = stats_[i];
+        Serial.printf("  %-7s %-4s %7lu %7lu %7lu %9lu %9lu %7lu %7lu\n",
+            t.name, PRIORITY_NAMES[t.priority], (unsigned long)t.budget_us, (unsigned long)cost(i),
+            (unsigned long)s.peak_us, (unsigned long)s.runs, (unsigned long)s.deferred,
+            (unsigned long)s.forced, (unsigned long)s.overruns);
+    }
+}
+
+void Scheduler::clearStats() {
+    for (uint8_t i = 0; i < count_; ++i) {
+        Stat& s = stats_[i];
+        s.runs = 0;
+        s.deferred = 0;
+        s.forced = 0;
+        s.overruns = 0;
+        s.peak_us = 0;
+    }
+}
@@ -0,0 +1,296 @@
+#include "tools/stress.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "modules/synth.hpp"
+#include "tools/capture.hpp"
+#include "tools/profiler.hpp"
+#include "utils/placement.hpp"
+
+Stress::UiHook Stress::ui_hook_ = nullptr;
+bool Stress::active_ = false;
+bool Stress::all_ = false;
+Stress::Scenario Stress::scenario_ = Stress::CHORD;
+uint16_t Stress::blocks_ = 0;
+uint16_t Stress::count_ = 0;
+bool Stress::pending_ = false;
+uint32_t Stress::pending_block_ = 0;
+uint32_t Stress::input_ticks_ = 0;
+uint32_t Stress::last_start_ = 0;
+uint32_t Stress::max_gap_ = 0;
+uint64_t Stress::total_ = 0;
+uint32_t Stress::rng_ = 1;
+bool Stress::capture_was_on_ = false;
+
+namespace {
+
+const char* const NAMES[Stress::SCENARIO_COUNT] = {"CHORD", "BEND", "CC", "FX", "PRESET", "UI", "MIX"};
+
+// ブロックごとの所要時間（シナリオの終わりに並べ替えて集計する）
+PLACE_BULK uint32_t times[Stress::MAX_BLOCKS];
+
+// 開始時の状態（各シナリオの起点と終了時の復元に使う）
+PLACE_BULK uint8_t saved_state[SYNTH_SNAPSHOT_MAX_BYTES];
+size_t saved_len = 0;
+
+// 和音は 3半音おきの 16音。弾き直しでは最低音を1半音ずらして全ボイスを奪わせる
+constexpr uint8_t CHORD_LOW = 36;
+constexpr uint8_t CHORD_STEP = 3;
+uint8_t chord_low = 0;  // 鳴らしている和音の最低音 (0: なし)
+
+void chordOn(Synth& synth, uint8_t low) {
+    for (uint8_t v = 0; v < MAX_NOTES; ++v) synth.noteOn(low + v * CHORD_STEP, 127, 1);
+    chord_low = low;
+}
+
+void retrigger(Synth& synth, uint16_t k) {
+    if (chord_low) {
+        for (uint8_t v = 0; v < MAX_NOTES; ++v) synth.noteOff(chord_low + v * CHORD_STEP, 1);
+    }
+    chordOn(synth, CHORD_LOW + (k & 1));
+}
+
+// 64ブロックで -8192 → +8191 → -8192 を1往復
+void bendSweep(Synth& synth, uint16_t k) {
+    const int32_t phase = k & 63;
+    const int32_t tri = phase < 32 ? phase : 64 - phase;
+    synth.setPitchBend(static_cast<int16_t>(std::min<int32_t>(tri * 16384 / 32 - 8192, 8191)));
+}
+
+void maxEffects(Synth& synth) {
+    Delay& delay = synth.getDelay();
+    delay.setDelay(MAX_TIME, MAX_LEVEL, MAX_FEEDBACK);
+
+    Filter& filter = synth.getFilter();
+    filter.setLowPass(Filter::CUTOFF_MAX, Filter::RESONANCE_MAX);
+    filter.setHighPass(Filter::HPF_CUTOFF_MIN, Filter::RESONANCE_MAX);
+    filter.setLpfMix(Q15_MAX);
+    filter.setHpfMix(Q15_MAX);
+
+    Chorus& chorus = synth.getChorus();
+    chorus.setRate(CHORUS_RATE_MAX);
+    chorus.setDepth(CHORUS_DEPTH_MAX);
+    chorus.setMix(Q15_MAX);
+
+    Reverb& reverb = synth.getReverb();
+    reverb.setRoomSize(REVERB_ROOM_MAX);
+    reverb.setDamping(REVERB_DAMP_MIN);
+    reverb.setMix(Q15_MAX);
+
+    synth.setDelayEnabled(true);
+    synth.setLpfEnabled(true);
+    synth.setHpfEnabled(true);
+    synth.setChorusEnabled(true);
+    synth.setReverbEnabled(true);
+}
+
+// CC を割り当てたパラメータの連続変更に相当する書き換えを 1ブロックに 32 回
+// （係数の再計算を伴うものを中心に選ぶ）
+void paramFlood(Synth& synth, uint32_t& rng) {
+    constexpr uint8_t WRITES = 32;
+    for (uint8_t i = 0; i < WRITES; ++i) {
+        rng = rng * 1664525u + 1013904223u;
+        const uint8_t v = static_cast<uint8_t>((rng >> 24) % 100);
+        switch (i & 7) {
+            case 0: synth.setMasterLevel(EffectPreset::toQ15(v)); break;
+            case 1: synth.setFeedback(v & 7); break;
+            case 2: synth.getLfo().setSpeed(v); break;
+            case 3: synth.getLfo().setPmDepth(v); break;
+            case 4: synth.getFilter().setLowPass(EffectPreset::cutoffToHz(v), synth.getLpfResonance()); break;
+            case 5: synth.getFilter().setHighPass(EffectPreset::cutoffToHz(v), synth.getHpfResonance()); break;
+            case 6: synth.getChorus().setRate(v); break;
+            case 7: synth.getReverb().setDamping(v); break;
+        }
+    }
+}
+
+void printHeader(const Synth& synth) {
+    const uint32_t budget = static_cast<uint32_t>(
+        static_cast<uint64_t>(Profiler::ticksPerSecond()) * BUFFER_SIZE / SAMPLE_RATE);
+    Serial.printf("STRESS: unit=%s block=%u budget=%lu preset=%u %s\n",
+        Profiler::unit(), (unsigned)BUFFER_SIZE, (unsigned long)budget,
+        (unsigned)synth.getCurrentPresetId(), synth.getCurrentPresetName());
+    Serial.printf("  %-8s %6s %9s %9s %9s %6s %9s\n",
+        "SCENARIO", "BLOCKS", "AVG", "P99.9", "MAX", "MAX%", "GAP");
+}
+
+} // namespace
+
+bool Stress::parse(const char* name, Scenario& out) {
+    for (uint8_t i = 0; i < SCENARIO_COUNT; ++i) {
+        if (std::strcmp(name, NAMES[i]) == 0) {
+            out = static_cast<Scenario>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* Stress::name(Scenario scenario) {
+    return scenario < SCENARIO_COUNT ? NAMES[scenario] : "?";
+}
+
+bool Stress::start(Synth& synth, Scenario scenario, bool all, uint16_t blocks) {
+    if (active_ || blocks == 0 || blocks > MAX_BLOCKS) return false;
+    while (!supported(scenario)) {
+        if (!all || scenario + 1 >= SCENARIO_COUNT) return false;
+        scenario = static_cast<Scenario>(scenario + 1);
+    }
+    if (synth.saveSnapshot(saved_state, sizeof(saved_state), false, saved_len) != SnapshotStatus::OK) return false;
+
+    // 内部で作る入力は記録しても再生できないので止めておく
+    capture_was_on_ = Capture::enabled();
+    Capture::stop();
+
+    all_ = all;
+    blocks_ = blocks;
+    scenario_ = scenario;
+    printHeader(synth);
+    begin(synth);
+    active_ = true;
+    return true;
+}
+
+void Stress::stop(Synth& synth) {
+    if (!active_) return;
+    if (scenario_ == UI && ui_hook_) ui_hook_(false);
+    Serial.println("STRESS: stopped");
+    end(synth);
+}
+
+// シナリオの起点: 開始時の音色・エフェクト設定で発音を止めた状態から
+void Stress::begin(Synth& synth) {
+    synth.restoreSnapshot(saved_state, saved_len);
+    synth.reset();
+    synth.setPitchBend(0);
+
+    count_ = 0;
+    pending_ = false;
+    last_start_ = 0;
+    max_gap_ = 0;
+    total_ = 0;
+    rng_ = 22222;
+    chord_low = 0;
+
+    if (scenario_ == FX || scenario_ == MIX) maxEffects(synth);
+    if (scenario_ == BEND || scenario_ == MIX) synth.setPitchBendRange(24);
+    if (scenario_ == UI) ui_hook_(true);
+}
+
+void Stress::end(Synth& synth) {
+    active_ = false;
+    pending_ = false;
+    synth.restoreSnapshot(saved_state, saved_len);
+    synth.clearEffectBuffers();
+    samples_ready_flags = false;
+    if (capture_was_on_) Capture::start();
+}
+
+// 1シナリオの集計を出力して次へ
+void Stress::finish(Synth& synth) {
+    std::sort(times, times + count_);
+    const uint32_t budget = static_cast<uint32_t>(
+        static_cast<uint64_t>(Profiler::ticksPerSecond()) * BUFFER_SIZE / SAMPLE_RATE);
+    const uint32_t p999 = times[(static_cast<uint32_t>(count_) * 999 + 999) / 1000 - 1];
+    const uint32_t worst = times[count_ - 1];
+    Serial.printf("  %-8s %6u %9lu %9lu %9lu %5.1f%% %9lu\n",
+        name(scenario_), (unsigned)count_, (unsigned long)(total_ / count_),
+        (unsigned long)p999, (unsigned long)worst, worst * 100.0 / budget, (unsigned long)max_gap_);
+
+    if (scenario_ == UI) ui_hook_(false);
+
+    Scenario next = scenario_;
+    do {
+        next = static_cast<Scenario>(next + 1);
+    } while (next < SCENARIO_COUNT && !supported(next));
+
+    if (all_ && next < SCENARIO_COUNT) {
+        scenario_ = next;
+        begin(synth);
+        return;
+    }
+    Serial.println("STRESS: done");
+    end(synth);
+}
+
+// count_ 番目のブロックの入力
+void Stress::inject(Synth& synth) {
+    const uint16_t k = count_;
+    switch (scenario_) {
+        case CHORD:
+            retrigger(synth, k);
+            break;
+        case BEND:
+            bendSweep(synth, k);
+            break;
+        case CC:
+            paramFlood(synth, rng_);
+            break;
+        case PRESET:
+            synth.loadPreset(k % MAX_PRESETS);
+            retrigger(synth, k);
+            break;
+        case MIX:
+            if ((k & 7) == 0) {
+                synth.loadPreset((k >> 3) % MAX_PRESETS);
+                maxEffects(synth);
+            }
+            retrigger(synth, k);
+            bendSweep(synth, k);
+            paramFlood(synth, rng_);
+            break;
+        default:
+            break;
+    }
+    // 保持するシナリオ: 最初のブロックと、減衰して発音が止まったときに弾く
+    if (!synth.isActive()) chordOn(synth, CHORD_LOW);
+}
+
+/**
+ * @brief 直前のブロックを記録し、次のブロックの入力を流し込む
+ *
+ * 1ブロックの時間 = 入力処理 + generate()。GAP は生成開始の間隔の最大値で、
+ * 実機ではメインループの他の処理（UI 描画・SPI 転送など）による遅れを含む。
+ */
+void Stress::process(Synth& synth) {
+    if (!active_) return;
+
+    if (pending_) {
+        if (synth.getBlockCount() == pending_block_) {
+            if (samples_ready_flags) return;  // 出力待ち
+            pending_ = false;                 // 生成されなかったので入れ直す
+        } else {
+            const uint32_t ticks = input_ticks_ + synth.getBlockTicks();
+            const uint32_t start = synth.getBlockStartTicks();
+            times[count_] = ticks;
+            total_ += ticks;
+            if (count_ > 0) max_gap_ = std::max(max_gap_, start - last_start_);
+            last_start_ = start;
+            pending_ = false;
+
+            if (++count_ >= blocks_) {
+                finish(synth);
+                if (!active_) return;
+            }
+        }
+    }
+
+    if (samples_ready_flags) return;  // 次の update() では生成されない
+
+    const uint32_t t0 = Profiler::now();
+    inject(synth);
+    input_ticks_ = Profiler::now() - t0;
+    pending_block_ = synth.getBlockCount();
+    pending_ = true;
+}
+
+bool Stress::run(Synth& synth, Scenario scenario, bool all, uint16_t blocks) {
+    if (!start(synth, scenario, all, blocks)) return false;
+    while (active_) {
+        process(synth);
+        synth.update();
+        samples_ready_flags = false;
+    }
+    return true;
+}
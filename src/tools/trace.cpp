@@ -0,0 +1,72 @@
+#include "tools/trace.hpp"
+
+#include "tools/profiler.hpp"
+#include "utils/placement.hpp"
+
+// 起動時に初期化されない領域だが、count_ までしか読まないのでクリアは不要
+PLACE_BULK Trace::Record Trace::ring_[Trace::CAPACITY];
+uint16_t Trace::head_ = 0;
+uint16_t Trace::count_ = 0;
+uint32_t Trace::dropped_ = 0;
+uint32_t Trace::min_ticks_ = 0;
+bool Trace::enabled_ = false;
+bool Trace::stop_on_underrun_ = false;
+uint16_t Trace::stop_countdown_ = 0;
+
+void Trace::start(uint32_t min_ticks, bool stop_on_underrun) {
+    enabled_ = false;
+    head_ = 0;
+    count_ = 0;
+    dropped_ = 0;
+    min_ticks_ = min_ticks;
+    stop_on_underrun_ = stop_on_underrun;
+    stop_countdown_ = 0;
+    enabled_ = true;
+}
+
+const Trace::Record& Trace::at(uint16_t index) {
+    const uint16_t oldest = (head_ + CAPACITY - count_) % CAPACITY;
+    return ring_[(oldest + index) % CAPACITY];
+}
+
+// 区間は終わったときに書くので、開始時刻は現在時刻から逆算する
+void Trace::pushSpan(uint8_t stage, uint32_t ticks) {
+    push(Profiler::now() - ticks, ticks, SPAN, stage, 0);
+}
+
+void Trace::pushEvent(Event type, uint8_t a, uint16_t b) {
+    push(Profiler::now(), 0, type, a, b);
+    if (type == UNDERRUN && stop_on_underrun_ && stop_countdown_ == 0) {
+        stop_countdown_ = CAPACITY / 4;
+    }
+}
+
+void Trace::push(uint32_t time, uint32_t dur, Event type, uint8_t a, uint16_t b) {
+    Record& r = ring_[head_];
+    r.time = time;
+    r.dur = dur;
+    r.type = type;
+    r.a = a;
+    r.b = b;
+    head_ = (head_ + 1) % CAPACITY;
+    if (count_ < CAPACITY) ++count_;
+    else ++dropped_;
+
+    // アンダーラン前後が残るよう、後ろ 1/4 を書いたら止める
+    if (stop_countdown_ > 0 && --stop_countdown_ == 0) enabled_ = false;
+}
+
+void Trace::dump() {
+    const bool was_enabled = enabled_;
+    enabled_ = false;
+
+    Serial.printf("TRACE %u %u %lu %lu\n", (unsigned)FORMAT_VERSION, (unsigned)count_,
+        (unsigned long)Profiler::ticksPerSecond(), (unsigned long)dropped_);
+    for (uint16_t i = 0; i < count_; ++i) {
+        Serial.write(reinterpret_cast<const uint8_t*>(&at(i)), sizeof(Record));
+    }
+    Serial.printf("\n");
+
+    // 送り終えたら再開する（ダンプ中のイベントは記録しない）
+    enabled_ = was_enabled;
+}
@@ -0,0 +1,319 @@
+// DSP コアの単体テスト ([env:native] / pio test -e native)
+// src/ は test_build_src でそのままリンクする (src/host/main.cpp は PIO_UNIT_TESTING で外れる)
+
+#include <unity.h>
+
+#include <cmath>
+#include <cstdlib>
+
+#include "host.hpp"
+#include "modules/oscillator.hpp"
+#include "modules/envelope.hpp"
+#include "modules/lfo.hpp"
+#include "utils/algorithm.hpp"
+#include "utils/preset.hpp"
+
+namespace {
+
+// Synth はシングルトンなのでエンジンも1つだけ（テーブル初期化も兼ねる）
+HostEngine engine;
+
+void setAllEffects(Synth& synth, bool on) {
+    synth.setDelayEnabled(on);
+    synth.setChorusEnabled(on);
+    synth.setReverbEnabled(on);
+    synth.setLpfEnabled(on);
+    synth.setHpfEnabled(on);
+}
+
+// 正弦波 (振幅 amp) を n サンプル分
+Sample16_t sineAt(float hz, size_t i, float amp = 16000.0f) {
+    return static_cast<Sample16_t>(amp * std::sin(2.0f * 3.14159265f * hz * i / SAMPLE_RATE));
+}
+
+// ブロックを生成して L/R の最大絶対値を返す
+int32_t renderPeak(int blocks) {
+    int32_t peak = 0;
+    for (int b = 0; b < blocks; ++b) {
+        engine.renderBlock();
+        for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+            peak = std::max<int32_t>(peak, std::abs(static_cast<int32_t>(engine.left()[i])));
+            peak = std::max<int32_t>(peak, std::abs(static_cast<int32_t>(engine.right()[i])));
+        }
+    }
+    return peak;
+}
+
+} // namespace
+
+void setUp() {
+    Synth& synth = engine.synth();
+    synth.reset();
+    synth.setPitchBend(0);
+    synth.loadPreset(0);
+    setAllEffects(synth, false);
+}
+
+void tearDown() {}
+
+// =============================================
+// Oscillator
+// =============================================
+
+// A4 のサインは 1 秒で 440 周期（正方向のゼロクロス 440 回）
+void test_oscillator_sine_frequency() {
+    Oscillator osc;
+    Oscillator::Memory mem;
+    osc.enable();
+    osc.setWavetable(0);
+    osc.setLevelNonLinear(99);
+    osc.prepareNoteTable();
+    osc.setFrequency(mem, 69);
+
+    int crossings = 0;
+    Audio24_t prev = osc.getSample(mem);
+    for (uint32_t i = 0; i < SAMPLE_RATE; ++i) {
+        osc.update(mem);
+        const Audio24_t s = osc.getSample(mem);
+        if (prev < 0 && s >= 0) ++crossings;
+        prev = s;
+    }
+    TEST_ASSERT_INT_WITHIN(1, 440, crossings);
+}
+
+void test_oscillator_disabled_is_silent() {
+    Oscillator osc;
+    Oscillator::Memory mem;
+    osc.prepareNoteTable();
+    osc.setFrequency(mem, 69);
+    for (size_t i = 0; i < BUFFER_SIZE; ++i) {
+        TEST_ASSERT_EQUAL_INT32(0, osc.getSample(mem));
+        osc.update(mem);
+    }
+}
+
+// 高い音ほど上位のミップ（倍音の少ないテーブル）を選ぶ
+void test_oscillator_mip_level_rises_with_pitch() {
+    Oscillator osc;
+    osc.enable();
+    osc.setWavetable(2);
+    osc.prepareNoteTable();
+    Oscillator::Memory low, high;
+    osc.setFrequency(low, 36);
+    osc.setFrequency(high, 108);
+    TEST_ASSERT_TRUE(high.mip > low.mip);
+    TEST_ASSERT_EQUAL_UINT8(Oscillator::selectMipLevel(high.delta), high.mip);
+}
+
+// =============================================
+// Envelope
+// =============================================
+
+void test_envelope_attack_sustain_release() {
+    Envelope env;
+    Envelope::Memory mem;
+    env.setRate1(90);
+    env.setRate2(90);
+    env.setRate3(90);
+    env.setRate4(90);
+    env.setLevel1(99);
+    env.setLevel2(99);
+    env.setLevel3(70);
+    env.setLevel4(0);
+    env.prepareNoteTables(99);
+    env.setOutlevel(99, 127, 60);
+    env.calcNoteTargetLevels(mem);
+    env.reset(mem);
+
+    const EnvGain_t start = env.currentLevel(mem);
+    for (int i = 0; i < 2000 && mem.state != Envelope::EnvelopeState::Phase3; ++i) env.update(mem);
+    TEST_ASSERT_TRUE(mem.state == Envelope::EnvelopeState::Phase3);
+    TEST_ASSERT_TRUE(env.currentLevel(mem) > start);
+    TEST_ASSERT_FALSE(env.isFinished(mem));
+
+    env.release(mem);
+    for (int i = 0; i < 20000 && !env.isFinished(mem); ++i) env.update(mem);
+    TEST_ASSERT_TRUE(env.isFinished(mem));
+}
+
+// =============================================
+// LFO
+// =============================================
+
+// サイン LFO のピッチ変調は正負の両方に振れる
+void test_lfo_pitch_mod_swings_both_ways() {
+    Lfo lfo;
+    lfo.init();
+    lfo.setWave(0);
+    lfo.setSpeed(70);
+    lfo.setDelay(0);
+    lfo.setPmDepth(99);
+    lfo.setPitchModSens(7);
+    lfo.reset();
+
+    int32_t lo = 0, hi = 0;
+    for (int b = 0; b < 2000; ++b) {
+        lfo.advance(BUFFER_SIZE);
+        lo = std::min(lo, lfo.getPitchMod());
+        hi = std::max(hi, lfo.getPitchMod());
+    }
+    TEST_ASSERT_TRUE(lo < 0);
+    TEST_ASSERT_TRUE(hi > 0);
+}
+
+// =============================================
+// エフェクト
+// =============================================
+
+// LPF 1kHz: 10kHz は大きく減衰し、200Hz はほぼそのまま通る
+void test_filter_lpf_attenuates_above_cutoff() {
+    Filter& filter = engine.synth().getFilter();
+    filter.setLowPass(1000.0f);
+    filter.setLpfMix(Q15_MAX);
+
+    auto peakThrough = [&](float hz) {
+        filter.reset();
+        int32_t peak = 0;
+        for (size_t i = 0; i < 4096; ++i) {
+            const Sample16_t y = filter.processLpfL(sineAt(hz, i));
+            if (i >= 2048) peak = std::max<int32_t>(peak, std::abs(static_cast<int32_t>(y)));
+        }
+        return peak;
+    };
+    TEST_ASSERT_TRUE(peakThrough(10000.0f) < 16000 / 50);  // -34dB 以下
+    TEST_ASSERT_INT_WITHIN(16000 / 10, 16000, peakThrough(200.0f));
+}
+
+// インパルスがディレイタイム後に戻ってくる
+void test_delay_echo_arrives_after_time() {
+    Synth& synth = engine.synth();
+    synth.setDelayEnabled(true);
+    Delay& delay = synth.getDelay();
+    delay.setDelay(10, Q15_MAX, 0);
+    delay.reset();
+    delay.setTime(10);
+
+    const uint32_t expect = delay.getDelayLength();
+    uint32_t first = 0;
+    for (uint32_t i = 0; i < expect * 2 && first == 0; ++i) {
+        const Sample16_t y = delay.processL(i == 0 ? 16000 : 0);
+        if (i > 0 && std::abs(static_cast<int32_t>(y)) > 1000) first = i;
+    }
+    TEST_ASSERT_INT_WITHIN(2, expect, first);
+}
+
+// インパルスの後に残響が続き、出力は有限
+void test_reverb_produces_tail() {
+    Synth& synth = engine.synth();
+    synth.setReverbEnabled(true);
+    Reverb& reverb = synth.getReverb();
+    reverb.reset();
+    reverb.setRoomSize(80);
+    reverb.setDamping(30);
+    reverb.setMix(Q15_MAX / 2);
+
+    int32_t tail = 0;
+    for (uint32_t i = 0; i < SAMPLE_RATE / 2; ++i) {
+        Sample16_t l = i == 0 ? 16000 : 0;
+        Sample16_t r = l;
+        reverb.process(l, r);
+        if (i > SAMPLE_RATE / 10) tail = std::max<int32_t>(tail, std::abs(static_cast<int32_t>(l)));
+    }
+    TEST_ASSERT_TRUE(tail > 0);
+}
+
+// =============================================
+// テーブル
+// =============================================
+
+// 各アルゴリズムの実行順はオペレーターの並べ替えで、キャリアが1つ以上ある
+void test_algorithms_are_well_formed() {
+    for (uint8_t a = 0; a < 32; ++a) {
+        const Algorithm& algo = Algorithms::get(a);
+        uint8_t seen = 0;
+        for (uint8_t k = 0; k < MAX_OPERATORS; ++k) {
+            TEST_ASSERT_TRUE(algo.exec_order[k] < MAX_OPERATORS);
+            seen |= 1 << algo.exec_order[k];
+        }
+        TEST_ASSERT_EQUAL_UINT8(0x3F, seen);
+        TEST_ASSERT_NOT_EQUAL(0, algo.output_mask);
+        TEST_ASSERT_TRUE(algo.feedback_op >= -1 && algo.feedback_op < MAX_OPERATORS);
+    }
+}
+
+// =============================================
+// Synth
+// =============================================
+
+void test_every_preset_sounds() {
+    Synth& synth = engine.synth();
+    for (uint8_t p = 0; p < MAX_PRESETS; ++p) {
+        synth.reset();
+        synth.loadPreset(p);
+        synth.noteOn(60, 100, 1);
+        synth.noteOn(64, 100, 1);
+        TEST_ASSERT_TRUE_MESSAGE(renderPeak(100) > 0, DefaultPresets::get(p).name);
+    }
+}
+
+void test_note_on_off_lifecycle() {
+    Synth& synth = engine.synth();
+    synth.noteOn(60, 100, 1);
+    TEST_ASSERT_EQUAL_UINT8(1, synth.getActiveNoteCount());
+    TEST_ASSERT_TRUE(renderPeak(20) > 0);
+
+    synth.noteOff(60, 1);
+    for (int b = 0; b < 2000 && synth.getActiveNoteCount() > 0; ++b) engine.renderBlock();
+    TEST_ASSERT_EQUAL_UINT8(0, synth.getActiveNoteCount());
+}
+
+// 編集はステージングの面に入り、次のブロックから鳴る音に反映される
+void test_operator_edit_applies_at_next_block() {
+    Synth& synth = engine.synth();
+    const Algorithm& algo = Algorithms::get(synth.getCurrentAlgorithmId());
+    for (uint8_t op = 0; op < MAX_OPERATORS; ++op) {
+        if (!(algo.output_mask & (1 << op))) continue;
+        synth.editOperatorOsc(op).disable();
+        TEST_ASSERT_FALSE(synth.getOperatorOsc(op).isEnabled());
+    }
+
+    engine.renderBlock();  // ブロックの境目で公開
+    synth.noteOn(60, 100, 1);
+    TEST_ASSERT_EQUAL_INT32(0, renderPeak(20));
+}
+
+// キャプチャの起点: ランダムプリセットの種を覚え、読み込み後の編集を知らせる
+void test_capture_base_tracks_seed_and_edits() {
+    Synth& synth = engine.synth();
+    TEST_ASSERT_EQUAL_UINT32(0, synth.getRandomSeed());
+    TEST_ASSERT_FALSE(synth.isVoiceEdited());
+
+    synth.randomizePreset(1234);
+    TEST_ASSERT_EQUAL_UINT32(1234, synth.getRandomSeed());
+    TEST_ASSERT_FALSE(synth.isVoiceEdited());
+
+    synth.editOperatorEnv(0).setRate1(10);
+    TEST_ASSERT_TRUE(synth.isVoiceEdited());
+
+    synth.loadPreset(3);
+    TEST_ASSERT_EQUAL_UINT32(0, synth.getRandomSeed());
+    TEST_ASSERT_FALSE(synth.isVoiceEdited());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_oscillator_sine_frequency);
+    RUN_TEST(test_oscillator_disabled_is_silent);
+    RUN_TEST(test_oscillator_mip_level_rises_with_pitch);
+    RUN_TEST(test_envelope_attack_sustain_release);
+    RUN_TEST(test_lfo_pitch_mod_swings_both_ways);
+    RUN_TEST(test_filter_lpf_attenuates_above_cutoff);
+    RUN_TEST(test_delay_echo_arrives_after_time);
+    RUN_TEST(test_reverb_produces_tail);
+    RUN_TEST(test_algorithms_are_well_formed);
+    RUN_TEST(test_every_preset_sounds);
+    RUN_TEST(test_note_on_off_lifecycle);
+    RUN_TEST(test_operator_edit_applies_at_next_block);
+    RUN_TEST(test_capture_base_tracks_seed_and_edits);
+    return UNITY_END();
+}
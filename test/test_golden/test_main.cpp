@@ -0,0 +1,37 @@
+// ゴールデン出力の回帰チェック ([env:native] / pio test -e native)
+// reference.gold は x86-64 Linux / GCC (-O2 -ffast-math) で golden record したもの。
+// 出力を意図して変えたときは golden record test/test_golden/reference.gold で取り直してコミットする
+
+#include <unity.h>
+
+#include <string>
+
+#include "host.hpp"
+
+namespace {
+
+// テストの作業ディレクトリに依存しないよう、このファイルの隣を見る
+std::string referencePath() {
+    const std::string self = __FILE__;
+    const size_t slash = self.find_last_of("/\\");
+    if (slash == std::string::npos) return "test/test_golden/reference.gold";
+    return self.substr(0, slash + 1) + "reference.gold";
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+// 全プリセット・全アルゴリズム × エフェクト ON/OFF がビット一致する
+void test_golden_matches_reference() {
+    const std::string path = referencePath();
+    char* argv[] = {const_cast<char*>("golden"), const_cast<char*>("check"), const_cast<char*>(path.c_str())};
+    TEST_ASSERT_EQUAL_INT(0, runGolden(3, argv));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_golden_matches_reference);
+    return UNITY_END();
+}
@@ -0,0 +1,21 @@
+// 模擬パネルの転送チェック ([env:native] / pio test -e native)
+// オーディオ処理を挟んで窓を設定し直しても、パネルの内容がキャンバスと一致する
+
+#include <unity.h>
+
+#include "host.hpp"
+
+void setUp() {}
+void tearDown() {}
+
+// PRESET / OPERATOR / OSCILLOSCOPE を各 2秒、GFX_CHUNK_H 行ごとと乱数の位置で挟む
+void test_panel_matches_canvas_after_audio_breaks() {
+    char* argv[] = {const_cast<char*>("panel"), const_cast<char*>("-n"), const_cast<char*>("120")};
+    TEST_ASSERT_EQUAL_INT(0, runPanel(3, argv));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_panel_matches_canvas_after_audio_breaks);
+    return UNITY_END();
+}